@@ -27,6 +27,34 @@
 
 #define LZMA_HEADER_SIZE (LZMA_PROPS_SIZE + 8)
 
+//
+// Multi-block LZMA layout (gLzmaMultiBlockCustomDecompressGuid). All fields
+// are little endian. The header is followed by BlockCount + 1 UINT32 offsets,
+// relative to the start of the header; block N starts at Offset[N], 4-byte
+// aligned, and ends before Offset[N + 1]. Each block is a GUIDed section of
+// gLzmaCustomDecompressGuid, holding a complete LZMA stream (props + 8-byte
+// size + data) of BlockSize decoded bytes, except the last block which holds
+// the remainder. Keep in sync with MdeModulePkg/Include/Guid/LzmaDecompress.h.
+//
+#define LZMA_MULTI_BLOCK_SIGNATURE    0x424D5A4C  // "LZMB"
+#define LZMA_MULTI_BLOCK_HEADER_SIZE  16
+#define LZMA_MULTI_BLOCK_MIN_SIZE     (4 * 1024)
+#define LZMA_MULTI_BLOCK_DEFAULT_SIZE (256 * 1024)
+
+//
+// EFI_GUID_DEFINED_SECTION and EFI_GUID_DEFINED_SECTION2 around each block
+//
+#define GUID_DEFINED_SECTION_TYPE     0x02
+#define GUID_DEFINED_SECTION_SIZE     24
+#define GUID_DEFINED_SECTION2_SIZE    28
+#define GUIDED_PROCESSING_REQUIRED    0x01
+#define MAX_SECTION_SIZE              0xFFFFFF
+
+static const Byte mLzmaCustomDecompressGuid[16] = {
+  0x98, 0x58, 0x4E, 0xEE, 0x14, 0x39, 0x59, 0x42,
+  0x9D, 0x6E, 0xDC, 0x7B, 0xD7, 0x94, 0x03, 0xCF
+};
+
 typedef enum {
   NoConverter,
   X86Converter,
@@ -41,13 +69,15 @@ const char *kInvalidParamValMessage = "Invalid parameter value";
 
 static BoolInt mQuietMode = False;
 static CONVERTER_TYPE mConType = NoConverter;
+static BoolInt mMultiBlock = False;
+static UInt32 mBlockSize = LZMA_MULTI_BLOCK_DEFAULT_SIZE;
 
 UINT64 mDictionarySize = 28;
 UINT64 mCompressionMode = 2;
 
 #define UTILITY_NAME "LzmaCompress"
 #define UTILITY_MAJOR_VERSION 0
-#define UTILITY_MINOR_VERSION 2
+#define UTILITY_MINOR_VERSION 3
 #define INTEL_COPYRIGHT \
   "Copyright (c) 2009-2018, Intel Corporation. All rights reserved."
 void PrintHelp(char *buffer)
@@ -60,6 +90,10 @@ void PrintHelp(char *buffer)
              "  -d: decode file\n"
              "  -o FileName, --output FileName: specify the output filename\n"
              "  --f86: enable converter for x86 code\n"
+             "  --multi-block: use the multi-block format whose blocks can be\n"
+             "                 decoded independently\n"
+             "  --block-size Size: decoded bytes per block for --multi-block,\n"
+             "                 a multiple of 4KB, default: 262144 (256KB)\n"
              "  -v, --verbose: increase output messages\n"
              "  -q, --quiet: reduce output messages\n"
              "  --debug [0-9]: set debug level\n"
@@ -238,6 +272,254 @@ Done:
   return res;
 }
 
+static void SetUInt32(Byte *buffer, UInt32 value)
+{
+  buffer[0] = (Byte)value;
+  buffer[1] = (Byte)(value >> 8);
+  buffer[2] = (Byte)(value >> 16);
+  buffer[3] = (Byte)(value >> 24);
+}
+
+static UInt32 GetUInt32(const Byte *buffer)
+{
+  return (UInt32)buffer[0] | ((UInt32)buffer[1] << 8) |
+         ((UInt32)buffer[2] << 16) | ((UInt32)buffer[3] << 24);
+}
+
+static size_t WriteBlockSectionHeader(Byte *buffer, size_t sectionSize, BoolInt section2)
+{
+  size_t headerSize = section2 ? GUID_DEFINED_SECTION2_SIZE : GUID_DEFINED_SECTION_SIZE;
+  Byte *guid;
+
+  if (section2) {
+    buffer[0] = buffer[1] = buffer[2] = 0xFF;
+    SetUInt32(buffer + 4, (UInt32)sectionSize);
+    guid = buffer + 8;
+  } else {
+    buffer[0] = (Byte)sectionSize;
+    buffer[1] = (Byte)(sectionSize >> 8);
+    buffer[2] = (Byte)(sectionSize >> 16);
+    guid = buffer + 4;
+  }
+  buffer[3] = GUID_DEFINED_SECTION_TYPE;
+
+  memcpy(guid, mLzmaCustomDecompressGuid, sizeof(mLzmaCustomDecompressGuid));
+  guid[16] = (Byte)headerSize;
+  guid[17] = 0;
+  guid[18] = GUIDED_PROCESSING_REQUIRED;
+  guid[19] = 0;
+  return headerSize;
+}
+
+static SRes EncodeMultiBlock(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize, CLzmaEncProps *props)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t outPos;
+  size_t headerSize;
+  size_t sectionHeaderSize;
+  UInt32 blockCount;
+  UInt32 block;
+  BoolInt section2;
+  CLzmaEncProps blockProps;
+
+  if (inSize == 0)
+    return SZ_ERROR_INPUT_EOF;
+  if (fileSize > 0xFFFFFFFF)
+    return SZ_ERROR_UNSUPPORTED;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  blockCount = (UInt32)((inSize + mBlockSize - 1) / mBlockSize);
+  headerSize = LZMA_MULTI_BLOCK_HEADER_SIZE + ((size_t)blockCount + 1) * 4;
+
+  //
+  // Each block gets the same 105% + 64KB worst case as a single stream, plus
+  // its section header and alignment. Blocks that may not fit in a 24-bit
+  // section size use EFI_GUID_DEFINED_SECTION2 headers.
+  //
+  section2 = (size_t)mBlockSize / 20 * 21 + (1 << 16) + LZMA_HEADER_SIZE +
+             GUID_DEFINED_SECTION_SIZE >= MAX_SECTION_SIZE;
+  sectionHeaderSize = section2 ? GUID_DEFINED_SECTION2_SIZE : GUID_DEFINED_SECTION_SIZE;
+  outSize = headerSize + inSize / 20 * 21 +
+            (size_t)blockCount * ((1 << 16) + LZMA_HEADER_SIZE + sectionHeaderSize + 3);
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  SetUInt32(outBuffer, LZMA_MULTI_BLOCK_SIGNATURE);
+  SetUInt32(outBuffer + 4, mBlockSize);
+  SetUInt32(outBuffer + 8, blockCount);
+  SetUInt32(outBuffer + 12, (UInt32)inSize);
+
+  //
+  // The dictionary never needs to exceed one block, and a smaller dictionary
+  // keeps the encoder footprint down for large inputs.
+  //
+  blockProps = *props;
+  blockProps.reduceSize = mBlockSize;
+
+  outPos = headerSize;
+  res = SZ_OK;
+  for (block = 0; block < blockCount; block++) {
+    size_t blockStart = (size_t)block * mBlockSize;
+    size_t blockSize = inSize - blockStart;
+    size_t outSizeProcessed;
+    size_t outPropsSize = LZMA_PROPS_SIZE;
+    Byte *stream;
+    int i;
+
+    if (blockSize > mBlockSize)
+      blockSize = mBlockSize;
+
+    while ((outPos & 3) != 0)
+      outBuffer[outPos++] = 0;
+
+    SetUInt32(outBuffer + LZMA_MULTI_BLOCK_HEADER_SIZE + (size_t)block * 4, (UInt32)outPos);
+
+    stream = outBuffer + outPos + sectionHeaderSize;
+    for (i = 0; i < 8; i++)
+      stream[i + LZMA_PROPS_SIZE] = (Byte)((UInt64)blockSize >> (8 * i));
+
+    outSizeProcessed = outSize - outPos - sectionHeaderSize - LZMA_HEADER_SIZE;
+    res = LzmaEncode(stream + LZMA_HEADER_SIZE, &outSizeProcessed,
+        inBuffer + blockStart, blockSize,
+        &blockProps, stream, &outPropsSize, 0,
+        NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+
+    WriteBlockSectionHeader(outBuffer + outPos,
+        sectionHeaderSize + LZMA_HEADER_SIZE + outSizeProcessed, section2);
+    outPos += sectionHeaderSize + LZMA_HEADER_SIZE + outSizeProcessed;
+  }
+
+  SetUInt32(outBuffer + LZMA_MULTI_BLOCK_HEADER_SIZE + (size_t)blockCount * 4, (UInt32)outPos);
+
+  if (outStream->Write(outStream, outBuffer, outPos) != outPos)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
+static SRes DecodeMultiBlock(ISeqOutStream *outStream, ISeqInStream *inStream, UInt64 fileSize)
+{
+  SRes res;
+  size_t inSize = (size_t)fileSize;
+  Byte *inBuffer = 0;
+  Byte *outBuffer = 0;
+  size_t outSize;
+  size_t headerSize;
+  UInt32 blockSize;
+  UInt32 blockCount;
+  UInt32 block;
+
+  if (inSize < LZMA_MULTI_BLOCK_HEADER_SIZE + 4)
+    return SZ_ERROR_INPUT_EOF;
+
+  inBuffer = (Byte *)MyAlloc(inSize);
+  if (inBuffer == 0)
+    return SZ_ERROR_MEM;
+
+  if (SeqInStream_Read(inStream, inBuffer, inSize) != SZ_OK) {
+    res = SZ_ERROR_READ;
+    goto Done;
+  }
+
+  blockSize = GetUInt32(inBuffer + 4);
+  blockCount = GetUInt32(inBuffer + 8);
+  outSize = GetUInt32(inBuffer + 12);
+  headerSize = LZMA_MULTI_BLOCK_HEADER_SIZE + ((size_t)blockCount + 1) * 4;
+
+  if (GetUInt32(inBuffer) != LZMA_MULTI_BLOCK_SIGNATURE ||
+      blockSize == 0 ||
+      blockCount != (UInt32)((outSize + blockSize - 1) / blockSize) ||
+      headerSize > inSize) {
+    res = SZ_ERROR_DATA;
+    goto Done;
+  }
+
+  if (outSize == 0) {
+    res = SZ_OK;
+    goto Done;
+  }
+
+  outBuffer = (Byte *)MyAlloc(outSize);
+  if (outBuffer == 0) {
+    res = SZ_ERROR_MEM;
+    goto Done;
+  }
+
+  res = SZ_OK;
+  for (block = 0; block < blockCount; block++) {
+    size_t start = GetUInt32(inBuffer + LZMA_MULTI_BLOCK_HEADER_SIZE + (size_t)block * 4);
+    size_t end = GetUInt32(inBuffer + LZMA_MULTI_BLOCK_HEADER_SIZE + (size_t)block * 4 + 4);
+    size_t blockOutSize = outSize - (size_t)block * blockSize;
+    size_t sectionSize;
+    size_t dataOffset;
+    size_t inSizePure;
+    const Byte *guid;
+    ELzmaStatus status;
+
+    if (blockOutSize > blockSize)
+      blockOutSize = blockSize;
+
+    if (start < headerSize || end > inSize || end < start + GUID_DEFINED_SECTION2_SIZE ||
+        inBuffer[start + 3] != GUID_DEFINED_SECTION_TYPE) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    sectionSize = GetUInt32(inBuffer + start) & MAX_SECTION_SIZE;
+    guid = inBuffer + start + 4;
+    if (sectionSize == MAX_SECTION_SIZE) {
+      sectionSize = GetUInt32(inBuffer + start + 4);
+      guid = inBuffer + start + 8;
+    }
+
+    dataOffset = guid[16] | ((size_t)guid[17] << 8);
+    if (memcmp(guid, mLzmaCustomDecompressGuid, sizeof(mLzmaCustomDecompressGuid)) != 0 ||
+        sectionSize > end - start || dataOffset < (size_t)(guid + 20 - (inBuffer + start)) ||
+        sectionSize < dataOffset + LZMA_HEADER_SIZE) {
+      res = SZ_ERROR_DATA;
+      goto Done;
+    }
+
+    start += dataOffset;
+    inSizePure = sectionSize - dataOffset - LZMA_HEADER_SIZE;
+    res = LzmaDecode(outBuffer + (size_t)block * blockSize, &blockOutSize,
+        inBuffer + start + LZMA_HEADER_SIZE, &inSizePure,
+        inBuffer + start, LZMA_PROPS_SIZE, LZMA_FINISH_END, &status, &g_Alloc);
+    if (res != SZ_OK)
+      goto Done;
+  }
+
+  if (outStream->Write(outStream, outBuffer, outSize) != outSize)
+    res = SZ_ERROR_WRITE;
+
+Done:
+  MyFree(outBuffer);
+  MyFree(inBuffer);
+
+  return res;
+}
+
 int main2(int numArgs, const char *args[], char *rs)
 {
   CFileSeqInStream inStream;
@@ -272,6 +554,19 @@ int main2(int numArgs, const char *args[], char *rs)
       modeWasSet = True;
     } else if (strcmp(args[param], "--f86") == 0) {
       mConType = X86Converter;
+    } else if (strcmp(args[param], "--multi-block") == 0) {
+      mMultiBlock = True;
+    } else if (strcmp(args[param], "--block-size") == 0) {
+      UINT64 BlockSize;
+      if (numArgs < (param + 2)) {
+        return PrintUserError(rs);
+      }
+      if (AsciiStringToUint64(args[++param], FALSE, &BlockSize) != EFI_SUCCESS ||
+          BlockSize < LZMA_MULTI_BLOCK_MIN_SIZE || BlockSize > 0x80000000 ||
+          (BlockSize % LZMA_MULTI_BLOCK_MIN_SIZE) != 0) {
+        return PrintError(rs, kInvalidParamValMessage);
+      }
+      mBlockSize = (UInt32)BlockSize;
     } else if (strcmp(args[param], "-o") == 0 ||
                strcmp(args[param], "--output") == 0) {
       if (numArgs < (param + 2)) {
@@ -342,6 +637,10 @@ int main2(int numArgs, const char *args[], char *rs)
     return PrintUserError(rs);
   }
 
+  if (mMultiBlock && (mConType != NoConverter)) {
+    return PrintError(rs, "--multi-block can not be combined with --f86");
+  }
+
   {
     size_t t4 = sizeof(UInt32);
     size_t t8 = sizeof(UInt64);
@@ -364,14 +663,22 @@ int main2(int numArgs, const char *args[], char *rs)
     if (!mQuietMode) {
       printf("Encoding\n");
     }
-    res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    if (mMultiBlock) {
+      res = EncodeMultiBlock(&outStream.vt, &inStream.vt, fileSize, &props);
+    } else {
+      res = Encode(&outStream.vt, &inStream.vt, fileSize, &props);
+    }
   }
   else
   {
     if (!mQuietMode) {
       printf("Decoding\n");
     }
-    res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    if (mMultiBlock) {
+      res = DecodeMultiBlock(&outStream.vt, &inStream.vt, fileSize);
+    } else {
+      res = Decode(&outStream.vt, &inStream.vt, fileSize);
+    }
   }
 
   File_Close(&outStream.file);
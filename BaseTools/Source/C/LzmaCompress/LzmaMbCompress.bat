@@ -0,0 +1,25 @@
+@REM @file
+@REM This script will exec LzmaCompress tool with --multi-block option that
+@REM produces blocks which can be decoded independently.
+@REM
+@REM SPDX-License-Identifier: BSD-2-Clause-Patent
+@REM
+
+@echo off
+@setlocal
+
+:Begin
+if "%1"=="" goto End
+if "%1"=="-e" (
+  set FLAG=--multi-block
+)
+if "%1"=="-d" (
+  set FLAG=--multi-block
+)
+set ARGS=%ARGS% %1
+shift
+goto Begin
+
+:End
+LzmaCompress %ARGS% %FLAG%
+@echo on
@@ -13,8 +13,10 @@ import os
 import sys
 import unittest
 
+import LzmaCompress
 import TianoCompress
 modules = (
+    LzmaCompress,
     TianoCompress,
     )
 
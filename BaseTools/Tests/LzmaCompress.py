@@ -0,0 +1,195 @@
+## @file
+# Unit tests for LzmaCompress utility
+#
+# Running this file directly with a firmware volume as the argument, for
+# example Build/OvmfX64/DEBUG_GCC5/FV/DXEFV.Fv, benchmarks the decoding of
+# that file: the single stream format, and the multi-block format both
+# sequentially and as scheduled over 1 to 8 processors by the DxeCore.
+#
+#  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+#
+#  SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+##
+# Import Modules
+#
+from __future__ import print_function
+import os
+import random
+import struct
+import sys
+import time
+import unittest
+import uuid
+
+import TestTools
+
+LZMA_MULTI_BLOCK_SIGNATURE = 0x424D5A4C
+LZMA_CUSTOM_DECOMPRESS_GUID = uuid.UUID('EE4E5898-3914-4259-9D6E-DC7BD79403CF')
+EFI_SECTION_GUID_DEFINED = 0x02
+
+class Tests(TestTools.BaseToolsTest):
+
+    def setUp(self):
+        TestTools.BaseToolsTest.setUp(self)
+        self.toolName = 'LzmaCompress'
+
+    def testHelp(self):
+        result = self.RunTool('--help', logFile='help')
+        self.assertTrue(result == 0)
+
+    def compressionTestCycle(self, data, *options):
+        self.WriteTmpFile('input', data)
+        result = self.RunTool(
+            '-e', '-q',
+            '-o', self.GetTmpFilePath('output1'),
+            self.GetTmpFilePath('input'),
+            *options
+            )
+        self.assertTrue(result == 0)
+        result = self.RunTool(
+            '-d', '-q',
+            '-o', self.GetTmpFilePath('output2'),
+            self.GetTmpFilePath('output1'),
+            *options
+            )
+        self.assertTrue(result == 0)
+        start = self.ReadTmpFile('input')
+        finish = self.ReadTmpFile('output2')
+        startEqualsFinish = start == finish
+        if not startEqualsFinish:
+            print()
+            print('Original data did not match decompress(compress(data))')
+            self.DisplayBinaryData('original data', start)
+            self.DisplayBinaryData('after compression', self.ReadTmpFile('output1'))
+            self.DisplayBinaryData('after decompression', finish)
+        self.assertTrue(startEqualsFinish)
+        return self.ReadTmpFile('output1')
+
+    def testRandomDataCycles(self):
+        for i in range(8):
+            data = self.GetRandomString(1024, 2048)
+            self.compressionTestCycle(data)
+            self.CleanUpTmpDir()
+
+    def testMultiBlockCycles(self):
+        for i in range(8):
+            data = self.GetRandomString(4096, 6 * 4096)
+            encoded = self.compressionTestCycle(
+                data, '--multi-block', '--block-size', '4096'
+                )
+            signature, blockSize, blockCount, decodedSize = \
+                struct.unpack_from('<IIII', encoded)
+            self.assertEqual(signature, LZMA_MULTI_BLOCK_SIGNATURE)
+            self.assertEqual(blockSize, 4096)
+            self.assertEqual(decodedSize, len(self.ReadTmpFile('input')))
+            self.assertEqual(blockCount, (decodedSize + 4095) // 4096)
+            offsets = struct.unpack_from('<%dI' % (blockCount + 1), encoded, 16)
+            self.assertEqual(offsets[-1], len(encoded))
+            self.assertEqual(list(offsets), sorted(offsets))
+            for block in range(blockCount):
+                self.checkBlockSection(encoded, offsets[block], offsets[block + 1])
+            self.CleanUpTmpDir()
+
+    def checkBlockSection(self, encoded, start, end):
+        #
+        # Each block is an aligned GUIDed section of the single stream LZMA
+        # GUID, so it can be decoded by the LZMA GUIDed section handler.
+        #
+        self.assertEqual(start % 4, 0)
+        size, sectionType, guid, dataOffset = \
+            struct.unpack_from('<3sB16sH', encoded, start)
+        size = int.from_bytes(size, 'little')
+        self.assertEqual(sectionType, EFI_SECTION_GUID_DEFINED)
+        self.assertEqual(uuid.UUID(bytes_le=guid), LZMA_CUSTOM_DECOMPRESS_GUID)
+        self.assertEqual(dataOffset, 24)
+        self.assertTrue(start + size <= end < start + size + 4)
+
+    def testMultiBlockOptions(self):
+        self.WriteTmpFile('input', self.GetRandomString(1024))
+        for options in (('--f86',), ('--block-size', '5000')):
+            result = self.RunTool(
+                '-e', '-q', '--multi-block',
+                '-o', self.GetTmpFilePath('output'),
+                self.GetTmpFilePath('input'),
+                *options
+                )
+            self.assertTrue(result != 0)
+
+TheTestSuite = TestTools.MakeTheTestSuite(locals())
+
+def DecodeTime(stream):
+    #
+    # LzmaCompress writes the LZMA SDK format, which the lzma module reads as
+    # FORMAT_ALONE. Take the best of a few runs to filter out noise.
+    #
+    import lzma
+
+    best = None
+    for i in range(3):
+        begin = time.perf_counter()
+        decoded = lzma.decompress(stream, format=lzma.FORMAT_ALONE)
+        elapsed = time.perf_counter() - begin
+        best = elapsed if best is None else min(best, elapsed)
+    return decoded, best
+
+def ScheduledTime(blockTimes, processors):
+    #
+    # The DxeCore hands the next block to the first processor that is free.
+    #
+    free = [0.0] * processors
+    for blockTime in blockTimes:
+        free.sort()
+        free[0] += blockTime
+    return max(free)
+
+def Benchmark(fileName):
+    import subprocess
+    import tempfile
+
+    with open(fileName, 'rb') as f:
+        original = f.read()
+    tmpDir = tempfile.mkdtemp()
+    encoded = os.path.join(tmpDir, 'encoded')
+
+    subprocess.check_call(['LzmaCompress', '-e', '-q', '-o', encoded, fileName])
+    with open(encoded, 'rb') as f:
+        single = f.read()
+    decoded, singleTime = DecodeTime(single)
+    assert decoded == original
+    print('%-14s %10d -> %10d bytes, decode %.3fs' %
+          ('single stream', len(original), len(single), singleTime))
+
+    subprocess.check_call(['LzmaCompress', '-e', '-q', '-o', encoded, fileName, '--multi-block'])
+    with open(encoded, 'rb') as f:
+        multi = f.read()
+    os.remove(encoded)
+    os.rmdir(tmpDir)
+
+    signature, blockSize, blockCount, decodedSize = \
+        struct.unpack_from('<IIII', multi)
+    assert signature == LZMA_MULTI_BLOCK_SIGNATURE
+    offsets = struct.unpack_from('<%dI' % (blockCount + 1), multi, 16)
+    blockTimes = []
+    decoded = b''
+    for block in range(blockCount):
+        start = offsets[block]
+        size = int.from_bytes(multi[start:start + 3], 'little')
+        dataOffset = struct.unpack_from('<H', multi, start + 20)[0]
+        blockData, blockTime = DecodeTime(multi[start + dataOffset:start + size])
+        decoded += blockData
+        blockTimes.append(blockTime)
+    assert decoded == original
+    print('%-14s %10d -> %10d bytes, %d blocks of %d bytes' %
+          ('multi-block', len(original), len(multi), blockCount, blockSize))
+    for processors in (1, 2, 4, 8):
+        print('%14s %d processor(s): decode %.3fs' %
+              ('', processors, ScheduledTime(blockTimes, processors)))
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        Benchmark(sys.argv[1])
+    else:
+        allTests = TheTestSuite()
+        unittest.TextTestRunner().run(allTests)
@@ -0,0 +1,410 @@
+/** @file
+  A shell application that measures the receive latency and the idle CPU cost
+  of the MnpDxe system poll over EmuSnpDxe.
+
+  The round trip time is measured with ARP requests sent to a host on the
+  emulated network. The application doesn't call Poll(), so each reply is only
+  seen when the system poll of MnpDxe receives it, and the RTT includes the
+  delay of the poll. The idle CPU cost is measured while no traffic is sent, as
+  the time taken from a busy loop by the timer and the system poll.
+
+  Build the platform with PcdMnpAdaptiveReceive TRUE and FALSE to compare the
+  adaptive and the fixed interval poll.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NetLib.h>
+#include <Library/PcdLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/ManagedNetwork.h>
+#include <Protocol/ServiceBinding.h>
+#include <Protocol/ShellParameters.h>
+
+#define BENCHMARK_ARP_ETHER_TYPE  0x0806
+#define BENCHMARK_ARP_REQUEST     1
+#define BENCHMARK_ARP_REPLY       2
+#define BENCHMARK_RTT_COUNT       100
+#define BENCHMARK_RTT_TIMEOUT_US  1000000
+#define BENCHMARK_IDLE_TIME_US    2000000
+#define BENCHMARK_IDLE_GAP_NS     5000
+
+#pragma pack(1)
+typedef struct {
+  UINT16    HwType;
+  UINT16    ProtoType;
+  UINT8     HwAddrLen;
+  UINT8     ProtoAddrLen;
+  UINT16    OpCode;
+  UINT8     SenderHwAddr[NET_ETHER_ADDR_LEN];
+  UINT8     SenderIpAddr[4];
+  UINT8     TargetHwAddr[NET_ETHER_ADDR_LEN];
+  UINT8     TargetIpAddr[4];
+} BENCHMARK_ARP_PACKET;
+#pragma pack()
+
+/**
+  Get the time elapsed since a performance counter value. The emulator
+  performance counter counts up.
+
+  @param[in] StartTick      The performance counter value at the start.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+GetElapsedNanoSeconds (
+  IN UINT64  StartTick
+  )
+{
+  return GetTimeInNanoSecond (GetPerformanceCounter () - StartTick);
+}
+
+/**
+  Send one ARP request and wait for the reply of the target, without polling
+  the MNP child.
+
+  @param[in]  Mnp           The MNP child.
+  @param[in]  Request       The ARP request.
+  @param[out] Rtt           The round trip time in nanoseconds.
+
+  @retval EFI_SUCCESS       The reply was received.
+  @retval EFI_TIMEOUT       No reply was received in BENCHMARK_RTT_TIMEOUT_US.
+  @retval Others            The request could not be sent.
+
+**/
+EFI_STATUS
+MeasureArpRtt (
+  IN  EFI_MANAGED_NETWORK_PROTOCOL  *Mnp,
+  IN  BENCHMARK_ARP_PACKET          *Request,
+  OUT UINT64                        *Rtt
+  )
+{
+  EFI_STATUS                            Status;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  TxToken;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  RxToken;
+  EFI_MANAGED_NETWORK_TRANSMIT_DATA     TxData;
+  EFI_MANAGED_NETWORK_RECEIVE_DATA      *RxData;
+  EFI_MAC_ADDRESS                       Broadcast;
+  BENCHMARK_ARP_PACKET                  *Reply;
+  UINT64                                StartTick;
+  BOOLEAN                               Matched;
+
+  ZeroMem (&TxToken, sizeof (TxToken));
+  ZeroMem (&RxToken, sizeof (RxToken));
+  ZeroMem (&TxData, sizeof (TxData));
+  SetMem (&Broadcast, sizeof (Broadcast), 0xFF);
+
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &TxToken.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &RxToken.Event);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (TxToken.Event);
+    return Status;
+  }
+
+  TxData.DestinationAddress              = &Broadcast;
+  TxData.ProtocolType                    = BENCHMARK_ARP_ETHER_TYPE;
+  TxData.DataLength                      = sizeof (BENCHMARK_ARP_PACKET);
+  TxData.FragmentCount                   = 1;
+  TxData.FragmentTable[0].FragmentLength = sizeof (BENCHMARK_ARP_PACKET);
+  TxData.FragmentTable[0].FragmentBuffer = Request;
+  TxToken.Packet.TxData                  = &TxData;
+
+  Status = Mnp->Receive (Mnp, &RxToken);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  StartTick = GetPerformanceCounter ();
+  Status    = Mnp->Transmit (Mnp, &TxToken);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  Matched = FALSE;
+  while (!Matched) {
+    //
+    // Only the system poll of MnpDxe completes the receive token.
+    //
+    while (gBS->CheckEvent (RxToken.Event) == EFI_NOT_READY) {
+      if (GetElapsedNanoSeconds (StartTick) > BENCHMARK_RTT_TIMEOUT_US * 1000ULL) {
+        Status = EFI_TIMEOUT;
+        goto ON_EXIT;
+      }
+    }
+
+    *Rtt = GetElapsedNanoSeconds (StartTick);
+
+    if (EFI_ERROR (RxToken.Status)) {
+      Status = RxToken.Status;
+      goto ON_EXIT;
+    }
+
+    RxData = RxToken.Packet.RxData;
+    Reply  = (BENCHMARK_ARP_PACKET *)RxData->PacketData;
+    if ((RxData->DataLength >= sizeof (BENCHMARK_ARP_PACKET)) &&
+        (NTOHS (Reply->OpCode) == BENCHMARK_ARP_REPLY) &&
+        (CompareMem (Reply->SenderIpAddr, Request->TargetIpAddr, sizeof (Reply->SenderIpAddr)) == 0))
+    {
+      Matched = TRUE;
+    }
+
+    gBS->SignalEvent (RxData->RecycleEvent);
+
+    if (!Matched) {
+      RxToken.Status = EFI_NOT_READY;
+      Status         = Mnp->Receive (Mnp, &RxToken);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+    }
+  }
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  Mnp->Cancel (Mnp, NULL);
+  gBS->CloseEvent (TxToken.Event);
+  gBS->CloseEvent (RxToken.Event);
+  return Status;
+}
+
+/**
+  Measure the round trip time of ARP requests to a host and print the minimum,
+  average and maximum.
+
+  @param[in]  Mnp           The MNP child.
+  @param[in]  SourceIp      The sender IPv4 address of the requests.
+  @param[in]  TargetIp      The IPv4 address of the host to measure.
+
+  @retval EFI_SUCCESS       The RTT was measured.
+  @retval Others            No reply was received or a request failed.
+
+**/
+EFI_STATUS
+RunRttBenchmark (
+  IN EFI_MANAGED_NETWORK_PROTOCOL  *Mnp,
+  IN EFI_IPv4_ADDRESS              *SourceIp,
+  IN EFI_IPv4_ADDRESS              *TargetIp
+  )
+{
+  EFI_STATUS               Status;
+  EFI_SIMPLE_NETWORK_MODE  SnpMode;
+  BENCHMARK_ARP_PACKET     Request;
+  UINTN                    Index;
+  UINTN                    Replies;
+  UINT64                   Rtt;
+  UINT64                   MinRtt;
+  UINT64                   MaxRtt;
+  UINT64                   TotalRtt;
+
+  Status = Mnp->GetModeData (Mnp, NULL, &SnpMode);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (&Request, sizeof (Request));
+  Request.HwType       = HTONS (NET_IFTYPE_ETHERNET);
+  Request.ProtoType    = HTONS (0x0800);
+  Request.HwAddrLen    = NET_ETHER_ADDR_LEN;
+  Request.ProtoAddrLen = 4;
+  Request.OpCode       = HTONS (BENCHMARK_ARP_REQUEST);
+  CopyMem (Request.SenderHwAddr, &SnpMode.CurrentAddress, NET_ETHER_ADDR_LEN);
+  CopyMem (Request.SenderIpAddr, SourceIp, sizeof (Request.SenderIpAddr));
+  CopyMem (Request.TargetIpAddr, TargetIp, sizeof (Request.TargetIpAddr));
+
+  Replies  = 0;
+  MinRtt   = MAX_UINT64;
+  MaxRtt   = 0;
+  TotalRtt = 0;
+  for (Index = 0; Index < BENCHMARK_RTT_COUNT; Index++) {
+    Status = MeasureArpRtt (Mnp, &Request, &Rtt);
+    if (Status == EFI_TIMEOUT) {
+      continue;
+    }
+
+    if (EFI_ERROR (Status)) {
+      Print (L"ARP request failed - %r\n", Status);
+      return Status;
+    }
+
+    Replies++;
+    MinRtt    = MIN (MinRtt, Rtt);
+    MaxRtt    = MAX (MaxRtt, Rtt);
+    TotalRtt += Rtt;
+  }
+
+  if (Replies == 0) {
+    Print (L"No ARP reply received\n");
+    return EFI_TIMEOUT;
+  }
+
+  Print (
+    L"RTT: %Lu of %Lu replies, min %Lu us, avg %Lu us, max %Lu us\n",
+    (UINT64)Replies,
+    (UINT64)BENCHMARK_RTT_COUNT,
+    DivU64x32 (MinRtt, 1000),
+    DivU64x64Remainder (TotalRtt, MultU64x32 (Replies, 1000), NULL),
+    DivU64x32 (MaxRtt, 1000)
+    );
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Measure the CPU time taken from a busy loop by the timer interrupt and the
+  system poll of MnpDxe while the network is idle, and print the idle share.
+
+  The loop reads the performance counter back to back. Any gap longer than
+  BENCHMARK_IDLE_GAP_NS between two reads is counted as time taken away from
+  the loop.
+
+**/
+VOID
+RunIdleBenchmark (
+  VOID
+  )
+{
+  UINT64  StartTick;
+  UINT64  LastTick;
+  UINT64  Tick;
+  UINT64  Gap;
+  UINT64  Busy;
+  UINT64  Elapsed;
+  UINTN   Interrupts;
+
+  Busy       = 0;
+  Interrupts = 0;
+  StartTick  = GetPerformanceCounter ();
+  LastTick   = StartTick;
+  do {
+    Tick = GetPerformanceCounter ();
+    Gap  = GetTimeInNanoSecond (Tick - LastTick);
+    if (Gap > BENCHMARK_IDLE_GAP_NS) {
+      Busy += Gap;
+      Interrupts++;
+    }
+
+    LastTick = Tick;
+    Elapsed  = GetTimeInNanoSecond (Tick - StartTick);
+  } while (Elapsed < BENCHMARK_IDLE_TIME_US * 1000ULL);
+
+  Print (
+    L"Idle: %Lu interruptions, %Lu us busy in %Lu us, %Lu.%02Lu%% idle\n",
+    (UINT64)Interrupts,
+    DivU64x32 (Busy, 1000),
+    DivU64x32 (Elapsed, 1000),
+    DivU64x64Remainder (MultU64x32 (Elapsed - Busy, 100), Elapsed, NULL),
+    DivU64x64Remainder (MultU64x32 (Elapsed - Busy, 10000), Elapsed, NULL) % 100
+    );
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this
+  function.
+
+  Usage: MnpPollBenchmark <source IPv4 address> <target IPv4 address>
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_SHELL_PARAMETERS_PROTOCOL    *ShellParameters;
+  EFI_IPv4_ADDRESS                 SourceIp;
+  EFI_IPv4_ADDRESS                 TargetIp;
+  EFI_HANDLE                       *Handles;
+  UINTN                            HandleCount;
+  EFI_SERVICE_BINDING_PROTOCOL     *MnpSb;
+  EFI_HANDLE                       ChildHandle;
+  EFI_MANAGED_NETWORK_PROTOCOL     *Mnp;
+  EFI_MANAGED_NETWORK_CONFIG_DATA  MnpConfig;
+
+  Status = gBS->HandleProtocol (ImageHandle, &gEfiShellParametersProtocolGuid, (VOID **)&ShellParameters);
+  if (EFI_ERROR (Status) || (ShellParameters->Argc != 3) ||
+      EFI_ERROR (NetLibStrToIp4 (ShellParameters->Argv[1], &SourceIp)) ||
+      EFI_ERROR (NetLibStrToIp4 (ShellParameters->Argv[2], &TargetIp)))
+  {
+    Print (L"Usage: MnpPollBenchmark <source IPv4 address> <target IPv4 address>\n");
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Print (L"MnpDxe adaptive receive: %a\n", PcdGetBool (PcdMnpAdaptiveReceive) ? "on" : "off");
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiManagedNetworkServiceBindingProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &Handles
+                  );
+  if (EFI_ERROR (Status)) {
+    Print (L"No network interface - %r\n", Status);
+    return Status;
+  }
+
+  Status = gBS->HandleProtocol (Handles[0], &gEfiManagedNetworkServiceBindingProtocolGuid, (VOID **)&MnpSb);
+  FreePool (Handles);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ChildHandle = NULL;
+  Status      = MnpSb->CreateChild (MnpSb, &ChildHandle);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = gBS->HandleProtocol (ChildHandle, &gEfiManagedNetworkProtocolGuid, (VOID **)&Mnp);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  //
+  // A configured child starts the system poll of MnpDxe.
+  //
+  ZeroMem (&MnpConfig, sizeof (MnpConfig));
+  MnpConfig.ProtocolTypeFilter     = BENCHMARK_ARP_ETHER_TYPE;
+  MnpConfig.EnableUnicastReceive   = TRUE;
+  MnpConfig.EnableBroadcastReceive = TRUE;
+  MnpConfig.FlushQueuesOnReset     = TRUE;
+  Status                           = Mnp->Configure (Mnp, &MnpConfig);
+  if (EFI_ERROR (Status)) {
+    Print (L"MNP configuration failed - %r\n", Status);
+    goto ON_EXIT;
+  }
+
+  RunIdleBenchmark ();
+  Status = RunRttBenchmark (Mnp, &SourceIp, &TargetIp);
+
+  Mnp->Configure (Mnp, NULL);
+
+ON_EXIT:
+  MnpSb->DestroyChild (MnpSb, ChildHandle);
+  return Status;
+}
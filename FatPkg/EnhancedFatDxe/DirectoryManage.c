@@ -1181,8 +1181,7 @@ FatOpenDirEnt (
       }
     }
 
-    OFile->FileCurrentCluster = OFile->FileCluster;
-    OFile->Volume             = Volume;
+    OFile->Volume = Volume;
     InsertHeadList (&Volume->CheckRef, &OFile->CheckLink);
 
     OFile->FileSize = DirEnt->Entry.FileSize;
@@ -1234,6 +1233,10 @@ FatCloseDirEnt (
     RemoveEntryList (&OFile->ChildLink);
   }
 
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
   FreePool (OFile);
   DirEnt->OFile = NULL;
   if (DirEnt->Invalid == TRUE) {
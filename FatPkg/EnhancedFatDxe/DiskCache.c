@@ -352,6 +352,138 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Load a data cache page together with the pages that follow it on the disk,
+  using a single disk read.
+
+  The read-ahead stops short of the end of the data cache buffer, and of the
+  first following page that is either cached already or held dirty in its
+  cache slot, so the pages always land in one contiguous part of the cache.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - PageNo of the requested page. Its cache slot
+                                  must not be dirty.
+  @param  ReadAheadPages        - The maximum number of pages to read after PageNo.
+
+  @retval EFI_SUCCESS           - The pages were loaded successfully.
+  @return Others                - An error occurred when reading the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN UINTN       ReadAheadPages
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINTN       Index;
+  UINTN       PageSize;
+  UINTN       ReadSize;
+  UINT64      EntryPos;
+  UINT64      MaxSize;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
+  GroupNo       = PageNo & DiskCache->GroupMask;
+
+  if (ReadAheadPages > DiskCache->GroupMask - GroupNo) {
+    ReadAheadPages = DiskCache->GroupMask - GroupNo;
+  }
+
+  for (Index = 1; Index <= ReadAheadPages; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    if ((CacheTag->RealSize > 0) &&
+        ((CacheTag->PageNo == PageNo + Index) || CacheTag->Dirty))
+    {
+      break;
+    }
+  }
+
+  ReadAheadPages = Index - 1;
+
+  EntryPos = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  ReadSize = (ReadAheadPages + 1) << PageAlignment;
+  MaxSize  = DiskCache->LimitAddress - EntryPos;
+  if (MaxSize < ReadSize) {
+    ReadSize = (UINTN)MaxSize;
+  }
+
+  Status = FatDiskIo (
+             Volume,
+             ReadDisk,
+             EntryPos,
+             ReadSize,
+             DiskCache->CacheBase + (GroupNo << PageAlignment),
+             NULL
+             );
+
+  for (Index = 0; Index <= ReadAheadPages; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    ClearCacheTagDirtyState (CacheTag);
+    CacheTag->PageNo   = PageNo + Index;
+    CacheTag->RealSize = 0;
+    if (!EFI_ERROR (Status) && (ReadSize > (Index << PageAlignment))) {
+      CacheTag->RealSize = MIN (PageSize, ReadSize - (Index << PageAlignment));
+    }
+  }
+
+  if (!EFI_ERROR (Status) && (ReadSize > PageSize)) {
+    DiskCache->ReadAheadBytes += ReadSize - PageSize;
+  }
+
+  return Status;
+}
+
+/**
+
+  Prefetch the data cache page following a sequential read that ended on a
+  page boundary, together with the pages after it, using a single disk read.
+
+  Nothing is read if the page is cached already, or if its cache slot is
+  dirty: a speculative read does not force a write back.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - PageNo of the first page to prefetch.
+  @param  ReadAheadPages        - The number of pages to prefetch, PageNo included.
+
+  @retval EFI_SUCCESS           - The pages were prefetched, or need not be.
+  @return Others                - An error occurred when reading the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatPrefetchCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN UINTN       ReadAheadPages
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  CacheTag  = &DiskCache->CacheTag[PageNo & DiskCache->GroupMask];
+  if (((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo)) || CacheTag->Dirty) {
+    return EFI_SUCCESS;
+  }
+
+  Status = FatReadAheadCachePages (Volume, PageNo, ReadAheadPages - 1);
+  if (!EFI_ERROR (Status)) {
+    DiskCache->ReadAheadBytes += CacheTag->RealSize;
+  }
+
+  return Status;
+}
+
 /**
 
   Get one cache page by specified PageNo.
@@ -360,6 +492,8 @@ FatExchangeCachePage (
   @param  CacheDataType         - The cache type: CACHE_FAT or CACHE_DATA.
   @param  PageNo                - PageNo to match with the cache.
   @param  CacheTag              - The Cache Tag for the current cache page.
+  @param  ReadAheadPages        - On a miss, the number of data cache pages
+                                  following PageNo to load along with it.
 
   @retval EFI_SUCCESS           - Get the cache page successfully.
   @return other                 - An error occurred when accessing data.
@@ -371,20 +505,26 @@ FatGetCachePage (
   IN FAT_VOLUME       *Volume,
   IN CACHE_DATA_TYPE  CacheDataType,
   IN UINTN            PageNo,
-  IN CACHE_TAG        *CacheTag
+  IN CACHE_TAG        *CacheTag,
+  IN UINTN            ReadAheadPages
   )
 {
   EFI_STATUS  Status;
   UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
 
+  DiskCache = &Volume->DiskCache[CacheDataType];
   OldPageNo = CacheTag->PageNo;
   if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
     //
     // Cache Hit occurred
     //
+    DiskCache->Hits++;
     return EFI_SUCCESS;
   }
 
+  DiskCache->Misses++;
+
   //
   // Write dirty cache page back to disk
   //
@@ -396,8 +536,13 @@ FatGetCachePage (
   }
 
   //
-  // Load new data from disk;
+  // Load new data from disk; for a sequential reader, fetch the following
+  // pages of its disk run along with it.
   //
+  if ((CacheDataType == CacheData) && (ReadAheadPages > 0)) {
+    return FatReadAheadCachePages (Volume, PageNo, ReadAheadPages);
+  }
+
   CacheTag->PageNo = PageNo;
   Status           = FatExchangeCachePage (Volume, CacheDataType, ReadDisk, CacheTag, NULL);
 
@@ -416,6 +561,7 @@ FatGetCachePage (
   @param  Offset                - The starting byte of cache page.
   @param  Length                - The number of bytes that is read or written
   @param  Buffer                - Buffer containing cache data.
+  @param  ReadAheadPages        - The number of pages to read ahead on a cache miss.
 
   @retval EFI_SUCCESS           - The data was accessed correctly.
   @return Others                - An error occurred when accessing unaligned cache page.
@@ -430,7 +576,8 @@ FatAccessUnalignedCachePage (
   IN     UINTN            PageNo,
   IN     UINTN            Offset,
   IN     UINTN            Length,
-  IN OUT VOID             *Buffer
+  IN OUT VOID             *Buffer,
+  IN     UINTN            ReadAheadPages
   )
 {
   EFI_STATUS  Status;
@@ -443,7 +590,7 @@ FatAccessUnalignedCachePage (
   DiskCache = &Volume->DiskCache[CacheDataType];
   GroupNo   = PageNo & DiskCache->GroupMask;
   CacheTag  = &DiskCache->CacheTag[GroupNo];
-  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag);
+  Status    = FatGetCachePage (Volume, CacheDataType, PageNo, CacheTag, ReadAheadPages);
   if (!EFI_ERROR (Status)) {
     Source      = DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + Offset;
     Destination = Buffer;
@@ -512,6 +659,8 @@ FatAccessCache (
   DISK_CACHE  *DiskCache;
   UINT64      EntryPos;
   UINT8       PageAlignment;
+  UINTN       ReadAheadPages;
+  BOOLEAN     EndAligned;
 
   ASSERT (Volume->CacheBuffer != NULL);
 
@@ -523,13 +672,41 @@ FatAccessCache (
   PageNo        = (UINTN)RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN)EntryPos) & (PageSize - 1);
 
+  //
+  // Read-ahead applies to the data cache page holding the end of the read:
+  // prefetch the whole pages of Volume->ReadAheadSize that follow that page.
+  // A read ending on a page boundary prefetches from the next page on.
+  //
+  ReadAheadPages = 0;
+  EndAligned     = FALSE;
+  if ((CacheDataType == CacheData) && (IoMode == ReadDisk)) {
+    Length     = (UnderRun + BufferSize) & (PageSize - 1);
+    EndAligned = (BOOLEAN)(Length == 0);
+    if (Length > 0) {
+      Length = PageSize - Length;
+    }
+
+    if (Volume->ReadAheadSize > Length) {
+      ReadAheadPages = (Volume->ReadAheadSize - Length) >> PageAlignment;
+    }
+  }
+
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
     if (Length > BufferSize) {
       Length = BufferSize;
     }
 
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, PageNo, UnderRun, Length, Buffer);
+    Status = FatAccessUnalignedCachePage (
+               Volume,
+               CacheDataType,
+               IoMode,
+               PageNo,
+               UnderRun,
+               Length,
+               Buffer,
+               (Length == BufferSize) ? ReadAheadPages : 0
+               );
     if (EFI_ERROR (Status)) {
       return Status;
     }
@@ -574,7 +751,14 @@ FatAccessCache (
     //
     // Last read is not a complete page
     //
-    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer);
+    Status = FatAccessUnalignedCachePage (Volume, CacheDataType, IoMode, OverRunPageNo, 0, OverRun, Buffer, ReadAheadPages);
+  } else if (EndAligned && (ReadAheadPages > 0) && (Task == NULL)) {
+    //
+    // The read ended on a page boundary, so there is no partial page to read
+    // ahead from; a sequential reader asks for the next page next. Prefetch
+    // errors are not the caller's: the page is read again when it is needed.
+    //
+    FatPrefetchCachePages (Volume, OverRunPageNo, ReadAheadPages);
   }
 
   return Status;
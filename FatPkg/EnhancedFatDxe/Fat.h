@@ -84,6 +84,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// Upper bound of the read-ahead window of a sequentially read file, in data
+// cache pages. Read-ahead never wraps around the data cache, so this must stay
+// below FAT_DATACACHE_GROUP_COUNT.
+//
+#define FAT_READ_AHEAD_MAX_PAGES  16
+
 // For cache block bits, use a UINT64
 typedef UINT64 DIRTY_BLOCKS;
 #define BITS_PER_BYTE         8
@@ -171,6 +178,12 @@ typedef struct {
   UINT8        PageAlignment;
   UINTN        GroupMask;
   CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  //
+  // Statistics for tuning the cache geometry and the read-ahead window
+  //
+  UINT64       Hits;
+  UINT64       Misses;
+  UINT64       ReadAheadBytes;
 } DISK_CACHE;
 
 //
@@ -214,6 +227,17 @@ struct _FAT_ODIR {
   FAT_DIRENT    *ShortNameHashTable[HASH_TABLE_SIZE];
 };
 
+//
+// A run of clusters that are consecutive both in the file and on the disk
+//
+typedef struct {
+  UINTN    FileCluster;               // Index of the run's first cluster within the file
+  UINTN    Cluster;                   // The run's first cluster on the disk
+  UINTN    Count;                     // Number of clusters in the run
+} FAT_EXTENT;
+
+#define FAT_EXTENT_MAP_INITIAL_COUNT  8
+
 typedef struct {
   UINTN                Signature;
   EFI_FILE_PROTOCOL    Handle;
@@ -264,9 +288,18 @@ struct _FAT_OFILE {
   //
   UINTN         FileSize;
   UINTN         FileCluster;
-  UINTN         FileCurrentCluster;
   UINTN         FileLastCluster;
 
+  //
+  // Extent map of the leading MappedClusters clusters of the cluster chain.
+  // Built lazily by FatOFilePosition(), and discarded by FatResetExtentMap()
+  // whenever the chain is cut or replaced.
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         MaxExtents;
+  UINTN         MappedClusters;
+
   //
   // Dirty is set if there have been any updates to the
   // file
@@ -282,10 +315,14 @@ struct _FAT_OFILE {
   //
   // Set by an OFile SetPosition
   //
-  UINTN         Position;       // within file
   UINT64        PosDisk;        // on the disk
   UINTN         PosRem;         // remaining in this disk run
   //
+  // Sequential read detection, for the data cache read-ahead
+  //
+  UINTN         ReadAheadNextPos; // position following the last read
+  UINTN         ReadAheadPages;   // current read-ahead window in cache pages
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE     *Parent;
@@ -389,6 +426,11 @@ struct _FAT_VOLUME {
   //
   VOID                               *CacheBuffer;
   DISK_CACHE                         DiskCache[CacheMaxType];
+  //
+  // Bytes of the current file's disk run that the data cache may prefetch
+  // beyond the end of the current read; set by FatAccessOFile()
+  //
+  UINTN                              ReadAheadSize;
 };
 
 //
@@ -943,6 +985,19 @@ FatPhysicalFileSize (
   IN UINTN       RealSize
   );
 
+/**
+
+  Discard the extent map of the open file, after its cluster chain has been
+  cut or replaced.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatResetExtentMap (
+  IN FAT_OFILE  *OFile
+  );
+
 /**
 
   Seek OFile to requested position, and calculate the number of
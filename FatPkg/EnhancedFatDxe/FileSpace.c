@@ -400,12 +400,11 @@ FatShrinkEof (
   }
 
   //
-  // Set CurrentCluster == FileCluster
-  // to force a recalculation of Position related stuffs
+  // The cluster chain has been cut, drop its extent map
   //
-  OFile->FileCurrentCluster = OFile->FileCluster;
-  OFile->FileLastCluster    = LastCluster;
-  OFile->Dirty              = TRUE;
+  FatResetExtentMap (OFile);
+  OFile->FileLastCluster = LastCluster;
+  OFile->Dirty           = TRUE;
   //
   // Free the remaining cluster chain
   //
@@ -513,8 +512,8 @@ FatGrowEof (
       if (LastCluster != 0) {
         FatSetFatEntry (Volume, LastCluster, NewCluster);
       } else {
-        OFile->FileCluster        = NewCluster;
-        OFile->FileCurrentCluster = NewCluster;
+        OFile->FileCluster = NewCluster;
+        FatResetExtentMap (OFile);
       }
 
       LastCluster = NewCluster;
@@ -545,6 +544,91 @@ Done:
   return Status;
 }
 
+/**
+
+  Discard the extent map of the open file, after its cluster chain has been
+  cut or replaced.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatResetExtentMap (
+  IN FAT_OFILE  *OFile
+  )
+{
+  OFile->ExtentCount    = 0;
+  OFile->MappedClusters = 0;
+}
+
+/**
+
+  Extend the extent map of the open file by the next cluster of its cluster
+  chain.
+
+  @param  OFile                 - The open file.
+
+  @retval EFI_SUCCESS           - The next cluster has been mapped.
+  @retval EFI_VOLUME_CORRUPTED  - The cluster chain ends, or is corrupt.
+  @retval EFI_OUT_OF_RESOURCES  - Can not grow the extent map.
+
+**/
+STATIC
+EFI_STATUS
+FatExtendExtentMap (
+  IN FAT_OFILE  *OFile
+  )
+{
+  FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *NewExtents;
+  UINTN       LastCluster;
+  UINTN       Cluster;
+  UINTN       NewMax;
+
+  Volume = OFile->Volume;
+  Extent = NULL;
+  if (OFile->ExtentCount == 0) {
+    Cluster = OFile->FileCluster;
+  } else {
+    Extent      = &OFile->Extents[OFile->ExtentCount - 1];
+    LastCluster = Extent->Cluster + Extent->Count - 1;
+    Cluster     = FatGetFatEntry (Volume, LastCluster);
+  }
+
+  if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  if ((Extent != NULL) && (Cluster == Extent->Cluster + Extent->Count)) {
+    Extent->Count++;
+    OFile->MappedClusters++;
+    return EFI_SUCCESS;
+  }
+
+  if (OFile->ExtentCount == OFile->MaxExtents) {
+    NewMax     = (OFile->MaxExtents == 0) ? FAT_EXTENT_MAP_INITIAL_COUNT : OFile->MaxExtents * 2;
+    NewExtents = ReallocatePool (
+                   OFile->MaxExtents * sizeof (FAT_EXTENT),
+                   NewMax * sizeof (FAT_EXTENT),
+                   OFile->Extents
+                   );
+    if (NewExtents == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    OFile->Extents    = NewExtents;
+    OFile->MaxExtents = NewMax;
+  }
+
+  Extent              = &OFile->Extents[OFile->ExtentCount++];
+  Extent->FileCluster = OFile->MappedClusters;
+  Extent->Cluster     = Cluster;
+  Extent->Count       = 1;
+  OFile->MappedClusters++;
+  return EFI_SUCCESS;
+}
+
 /**
 
   Seek OFile to requested position, and calculate the number of
@@ -555,7 +639,7 @@ Done:
   @param  PosLimit              - The maximum length current reading/writing may access
 
   @retval EFI_SUCCESS           - Set the info successfully.
-  @retval EFI_VOLUME_CORRUPTED  - Cluster chain corrupt.
+  @retval EFI_VOLUME_CORRUPTED  - Cluster chain corrupt, or the file is empty.
 
 **/
 EFI_STATUS
@@ -566,13 +650,16 @@ FatOFilePosition (
   )
 {
   FAT_VOLUME  *Volume;
-  UINTN       ClusterSize;
-  UINTN       Cluster;
-  UINTN       StartPos;
+  FAT_EXTENT  *Extent;
+  EFI_STATUS  Status;
+  UINTN       ClusterIndex;
+  UINTN       ClusterOffset;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
   UINTN       Run;
 
-  Volume      = OFile->Volume;
-  ClusterSize = Volume->ClusterSize;
+  Volume = OFile->Volume;
 
   ASSERT_VOLUME_LOCKED (Volume);
 
@@ -585,53 +672,67 @@ FatOFilePosition (
     Run            = OFile->FileSize - Position;
   } else {
     //
-    // Run the file's cluster chain to find the current position
-    // If possible, run from the current cluster rather than
-    // start from beginning
-    // Assumption: OFile->Position is always consistent with
-    // OFile->FileCurrentCluster.
-    // OFile->Position is not modified outside this function;
-    // OFile->FileCurrentCluster is modified outside this function
-    // to be the same as OFile->FileCluster
-    // when OFile->FileCluster is updated, so make a check of this
-    // and invalidate the original OFile->Position in this case
+    // An empty file has no cluster chain to walk, and no position to seek to.
     //
-    Cluster  = OFile->FileCurrentCluster;
-    StartPos = OFile->Position;
-    if ((Position < StartPos) || (OFile->FileCluster == Cluster)) {
-      StartPos = 0;
-      Cluster  = OFile->FileCluster;
+    if ((OFile->FileSize == 0) || (OFile->FileCluster == FAT_CLUSTER_FREE)) {
+      return EFI_VOLUME_CORRUPTED;
     }
 
-    while (StartPos + ClusterSize <= Position) {
-      StartPos += ClusterSize;
-      if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
-        DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
-        return EFI_VOLUME_CORRUPTED;
-      }
+    //
+    // Map the cluster chain up to the requested position. The chain is
+    // walked only once per file; later seeks search the extent map.
+    //
+    ClusterIndex  = Position >> Volume->ClusterAlignment;
+    ClusterOffset = Position & (Volume->ClusterSize - 1);
+    while (OFile->MappedClusters <= ClusterIndex) {
+      Status = FatExtendExtentMap (OFile);
+      if (EFI_ERROR (Status)) {
+        if (Status == EFI_VOLUME_CORRUPTED) {
+          DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
+        }
 
-      Cluster = FatGetFatEntry (Volume, Cluster);
+        return Status;
+      }
     }
 
-    if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
-      return EFI_VOLUME_CORRUPTED;
+    //
+    // Find the extent holding the position
+    //
+    Low  = 0;
+    High = OFile->ExtentCount - 1;
+    while (Low < High) {
+      Middle = (Low + High + 1) / 2;
+      if (OFile->Extents[Middle].FileCluster <= ClusterIndex) {
+        Low = Middle;
+      } else {
+        High = Middle - 1;
+      }
     }
 
+    Extent         = &OFile->Extents[Low];
     OFile->PosDisk = Volume->FirstClusterPos +
-                     LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
-                     Position - StartPos;
-    OFile->FileCurrentCluster = Cluster;
-    OFile->Position           = StartPos;
+                     LShiftU64 (
+                       Extent->Cluster + (ClusterIndex - Extent->FileCluster) - FAT_MIN_CLUSTER,
+                       Volume->ClusterAlignment
+                       ) +
+                     ClusterOffset;
 
     //
-    // Compute the number of consecutive clusters in the file
+    // Compute the number of consecutive clusters in the file. The last
+    // extent may continue beyond the mapped part of the chain.
     //
-    Run = StartPos + ClusterSize - Position;
-    if (!FAT_END_OF_FAT_CHAIN (Cluster)) {
-      while ((FatGetFatEntry (Volume, Cluster) == Cluster + 1) && Run < PosLimit) {
-        Run     += ClusterSize;
-        Cluster += 1;
+    Run = (Extent->FileCluster + Extent->Count - ClusterIndex) * Volume->ClusterSize - ClusterOffset;
+    while ((Run < PosLimit) && (Low == OFile->ExtentCount - 1)) {
+      if (EFI_ERROR (FatExtendExtentMap (OFile))) {
+        break;
       }
+
+      //
+      // The map may have been reallocated, and the new cluster may have
+      // started a new extent.
+      //
+      Extent = &OFile->Extents[Low];
+      Run    = (Extent->FileCluster + Extent->Count - ClusterIndex) * Volume->ClusterSize - ClusterOffset;
     }
   }
 
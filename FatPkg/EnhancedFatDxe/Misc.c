@@ -465,6 +465,13 @@ FatFreeVolume (
   // Free disk cache
   //
   if (Volume->CacheBuffer != NULL) {
+    DEBUG ((
+      DEBUG_INFO,
+      "FatFreeVolume: data cache hits %Ld misses %Ld read-ahead %Ld bytes\n",
+      Volume->DiskCache[CacheData].Hits,
+      Volume->DiskCache[CacheData].Misses,
+      Volume->DiskCache[CacheData].ReadAheadBytes
+      ));
     FreePool (Volume->CacheBuffer);
   }
 
@@ -470,17 +470,36 @@ FatAccessOFile (
   UINTN       Len;
   EFI_STATUS  Status;
   UINTN       BufferSize;
+  UINTN       ReadAhead;
 
   BufferSize = *DataBufferSize;
   Volume     = OFile->Volume;
   ASSERT_VOLUME_LOCKED (Volume);
 
+  //
+  // A read that continues where the previous one stopped widens the read-ahead
+  // window of the file; any other read closes it.
+  //
+  ReadAhead = 0;
+  if (IoMode == ReadData) {
+    if (Position == OFile->ReadAheadNextPos) {
+      OFile->ReadAheadPages = (OFile->ReadAheadPages == 0) ? 1 :
+                              MIN (OFile->ReadAheadPages * 2, FAT_READ_AHEAD_MAX_PAGES);
+    } else {
+      OFile->ReadAheadPages = 0;
+    }
+
+    ReadAhead = OFile->ReadAheadPages << Volume->DiskCache[CacheData].PageAlignment;
+  }
+
   Status = EFI_SUCCESS;
   while (BufferSize > 0) {
     //
-    // Seek the OFile to the file position
+    // Seek the OFile to the file position; when reading ahead, also measure
+    // the contiguous clusters beyond the request, so that the data cache can
+    // prefetch them in the same disk read.
     //
-    Status = FatOFilePosition (OFile, Position, BufferSize);
+    Status = FatOFilePosition (OFile, Position, BufferSize + ReadAhead);
     if (EFI_ERROR (Status)) {
       break;
     }
@@ -493,7 +512,9 @@ FatAccessOFile (
     //
     // Write the data
     //
-    Status = FatDiskIo (Volume, IoMode, OFile->PosDisk, Len, UserBuffer, Task);
+    Volume->ReadAheadSize = MIN (OFile->PosRem - Len, ReadAhead);
+    Status                = FatDiskIo (Volume, IoMode, OFile->PosDisk, Len, UserBuffer, Task);
+    Volume->ReadAheadSize = 0;
     if (EFI_ERROR (Status)) {
       break;
     }
@@ -515,6 +536,10 @@ FatAccessOFile (
     ASSERT (Position <= OFile->FileSize);
   }
 
+  if (IoMode == ReadData) {
+    OFile->ReadAheadNextPos = Position;
+  }
+
   //
   // Update the number of bytes accessed
   //
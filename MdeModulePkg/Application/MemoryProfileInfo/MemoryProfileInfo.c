@@ -638,6 +638,53 @@ DumpMemoryProfileMemoryRange (
   return (VOID *)Descriptor;
 }
 
+/**
+  Dump memory profile pool slab statistics.
+
+  @param[in] PoolStats          Pointer to memory profile pool statistics.
+
+  @return Pointer to the end of memory profile pool statistics buffer.
+
+**/
+VOID *
+DumpMemoryProfilePoolStats (
+  IN MEMORY_PROFILE_POOL_STATS  *PoolStats
+  )
+{
+  MEMORY_PROFILE_POOL_CLASS  *PoolClass;
+  UINTN                      PoolClassIndex;
+
+  if (PoolStats->Header.Signature != MEMORY_PROFILE_POOL_STATS_SIGNATURE) {
+    return NULL;
+  }
+
+  Print (L"MEMORY_PROFILE_POOL_STATS\n");
+  Print (L"  Signature                     - 0x%08x\n", PoolStats->Header.Signature);
+  Print (L"  Length                        - 0x%04x\n", PoolStats->Header.Length);
+  Print (L"  Revision                      - 0x%04x\n", PoolStats->Header.Revision);
+  Print (L"  PoolClassCount                - 0x%08x\n", PoolStats->PoolClassCount);
+
+  PoolClass = (MEMORY_PROFILE_POOL_CLASS *)((UINTN)PoolStats + PoolStats->Header.Length);
+  for (PoolClassIndex = 0; PoolClassIndex < PoolStats->PoolClassCount; PoolClassIndex++) {
+    if (PoolClass->Header.Signature != MEMORY_PROFILE_POOL_CLASS_SIGNATURE) {
+      return NULL;
+    }
+
+    Print (L"  MEMORY_PROFILE_POOL_CLASS (0x%x)\n", PoolClassIndex);
+    Print (L"    MemoryType              - 0x%08x (%a)\n", PoolClass->MemoryType, ProfileMemoryTypeToStr (PoolClass->MemoryType));
+    Print (L"    ObjectSize              - 0x%08x\n", PoolClass->ObjectSize);
+    Print (L"    SlabCount               - 0x%016lx\n", PoolClass->SlabCount);
+    Print (L"    SlabPages               - 0x%016lx\n", PoolClass->SlabPages);
+    Print (L"    TotalObjects            - 0x%016lx\n", PoolClass->TotalObjects);
+    Print (L"    UsedObjects             - 0x%016lx\n", PoolClass->UsedObjects);
+    Print (L"    ReleasedSlabCount       - 0x%016lx\n", PoolClass->ReleasedSlabCount);
+
+    PoolClass = (MEMORY_PROFILE_POOL_CLASS *)((UINTN)PoolClass + PoolClass->Header.Length);
+  }
+
+  return (VOID *)PoolClass;
+}
+
 /**
   Scan memory profile by Signature.
 
@@ -698,6 +745,7 @@ DumpMemoryProfile (
   MEMORY_PROFILE_CONTEXT       *Context;
   MEMORY_PROFILE_FREE_MEMORY   *FreeMemory;
   MEMORY_PROFILE_MEMORY_RANGE  *MemoryRange;
+  MEMORY_PROFILE_POOL_STATS    *PoolStats;
 
   Context = (MEMORY_PROFILE_CONTEXT *)ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_CONTEXT_SIGNATURE);
   if (Context != NULL) {
@@ -713,6 +761,13 @@ DumpMemoryProfile (
   if (MemoryRange != NULL) {
     DumpMemoryProfileMemoryRange (MemoryRange);
   }
+
+  if ((Context != NULL) && (Context->Header.Revision >= MEMORY_PROFILE_CONTEXT_POOL_STATS_REVISION)) {
+    PoolStats = (MEMORY_PROFILE_POOL_STATS *)ScanMemoryProfileBySignature (ProfileBuffer, ProfileSize, MEMORY_PROFILE_POOL_STATS_SIGNATURE);
+    if (PoolStats != NULL) {
+      DumpMemoryProfilePoolStats (PoolStats);
+    }
+  }
 }
 
 /**
@@ -0,0 +1,258 @@
+/** @file
+  A shell application that compares setting non-volatile variables one by one
+  through the SetVariable() runtime service with setting them in batches through
+  EDKII_VARIABLE_BATCH_PROTOCOL.
+
+  For the SMM variable driver each SetVariable() call costs one SMI, while a
+  batch costs one SMI per full communicate buffer. The application prints the
+  number of SetVariable() calls and the number of requests the batch protocol
+  sent to the variable driver. The time taken by both paths is recorded as
+  "VarOneByOne" and "VarBatch" performance records, one pair per variable
+  count, and can be read from the FPDT with the shell "dp" command. The
+  variables it creates are deleted again, but the run still writes to the
+  variable flash.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiApplicationEntryPoint.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PerformanceLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include <Protocol/VariableBatch.h>
+
+#define BENCHMARK_VARIABLE_NAME_LENGTH  16
+#define BENCHMARK_VARIABLE_DATA_SIZE    64
+#define BENCHMARK_VARIABLE_ATTRIBUTES   (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+EFI_GUID  mBenchmarkVendorGuid = {
+  0x5c2b4871, 0x2fe7, 0x43e9, { 0x83, 0x45, 0x40, 0x34, 0x3c, 0xc5, 0xef, 0x72 }
+};
+
+UINTN  mBenchmarkVariableCount[] = { 8, 32, 128 };
+
+/**
+  Set all the benchmark variables one by one through the runtime service.
+
+  @param[in] Entries        The benchmark variables.
+  @param[in] Count          The number of benchmark variables.
+  @param[in] Delete         TRUE to delete the variables instead.
+
+  @retval EFI_SUCCESS       All the variables were set.
+  @retval Others            The status of the first variable that failed.
+
+**/
+EFI_STATUS
+SetVariablesOneByOne (
+  IN EDKII_VARIABLE_BATCH_ENTRY  *Entries,
+  IN UINTN                       Count,
+  IN BOOLEAN                     Delete
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = gRT->SetVariable (
+                    Entries[Index].VariableName,
+                    Entries[Index].VendorGuid,
+                    Entries[Index].Attributes,
+                    Delete ? 0 : Entries[Index].DataSize,
+                    Delete ? NULL : Entries[Index].Data
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Set all the benchmark variables through the batch protocol.
+
+  @param[in]  VariableBatch The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]  Entries       The benchmark variables.
+  @param[in]  Count         The number of benchmark variables.
+  @param[in]  Delete        TRUE to delete the variables instead.
+  @param[out] CommitCount   The number of requests sent to the variable driver.
+
+  @retval EFI_SUCCESS       All the variables were set.
+  @retval Others            The status of the first variable that failed.
+
+**/
+EFI_STATUS
+SetVariablesInBatch (
+  IN  EDKII_VARIABLE_BATCH_PROTOCOL  *VariableBatch,
+  IN  EDKII_VARIABLE_BATCH_ENTRY     *Entries,
+  IN  UINTN                          Count,
+  IN  BOOLEAN                        Delete,
+  OUT UINTN                          *CommitCount
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_VARIABLE_BATCH_ENTRY  *DeleteEntries;
+  UINTN                       Index;
+
+  if (!Delete) {
+    return VariableBatch->SetVariables (VariableBatch, Count, Entries, CommitCount);
+  }
+
+  DeleteEntries = AllocateCopyPool (Count * sizeof (EDKII_VARIABLE_BATCH_ENTRY), Entries);
+  if (DeleteEntries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    DeleteEntries[Index].DataSize = 0;
+    DeleteEntries[Index].Data     = NULL;
+  }
+
+  Status = VariableBatch->SetVariables (VariableBatch, Count, DeleteEntries, CommitCount);
+  FreePool (DeleteEntries);
+  return Status;
+}
+
+/**
+  Run the benchmark for a number of variables and print the result.
+
+  @param[in] VariableBatch  The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in] Count          The number of variables to set.
+
+  @retval EFI_SUCCESS       The benchmark completed.
+  @retval Others            Setting the variables failed.
+
+**/
+EFI_STATUS
+RunBenchmark (
+  IN EDKII_VARIABLE_BATCH_PROTOCOL  *VariableBatch,
+  IN UINTN                          Count
+  )
+{
+  EFI_STATUS                  Status;
+  EDKII_VARIABLE_BATCH_ENTRY  *Entries;
+  CHAR16                      *Names;
+  UINT8                       *Data;
+  UINTN                       Index;
+  UINTN                       CommitCount;
+
+  Entries = AllocateZeroPool (Count * sizeof (EDKII_VARIABLE_BATCH_ENTRY));
+  Names   = AllocateZeroPool (Count * BENCHMARK_VARIABLE_NAME_LENGTH * sizeof (CHAR16));
+  Data    = AllocatePool (Count * BENCHMARK_VARIABLE_DATA_SIZE);
+  if ((Entries == NULL) || (Names == NULL) || (Data == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    UnicodeSPrint (
+      &Names[Index * BENCHMARK_VARIABLE_NAME_LENGTH],
+      BENCHMARK_VARIABLE_NAME_LENGTH * sizeof (CHAR16),
+      L"BatchBench%04Lu",
+      (UINT64)Index
+      );
+    SetMem (&Data[Index * BENCHMARK_VARIABLE_DATA_SIZE], BENCHMARK_VARIABLE_DATA_SIZE, (UINT8)Index);
+    Entries[Index].VariableName = &Names[Index * BENCHMARK_VARIABLE_NAME_LENGTH];
+    Entries[Index].VendorGuid   = &mBenchmarkVendorGuid;
+    Entries[Index].Attributes   = BENCHMARK_VARIABLE_ATTRIBUTES;
+    Entries[Index].DataSize     = BENCHMARK_VARIABLE_DATA_SIZE;
+    Entries[Index].Data         = &Data[Index * BENCHMARK_VARIABLE_DATA_SIZE];
+  }
+
+  PERF_INMODULE_BEGIN ("VarOneByOne");
+  Status = SetVariablesOneByOne (Entries, Count, FALSE);
+  PERF_INMODULE_END ("VarOneByOne");
+  if (EFI_ERROR (Status)) {
+    Print (L"SetVariable() failed - %r\n", Status);
+    goto Done;
+  }
+
+  Status = SetVariablesOneByOne (Entries, Count, TRUE);
+  if (EFI_ERROR (Status)) {
+    Print (L"SetVariable() failed to delete - %r\n", Status);
+    goto Done;
+  }
+
+  PERF_INMODULE_BEGIN ("VarBatch");
+  Status = SetVariablesInBatch (VariableBatch, Entries, Count, FALSE, &CommitCount);
+  PERF_INMODULE_END ("VarBatch");
+  if (EFI_ERROR (Status)) {
+    Print (L"SetVariables() failed - %r\n", Status);
+    goto Done;
+  }
+
+  Print (
+    L"%4Lu variables: %4Lu SetVariable() calls, %4Lu batch requests\n",
+    (UINT64)Count,
+    (UINT64)Count,
+    (UINT64)CommitCount
+    );
+
+  Status = SetVariablesInBatch (VariableBatch, Entries, Count, TRUE, &CommitCount);
+  if (EFI_ERROR (Status)) {
+    Print (L"SetVariables() failed to delete - %r\n", Status);
+  }
+
+Done:
+  if (Entries != NULL) {
+    FreePool (Entries);
+  }
+
+  if (Names != NULL) {
+    FreePool (Names);
+  }
+
+  if (Data != NULL) {
+    FreePool (Data);
+  }
+
+  return Status;
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this
+  function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UefiMain (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                     Status;
+  EDKII_VARIABLE_BATCH_PROTOCOL  *VariableBatch;
+  UINTN                          Index;
+
+  Status = gBS->LocateProtocol (&gEdkiiVariableBatchProtocolGuid, NULL, (VOID **)&VariableBatch);
+  if (EFI_ERROR (Status)) {
+    Print (L"Variable batch protocol not found - %r\n", Status);
+    return Status;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mBenchmarkVariableCount); Index++) {
+    Status = RunBenchmark (VariableBatch, mBenchmarkVariableCount[Index]);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
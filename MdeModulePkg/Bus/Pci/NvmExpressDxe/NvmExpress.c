@@ -699,16 +699,14 @@ ProcessAsyncTaskList (
           PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
         }
 
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
-
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
+        if ((AsyncRequest->MapPrpList != NULL) || (AsyncRequest->PrpListHost != NULL)) {
+          NvmeReleasePrpList (
+            Private,
+            AsyncRequest->PrpList,
+            AsyncRequest->PrpListHost,
+            AsyncRequest->PrpListNo,
+            AsyncRequest->MapPrpList
+            );
         }
 
         RemoveEntryList (Link);
@@ -1166,6 +1164,10 @@ NvmExpressDriverBindingStart (
   return EFI_SUCCESS;
 
 Exit:
+  if (Private != NULL) {
+    NvmeFreePrpListCache (Private);
+  }
+
   if ((Private != NULL) && (Private->Mapping != NULL)) {
     PciIo->Unmap (PciIo, Private->Mapping);
   }
@@ -1288,6 +1290,8 @@ NvmExpressDriverBindingStop (
         gBS->CloseEvent (Private->TimerEvent);
       }
 
+      NvmeFreePrpListCache (Private);
+
       if (Private->Mapping != NULL) {
         Private->PciIo->Unmap (Private->PciIo, Private->Mapping);
       }
@@ -42,6 +42,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 #include <Guid/NVMeEventGroup.h>
 
@@ -80,6 +81,12 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 #define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
 
+//
+// Number of single-page PRP lists kept mapped per controller for reuse by
+// subsequent I/O commands.
+//
+#define NVME_PRP_LIST_CACHE_SIZE  16
+
 //
 // FormatNVM Admin Command LBA Format (LBAF) Mask
 //
@@ -121,6 +128,15 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 //
 #define NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('N','V','M','E')
 
+//
+// A PRP list page that has been allocated and mapped for bus master access.
+//
+typedef struct {
+  VOID                    *Host;
+  EFI_PHYSICAL_ADDRESS    PciAddr;
+  VOID                    *Mapping;
+} NVME_PRP_LIST_BUFFER;
+
 //
 // Nvme private data structure.
 //
@@ -171,6 +187,11 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
   UINT16         AsyncSqHead;
 
+  //
+  // Number of asynchronous I/O submission queue entries, which is 0-based.
+  //
+  UINT16         AsyncSqSize;
+
   //
   // Flag to indicate internal IO queue creation.
   //
@@ -192,6 +213,12 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   EFI_EVENT      TimerEvent;
   LIST_ENTRY     AsyncPassThruQueue;
   LIST_ENTRY     UnsubmittedSubtasks;
+
+  //
+  // Released single-page PRP lists, still mapped.
+  //
+  NVME_PRP_LIST_BUFFER    PrpListCache[NVME_PRP_LIST_CACHE_SIZE];
+  UINTN                   PrpListCacheCount;
 };
 
 #define NVME_CONTROLLER_PRIVATE_DATA_FROM_PASS_THRU(a) \
@@ -331,6 +358,7 @@ typedef struct {
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
   UINT16                                      CommandId;
   VOID                                        *MapPrpList;
+  VOID                                        *PrpList;
   UINTN                                       PrpListNo;
   VOID                                        *PrpListHost;
   VOID                                        *MapData;
@@ -759,6 +787,69 @@ NvmeDumpStatus (
   IN NVME_CQ  *Cq
   );
 
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  A single-page PRP list is kept mapped in the controller PRP list cache when
+  there is room for it, otherwise it is unmapped and freed.
+
+  @param[in] Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpList       The first PRP list, as returned by NvmeCreatePrpList().
+  @param[in] PrpListHost   The host base address of the PRP lists.
+  @param[in] PrpListNo     The number of PRP lists.
+  @param[in] Mapping       The mapping value returned from PciIo.Map().
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpList,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  );
+
+/**
+  Unmap and free all the PRP lists held in the controller PRP list cache.
+
+  @param[in] Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeFreePrpListCache (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
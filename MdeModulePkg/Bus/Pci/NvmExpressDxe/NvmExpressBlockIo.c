@@ -956,6 +956,174 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Read or write some blocks of the device in a blocking manner, keeping
+  multiple commands outstanding on the asynchronous I/O queue.
+
+  Transfers that fit in one command, or controllers whose asynchronous I/O
+  queue can only hold one command, are handled by NvmeRead() and NvmeWrite().
+
+  @param  Device        The pointer to the NVME_DEVICE_PRIVATE_DATA data
+                        structure.
+  @param  Buffer        The buffer used to store the data read from the device,
+                        or to be written into the device.
+  @param  Lba           The start block number.
+  @param  Blocks        Total block number to be transferred.
+  @param  IsRead        TRUE to read from the device, FALSE to write to it.
+
+  @retval EFI_SUCCESS   Data are transferred.
+  @retval EFI_TIMEOUT   The commands did not complete in time, the controller
+                        has been reset.
+  @retval Others        Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeQueuedReadWrite (
+  IN     NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN OUT VOID                      *Buffer,
+  IN     UINT64                    Lba,
+  IN     UINTN                     Blocks,
+  IN     BOOLEAN                   IsRead
+  )
+{
+  EFI_STATUS                    Status;
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  UINT32                        MaxTransferBlocks;
+  UINTN                         Commands;
+  EFI_BLOCK_IO2_TOKEN           *Token;
+  EFI_EVENT                     TimerEvent;
+  BOOLEAN                       IsEmpty;
+  EFI_TPL                       OldTpl;
+
+  Private = Device->Controller;
+
+  if (Private->ControllerData->Mdts != 0) {
+    MaxTransferBlocks = (1 << (Private->ControllerData->Mdts)) * (1 << (Private->Cap.Mpsmin + 12)) / Device->Media.BlockSize;
+  } else {
+    MaxTransferBlocks = 1024;
+  }
+
+  if ((Blocks <= MaxTransferBlocks) || (Private->AsyncSqSize < 2)) {
+    if (IsRead) {
+      return NvmeRead (Device, Buffer, Lba, Blocks);
+    }
+
+    return NvmeWrite (Device, Buffer, Lba, Blocks);
+  }
+
+  //
+  // Wait for the device's asynchronous I/O queue to become empty.
+  //
+  while (TRUE) {
+    OldTpl  = gBS->RaiseTPL (TPL_NOTIFY);
+    IsEmpty = IsListEmpty (&Device->AsyncQueue);
+    gBS->RestoreTPL (OldTpl);
+
+    if (IsEmpty) {
+      break;
+    }
+
+    gBS->Stall (100);
+  }
+
+  TimerEvent = NULL;
+  Token      = AllocateZeroPool (sizeof (EFI_BLOCK_IO2_TOKEN));
+  if (Token == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &Token->Event);
+  if (EFI_ERROR (Status)) {
+    FreePool (Token);
+    return Status;
+  }
+
+  Commands = (Blocks + MaxTransferBlocks - 1) / MaxTransferBlocks;
+  Status   = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (TimerEvent, TimerRelative, MultU64x32 (NVME_GENERIC_TIMEOUT, (UINT32)Commands));
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    if (IsRead) {
+      Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, Token);
+    } else {
+      Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, Token);
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (TimerEvent != NULL) {
+      gBS->CloseEvent (TimerEvent);
+    }
+
+    gBS->CloseEvent (Token->Event);
+    FreePool (Token);
+    return Status;
+  }
+
+  //
+  // Reap the completions directly rather than waiting for the periodic
+  // timer, so that the queue is refilled as soon as commands finish.
+  //
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+
+    if (!EFI_ERROR (gBS->CheckEvent (Token->Event))) {
+      Status = Token->TransactionStatus;
+      break;
+    }
+
+    if (!EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+      ReportStatusCode ((EFI_ERROR_MAJOR | EFI_ERROR_CODE), (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR));
+      DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for queued NVMe commands.\n", __func__));
+
+      //
+      // Reset the NVMe controller to abort the outstanding commands, the
+      // same way NvmExpressPassThru() recovers from a blocking timeout.
+      //
+      gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+      Status = NvmeControllerInit (Private);
+      if (!EFI_ERROR (Status)) {
+        Status = AbortAsyncPassThruTasks (Private);
+      }
+
+      gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+
+      if (EFI_ERROR (gBS->CheckEvent (Token->Event))) {
+        //
+        // The request still references the token, leave it allocated.
+        //
+        gBS->CloseEvent (TimerEvent);
+        return EFI_DEVICE_ERROR;
+      }
+
+      Status = EFI_ERROR (Status) ? EFI_DEVICE_ERROR : EFI_TIMEOUT;
+      break;
+    }
+  }
+
+  gBS->CloseEvent (TimerEvent);
+  gBS->CloseEvent (Token->Event);
+  FreePool (Token);
+
+  DEBUG ((
+    DEBUG_BLKIO,
+    "%a: Lba = 0x%08Lx, Blocks = 0x%08Lx, Commands = 0x%Lx, IsRead = %d, Status = %r\n",
+    __func__,
+    Lba,
+    (UINT64)Blocks,
+    (UINT64)Commands,
+    IsRead,
+    Status
+    ));
+
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
@@ -1080,7 +1248,7 @@ NvmeBlockIoReadBlocks (
 
   Device = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
 
-  Status = NvmeRead (Device, Buffer, Lba, NumberOfBlocks);
+  Status = NvmeQueuedReadWrite (Device, Buffer, Lba, NumberOfBlocks, TRUE);
 
   gBS->RestoreTPL (OldTpl);
   return Status;
@@ -1164,7 +1332,7 @@ NvmeBlockIoWriteBlocks (
 
   Device = NVME_DEVICE_PRIVATE_DATA_FROM_BLOCK_IO (This);
 
-  Status = NvmeWrite (Device, Buffer, Lba, NumberOfBlocks);
+  Status = NvmeQueuedReadWrite (Device, Buffer, Lba, NumberOfBlocks, FALSE);
 
   gBS->RestoreTPL (OldTpl);
 
@@ -1376,7 +1544,7 @@ NvmeBlockIoReadBlocksEx (
     Token->TransactionStatus = EFI_SUCCESS;
     Status                   = NvmeAsyncRead (Device, Buffer, Lba, NumberOfBlocks, Token);
   } else {
-    Status = NvmeRead (Device, Buffer, Lba, NumberOfBlocks);
+    Status = NvmeQueuedReadWrite (Device, Buffer, Lba, NumberOfBlocks, TRUE);
   }
 
   gBS->RestoreTPL (OldTpl);
@@ -1489,7 +1657,7 @@ NvmeBlockIoWriteBlocksEx (
     Token->TransactionStatus = EFI_SUCCESS;
     Status                   = NvmeAsyncWrite (Device, Buffer, Lba, NumberOfBlocks, Token);
   } else {
-    Status = NvmeWrite (Device, Buffer, Lba, NumberOfBlocks);
+    Status = NvmeQueuedReadWrite (Device, Buffer, Lba, NumberOfBlocks, FALSE);
   }
 
   gBS->RestoreTPL (OldTpl);
@@ -679,11 +679,7 @@ NvmeCreateIoSubmissionQueue (
     if (Index == 1) {
       QueueSize = NVME_CSQ_SIZE;
     } else {
-      if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
-        QueueSize = NVME_ASYNC_CSQ_SIZE;
-      } else {
-        QueueSize = Private->Cap.Mqes;
-      }
+      QueueSize = Private->AsyncSqSize;
     }
 
     CrIoSq.Qid   = Index;
@@ -791,6 +787,15 @@ NvmeControllerInit (
   Private->CqHdbl[2].Cqh = 0;
   Private->AsyncSqHead   = 0;
 
+  //
+  // AsyncSqSize is 0-based: the asynchronous I/O submission queue has
+  // AsyncSqSize + 1 entries and, as one entry is always left empty, holds up
+  // to AsyncSqSize outstanding commands. The queue takes at most one page and
+  // at least the 2 entries required by the NVMe specification.
+  //
+  Private->AsyncSqSize = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes);
+  Private->AsyncSqSize = MIN (Private->AsyncSqSize, (UINT16)MAX (PcdGet16 (PcdNvmExpressIoQueueDepth), 1));
+
   Status = NvmeDisableController (Private);
 
   if (EFI_ERROR (Status)) {
@@ -840,6 +845,7 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "Sync  I/O Submission Queue (SqBuffer[1]) = [%016X]\n", Private->SqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
+  DEBUG ((DEBUG_INFO, "Async I/O Submission Queue size          = [%08X]\n", Private->AsyncSqSize));
   DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
 
   //
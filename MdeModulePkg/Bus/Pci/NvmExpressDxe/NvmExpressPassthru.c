@@ -198,8 +198,9 @@ NvmeDumpStatus (
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
+  A single PRP list is taken from the controller PRP list cache when possible.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
@@ -211,14 +212,15 @@ NvmeDumpStatus (
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost,
+  IN OUT UINTN                         *PrpListNo,
+  OUT VOID                             **Mapping
   )
 {
+  EFI_PCI_IO_PROTOCOL   *PciIo;
   UINTN                 PrpEntryNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
@@ -227,6 +229,10 @@ NvmeCreatePrpList (
   EFI_PHYSICAL_ADDRESS  PrpListPhyAddr;
   UINTN                 Bytes;
   EFI_STATUS            Status;
+  EFI_TPL               OldTpl;
+  NVME_PRP_LIST_BUFFER  *Cached;
+
+  PciIo = Private->PciIo;
 
   //
   // The number of Prp Entry in a memory page.
@@ -247,6 +253,34 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
+  //
+  // Most transfers fit in one PRP list, reuse a cached one if available.
+  //
+  if (*PrpListNo == 1) {
+    Cached = NULL;
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Private->PrpListCacheCount > 0) {
+      Private->PrpListCacheCount--;
+      Cached         = &Private->PrpListCache[Private->PrpListCacheCount];
+      *PrpListHost   = Cached->Host;
+      *Mapping       = Cached->Mapping;
+      PrpListPhyAddr = Cached->PciAddr;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    if (Cached != NULL) {
+      ZeroMem (*PrpListHost, EFI_PAGE_SIZE);
+      PrpListBase = *(UINT64 *)PrpListHost;
+      for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
+        *((UINT64 *)(UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
+        PhysicalAddr                                   += EFI_PAGE_SIZE;
+      }
+
+      return (VOID *)(UINTN)PrpListPhyAddr;
+    }
+  }
+
   Status = PciIo->AllocateBuffer (
                     PciIo,
                     AllocateAnyPages,
@@ -314,6 +348,85 @@ EXIT:
   return NULL;
 }
 
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  A single-page PRP list is kept mapped in the controller PRP list cache when
+  there is room for it, otherwise it is unmapped and freed.
+
+  @param[in] Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpList       The first PRP list, as returned by NvmeCreatePrpList().
+  @param[in] PrpListHost   The host base address of the PRP lists.
+  @param[in] PrpListNo     The number of PRP lists.
+  @param[in] Mapping       The mapping value returned from PciIo.Map().
+
+**/
+VOID
+NvmeReleasePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpList,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  EFI_TPL               OldTpl;
+  NVME_PRP_LIST_BUFFER  *Cached;
+
+  PciIo = Private->PciIo;
+
+  if ((PrpListNo == 1) && (PrpList != NULL)) {
+    Cached = NULL;
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (Private->PrpListCacheCount < NVME_PRP_LIST_CACHE_SIZE) {
+      Cached          = &Private->PrpListCache[Private->PrpListCacheCount];
+      Cached->Host    = PrpListHost;
+      Cached->PciAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)PrpList;
+      Cached->Mapping = Mapping;
+      Private->PrpListCacheCount++;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    if (Cached != NULL) {
+      return;
+    }
+  }
+
+  if (Mapping != NULL) {
+    PciIo->Unmap (PciIo, Mapping);
+  }
+
+  if (PrpListHost != NULL) {
+    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+  }
+}
+
+/**
+  Unmap and free all the PRP lists held in the controller PRP list cache.
+
+  @param[in] Private       The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+**/
+VOID
+NvmeFreePrpListCache (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  NVME_PRP_LIST_BUFFER  *Cached;
+
+  PciIo = Private->PciIo;
+
+  while (Private->PrpListCacheCount > 0) {
+    Private->PrpListCacheCount--;
+    Cached = &Private->PrpListCache[Private->PrpListCacheCount];
+    PciIo->Unmap (PciIo, Cached->Mapping);
+    PciIo->FreeBuffer (PciIo, 1, Cached->Host);
+  }
+}
+
 /**
   Aborts the asynchronous PassThru requests.
 
@@ -384,16 +497,14 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
-    if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+    if ((AsyncRequest->MapPrpList != NULL) || (AsyncRequest->PrpListHost != NULL)) {
+      NvmeReleasePrpList (
+        Private,
+        AsyncRequest->PrpList,
+        AsyncRequest->PrpListHost,
+        AsyncRequest->PrpListNo,
+        AsyncRequest->MapPrpList
+        );
     }
 
     RemoveEntryList (Link);
@@ -553,7 +664,7 @@ NvmExpressPassThru (
   Prp         = NULL;
   TimerEvent  = NULL;
   Status      = EFI_SUCCESS;
-  QueueSize   = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  QueueSize   = Private->AsyncSqSize + 1;
 
   if (Packet->QueueType == NVME_ADMIN_QUEUE) {
     QueueId = 0;
@@ -680,7 +791,7 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -765,6 +876,7 @@ NvmExpressPassThru (
     AsyncRequest->MapData     = MapData;
     AsyncRequest->MapMeta     = MapMeta;
     AsyncRequest->MapPrpList  = MapPrpList;
+    AsyncRequest->PrpList     = Prp;
     AsyncRequest->PrpListNo   = PrpListNo;
     AsyncRequest->PrpListHost = PrpListHost;
 
@@ -907,17 +1019,15 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
+  if (Prp != NULL) {
+    NvmeReleasePrpList (Private, Prp, PrpListHost, PrpListNo, MapPrpList);
+  } else if (MapPrpList != NULL) {
     PciIo->Unmap (
              PciIo,
              MapPrpList
              );
   }
 
-  if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
-  }
-
   if (TimerEvent != NULL) {
     gBS->CloseEvent (TimerEvent);
   }
@@ -19,6 +19,32 @@ BOOLEAN  *mDepexEvaluationStack        = NULL;
 BOOLEAN  *mDepexEvaluationStackEnd     = NULL;
 BOOLEAN  *mDepexEvaluationStackPointer = NULL;
 
+//
+// Number of buckets in mDepexWaiterHashTable.  Must be a power of 2.
+//
+#define DEPEX_WAITER_HASH_BUCKET_COUNT  64
+
+#define DEPEX_WAITER_SIGNATURE  SIGNATURE_32('d','w','t','r')
+
+//
+// A driver whose DEPEX pushes a protocol GUID
+//
+typedef struct {
+  UINTN                    Signature;
+  LIST_ENTRY               Link;        // mDepexWaiterHashTable
+  LIST_ENTRY               DriverLink;  // EFI_CORE_DRIVER_ENTRY.DepexWaiters
+  EFI_GUID                 ProtocolGuid;
+  EFI_CORE_DRIVER_ENTRY    *DriverEntry;
+} DEPEX_WAITER;
+
+//
+// The drivers waiting for protocols, hashed by protocol GUID. It lets the
+// installation of a protocol flag the DEPEX it may satisfy, instead of the
+// dispatcher evaluating every DEPEX again after each driver it starts.
+//
+LIST_ENTRY  mDepexWaiterHashTable[DEPEX_WAITER_HASH_BUCKET_COUNT];
+BOOLEAN     mDepexWaiterHashTableReady = FALSE;
+
 //
 // Worker functions
 //
@@ -141,6 +167,172 @@ PopBool (
   return EFI_SUCCESS;
 }
 
+/**
+  Returns the mDepexWaiterHashTable bucket of a protocol GUID.
+
+  @param  Protocol              The GUID of the protocol.
+
+  @return The bucket of the protocol.
+
+**/
+LIST_ENTRY *
+CoreGetDepexWaiterHashBucket (
+  IN EFI_GUID  *Protocol
+  )
+{
+  UINTN  Index;
+
+  if (!mDepexWaiterHashTableReady) {
+    for (Index = 0; Index < DEPEX_WAITER_HASH_BUCKET_COUNT; Index++) {
+      InitializeListHead (&mDepexWaiterHashTable[Index]);
+    }
+
+    mDepexWaiterHashTableReady = TRUE;
+  }
+
+  return &mDepexWaiterHashTable[CoreGetGuidHashIndex (Protocol, DEPEX_WAITER_HASH_BUCKET_COUNT)];
+}
+
+/**
+  Adds the protocols pushed by the DEPEX of a driver to the DEPEX waiter index.
+
+  DriverEntry->DepexIndexed is only set if the result of the DEPEX can only
+  change from FALSE to TRUE when one of these protocols is installed. A DEPEX
+  with a NOT, or that cannot be parsed, is evaluated on every dispatcher pass.
+
+  @param  DriverEntry           DriverEntry element to index.
+
+**/
+VOID
+CoreIndexDepex (
+  IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  UINT8         *Iterator;
+  UINT8         *End;
+  DEPEX_WAITER  *Waiter;
+  EFI_TPL       OldTpl;
+
+  Iterator = DriverEntry->Depex;
+  End      = Iterator + DriverEntry->DepexSize;
+
+  while (Iterator < End) {
+    switch (*Iterator) {
+      case EFI_DEP_PUSH:
+        if ((UINTN)(End - Iterator) <= sizeof (EFI_GUID)) {
+          return;
+        }
+
+        Waiter = AllocatePool (sizeof (DEPEX_WAITER));
+        if (Waiter == NULL) {
+          return;
+        }
+
+        Waiter->Signature   = DEPEX_WAITER_SIGNATURE;
+        Waiter->DriverEntry = DriverEntry;
+        CopyMem (&Waiter->ProtocolGuid, Iterator + 1, sizeof (EFI_GUID));
+
+        //
+        // Protocols may be installed from event notification functions,
+        // which walk the buckets in CoreDepexProtocolInstalled().
+        //
+        OldTpl = CoreRaiseTpl (TPL_HIGH_LEVEL);
+        InsertTailList (CoreGetDepexWaiterHashBucket (&Waiter->ProtocolGuid), &Waiter->Link);
+        CoreRestoreTpl (OldTpl);
+        InsertTailList (&DriverEntry->DepexWaiters, &Waiter->DriverLink);
+
+        Iterator += sizeof (EFI_GUID);
+        break;
+
+      case EFI_DEP_AND:
+      case EFI_DEP_OR:
+      case EFI_DEP_TRUE:
+      case EFI_DEP_FALSE:
+      case EFI_DEP_SOR:
+        break;
+
+      case EFI_DEP_END:
+        DriverEntry->DepexIndexed = TRUE;
+        return;
+
+      default:
+        //
+        // BEFORE and AFTER are not evaluated by CoreIsSchedulable(), and
+        // NOT may turn TRUE when a protocol is uninstalled.
+        //
+        return;
+    }
+
+    Iterator++;
+  }
+}
+
+/**
+  Marks the DEPEX of every driver waiting for a protocol to be evaluated
+  again, as the protocol has just been installed.
+
+  @param  Protocol              The GUID of the installed protocol.
+
+**/
+VOID
+CoreDepexProtocolInstalled (
+  IN EFI_GUID  *Protocol
+  )
+{
+  LIST_ENTRY    *Bucket;
+  LIST_ENTRY    *Link;
+  DEPEX_WAITER  *Waiter;
+
+  if (!mDepexWaiterHashTableReady) {
+    return;
+  }
+
+  Bucket = CoreGetDepexWaiterHashBucket (Protocol);
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Waiter = CR (Link, DEPEX_WAITER, Link, DEPEX_WAITER_SIGNATURE);
+    if (CompareGuid (&Waiter->ProtocolGuid, Protocol)) {
+      Waiter->DriverEntry->DepexReevaluate = TRUE;
+    }
+  }
+}
+
+/**
+  Removes a driver from the DEPEX waiter index, as its DEPEX no longer needs
+  to be evaluated once it is scheduled.
+
+  @param  DriverEntry           The driver leaving the Dependent state.
+
+**/
+VOID
+CoreRemoveDepexWaiters (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  LIST_ENTRY    *Link;
+  DEPEX_WAITER  *Waiter;
+  EFI_TPL       OldTpl;
+
+  //
+  // Unlink the waiters from the buckets at TPL_HIGH_LEVEL, as they are
+  // inserted, and free them afterwards.
+  //
+  OldTpl = CoreRaiseTpl (TPL_HIGH_LEVEL);
+  for (Link = DriverEntry->DepexWaiters.ForwardLink; Link != &DriverEntry->DepexWaiters; Link = Link->ForwardLink) {
+    Waiter = CR (Link, DEPEX_WAITER, DriverLink, DEPEX_WAITER_SIGNATURE);
+    RemoveEntryList (&Waiter->Link);
+  }
+
+  CoreRestoreTpl (OldTpl);
+
+  while (!IsListEmpty (&DriverEntry->DepexWaiters)) {
+    Waiter = CR (DriverEntry->DepexWaiters.ForwardLink, DEPEX_WAITER, DriverLink, DEPEX_WAITER_SIGNATURE);
+    RemoveEntryList (&Waiter->DriverLink);
+    FreePool (Waiter);
+  }
+
+  DriverEntry->DepexIndexed = FALSE;
+}
+
 /**
   Preprocess dependency expression and update DriverEntry to reflect the
   state of  Before, After, and SOR dependencies. If DriverEntry->Before
@@ -177,6 +369,12 @@ CorePreProcessDepex (
     CopyMem (&DriverEntry->BeforeAfterGuid, Iterator + 1, sizeof (EFI_GUID));
   }
 
+  //
+  // The DEPEX has never been evaluated
+  //
+  DriverEntry->DepexReevaluate = TRUE;
+  CoreIndexDepex (DriverEntry);
+
   return EFI_SUCCESS;
 }
 
@@ -407,6 +407,8 @@ CoreDispatcher (
   EFI_CORE_DRIVER_ENTRY  *DriverEntry;
   BOOLEAN                ReadyToRun;
   EFI_EVENT              DxeDispatchEvent;
+  UINTN                  EvaluatedCount;
+  UINTN                  SkippedCount;
 
   PERF_FUNCTION_BEGIN ();
 
@@ -540,7 +542,10 @@ CoreDispatcher (
     //
     // Search DriverList for items to place on Scheduled Queue
     //
-    ReadyToRun = FALSE;
+    PERF_INMODULE_BEGIN ("DxeDepexEval");
+    ReadyToRun     = FALSE;
+    EvaluatedCount = 0;
+    SkippedCount   = 0;
     for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
       DriverEntry = CR (Link, EFI_CORE_DRIVER_ENTRY, Link, EFI_CORE_DRIVER_ENTRY_SIGNATURE);
 
@@ -552,6 +557,17 @@ CoreDispatcher (
       }
 
       if (DriverEntry->Dependent) {
+        if (DriverEntry->DepexIndexed && !DriverEntry->DepexReevaluate) {
+          //
+          // None of the protocols the DEPEX waits for was installed since
+          // it was last evaluated, so it is still FALSE.
+          //
+          SkippedCount++;
+          continue;
+        }
+
+        DriverEntry->DepexReevaluate = FALSE;
+        EvaluatedCount++;
         if (CoreIsSchedulable (DriverEntry)) {
           CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (DriverEntry);
           ReadyToRun = TRUE;
@@ -564,6 +580,23 @@ CoreDispatcher (
         }
       }
     }
+
+    PERF_INMODULE_END ("DxeDepexEval");
+    DEBUG ((
+      DEBUG_DISPATCH,
+      "DXE DEPEX evaluated: %d, skipped: %d\n",
+      EvaluatedCount,
+      SkippedCount
+      ));
+
+    //
+    // Complete the driver init phases that finished on APs, which may install
+    // protocols other drivers wait for. If no driver is ready, wait for one of
+    // those still running rather than leaving the dispatcher.
+    //
+    if (CoreCompleteParallelDriverInits (!ReadyToRun)) {
+      ReadyToRun = TRUE;
+    }
   } while (ReadyToRun);
 
   //
@@ -628,6 +661,8 @@ CoreInsertOnScheduledQueueWhileProcessingBeforeAndAfter (
 
   CoreReleaseDispatcherLock ();
 
+  CoreRemoveDepexWaiters (InsertedDriverEntry);
+
   //
   // Process After Dependency
   //
@@ -873,6 +908,7 @@ CoreAddToDriverList (
   }
 
   DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
+  InitializeListHead (&DriverEntry->DepexWaiters);
   CopyGuid (&DriverEntry->FileName, DriverName);
   DriverEntry->FvHandle         = FvHandle;
   DriverEntry->Fv               = Fv;
@@ -1421,6 +1457,7 @@ CoreFwVolEventProtocolNotify (
           DriverEntry->Scheduled = TRUE;
           InsertTailList (&mScheduledQueue, &DriverEntry->ScheduledLink);
           CoreReleaseDispatcherLock ();
+          CoreRemoveDepexWaiters (DriverEntry);
           DEBUG ((DEBUG_DISPATCH, "Evaluate DXE DEPEX for FFS(%g)\n", &DriverEntry->FileName));
           DEBUG ((DEBUG_DISPATCH, "  RESULT = TRUE (Apriori)\n"));
           break;
@@ -0,0 +1,346 @@
+/** @file
+  DXE Core support of EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  If PcdDxeCoreParallelDriverInit is set, the init phases handed over by DXE
+  drivers are started on idle APs through EFI_MP_SERVICES_PROTOCOL, in
+  non-blocking mode. The DXE dispatcher runs the completions of the finished
+  phases between drivers, and waits for the phases still running when no other
+  driver can be dispatched.
+
+  A phase keeps its AP busy, so EFI_MP_SERVICES_PROTOCOL.StartupAllAPs() fails
+  until it returns. The GCD waits for every phase to return before it changes
+  memory attributes, as a cache attribute change reprograms the MTRRs of every
+  AP.
+
+  Each phase is recorded as an FPDT measurement of the image of the driver, so
+  the timeline shows how it overlaps with the dispatch: "ParallelInitAp" for a
+  phase run on an AP, "ParallelInitBsp" for a phase run in line on the BSP.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+
+#define PARALLEL_INIT_JOB_SIGNATURE  SIGNATURE_32('p','i','n','j')
+
+typedef struct {
+  UINTN                                   Signature;
+  LIST_ENTRY                              Link;        // mParallelInitJobs
+  EFI_HANDLE                              ImageHandle;
+  EDKII_PARALLEL_DRIVER_INIT_PROCEDURE    Procedure;
+  EDKII_PARALLEL_DRIVER_INIT_PROCEDURE    Completion;
+  VOID                                    *Context;
+  EFI_EVENT                               Event;
+  volatile BOOLEAN                        Finished;
+  volatile BOOLEAN                        ApIdle;      // Set by the MP Services protocol
+} PARALLEL_INIT_JOB;
+
+#define PARALLEL_INIT_JOB_FROM_LINK(a)  CR (a, PARALLEL_INIT_JOB, Link, PARALLEL_INIT_JOB_SIGNATURE)
+
+EFI_STATUS
+EFIAPI
+CoreRunParallelDriverInit (
+  IN EDKII_PARALLEL_DRIVER_INIT_PROTOCOL   *This,
+  IN EFI_HANDLE                            ImageHandle,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Procedure,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Completion OPTIONAL,
+  IN VOID                                  *Context
+  );
+
+EFI_HANDLE                           mParallelDriverInitHandle = NULL;
+EDKII_PARALLEL_DRIVER_INIT_PROTOCOL  mParallelDriverInit       = {
+  CoreRunParallelDriverInit
+};
+
+//
+// The init phases started on APs whose completion has not run yet
+//
+LIST_ENTRY  mParallelInitJobs = INITIALIZE_LIST_HEAD_VARIABLE (mParallelInitJobs);
+
+/**
+  Notification function of the event signaled by the MP Services protocol
+  when the init phase of a job has returned on its AP.
+
+  @param  Event                 The event of the job.
+  @param  Context               The job.
+
+**/
+VOID
+EFIAPI
+CoreParallelInitJobFinished (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  PARALLEL_INIT_JOB  *Job;
+
+  Job = (PARALLEL_INIT_JOB *)Context;
+  PERF_END_EX (Job->ImageHandle, "ParallelInitAp", NULL, 0, 0);
+  Job->Finished = TRUE;
+}
+
+/**
+  Starts the init phase of a job on an idle AP.
+
+  @param  Job                   The job to start.
+
+  @retval EFI_SUCCESS           The init phase was started on an AP.
+  @retval EFI_NOT_READY         No AP is available.
+
+**/
+EFI_STATUS
+CoreStartParallelInitJob (
+  IN PARALLEL_INIT_JOB  *Job
+  )
+{
+  EFI_STATUS                Status;
+  EFI_MP_SERVICES_PROTOCOL  *MpServices;
+  UINTN                     NumberOfProcessors;
+  UINTN                     NumberOfEnabledProcessors;
+  UINTN                     ProcessorNumber;
+  EFI_TPL                   OldTpl;
+
+  if (!FeaturePcdGet (PcdDxeCoreParallelDriverInit) || !gDispatcherRunning) {
+    return EFI_NOT_READY;
+  }
+
+  Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_READY;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return EFI_NOT_READY;
+  }
+
+  Status = CoreCreateEvent (
+             EVT_NOTIFY_SIGNAL,
+             TPL_CALLBACK,
+             CoreParallelInitJobFinished,
+             Job,
+             &Job->Event
+             );
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_READY;
+  }
+
+  //
+  // StartupThisAP() fails on the BSP, on disabled APs and on busy APs, so
+  // the first processor that takes the procedure is an idle AP. The TPL is
+  // raised to record the start before CoreParallelInitJobFinished() can run.
+  // The MP Services protocol sets ApIdle once the AP is idle again, before it
+  // signals the event.
+  //
+  OldTpl = CoreRaiseTpl (TPL_CALLBACK);
+  for (ProcessorNumber = 0; ProcessorNumber < NumberOfProcessors; ProcessorNumber++) {
+    Status = MpServices->StartupThisAP (
+                           MpServices,
+                           (EFI_AP_PROCEDURE)Job->Procedure,
+                           ProcessorNumber,
+                           Job->Event,
+                           0,
+                           Job->Context,
+                           (BOOLEAN *)&Job->ApIdle
+                           );
+    if (!EFI_ERROR (Status)) {
+      PERF_START_EX (Job->ImageHandle, "ParallelInitAp", NULL, 0, 0);
+      CoreRestoreTpl (OldTpl);
+      DEBUG ((
+        DEBUG_DISPATCH,
+        "Parallel init of image %p started on processor %Lu\n",
+        Job->ImageHandle,
+        (UINT64)ProcessorNumber
+        ));
+      return EFI_SUCCESS;
+    }
+  }
+
+  CoreRestoreTpl (OldTpl);
+  CoreCloseEvent (Job->Event);
+  Job->Event = NULL;
+  return EFI_NOT_READY;
+}
+
+/**
+  Runs a phase of the init of a driver in parallel with the dispatch of other
+  drivers, then completes the init on the BSP.
+
+  @param[in] This           The EDKII_PARALLEL_DRIVER_INIT_PROTOCOL instance.
+  @param[in] ImageHandle    The image handle of the driver.
+  @param[in] Procedure      The phase of the init that may run on an AP.
+  @param[in] Completion     The phase of the init that runs on the BSP afterwards.
+                            Optional.
+  @param[in] Context        The context passed to Procedure and Completion.
+
+  @retval EFI_SUCCESS           Procedure was started on an AP, or has run on the BSP.
+  @retval EFI_INVALID_PARAMETER ImageHandle or Procedure is NULL.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory to track Procedure.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreRunParallelDriverInit (
+  IN EDKII_PARALLEL_DRIVER_INIT_PROTOCOL   *This,
+  IN EFI_HANDLE                            ImageHandle,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Procedure,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Completion OPTIONAL,
+  IN VOID                                  *Context
+  )
+{
+  EFI_STATUS         Status;
+  PARALLEL_INIT_JOB  *Job;
+
+  if ((ImageHandle == NULL) || (Procedure == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Job = AllocateZeroPool (sizeof (PARALLEL_INIT_JOB));
+  if (Job == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Job->Signature   = PARALLEL_INIT_JOB_SIGNATURE;
+  Job->ImageHandle = ImageHandle;
+  Job->Procedure   = Procedure;
+  Job->Completion  = Completion;
+  Job->Context     = Context;
+
+  Status = CoreStartParallelInitJob (Job);
+  if (!EFI_ERROR (Status)) {
+    InsertTailList (&mParallelInitJobs, &Job->Link);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Run both phases in line, as the driver would without this protocol.
+  //
+  PERF_START_EX (ImageHandle, "ParallelInitBsp", NULL, 0, 0);
+  Procedure (Context);
+  PERF_END_EX (ImageHandle, "ParallelInitBsp", NULL, 0, 0);
+
+  if (Completion != NULL) {
+    Completion (Context);
+  }
+
+  CoreFreePool (Job);
+  return EFI_SUCCESS;
+}
+
+/**
+  Runs the completion of the driver init phases that have finished on APs.
+
+  @param  Wait                  TRUE to wait for an init phase to finish if some
+                                are still running and none has finished yet.
+
+  @retval TRUE                  At least one completion has run.
+  @retval FALSE                 No completion has run.
+
+**/
+BOOLEAN
+CoreCompleteParallelDriverInits (
+  IN BOOLEAN  Wait
+  )
+{
+  LIST_ENTRY         *Link;
+  PARALLEL_INIT_JOB  *Job;
+  BOOLEAN            Completed;
+
+  Completed = FALSE;
+
+  do {
+    Link = GetFirstNode (&mParallelInitJobs);
+    while (!IsNull (&mParallelInitJobs, Link)) {
+      Job  = PARALLEL_INIT_JOB_FROM_LINK (Link);
+      Link = GetNextNode (&mParallelInitJobs, Link);
+      if (!Job->Finished) {
+        continue;
+      }
+
+      RemoveEntryList (&Job->Link);
+      CoreCloseEvent (Job->Event);
+
+      //
+      // A completion may start other init phases, which are appended to
+      // mParallelInitJobs and picked up by a later call.
+      //
+      if (Job->Completion != NULL) {
+        Job->Completion (Job->Context);
+      }
+
+      CoreFreePool (Job);
+      Completed = TRUE;
+    }
+
+    if (Completed || !Wait || IsListEmpty (&mParallelInitJobs)) {
+      break;
+    }
+
+    //
+    // The MP Services protocol signals the event of a job from a timer
+    // event, which needs the BSP to be at TPL_APPLICATION.
+    //
+    CpuPause ();
+  } while (TRUE);
+
+  return Completed;
+}
+
+/**
+  Waits for the driver init phases running on APs to return, so that every AP
+  is idle for EFI_MP_SERVICES_PROTOCOL.StartupAllAPs(). The completions of the
+  phases are left to the DXE dispatcher.
+
+  The MP Services protocol marks an AP idle from a TPL_NOTIFY timer event, so
+  the phases cannot be waited for at TPL_NOTIFY and above.
+
+**/
+VOID
+CoreWaitForParallelDriverInitAps (
+  VOID
+  )
+{
+  LIST_ENTRY         *Link;
+  PARALLEL_INIT_JOB  *Job;
+
+  if (IsListEmpty (&mParallelInitJobs)) {
+    return;
+  }
+
+  if (gEfiCurrentTpl >= TPL_NOTIFY) {
+    DEBUG ((DEBUG_WARN, "Parallel init phases cannot be waited for at TPL %Lu\n", (UINT64)gEfiCurrentTpl));
+    return;
+  }
+
+  for (Link = GetFirstNode (&mParallelInitJobs); !IsNull (&mParallelInitJobs, Link); Link = GetNextNode (&mParallelInitJobs, Link)) {
+    Job = PARALLEL_INIT_JOB_FROM_LINK (Link);
+    while (!Job->ApIdle) {
+      CpuPause ();
+    }
+  }
+}
+
+/**
+  Installs EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  The protocol is installed even if PcdDxeCoreParallelDriverInit is not set,
+  in which case both phases of the init of a driver run in line.
+
+  @retval EFI_SUCCESS           The protocol was installed.
+  @retval Others                The protocol could not be installed.
+
+**/
+EFI_STATUS
+CoreInitializeParallelDriverInit (
+  VOID
+  )
+{
+  return CoreInstallMultipleProtocolInterfaces (
+           &mParallelDriverInitHandle,
+           &gEdkiiParallelDriverInitProtocolGuid,
+           &mParallelDriverInit,
+           NULL
+           );
+}
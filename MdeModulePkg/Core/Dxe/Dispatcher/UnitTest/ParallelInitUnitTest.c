@@ -0,0 +1,838 @@
+/** @file
+  This is a host-based unit test for the DXE core support of
+  EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  ParallelInit.c is built as is. The DXE core services it calls are replaced
+  here, and a fake EFI_MP_SERVICES_PROTOCOL records the procedures started on
+  its APs, so each test decides when an AP returns and signals the event of
+  its job, after it sets the Finished flag of the job as the MP Services
+  protocol does once the AP is idle again.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "DxeMain.h"
+
+#define UNIT_TEST_NAME     "DXE Core Parallel Driver Init Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_PROCESSOR_COUNT  4
+
+#define TEST_IMAGE_HANDLE  ((EFI_HANDLE)(UINTN)0x1000)
+
+///
+/// An event created through CoreCreateEvent().
+///
+typedef struct {
+  EFI_EVENT_NOTIFY    NotifyFunction;
+  VOID                *NotifyContext;
+} TEST_EVENT;
+
+///
+/// The procedure started on an AP of the fake MP Services protocol.
+///
+typedef struct {
+  BOOLEAN             Busy;
+  EFI_AP_PROCEDURE    Procedure;
+  VOID                *Argument;
+  EFI_EVENT           WaitEvent;
+  BOOLEAN             *Finished;
+} TEST_AP;
+
+///
+/// The context handed over to RunParallel() by a test driver.
+///
+typedef struct {
+  UINTN    ProcedureRuns;
+  UINTN    CompletionRuns;
+  UINTN    CompletionOrder;
+  BOOLEAN  RunParallelInCompletion;
+} TEST_INIT_CONTEXT;
+
+extern LIST_ENTRY  mParallelInitJobs;
+
+BOOLEAN  gDispatcherRunning = FALSE;
+EFI_TPL  gEfiCurrentTpl     = TPL_APPLICATION;
+
+EDKII_PARALLEL_DRIVER_INIT_PROTOCOL  *mTestParallelInit = NULL;
+EFI_MP_SERVICES_PROTOCOL             mTestMpServices;
+BOOLEAN                              mTestMpServicesInstalled = FALSE;
+UINTN                                mTestEnabledProcessors   = TEST_PROCESSOR_COUNT;
+TEST_AP                              mTestAps[TEST_PROCESSOR_COUNT];
+UINTN                                mTestOpenEvents     = 0;
+UINTN                                mTestCompletionRuns = 0;
+TEST_INIT_CONTEXT                    mTestChainedContext;
+
+/**
+  Returns the number of processors of the fake MP Services protocol.
+
+  @param  This                       The protocol instance.
+  @param  NumberOfProcessors         The number of processors.
+  @param  NumberOfEnabledProcessors  The number of enabled processors.
+
+  @retval EFI_SUCCESS                Always.
+
+**/
+EFI_STATUS
+EFIAPI
+TestGetNumberOfProcessors (
+  IN  EFI_MP_SERVICES_PROTOCOL  *This,
+  OUT UINTN                     *NumberOfProcessors,
+  OUT UINTN                     *NumberOfEnabledProcessors
+  )
+{
+  *NumberOfProcessors        = TEST_PROCESSOR_COUNT;
+  *NumberOfEnabledProcessors = mTestEnabledProcessors;
+  return EFI_SUCCESS;
+}
+
+/**
+  Records a procedure started on an AP of the fake MP Services protocol.
+
+  @param  This                   The protocol instance.
+  @param  Procedure              The procedure to run.
+  @param  ProcessorNumber        The processor to run it on.
+  @param  WaitEvent              The event to signal once Procedure returns.
+  @param  TimeoutInMicroseconds  Not used.
+  @param  ProcedureArgument      The argument of Procedure.
+  @param  Finished               Set to TRUE once Procedure returns.
+
+  @retval EFI_SUCCESS            Procedure is recorded on the AP.
+  @retval EFI_INVALID_PARAMETER  ProcessorNumber is the BSP, or WaitEvent is NULL.
+  @retval EFI_NOT_READY          The AP is busy.
+  @retval EFI_NOT_FOUND          The AP is disabled or does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+TestStartupThisAP (
+  IN  EFI_MP_SERVICES_PROTOCOL  *This,
+  IN  EFI_AP_PROCEDURE          Procedure,
+  IN  UINTN                     ProcessorNumber,
+  IN  EFI_EVENT                 WaitEvent               OPTIONAL,
+  IN  UINTN                     TimeoutInMicroseconds,
+  IN  VOID                      *ProcedureArgument      OPTIONAL,
+  OUT BOOLEAN                   *Finished               OPTIONAL
+  )
+{
+  if ((ProcessorNumber == 0) || (WaitEvent == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (ProcessorNumber >= mTestEnabledProcessors) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (mTestAps[ProcessorNumber].Busy) {
+    return EFI_NOT_READY;
+  }
+
+  mTestAps[ProcessorNumber].Busy      = TRUE;
+  mTestAps[ProcessorNumber].Procedure = Procedure;
+  mTestAps[ProcessorNumber].Argument  = ProcedureArgument;
+  mTestAps[ProcessorNumber].WaitEvent = WaitEvent;
+  mTestAps[ProcessorNumber].Finished  = Finished;
+  if (Finished != NULL) {
+    *Finished = FALSE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Runs the procedure recorded on an AP, then sets its Finished flag and
+  signals its event.
+
+  @param  ProcessorNumber        The AP.
+
+  @retval TRUE                   The AP had a procedure to run.
+  @retval FALSE                  The AP was idle, or is marked busy by the test.
+
+**/
+BOOLEAN
+TestFinishAp (
+  IN UINTN  ProcessorNumber
+  )
+{
+  TEST_AP     *Ap;
+  TEST_EVENT  *Event;
+
+  Ap = &mTestAps[ProcessorNumber];
+  if (!Ap->Busy || (Ap->Procedure == NULL)) {
+    return FALSE;
+  }
+
+  Ap->Procedure (Ap->Argument);
+  Ap->Busy      = FALSE;
+  Ap->Procedure = NULL;
+  if (Ap->Finished != NULL) {
+    *Ap->Finished = TRUE;
+  }
+
+  Event = (TEST_EVENT *)Ap->WaitEvent;
+  Event->NotifyFunction ((EFI_EVENT)Event, Event->NotifyContext);
+  return TRUE;
+}
+
+/**
+  Locates the fake MP Services protocol, if the test has installed it.
+
+  @param  Protocol               The protocol to locate.
+  @param  Registration           Not used.
+  @param  Interface              The protocol interface.
+
+  @retval EFI_SUCCESS            The protocol is located.
+  @retval EFI_NOT_FOUND          The protocol is not installed.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  if (mTestMpServicesInstalled && CompareGuid (Protocol, &gEfiMpServiceProtocolGuid)) {
+    *Interface = &mTestMpServices;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Records the interface of EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  @param  Handle                 The handle to install the protocols on.
+  @param  ...                    Pairs of protocol GUIDs and interfaces, ended by NULL.
+
+  @retval EFI_SUCCESS            Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE  *Handle,
+  ...
+  )
+{
+  VA_LIST   Args;
+  EFI_GUID  *Protocol;
+  VOID      *Interface;
+
+  VA_START (Args, Handle);
+  for (Protocol = VA_ARG (Args, EFI_GUID *); Protocol != NULL; Protocol = VA_ARG (Args, EFI_GUID *)) {
+    Interface = VA_ARG (Args, VOID *);
+    if (CompareGuid (Protocol, &gEdkiiParallelDriverInitProtocolGuid)) {
+      mTestParallelInit = Interface;
+    }
+  }
+
+  VA_END (Args);
+  return EFI_SUCCESS;
+}
+
+/**
+  Creates an event that only records its notification function.
+
+  @param  Type                   The type of the event.
+  @param  NotifyTpl              Not used.
+  @param  NotifyFunction         The notification function.
+  @param  NotifyContext          The context of NotifyFunction.
+  @param  Event                  The new event.
+
+  @retval EFI_SUCCESS            The event is created.
+  @retval EFI_OUT_OF_RESOURCES   The event could not be allocated.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreCreateEvent (
+  IN UINT32            Type,
+  IN EFI_TPL           NotifyTpl,
+  IN EFI_EVENT_NOTIFY  NotifyFunction  OPTIONAL,
+  IN VOID              *NotifyContext  OPTIONAL,
+  OUT EFI_EVENT        *Event
+  )
+{
+  TEST_EVENT  *TestEvent;
+
+  ASSERT (Type == EVT_NOTIFY_SIGNAL);
+  TestEvent = AllocatePool (sizeof (TEST_EVENT));
+  if (TestEvent == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  TestEvent->NotifyFunction = NotifyFunction;
+  TestEvent->NotifyContext  = NotifyContext;
+  *Event                    = (EFI_EVENT)TestEvent;
+  mTestOpenEvents++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Frees an event created through CoreCreateEvent().
+
+  @param  UserEvent              The event.
+
+  @retval EFI_SUCCESS            Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreCloseEvent (
+  IN EFI_EVENT  UserEvent
+  )
+{
+  ASSERT (mTestOpenEvents > 0);
+  mTestOpenEvents--;
+  FreePool (UserEvent);
+  return EFI_SUCCESS;
+}
+
+/**
+  Raises the recorded task priority level.
+
+  @param  NewTpl                 The new task priority level.
+
+  @return The previous task priority level.
+
+**/
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  ASSERT (NewTpl >= gEfiCurrentTpl);
+  OldTpl         = gEfiCurrentTpl;
+  gEfiCurrentTpl = NewTpl;
+  return OldTpl;
+}
+
+/**
+  Restores the recorded task priority level.
+
+  @param  NewTpl                 The task priority level to restore.
+
+**/
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  ASSERT (NewTpl <= gEfiCurrentTpl);
+  gEfiCurrentTpl = NewTpl;
+}
+
+/**
+  Frees pool allocated by the host MemoryAllocationLib.
+
+  @param  Buffer                 The buffer to free.
+
+  @retval EFI_SUCCESS            Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  The init phase of a test driver, which may run on an AP.
+
+  @param  Context                The TEST_INIT_CONTEXT of the driver.
+
+**/
+VOID
+EFIAPI
+TestInitProcedure (
+  IN VOID  *Context
+  )
+{
+  ((TEST_INIT_CONTEXT *)Context)->ProcedureRuns++;
+}
+
+/**
+  The completion of the init of a test driver, which runs on the BSP. It may
+  hand over another init phase, as a driver that starts a second phase once
+  the first one has finished would.
+
+  @param  Context                The TEST_INIT_CONTEXT of the driver.
+
+**/
+VOID
+EFIAPI
+TestInitCompletion (
+  IN VOID  *Context
+  )
+{
+  TEST_INIT_CONTEXT  *InitContext;
+  EFI_STATUS         Status;
+
+  InitContext = (TEST_INIT_CONTEXT *)Context;
+  ASSERT (InitContext->ProcedureRuns == 1);
+  ASSERT (gEfiCurrentTpl == TPL_APPLICATION);
+
+  InitContext->CompletionRuns++;
+  InitContext->CompletionOrder = ++mTestCompletionRuns;
+
+  if (InitContext->RunParallelInCompletion) {
+    ZeroMem (&mTestChainedContext, sizeof (mTestChainedContext));
+    Status = mTestParallelInit->RunParallel (
+                                  mTestParallelInit,
+                                  TEST_IMAGE_HANDLE,
+                                  TestInitProcedure,
+                                  TestInitCompletion,
+                                  &mTestChainedContext
+                                  );
+    ASSERT_EFI_ERROR (Status);
+  }
+}
+
+/**
+  Resets the fake MP Services protocol and the dispatcher state, and installs
+  EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The protocol is installed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParallelInitSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  ZeroMem (&mTestMpServices, sizeof (mTestMpServices));
+  mTestMpServices.GetNumberOfProcessors = TestGetNumberOfProcessors;
+  mTestMpServices.StartupThisAP         = TestStartupThisAP;
+
+  ZeroMem (mTestAps, sizeof (mTestAps));
+  mTestMpServicesInstalled = TRUE;
+  mTestEnabledProcessors   = TEST_PROCESSOR_COUNT;
+  mTestCompletionRuns      = 0;
+  gEfiCurrentTpl           = TPL_APPLICATION;
+  gDispatcherRunning       = TRUE;
+
+  mTestParallelInit = NULL;
+  Status            = CoreInitializeParallelDriverInit ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_NOT_NULL (mTestParallelInit);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Stops the dispatcher. Every test completes the jobs it starts.
+
+  @param  Context                Not used.
+
+**/
+VOID
+EFIAPI
+ParallelInitCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ASSERT (IsListEmpty (&mParallelInitJobs));
+  ASSERT (mTestOpenEvents == 0);
+  gDispatcherRunning = FALSE;
+}
+
+/**
+  Hands over an init phase and checks that both phases have run in line.
+
+  @param  InitContext            The context of the test driver.
+
+  @retval TRUE                   Both phases have run once, before RunParallel() returned.
+  @retval FALSE                  Otherwise.
+
+**/
+BOOLEAN
+TestRunsInLine (
+  IN TEST_INIT_CONTEXT  *InitContext
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       OpenEvents;
+
+  OpenEvents = mTestOpenEvents;
+  ZeroMem (InitContext, sizeof (*InitContext));
+  Status = mTestParallelInit->RunParallel (
+                                mTestParallelInit,
+                                TEST_IMAGE_HANDLE,
+                                TestInitProcedure,
+                                TestInitCompletion,
+                                InitContext
+                                );
+  return !EFI_ERROR (Status) &&
+         (InitContext->ProcedureRuns == 1) &&
+         (InitContext->CompletionRuns == 1) &&
+         (mTestOpenEvents == OpenEvents) &&
+         !CoreCompleteParallelDriverInits (FALSE);
+}
+
+/**
+  RunParallel() rejects a missing image handle or procedure.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunParallelChecksParameters (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_INIT_CONTEXT  InitContext;
+
+  ZeroMem (&InitContext, sizeof (InitContext));
+  UT_ASSERT_STATUS_EQUAL (
+    mTestParallelInit->RunParallel (mTestParallelInit, NULL, TestInitProcedure, NULL, &InitContext),
+    EFI_INVALID_PARAMETER
+    );
+  UT_ASSERT_STATUS_EQUAL (
+    mTestParallelInit->RunParallel (mTestParallelInit, TEST_IMAGE_HANDLE, NULL, NULL, &InitContext),
+    EFI_INVALID_PARAMETER
+    );
+  UT_ASSERT_EQUAL (InitContext.ProcedureRuns, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  RunParallel() runs both phases in line when no AP can take the procedure.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunsInLineWithoutIdleAp (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_INIT_CONTEXT  InitContext;
+  UINTN              Index;
+
+  //
+  // The dispatcher is not running, e.g. a driver started from the shell.
+  //
+  gDispatcherRunning = FALSE;
+  UT_ASSERT_TRUE (TestRunsInLine (&InitContext));
+  gDispatcherRunning = TRUE;
+
+  //
+  // The MP Services protocol is not installed yet.
+  //
+  mTestMpServicesInstalled = FALSE;
+  UT_ASSERT_TRUE (TestRunsInLine (&InitContext));
+  mTestMpServicesInstalled = TRUE;
+
+  //
+  // Only the BSP is enabled.
+  //
+  mTestEnabledProcessors = 1;
+  UT_ASSERT_TRUE (TestRunsInLine (&InitContext));
+  mTestEnabledProcessors = TEST_PROCESSOR_COUNT;
+
+  //
+  // Every AP is busy.
+  //
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    mTestAps[Index].Busy = TRUE;
+  }
+
+  UT_ASSERT_TRUE (TestRunsInLine (&InitContext));
+
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    mTestAps[Index].Busy = FALSE;
+  }
+
+  //
+  // A driver without a completion.
+  //
+  gDispatcherRunning = FALSE;
+  ZeroMem (&InitContext, sizeof (InitContext));
+  UT_ASSERT_NOT_EFI_ERROR (
+    mTestParallelInit->RunParallel (mTestParallelInit, TEST_IMAGE_HANDLE, TestInitProcedure, NULL, &InitContext)
+    );
+  UT_ASSERT_EQUAL (InitContext.ProcedureRuns, 1);
+  UT_ASSERT_EQUAL (InitContext.CompletionRuns, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  RunParallel() starts the procedure on the first idle AP, and the completion
+  only runs once the dispatcher collects the finished job.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunsOnIdleAp (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_INIT_CONTEXT  InitContext;
+
+  mTestAps[1].Busy = TRUE;
+
+  ZeroMem (&InitContext, sizeof (InitContext));
+  UT_ASSERT_NOT_EFI_ERROR (
+    mTestParallelInit->RunParallel (mTestParallelInit, TEST_IMAGE_HANDLE, TestInitProcedure, TestInitCompletion, &InitContext)
+    );
+  UT_ASSERT_EQUAL (gEfiCurrentTpl, TPL_APPLICATION);
+  UT_ASSERT_TRUE (mTestAps[2].Busy);
+  UT_ASSERT_TRUE (mTestAps[2].Argument == &InitContext);
+  UT_ASSERT_EQUAL (InitContext.ProcedureRuns, 0);
+  UT_ASSERT_EQUAL (mTestOpenEvents, 1);
+
+  //
+  // Nothing is completed while the AP still runs the procedure.
+  //
+  UT_ASSERT_FALSE (CoreCompleteParallelDriverInits (FALSE));
+  UT_ASSERT_EQUAL (InitContext.CompletionRuns, 0);
+
+  UT_ASSERT_TRUE (TestFinishAp (2));
+  UT_ASSERT_EQUAL (InitContext.ProcedureRuns, 1);
+  UT_ASSERT_EQUAL (InitContext.CompletionRuns, 0);
+
+  UT_ASSERT_TRUE (CoreCompleteParallelDriverInits (TRUE));
+  UT_ASSERT_EQUAL (InitContext.CompletionRuns, 1);
+  UT_ASSERT_EQUAL (mTestOpenEvents, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Jobs are completed in the order their APs return, and a job handed over by
+  a completion is picked up by a later call.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CompletesFinishedJobs (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_INIT_CONTEXT  InitContexts[TEST_PROCESSOR_COUNT];
+  UINTN              Index;
+
+  ZeroMem (InitContexts, sizeof (InitContexts));
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (
+      mTestParallelInit->RunParallel (mTestParallelInit, TEST_IMAGE_HANDLE, TestInitProcedure, TestInitCompletion, &InitContexts[Index])
+      );
+    UT_ASSERT_TRUE (mTestAps[Index].Argument == &InitContexts[Index]);
+  }
+
+  InitContexts[2].RunParallelInCompletion = TRUE;
+
+  //
+  // Every AP is busy, so the next driver runs in line.
+  //
+  UT_ASSERT_TRUE (TestRunsInLine (&InitContexts[0]));
+  UT_ASSERT_EQUAL (mTestOpenEvents, TEST_PROCESSOR_COUNT - 1);
+
+  //
+  // Only the job of AP 3 is completed.
+  //
+  UT_ASSERT_TRUE (TestFinishAp (3));
+  UT_ASSERT_TRUE (CoreCompleteParallelDriverInits (FALSE));
+  UT_ASSERT_EQUAL (InitContexts[3].CompletionRuns, 1);
+  UT_ASSERT_EQUAL (InitContexts[1].CompletionRuns, 0);
+  UT_ASSERT_EQUAL (InitContexts[2].CompletionRuns, 0);
+  UT_ASSERT_FALSE (CoreCompleteParallelDriverInits (FALSE));
+
+  //
+  // The completion of the job of AP 2 starts another job on the first idle AP.
+  //
+  UT_ASSERT_TRUE (TestFinishAp (2));
+  UT_ASSERT_TRUE (TestFinishAp (1));
+  UT_ASSERT_TRUE (CoreCompleteParallelDriverInits (FALSE));
+  UT_ASSERT_EQUAL (InitContexts[1].CompletionRuns, 1);
+  UT_ASSERT_EQUAL (InitContexts[2].CompletionRuns, 1);
+  UT_ASSERT_TRUE (mTestAps[1].Busy);
+  UT_ASSERT_TRUE (mTestAps[1].Argument == &mTestChainedContext);
+  UT_ASSERT_EQUAL (mTestOpenEvents, 1);
+
+  UT_ASSERT_TRUE (TestFinishAp (1));
+  UT_ASSERT_TRUE (CoreCompleteParallelDriverInits (TRUE));
+  UT_ASSERT_EQUAL (mTestChainedContext.ProcedureRuns, 1);
+  UT_ASSERT_EQUAL (mTestChainedContext.CompletionRuns, 1);
+
+  UT_ASSERT_TRUE (InitContexts[0].CompletionOrder < InitContexts[3].CompletionOrder);
+  UT_ASSERT_TRUE (InitContexts[3].CompletionOrder < mTestChainedContext.CompletionOrder);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  CoreWaitForParallelDriverInitAps() returns once every AP running an init
+  phase is idle, and does not wait at TPL_NOTIFY, where the MP Services
+  protocol cannot mark an AP idle.
+
+  @param  Context                Not used.
+
+  @retval UNIT_TEST_PASSED       The test passed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WaitsForBusyAps (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_INIT_CONTEXT  InitContexts[TEST_PROCESSOR_COUNT];
+  UINTN              Index;
+
+  //
+  // No phase is running.
+  //
+  CoreWaitForParallelDriverInitAps ();
+
+  ZeroMem (InitContexts, sizeof (InitContexts));
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (
+      mTestParallelInit->RunParallel (mTestParallelInit, TEST_IMAGE_HANDLE, TestInitProcedure, TestInitCompletion, &InitContexts[Index])
+      );
+    UT_ASSERT_NOT_NULL (mTestAps[Index].Finished);
+    UT_ASSERT_FALSE (*mTestAps[Index].Finished);
+  }
+
+  //
+  // The AP of the first phase is still busy.
+  //
+  UT_ASSERT_TRUE (TestFinishAp (2));
+  UT_ASSERT_TRUE (TestFinishAp (3));
+  gEfiCurrentTpl = TPL_NOTIFY;
+  CoreWaitForParallelDriverInitAps ();
+  gEfiCurrentTpl = TPL_APPLICATION;
+  UT_ASSERT_TRUE (mTestAps[1].Busy);
+
+  UT_ASSERT_TRUE (TestFinishAp (1));
+  CoreWaitForParallelDriverInitAps ();
+
+  //
+  // The completions are left to the dispatcher.
+  //
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    UT_ASSERT_EQUAL (InitContexts[Index].ProcedureRuns, 1);
+    UT_ASSERT_EQUAL (InitContexts[Index].CompletionRuns, 0);
+  }
+
+  UT_ASSERT_TRUE (CoreCompleteParallelDriverInits (TRUE));
+  for (Index = 1; Index < TEST_PROCESSOR_COUNT; Index++) {
+    UT_ASSERT_EQUAL (InitContexts[Index].CompletionRuns, 1);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  parallel driver init of the DXE core, and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ParallelInitTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&ParallelInitTests, Framework, "Parallel Driver Init Tests", "ParallelInit", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the parallel driver init tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (ParallelInitTests, "RunParallel() checks its parameters", "RunParallelChecksParameters", RunParallelChecksParameters, ParallelInitSetup, ParallelInitCleanup, NULL);
+  AddTestCase (ParallelInitTests, "Init phases run in line without an idle AP", "RunsInLineWithoutIdleAp", RunsInLineWithoutIdleAp, ParallelInitSetup, ParallelInitCleanup, NULL);
+  AddTestCase (ParallelInitTests, "Init phases run on an idle AP", "RunsOnIdleAp", RunsOnIdleAp, ParallelInitSetup, ParallelInitCleanup, NULL);
+  AddTestCase (ParallelInitTests, "Finished init phases are completed", "CompletesFinishedJobs", CompletesFinishedJobs, ParallelInitSetup, ParallelInitCleanup, NULL);
+  AddTestCase (ParallelInitTests, "Busy APs are waited for", "WaitsForBusyAps", WaitsForBusyAps, ParallelInitSetup, ParallelInitCleanup, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
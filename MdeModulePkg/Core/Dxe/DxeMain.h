@@ -46,9 +46,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmBase2.h>
 #include <Protocol/PeCoffImageEmulator.h>
 #include <Protocol/MemoryAttribute.h>
+#include <Protocol/MpService.h>
+#include <Protocol/ParallelDriverInit.h>
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/FirmwareFileSystem2.h>
 #include <Guid/FirmwareFileSystem3.h>
+#include <Guid/FvFileIndex.h>
 #include <Guid/HobList.h>
 #include <Guid/DebugImageInfoTable.h>
 #include <Guid/FileInfo.h>
@@ -63,6 +66,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/VectorHandoffTable.h>
 #include <Ppi/VectorHandoffInfo.h>
 #include <Guid/MemoryProfile.h>
+#include <Guid/LzmaDecompress.h>
 
 #include <Library/DxeCoreEntryPoint.h>
 #include <Library/DebugLib.h>
@@ -86,6 +90,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugAgentLib.h>
 #include <Library/CpuExceptionHandlerLib.h>
 #include <Library/OrderedCollectionLib.h>
+#include <Library/SynchronizationLib.h>
+
+#include "Mem/MemoryMapTree.h"
 
 //
 // attributes for reserved memory before it is promoted to system memory
@@ -159,6 +166,16 @@ typedef struct {
   BOOLEAN                          Untrusted;
   BOOLEAN                          Initialized;
   BOOLEAN                          DepexProtocolError;
+  ///
+  /// TRUE if every protocol the DEPEX waits for is in the DEPEX waiter index,
+  /// so the DEPEX only needs to be evaluated again when DepexReevaluate is set.
+  ///
+  BOOLEAN                          DepexIndexed;
+  BOOLEAN                          DepexReevaluate;
+  ///
+  /// The entries of the DEPEX waiter index that point to this driver.
+  ///
+  LIST_ENTRY                       DepexWaiters;
 
   EFI_HANDLE                       ImageHandle;
   BOOLEAN                          IsFvImage;
@@ -179,8 +196,21 @@ typedef struct {
   EFI_GCD_IO_TYPE         GcdIoType;
   EFI_HANDLE              ImageHandle;
   EFI_HANDLE              DeviceHandle;
+  ///
+  /// Node of the index of the GCD map by base address
+  ///
+  MEMORY_MAP_TREE_NODE    TreeNode;
 } EFI_GCD_MAP_ENTRY;
 
+//
+// A memory region whose attributes are set by CoreSetMemorySpaceAttributesList()
+//
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    BaseAddress;
+  UINT64                  Length;
+  UINT64                  Attributes;
+} GCD_MEMORY_SPACE_RANGE;
+
 #define LOADED_IMAGE_PRIVATE_DATA_SIGNATURE  SIGNATURE_32('l','d','r','i')
 
 typedef struct {
@@ -441,6 +471,15 @@ CoreTimerTick (
   IN UINT64  Duration
   );
 
+/**
+  Reports the timer database activity counters through DEBUG output.
+
+**/
+VOID
+CoreDumpTimerStatistics (
+  VOID
+  );
+
 /**
   Initialize the dispatcher. Initialize the notification function that runs when
   an FV2 protocol is added to the system.
@@ -486,6 +525,71 @@ CorePreProcessDepex (
   IN  EFI_CORE_DRIVER_ENTRY  *DriverEntry
   );
 
+/**
+  Installs EDKII_PARALLEL_DRIVER_INIT_PROTOCOL.
+
+  The protocol is installed even if PcdDxeCoreParallelDriverInit is not set,
+  in which case both phases of the init of a driver run in line.
+
+  @retval EFI_SUCCESS           The protocol was installed.
+  @retval Others                The protocol could not be installed.
+
+**/
+EFI_STATUS
+CoreInitializeParallelDriverInit (
+  VOID
+  );
+
+/**
+  Runs the completion of the driver init phases that have finished on APs.
+
+  @param  Wait                  TRUE to wait for an init phase to finish if some
+                                are still running and none has finished yet.
+
+  @retval TRUE                  At least one completion has run.
+  @retval FALSE                 No completion has run.
+
+**/
+BOOLEAN
+CoreCompleteParallelDriverInits (
+  IN BOOLEAN  Wait
+  );
+
+/**
+  Waits for the driver init phases running on APs to return, so that every AP
+  is idle for EFI_MP_SERVICES_PROTOCOL.StartupAllAPs(). The completions of the
+  phases are left to the DXE dispatcher.
+
+**/
+VOID
+CoreWaitForParallelDriverInitAps (
+  VOID
+  );
+
+/**
+  Marks the DEPEX of every driver waiting for a protocol to be evaluated
+  again, as the protocol has just been installed.
+
+  @param  Protocol              The GUID of the installed protocol.
+
+**/
+VOID
+CoreDepexProtocolInstalled (
+  IN EFI_GUID  *Protocol
+  );
+
+/**
+  Removes a driver from the DEPEX waiter index, as its DEPEX no longer needs
+  to be evaluated once it is scheduled.
+
+  @param  DriverEntry           The driver leaving the Dependent state.
+
+**/
+VOID
+CoreRemoveDepexWaiters (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  );
+
 /**
   Terminates all boot services.
 
@@ -1738,6 +1842,38 @@ CoreSetMemorySpaceAttributes (
   IN UINT64                Attributes
   );
 
+/**
+  Modifies the attributes for several memory regions in the global coherency
+  domain of the processor.
+
+  The regions are sorted by base address, and adjacent regions with the same
+  CPU arch attributes are set in a single call to the CPU Arch Protocol. All
+  the regions are checked, and the GCD memory map entries covering them are
+  split, before any attribute is changed. If the CPU Arch Protocol fails, the
+  attributes already set through it are restored from the GCD memory map.
+
+  @param  RangeCount             Number of entries in Ranges
+  @param  Ranges                 The memory regions and their attributes. The
+                                 array is sorted in place.
+
+  @retval EFI_SUCCESS           The attributes were set for all the memory regions.
+  @retval EFI_INVALID_PARAMETER RangeCount is zero, Ranges is NULL, the length of
+                                a region is zero, or two regions overlap.
+  @retval EFI_UNSUPPORTED       The processor does not support one or more bytes of a
+                                memory region, or the attributes of a region are not
+                                supported for it.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough system resources to modify the
+                                attributes of the memory regions.
+  @retval EFI_NOT_AVAILABLE_YET The attributes cannot be set because CPU architectural
+                                protocol is not available yet.
+
+**/
+EFI_STATUS
+CoreSetMemorySpaceAttributesList (
+  IN     UINTN                   RangeCount,
+  IN OUT GCD_MEMORY_SPACE_RANGE  *Ranges
+  );
+
 /**
   Modifies the capabilities for a memory region in the global coherency domain of the
   processor.
@@ -2804,4 +2940,20 @@ CoreInitializeHandleServices (
   VOID
   );
 
+/**
+  Returns the index of the hash bucket of a GUID, in a hash table of GUIDs.
+
+  @param  Guid                   The GUID.
+  @param  BucketCount            The number of buckets of the table. Must be a
+                                 power of 2.
+
+  @return The index of the bucket of Guid, below BucketCount.
+
+**/
+UINTN
+CoreGetGuidHashIndex (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           BucketCount
+  );
+
 #endif
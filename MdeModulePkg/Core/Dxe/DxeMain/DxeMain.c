@@ -516,6 +516,12 @@ DxeMain (
              );
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Publish the Parallel Driver Init protocol for the DXE drivers with a long init
+  //
+  Status = CoreInitializeParallelDriverInit ();
+  ASSERT_EFI_ERROR (Status);
+
   //
   // Register for the GUIDs of the Architectural Protocols, so the rest of the
   // EFI Boot Services and EFI Runtime Services tables can be filled in.
@@ -790,6 +796,10 @@ CoreExitBootServices (
     mExitBootServicesCalled = TRUE;
   }
 
+  DEBUG_CODE_BEGIN ();
+  CoreDumpTimerStatistics ();
+  DEBUG_CODE_END ();
+
   //
   // Disable Timer
   //
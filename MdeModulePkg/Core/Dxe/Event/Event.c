@@ -450,6 +450,18 @@ CoreCreateEventInternal (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Reserve room in the timer database, so that arming the timer later
+  // does not need to allocate memory
+  //
+  if ((Type & EVT_TIMER) != 0) {
+    Status = CoreReserveEventTimer ();
+    if (EFI_ERROR (Status)) {
+      FreePool (IEvent);
+      return Status;
+    }
+  }
+
   IEvent->Signature = EVENT_SIGNATURE;
   IEvent->Type      = Type;
 
@@ -719,6 +731,7 @@ CoreCloseEvent (
   //
   if ((Event->Type & EVT_TIMER) != 0) {
     CoreSetTimer (Event, TimerCancel, 0);
+    CoreReleaseEventTimer ();
   }
 
   CoreAcquireEventLock ();
@@ -30,11 +30,28 @@ extern  UINTN  gEventPending;
 /// Timer event information
 ///
 typedef struct {
-  LIST_ENTRY    Link;
-  UINT64        TriggerTime;
-  UINT64        Period;
+  ///
+  /// One-based slot in the timer heap, 0 if the timer is not queued
+  ///
+  UINTN     HeapIndex;
+  UINT64    InsertSequence;
+  UINT64    TriggerTime;
+  UINT64    Period;
 } TIMER_EVENT_INFO;
 
+///
+/// Timer activity counters. CoreTimerTick() updates TickCount with the system
+/// time lock held, the timer services update the others with the timer lock.
+///
+typedef struct {
+  UINT64    TickCount;
+  UINT64    CheckCount;
+  UINT64    InsertCount;
+  UINT64    ExpireCount;
+  UINTN     MaxExpirePerCheck;
+  UINTN     MaxQueueDepth;
+} TIMER_STATISTICS;
+
 #define EVENT_SIGNATURE  SIGNATURE_32('e','v','n','t')
 typedef struct {
   UINTN                      Signature;
@@ -85,4 +102,27 @@ CoreInitializeTimer (
   VOID
   );
 
+/**
+  Reserves a slot of the timer database for a new timer event, growing the
+  database if needed. Must be called at a TPL where memory can be allocated.
+
+  @retval EFI_SUCCESS            A slot has been reserved.
+  @retval EFI_OUT_OF_RESOURCES   The timer database could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveEventTimer (
+  VOID
+  );
+
+/**
+  Releases the slot of the timer database reserved for a timer event that
+  is being closed. The timer event must not be queued.
+
+**/
+VOID
+CoreReleaseEventTimer (
+  VOID
+  );
+
 #endif
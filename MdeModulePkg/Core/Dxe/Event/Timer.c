@@ -13,17 +13,176 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // Internal data
 //
 
-LIST_ENTRY  mEfiTimerList       = INITIALIZE_LIST_HEAD_VARIABLE (mEfiTimerList);
-EFI_LOCK    mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
-EFI_EVENT   mEfiCheckTimerEvent = NULL;
+EFI_LOCK   mEfiTimerLock       = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL - 1);
+EFI_EVENT  mEfiCheckTimerEvent = NULL;
 
 EFI_LOCK  mEfiSystemTimeLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_HIGH_LEVEL);
 UINT64    mEfiSystemTime     = 0;
 
+//
+// The timer database is a binary min-heap of the queued timer events, ordered
+// by trigger time and then by insertion order. Every timer event reserves a
+// slot when it is created, so queuing a timer never allocates memory.
+//
+IEVENT  **mEfiTimerHeap        = NULL;
+UINTN   mEfiTimerHeapCount     = 0;
+UINTN   mEfiTimerHeapCapacity  = 0;
+UINTN   mEfiTimerHeapReserved  = 0;
+UINT64  mEfiTimerInsertCounter = 0;
+
+//
+// Trigger time of the head of the timer heap. It is checked by CoreTimerTick(),
+// which cannot take the timer lock, so it is protected by mEfiSystemTimeLock.
+//
+UINT64  mEfiTimerNextTriggerTime = MAX_UINT64;
+
+//
+// Timer activity counters. TickCount is protected by mEfiSystemTimeLock, the
+// other counters by mEfiTimerLock.
+//
+TIMER_STATISTICS  mEfiTimerStatistics;
+
+#define TIMER_HEAP_INITIAL_CAPACITY  64
+
 //
 // Timer functions
 //
 
+/**
+  Checks if a queued timer event expires before another one.
+
+  @param  Event1                 The first timer event
+  @param  Event2                 The second timer event
+
+  @retval TRUE                   Event1 expires before Event2.
+  @retval FALSE                  Event2 expires before Event1.
+
+**/
+STATIC
+BOOLEAN
+CoreTimerExpiresBefore (
+  IN IEVENT  *Event1,
+  IN IEVENT  *Event2
+  )
+{
+  if (Event1->Timer.TriggerTime != Event2->Timer.TriggerTime) {
+    return (BOOLEAN)(Event1->Timer.TriggerTime < Event2->Timer.TriggerTime);
+  }
+
+  return (BOOLEAN)(Event1->Timer.InsertSequence < Event2->Timer.InsertSequence);
+}
+
+/**
+  Stores a timer event into a slot of the timer heap.
+
+  @param  Index                  The slot of the timer heap
+  @param  Event                  The timer event
+
+**/
+STATIC
+VOID
+CoreSetTimerHeapSlot (
+  IN UINTN   Index,
+  IN IEVENT  *Event
+  )
+{
+  mEfiTimerHeap[Index]   = Event;
+  Event->Timer.HeapIndex = Index + 1;
+}
+
+/**
+  Moves a timer event towards the root of the timer heap until the heap
+  order is restored.
+
+  @param  Index                  The slot of the timer event to move
+
+**/
+STATIC
+VOID
+CoreTimerHeapSiftUp (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+  UINTN   Parent;
+
+  Event = mEfiTimerHeap[Index];
+  while (Index > 0) {
+    Parent = (Index - 1) / 2;
+    if (!CoreTimerExpiresBefore (Event, mEfiTimerHeap[Parent])) {
+      break;
+    }
+
+    CoreSetTimerHeapSlot (Index, mEfiTimerHeap[Parent]);
+    Index = Parent;
+  }
+
+  CoreSetTimerHeapSlot (Index, Event);
+}
+
+/**
+  Moves a timer event towards the leaves of the timer heap until the heap
+  order is restored.
+
+  @param  Index                  The slot of the timer event to move
+
+**/
+STATIC
+VOID
+CoreTimerHeapSiftDown (
+  IN UINTN  Index
+  )
+{
+  IEVENT  *Event;
+  UINTN   Child;
+
+  Event = mEfiTimerHeap[Index];
+  for ( ; ;) {
+    Child = 2 * Index + 1;
+    if (Child >= mEfiTimerHeapCount) {
+      break;
+    }
+
+    if ((Child + 1 < mEfiTimerHeapCount) &&
+        CoreTimerExpiresBefore (mEfiTimerHeap[Child + 1], mEfiTimerHeap[Child]))
+    {
+      Child++;
+    }
+
+    if (!CoreTimerExpiresBefore (mEfiTimerHeap[Child], Event)) {
+      break;
+    }
+
+    CoreSetTimerHeapSlot (Index, mEfiTimerHeap[Child]);
+    Index = Child;
+  }
+
+  CoreSetTimerHeapSlot (Index, Event);
+}
+
+/**
+  Updates the cached trigger time of the head of the timer heap.
+
+**/
+STATIC
+VOID
+CoreUpdateNextTriggerTime (
+  VOID
+  )
+{
+  UINT64  TriggerTime;
+
+  if (mEfiTimerHeapCount == 0) {
+    TriggerTime = MAX_UINT64;
+  } else {
+    TriggerTime = mEfiTimerHeap[0]->Timer.TriggerTime;
+  }
+
+  CoreAcquireLock (&mEfiSystemTimeLock);
+  mEfiTimerNextTriggerTime = TriggerTime;
+  CoreReleaseLock (&mEfiSystemTimeLock);
+}
+
 /**
   Inserts the timer event.
 
@@ -36,29 +195,132 @@ CoreInsertEventTimer (
   IN IEVENT  *Event
   )
 {
-  UINT64      TriggerTime;
-  LIST_ENTRY  *Link;
-  IEVENT      *Event2;
+  ASSERT_LOCKED (&mEfiTimerLock);
+  ASSERT (Event->Timer.HeapIndex == 0);
+  ASSERT (mEfiTimerHeapCount < mEfiTimerHeapCapacity);
+
+  Event->Timer.InsertSequence = mEfiTimerInsertCounter++;
+
+  mEfiTimerHeapCount++;
+  CoreSetTimerHeapSlot (mEfiTimerHeapCount - 1, Event);
+  CoreTimerHeapSiftUp (mEfiTimerHeapCount - 1);
+  CoreUpdateNextTriggerTime ();
+
+  mEfiTimerStatistics.InsertCount++;
+  if (mEfiTimerHeapCount > mEfiTimerStatistics.MaxQueueDepth) {
+    mEfiTimerStatistics.MaxQueueDepth = mEfiTimerHeapCount;
+  }
+}
+
+/**
+  Removes the timer event from the timer database.
+
+  @param  Event                  Points to the internal structure of timer event
+                                 to be removed
+
+**/
+STATIC
+VOID
+CoreRemoveEventTimer (
+  IN IEVENT  *Event
+  )
+{
+  UINTN   Index;
+  IEVENT  *Last;
 
   ASSERT_LOCKED (&mEfiTimerLock);
+  ASSERT (Event->Timer.HeapIndex != 0);
 
-  //
-  // Get the timer's trigger time
-  //
-  TriggerTime = Event->Timer.TriggerTime;
+  Index                  = Event->Timer.HeapIndex - 1;
+  Event->Timer.HeapIndex = 0;
 
-  //
-  // Insert the timer into the timer database in assending sorted order
-  //
-  for (Link = mEfiTimerList.ForwardLink; Link != &mEfiTimerList; Link = Link->ForwardLink) {
-    Event2 = CR (Link, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  mEfiTimerHeapCount--;
+  if (Index != mEfiTimerHeapCount) {
+    Last = mEfiTimerHeap[mEfiTimerHeapCount];
+    CoreSetTimerHeapSlot (Index, Last);
+    CoreTimerHeapSiftDown (Index);
+    CoreTimerHeapSiftUp (Last->Timer.HeapIndex - 1);
+  }
 
-    if (Event2->Timer.TriggerTime > TriggerTime) {
-      break;
+  mEfiTimerHeap[mEfiTimerHeapCount] = NULL;
+  CoreUpdateNextTriggerTime ();
+}
+
+/**
+  Reserves a slot of the timer database for a new timer event, growing the
+  database if needed. Must be called at a TPL where memory can be allocated.
+
+  @retval EFI_SUCCESS            A slot has been reserved.
+  @retval EFI_OUT_OF_RESOURCES   The timer database could not be grown.
+
+**/
+EFI_STATUS
+CoreReserveEventTimer (
+  VOID
+  )
+{
+  IEVENT  **NewHeap;
+  IEVENT  **OldHeap;
+  UINTN   NewCapacity;
+
+  for ( ; ;) {
+    CoreAcquireLock (&mEfiTimerLock);
+    if (mEfiTimerHeapReserved < mEfiTimerHeapCapacity) {
+      mEfiTimerHeapReserved++;
+      CoreReleaseLock (&mEfiTimerLock);
+      return EFI_SUCCESS;
+    }
+
+    NewCapacity = MAX (mEfiTimerHeapCapacity * 2, TIMER_HEAP_INITIAL_CAPACITY);
+    CoreReleaseLock (&mEfiTimerLock);
+
+    NewHeap = AllocateZeroPool (NewCapacity * sizeof (IEVENT *));
+    if (NewHeap == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    //
+    // Another caller may have grown the database while the lock was released
+    //
+    OldHeap = NULL;
+    CoreAcquireLock (&mEfiTimerLock);
+    if (NewCapacity > mEfiTimerHeapCapacity) {
+      if (mEfiTimerHeapCount != 0) {
+        CopyMem (NewHeap, mEfiTimerHeap, mEfiTimerHeapCount * sizeof (IEVENT *));
+      }
+
+      OldHeap               = mEfiTimerHeap;
+      mEfiTimerHeap         = NewHeap;
+      mEfiTimerHeapCapacity = NewCapacity;
+      NewHeap               = NULL;
+    }
+
+    CoreReleaseLock (&mEfiTimerLock);
+
+    if (OldHeap != NULL) {
+      FreePool (OldHeap);
+    }
+
+    if (NewHeap != NULL) {
+      FreePool (NewHeap);
     }
   }
+}
 
-  InsertTailList (Link, &Event->Timer.Link);
+/**
+  Releases the slot of the timer database reserved for a timer event that
+  is being closed. The timer event must not be queued.
+
+**/
+VOID
+CoreReleaseEventTimer (
+  VOID
+  )
+{
+  CoreAcquireLock (&mEfiTimerLock);
+  ASSERT (mEfiTimerHeapReserved > 0);
+  mEfiTimerHeapReserved--;
+  CoreReleaseLock (&mEfiTimerLock);
 }
 
 /**
@@ -98,15 +360,17 @@ CoreCheckTimers (
 {
   UINT64  SystemTime;
   IEVENT  *Event;
+  UINTN   Expired;
 
   //
   // Check the timer database for expired timers
   //
   CoreAcquireLock (&mEfiTimerLock);
   SystemTime = CoreCurrentSystemTime ();
+  Expired    = 0;
 
-  while (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
+  while (mEfiTimerHeapCount != 0) {
+    Event = mEfiTimerHeap[0];
 
     //
     // If this timer is not expired, then we're done
@@ -119,8 +383,8 @@ CoreCheckTimers (
     // Remove this timer from the timer queue
     //
 
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+    CoreRemoveEventTimer (Event);
+    Expired++;
 
     //
     // Signal it
@@ -151,6 +415,12 @@ CoreCheckTimers (
     }
   }
 
+  mEfiTimerStatistics.CheckCount++;
+  mEfiTimerStatistics.ExpireCount += Expired;
+  if (Expired > mEfiTimerStatistics.MaxExpirePerCheck) {
+    mEfiTimerStatistics.MaxExpirePerCheck = Expired;
+  }
+
   CoreReleaseLock (&mEfiTimerLock);
 }
 
@@ -189,8 +459,6 @@ CoreTimerTick (
   IN UINT64  Duration
   )
 {
-  IEVENT  *Event;
-
   //
   // Check runtiem flag in case there are ticks while exiting boot services
   //
@@ -200,17 +468,14 @@ CoreTimerTick (
   // Update the system time
   //
   mEfiSystemTime += Duration;
+  mEfiTimerStatistics.TickCount++;
 
   //
-  // If the head of the list is expired, fire the timer event
+  // If the head of the timer database is expired, fire the timer event
   // to process it
   //
-  if (!IsListEmpty (&mEfiTimerList)) {
-    Event = CR (mEfiTimerList.ForwardLink, IEVENT, Timer.Link, EVENT_SIGNATURE);
-
-    if (Event->Timer.TriggerTime <= mEfiSystemTime) {
-      CoreSignalEvent (mEfiCheckTimerEvent);
-    }
+  if (mEfiTimerNextTriggerTime <= mEfiSystemTime) {
+    CoreSignalEvent (mEfiCheckTimerEvent);
   }
 
   CoreReleaseLock (&mEfiSystemTimeLock);
@@ -260,9 +525,8 @@ CoreSetTimer (
   //
   // If the timer is queued to the timer database, remove it
   //
-  if (Event->Timer.Link.ForwardLink != NULL) {
-    RemoveEntryList (&Event->Timer.Link);
-    Event->Timer.Link.ForwardLink = NULL;
+  if (Event->Timer.HeapIndex != 0) {
+    CoreRemoveEventTimer (Event);
   }
 
   Event->Timer.TriggerTime = 0;
@@ -289,3 +553,60 @@ CoreSetTimer (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Reports the timer database activity counters through DEBUG output.
+
+**/
+VOID
+CoreDumpTimerStatistics (
+  VOID
+  )
+{
+  TIMER_STATISTICS  Statistics;
+  UINT64            InsertRate;
+  UINT64            ExpireRate;
+  UINT32            InsertRemainder;
+  UINT32            ExpireRemainder;
+
+  CoreAcquireLock (&mEfiTimerLock);
+  CopyMem (&Statistics, &mEfiTimerStatistics, sizeof (Statistics));
+  CoreReleaseLock (&mEfiTimerLock);
+
+  CoreAcquireLock (&mEfiSystemTimeLock);
+  Statistics.TickCount = mEfiTimerStatistics.TickCount;
+  CoreReleaseLock (&mEfiSystemTimeLock);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Timer: %ld ticks, %ld checks, %ld inserts, %ld expirations\n",
+    Statistics.TickCount,
+    Statistics.CheckCount,
+    Statistics.InsertCount,
+    Statistics.ExpireCount
+    ));
+  if (Statistics.TickCount != 0) {
+    //
+    // Per tick rates in hundredths
+    //
+    InsertRate = DivU64x64Remainder (MultU64x32 (Statistics.InsertCount, 100), Statistics.TickCount, NULL);
+    ExpireRate = DivU64x64Remainder (MultU64x32 (Statistics.ExpireCount, 100), Statistics.TickCount, NULL);
+    InsertRate = DivU64x32Remainder (InsertRate, 100, &InsertRemainder);
+    ExpireRate = DivU64x32Remainder (ExpireRate, 100, &ExpireRemainder);
+    DEBUG ((
+      DEBUG_INFO,
+      "Timer: %ld.%02d inserts/tick, %ld.%02d expirations/tick\n",
+      InsertRate,
+      InsertRemainder,
+      ExpireRate,
+      ExpireRemainder
+      ));
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Timer: max %ld expirations per check, max %ld queued timers\n",
+    (UINT64)Statistics.MaxExpirePerCheck,
+    (UINT64)Statistics.MaxQueueDepth
+    ));
+}
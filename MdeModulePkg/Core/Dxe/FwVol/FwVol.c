@@ -296,6 +296,63 @@ FreeFvDeviceResource (
   return;
 }
 
+/**
+  Build the FFS file list of a memory mapped FV from the FV file index HOB
+  the PEI Core published for it, if there is one.
+
+  The PEI Core has already verified the header and data checksums of every
+  file in the index, so the files are neither checked nor cached again.
+
+  @param  FvDevice              A pointer to the FvDevice whose list is built.
+
+  @retval EFI_SUCCESS           The file list was built from the index.
+  @retval EFI_NOT_FOUND         There is no index for this FV.
+  @retval EFI_OUT_OF_RESOURCES  No enough buffer could be allocated.
+
+**/
+EFI_STATUS
+FvBuildFileListFromIndex (
+  IN OUT FV_DEVICE  *FvDevice
+  )
+{
+  EFI_HOB_GUID_TYPE    *GuidHob;
+  EDKII_FV_FILE_INDEX  *FileIndex;
+  UINT32               *FileOffset;
+  FFS_FILE_LIST_ENTRY  *FfsFileEntry;
+  UINT32               Index;
+
+  FileIndex = NULL;
+  GuidHob   = GetFirstGuidHob (&gEdkiiFvFileIndexGuid);
+  while (GuidHob != NULL) {
+    FileIndex = GET_GUID_HOB_DATA (GuidHob);
+    if ((FileIndex->FvBase == (EFI_PHYSICAL_ADDRESS)(UINTN)FvDevice->CachedFv) &&
+        (FileIndex->FvLength == FvDevice->FwVolHeader->FvLength))
+    {
+      break;
+    }
+
+    GuidHob = GetNextGuidHob (&gEdkiiFvFileIndexGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  if (GuidHob == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  FileOffset = EDKII_FV_FILE_INDEX_OFFSETS (FileIndex);
+  for (Index = 0; Index < FileIndex->FileCount; Index++) {
+    FfsFileEntry = AllocateZeroPool (sizeof (FFS_FILE_LIST_ENTRY));
+    if (FfsFileEntry == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    FfsFileEntry->FfsHeader = (EFI_FFS_FILE_HEADER *)(FvDevice->CachedFv + FileOffset[Index]);
+    InsertTailList (&FvDevice->FfsFileListHeader, &FfsFileEntry->Link);
+  }
+
+  DEBUG ((DEBUG_INFO, "FV at %p: %d files from the PEI file index\n", FvDevice->CachedFv, FileIndex->FileCount));
+  return EFI_SUCCESS;
+}
+
 /**
   Check if an FV is consistent and allocate cache for it.
 
@@ -364,6 +421,8 @@ FvCheck (
     }
   }
 
+  PERF_INMODULE_BEGIN ("FvCheck");
+
   //
   // Remember a pointer to the end of the CachedFv
   //
@@ -421,6 +480,15 @@ FvCheck (
   Status = EFI_SUCCESS;
   InitializeListHead (&FvDevice->FfsFileListHeader);
 
+  if (FvDevice->IsMemoryMapped) {
+    Status = FvBuildFileListFromIndex (FvDevice);
+    if (Status != EFI_NOT_FOUND) {
+      goto Done;
+    }
+
+    Status = EFI_SUCCESS;
+  }
+
   //
   // Build FFS list
   //
@@ -552,6 +620,8 @@ FvCheck (
   }
 
 Done:
+  PERF_INMODULE_END ("FvCheck");
+
   if (EFI_ERROR (Status)) {
     if (FileCached) {
       CoreFreePool (CacheFfsHeader);
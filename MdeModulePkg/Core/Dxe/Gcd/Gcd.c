@@ -46,6 +46,19 @@ EFI_LOCK    mGcdIoSpaceLock     = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 LIST_ENTRY  mGcdMemorySpaceMap  = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
 LIST_ENTRY  mGcdIoSpaceMap      = INITIALIZE_LIST_HEAD_VARIABLE (mGcdIoSpaceMap);
 
+VOID
+CoreGcdMapEntryRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+//
+// Indexes of the GCD maps by base address
+//
+MEMORY_MAP_TREE  mGcdMemorySpaceTree = { NULL, 0, CoreGcdMapEntryRange };
+MEMORY_MAP_TREE  mGcdIoSpaceTree     = { NULL, 0, CoreGcdMapEntryRange };
+
 EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EFI_GCD_MAP_SIGNATURE,
   {
@@ -59,7 +72,8 @@ EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate = {
   EfiGcdMemoryTypeNonExistent,
   (EFI_GCD_IO_TYPE)0,
   NULL,
-  NULL
+  NULL,
+  { NULL, NULL, NULL, FALSE, 0 }
 };
 
 EFI_GCD_MAP_ENTRY  mGcdIoSpaceMapEntryTemplate = {
@@ -75,7 +89,8 @@ EFI_GCD_MAP_ENTRY  mGcdIoSpaceMapEntryTemplate = {
   (EFI_GCD_MEMORY_TYPE)0,
   EfiGcdIoTypeNonExistent,
   NULL,
-  NULL
+  NULL,
+  { NULL, NULL, NULL, FALSE, 0 }
 };
 
 GCD_ATTRIBUTE_CONVERSION_ENTRY  mAttributeConversionTable[] = {
@@ -391,6 +406,49 @@ PageAlignLength (
 // GCD Memory Space Worker Functions
 //
 
+/**
+  Internal function.  Returns the range of a GCD map entry in the index.
+
+  @param  Node                   The tree node of the entry
+  @param  Start                  The base address of the entry
+  @param  End                    The end address of the entry
+
+**/
+VOID
+CoreGcdMapEntryRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  )
+{
+  EFI_GCD_MAP_ENTRY  *Entry;
+
+  Entry  = CR (Node, EFI_GCD_MAP_ENTRY, TreeNode, EFI_GCD_MAP_SIGNATURE);
+  *Start = Entry->BaseAddress;
+  *End   = Entry->EndAddress;
+}
+
+/**
+  Internal function.  Returns the index of a GCD map.
+
+  @param  Map                    The GCD memory or I/O space map
+
+  @return The index of Map by base address.
+
+**/
+MEMORY_MAP_TREE *
+CoreGetGcdMapTree (
+  IN LIST_ENTRY  *Map
+  )
+{
+  if (Map == &mGcdMemorySpaceMap) {
+    return &mGcdMemorySpaceTree;
+  }
+
+  ASSERT (Map == &mGcdIoSpaceMap);
+  return &mGcdIoSpaceTree;
+}
+
 /**
   Allocate pool for two entries.
 
@@ -440,6 +498,7 @@ CoreAllocateGcdMapEntry (
   @param  Length                 The length of the new range in bytes
   @param  TopEntry               Top pad entry to insert if needed.
   @param  BottomEntry            Bottom pad entry to insert if needed.
+  @param  Map                    The GCD map that Link belongs to.
 
   @retval EFI_SUCCESS            The new range was inserted into the linked list
 
@@ -451,11 +510,16 @@ CoreInsertGcdMapEntry (
   IN EFI_PHYSICAL_ADDRESS  BaseAddress,
   IN UINT64                Length,
   IN EFI_GCD_MAP_ENTRY     *TopEntry,
-  IN EFI_GCD_MAP_ENTRY     *BottomEntry
+  IN EFI_GCD_MAP_ENTRY     *BottomEntry,
+  IN LIST_ENTRY            *Map
   )
 {
+  MEMORY_MAP_TREE  *Tree;
+
   ASSERT (Length != 0);
 
+  Tree = CoreGetGcdMapTree (Map);
+
   if (BaseAddress > Entry->BaseAddress) {
     ASSERT (BottomEntry->Signature == 0);
 
@@ -463,6 +527,8 @@ CoreInsertGcdMapEntry (
     Entry->BaseAddress      = BaseAddress;
     BottomEntry->EndAddress = BaseAddress - 1;
     InsertTailList (Link, &BottomEntry->Link);
+    MemoryMapTreeUpdate (Tree, &Entry->TreeNode);
+    MemoryMapTreeInsert (Tree, &BottomEntry->TreeNode);
   }
 
   if ((BaseAddress + Length - 1) < Entry->EndAddress) {
@@ -472,6 +538,8 @@ CoreInsertGcdMapEntry (
     TopEntry->BaseAddress = BaseAddress + Length;
     Entry->EndAddress     = BaseAddress + Length - 1;
     InsertHeadList (Link, &TopEntry->Link);
+    MemoryMapTreeUpdate (Tree, &Entry->TreeNode);
+    MemoryMapTreeInsert (Tree, &TopEntry->TreeNode);
   }
 
   return EFI_SUCCESS;
@@ -543,12 +611,16 @@ CoreMergeGcdMapEntry (
     return EFI_UNSUPPORTED;
   }
 
+  MemoryMapTreeRemove (CoreGetGcdMapTree (Map), &AdjacentEntry->TreeNode);
+
   if (Forward) {
     Entry->EndAddress = AdjacentEntry->EndAddress;
   } else {
     Entry->BaseAddress = AdjacentEntry->BaseAddress;
   }
 
+  MemoryMapTreeUpdate (CoreGetGcdMapTree (Map), &Entry->TreeNode);
+
   RemoveEntryList (AdjacentLink);
   CoreFreePool (AdjacentEntry);
 
@@ -621,34 +693,46 @@ CoreSearchGcdMapEntry (
   IN  LIST_ENTRY            *Map
   )
 {
-  LIST_ENTRY         *Link;
-  EFI_GCD_MAP_ENTRY  *Entry;
+  MEMORY_MAP_TREE       *Tree;
+  MEMORY_MAP_TREE_NODE  *Node;
+  EFI_GCD_MAP_ENTRY     *StartEntry;
+  EFI_GCD_MAP_ENTRY     *EndEntry;
 
   ASSERT (Length != 0);
 
   *StartLink = NULL;
   *EndLink   = NULL;
 
-  Link = Map->ForwardLink;
-  while (Link != Map) {
-    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    if ((BaseAddress >= Entry->BaseAddress) && (BaseAddress <= Entry->EndAddress)) {
-      *StartLink = Link;
-    }
+  //
+  // Look up the entries that contain the first and the last address of the
+  // segment in the index of the map.
+  //
+  Tree = CoreGetGcdMapTree (Map);
+  Node = MemoryMapTreeFindFloor (Tree, BaseAddress);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
+  }
 
-    if (*StartLink != NULL) {
-      if (((BaseAddress + Length - 1) >= Entry->BaseAddress) &&
-          ((BaseAddress + Length - 1) <= Entry->EndAddress))
-      {
-        *EndLink = Link;
-        return EFI_SUCCESS;
-      }
-    }
+  StartEntry = CR (Node, EFI_GCD_MAP_ENTRY, TreeNode, EFI_GCD_MAP_SIGNATURE);
+  if (BaseAddress > StartEntry->EndAddress) {
+    return EFI_NOT_FOUND;
+  }
 
-    Link = Link->ForwardLink;
+  Node = MemoryMapTreeFindFloor (Tree, BaseAddress + Length - 1);
+  if (Node == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  EndEntry = CR (Node, EFI_GCD_MAP_ENTRY, TreeNode, EFI_GCD_MAP_SIGNATURE);
+  if (((BaseAddress + Length - 1) > EndEntry->EndAddress) ||
+      (EndEntry->BaseAddress < StartEntry->BaseAddress))
+  {
+    return EFI_NOT_FOUND;
   }
 
-  return EFI_NOT_FOUND;
+  *StartLink = &StartEntry->Link;
+  *EndLink   = &EndEntry->Link;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -664,17 +748,7 @@ CoreCountGcdMapEntry (
   IN LIST_ENTRY  *Map
   )
 {
-  UINTN       Count;
-  LIST_ENTRY  *Link;
-
-  Count = 0;
-  Link  = Map->ForwardLink;
-  while (Link != Map) {
-    Count++;
-    Link = Link->ForwardLink;
-  }
-
-  return Count;
+  return CoreGetGcdMapTree (Map)->Count;
 }
 
 /**
@@ -712,7 +786,67 @@ ConverToCpuArchAttributes (
 }
 
 /**
-  Do operation on a segment of memory space specified (add, free, remove, change attribute ...).
+  Check whether the attributes of a GCD memory map entry can be set.
+
+  @param  Entry                  The entry that covers part of the segment
+  @param  BaseAddress            Start address of the segment
+  @param  Length                 Length of the segment
+  @param  Attributes             The attributes to set
+
+  @retval EFI_SUCCESS            The attributes can be set.
+  @retval EFI_INVALID_PARAMETER  The segment is not page aligned for runtime
+                                 memory.
+  @retval EFI_UNSUPPORTED        The attributes are not supported by the entry.
+
+**/
+EFI_STATUS
+CoreCheckGcdMapEntryAttributes (
+  IN EFI_GCD_MAP_ENTRY     *Entry,
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length,
+  IN UINT64                Attributes
+  )
+{
+  if ((Attributes & EFI_MEMORY_RUNTIME) != 0) {
+    if (((BaseAddress & EFI_PAGE_MASK) != 0) || ((Length & EFI_PAGE_MASK) != 0)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  if ((Entry->Capabilities & Attributes) != Attributes) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Set the attributes of a GCD memory map entry.
+
+  @param  Entry                  The entry to update
+  @param  Attributes             The attributes to set
+
+**/
+VOID
+CoreSetGcdMapEntryAttributes (
+  IN EFI_GCD_MAP_ENTRY  *Entry,
+  IN UINT64             Attributes
+  )
+{
+  if ((ConverToCpuArchAttributes (Attributes) == 0) && (Attributes != 0)) {
+    //
+    // Keep original CPU arch attributes when caller just calls
+    // SetMemorySpaceAttributes() with none CPU arch attributes (for example, RUNTIME).
+    //
+    Attributes |= (Entry->Attributes & (EFI_CACHE_ATTRIBUTE_MASK | EFI_MEMORY_ATTRIBUTE_MASK));
+  }
+
+  Entry->Attributes = Attributes;
+}
+
+/**
+  Do operation on a segment of memory space specified, with the lock of the
+  GCD map held.
 
   @param  Operation              The type of the operation
   @param  GcdMemoryType          Additional information for the operation
@@ -721,33 +855,25 @@ ConverToCpuArchAttributes (
   @param  Length                 length of the segment
   @param  Capabilities           The alterable attributes of a newly added entry
   @param  Attributes             The attributes needs to be set
+  @param  Map                    The GCD map of the operation
 
-  @retval EFI_INVALID_PARAMETER  Length is 0 or address (length) not aligned when
-                                 setting attribute.
   @retval EFI_SUCCESS            Action successfully done.
-  @retval EFI_UNSUPPORTED        Could not find the proper descriptor on this
-                                 segment or  set an upsupported attribute.
-  @retval EFI_ACCESS_DENIED      Operate on an space non-exist or is used for an
-                                 image.
-  @retval EFI_NOT_FOUND          Free a non-using space or remove a non-exist
-                                 space, and so on.
-  @retval EFI_OUT_OF_RESOURCES   No buffer could be allocated.
-  @retval EFI_NOT_AVAILABLE_YET  The attributes cannot be set because CPU architectural protocol
-                                 is not available yet.
+  @retval Others                 See CoreConvertSpace().
+
 **/
 EFI_STATUS
-CoreConvertSpace (
+CoreConvertSpaceLocked (
   IN UINTN                 Operation,
   IN EFI_GCD_MEMORY_TYPE   GcdMemoryType,
   IN EFI_GCD_IO_TYPE       GcdIoType,
   IN EFI_PHYSICAL_ADDRESS  BaseAddress,
   IN UINT64                Length,
   IN UINT64                Capabilities,
-  IN UINT64                Attributes
+  IN UINT64                Attributes,
+  IN LIST_ENTRY            *Map
   )
 {
   EFI_STATUS         Status;
-  LIST_ENTRY         *Map;
   LIST_ENTRY         *Link;
   EFI_GCD_MAP_ENTRY  *Entry;
   EFI_GCD_MAP_ENTRY  *TopEntry;
@@ -756,22 +882,6 @@ CoreConvertSpace (
   LIST_ENTRY         *EndLink;
   UINT64             CpuArchAttributes;
 
-  if (Length == 0) {
-    DEBUG ((DEBUG_GCD, "  Status = %r\n", EFI_INVALID_PARAMETER));
-    return EFI_INVALID_PARAMETER;
-  }
-
-  Map = NULL;
-  if ((Operation & GCD_MEMORY_SPACE_OPERATION) != 0) {
-    CoreAcquireGcdMemoryLock ();
-    Map = &mGcdMemorySpaceMap;
-  } else if ((Operation & GCD_IO_SPACE_OPERATION) != 0) {
-    CoreAcquireGcdIoLock ();
-    Map = &mGcdIoSpaceMap;
-  } else {
-    ASSERT (FALSE);
-  }
-
   //
   // Search for the list of descriptors that cover the range BaseAddress to BaseAddress+Length
   //
@@ -854,15 +964,8 @@ CoreConvertSpace (
       // Set attributes operation
       //
       case GCD_SET_ATTRIBUTES_MEMORY_OPERATION:
-        if ((Attributes & EFI_MEMORY_RUNTIME) != 0) {
-          if (((BaseAddress & EFI_PAGE_MASK) != 0) || ((Length & EFI_PAGE_MASK) != 0)) {
-            Status = EFI_INVALID_PARAMETER;
-            goto Done;
-          }
-        }
-
-        if ((Entry->Capabilities & Attributes) != Attributes) {
-          Status = EFI_UNSUPPORTED;
+        Status = CoreCheckGcdMapEntryAttributes (Entry, BaseAddress, Length, Attributes);
+        if (EFI_ERROR (Status)) {
           goto Done;
         }
 
@@ -951,7 +1054,7 @@ CoreConvertSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, BaseAddress, Length, TopEntry, BottomEntry, Map);
     switch (Operation) {
       //
       // Add operations
@@ -990,15 +1093,7 @@ CoreConvertSpace (
       // Set attributes operation
       //
       case GCD_SET_ATTRIBUTES_MEMORY_OPERATION:
-        if ((CpuArchAttributes == 0) && (Attributes != 0)) {
-          //
-          // Keep original CPU arch attributes when caller just calls
-          // SetMemorySpaceAttributes() with none CPU arch attributes (for example, RUNTIME).
-          //
-          Attributes |= (Entry->Attributes & (EFI_CACHE_ATTRIBUTE_MASK | EFI_MEMORY_ATTRIBUTE_MASK));
-        }
-
-        Entry->Attributes = Attributes;
+        CoreSetGcdMapEntryAttributes (Entry, Attributes);
         break;
       //
       // Set capabilities operation
@@ -1031,6 +1126,82 @@ CoreConvertSpace (
   Status = CoreCleanupGcdMapEntry (TopEntry, BottomEntry, StartLink, EndLink, Map);
 
 Done:
+  return Status;
+}
+
+/**
+  Do operation on a segment of memory space specified (add, free, remove, change attribute ...).
+
+  @param  Operation              The type of the operation
+  @param  GcdMemoryType          Additional information for the operation
+  @param  GcdIoType              Additional information for the operation
+  @param  BaseAddress            Start address of the segment
+  @param  Length                 length of the segment
+  @param  Capabilities           The alterable attributes of a newly added entry
+  @param  Attributes             The attributes needs to be set
+
+  @retval EFI_INVALID_PARAMETER  Length is 0 or address (length) not aligned when
+                                 setting attribute.
+  @retval EFI_SUCCESS            Action successfully done.
+  @retval EFI_UNSUPPORTED        Could not find the proper descriptor on this
+                                 segment or  set an upsupported attribute.
+  @retval EFI_ACCESS_DENIED      Operate on an space non-exist or is used for an
+                                 image.
+  @retval EFI_NOT_FOUND          Free a non-using space or remove a non-exist
+                                 space, and so on.
+  @retval EFI_OUT_OF_RESOURCES   No buffer could be allocated.
+  @retval EFI_NOT_AVAILABLE_YET  The attributes cannot be set because CPU architectural protocol
+                                 is not available yet.
+**/
+EFI_STATUS
+CoreConvertSpace (
+  IN UINTN                 Operation,
+  IN EFI_GCD_MEMORY_TYPE   GcdMemoryType,
+  IN EFI_GCD_IO_TYPE       GcdIoType,
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length,
+  IN UINT64                Capabilities,
+  IN UINT64                Attributes
+  )
+{
+  EFI_STATUS  Status;
+  LIST_ENTRY  *Map;
+
+  if (Length == 0) {
+    DEBUG ((DEBUG_GCD, "  Status = %r\n", EFI_INVALID_PARAMETER));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // A cache attribute change is synchronized on every AP, which must not be
+  // busy with the init phase of a driver.
+  //
+  if (Operation == GCD_SET_ATTRIBUTES_MEMORY_OPERATION) {
+    CoreWaitForParallelDriverInitAps ();
+  }
+
+  Map = NULL;
+  if ((Operation & GCD_MEMORY_SPACE_OPERATION) != 0) {
+    CoreAcquireGcdMemoryLock ();
+    Map = &mGcdMemorySpaceMap;
+  } else if ((Operation & GCD_IO_SPACE_OPERATION) != 0) {
+    CoreAcquireGcdIoLock ();
+    Map = &mGcdIoSpaceMap;
+  } else {
+    ASSERT (FALSE);
+  }
+
+  Status = CoreConvertSpaceLocked (
+             Operation,
+             GcdMemoryType,
+             GcdIoType,
+             BaseAddress,
+             Length,
+             Capabilities,
+             Attributes,
+             Map
+             );
+
   DEBUG ((DEBUG_GCD, "  Status = %r\n", Status));
 
   if ((Operation & GCD_MEMORY_SPACE_OPERATION) != 0) {
@@ -1353,7 +1524,7 @@ CoreAllocateSpace (
   Link = StartLink;
   while (Link != EndLink->ForwardLink) {
     Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
-    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry);
+    CoreInsertGcdMapEntry (Link, Entry, *BaseAddress, Length, TopEntry, BottomEntry, Map);
     Entry->ImageHandle  = ImageHandle;
     Entry->DeviceHandle = DeviceHandle;
     Link                = Link->ForwardLink;
@@ -1705,6 +1876,344 @@ CoreSetMemorySpaceAttributes (
   return CoreConvertSpace (GCD_SET_ATTRIBUTES_MEMORY_OPERATION, (EFI_GCD_MEMORY_TYPE)0, (EFI_GCD_IO_TYPE)0, BaseAddress, Length, 0, Attributes);
 }
 
+/**
+  Compares the base addresses of two memory regions, for QuickSort().
+
+  @param  Buffer1                Pointer to the first GCD_MEMORY_SPACE_RANGE
+  @param  Buffer2                Pointer to the second GCD_MEMORY_SPACE_RANGE
+
+  @retval 0                      The base addresses are equal.
+  @retval >0                     Buffer1 is above Buffer2.
+  @retval <0                     Buffer1 is below Buffer2.
+
+**/
+INTN
+EFIAPI
+CoreCompareMemorySpaceRange (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST GCD_MEMORY_SPACE_RANGE  *Range1;
+  CONST GCD_MEMORY_SPACE_RANGE  *Range2;
+
+  Range1 = (CONST GCD_MEMORY_SPACE_RANGE *)Buffer1;
+  Range2 = (CONST GCD_MEMORY_SPACE_RANGE *)Buffer2;
+
+  if (Range1->BaseAddress > Range2->BaseAddress) {
+    return 1;
+  }
+
+  if (Range1->BaseAddress < Range2->BaseAddress) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/**
+  Internal function.  Splits the GCD memory map entries that cover a memory
+  region so that the region starts and ends on an entry boundary. The
+  attributes of the entries are not changed.
+  Caller must have the GCD memory lock held
+
+  @param  BaseAddress            Start address of the region
+  @param  Length                 Length of the region
+
+  @retval EFI_SUCCESS            The region is covered by whole entries.
+  @retval EFI_UNSUPPORTED        The region is not covered by the map.
+  @retval EFI_OUT_OF_RESOURCES   No buffer could be allocated.
+
+**/
+EFI_STATUS
+CoreSplitGcdMemoryMapEntries (
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length
+  )
+{
+  EFI_STATUS         Status;
+  LIST_ENTRY         *StartLink;
+  LIST_ENTRY         *EndLink;
+  EFI_GCD_MAP_ENTRY  *TopEntry;
+  EFI_GCD_MAP_ENTRY  *BottomEntry;
+
+  Status = CoreSearchGcdMapEntry (BaseAddress, Length, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = CoreAllocateGcdMapEntry (&TopEntry, &BottomEntry);
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The first entry is split below the region, and the last one above it
+  //
+  CoreInsertGcdMapEntry (
+    StartLink,
+    CR (StartLink, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE),
+    BaseAddress,
+    Length,
+    TopEntry,
+    BottomEntry,
+    &mGcdMemorySpaceMap
+    );
+  if (EndLink != StartLink) {
+    CoreInsertGcdMapEntry (
+      EndLink,
+      CR (EndLink, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE),
+      BaseAddress,
+      Length,
+      TopEntry,
+      BottomEntry,
+      &mGcdMemorySpaceMap
+      );
+  }
+
+  if (TopEntry->Signature == 0) {
+    CoreFreePool (TopEntry);
+  }
+
+  if (BottomEntry->Signature == 0) {
+    CoreFreePool (BottomEntry);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Internal function.  Merges the GCD memory map entries that cover a memory
+  region with each other and with their neighbors where possible.
+  Caller must have the GCD memory lock held
+
+  @param  BaseAddress            Start address of the region
+  @param  Length                 Length of the region
+
+**/
+VOID
+CoreMergeGcdMemoryMapEntries (
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length
+  )
+{
+  LIST_ENTRY  *StartLink;
+  LIST_ENTRY  *EndLink;
+  LIST_ENTRY  *Link;
+
+  if (EFI_ERROR (CoreSearchGcdMapEntry (BaseAddress, Length, &StartLink, &EndLink, &mGcdMemorySpaceMap))) {
+    return;
+  }
+
+  Link = StartLink;
+  while (Link != EndLink->ForwardLink) {
+    CoreMergeGcdMapEntry (Link, FALSE, &mGcdMemorySpaceMap);
+    Link = Link->ForwardLink;
+  }
+
+  CoreMergeGcdMapEntry (EndLink, TRUE, &mGcdMemorySpaceMap);
+}
+
+/**
+  Internal function.  Sets the CPU arch attributes that the GCD memory map
+  holds for memory regions back through the CPU Arch Protocol.
+  Caller must have the GCD memory lock held
+
+  @param  RangeCount             Number of entries in Ranges
+  @param  Ranges                 The memory regions, each covered by whole
+                                 entries of the GCD memory map
+
+**/
+VOID
+CoreRestoreCpuArchAttributes (
+  IN UINTN                   RangeCount,
+  IN GCD_MEMORY_SPACE_RANGE  *Ranges
+  )
+{
+  EFI_STATUS         Status;
+  LIST_ENTRY         *StartLink;
+  LIST_ENTRY         *EndLink;
+  LIST_ENTRY         *Link;
+  EFI_GCD_MAP_ENTRY  *Entry;
+  UINT64             CpuArchAttributes;
+  UINTN              Index;
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = CoreSearchGcdMapEntry (Ranges[Index].BaseAddress, Ranges[Index].Length, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    ASSERT_EFI_ERROR (Status);
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    for (Link = StartLink; Link != EndLink->ForwardLink; Link = Link->ForwardLink) {
+      Entry             = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+      CpuArchAttributes = ConverToCpuArchAttributes (Entry->Attributes);
+      if (CpuArchAttributes != 0) {
+        gCpu->SetMemoryAttributes (
+                gCpu,
+                Entry->BaseAddress,
+                Entry->EndAddress - Entry->BaseAddress + 1,
+                CpuArchAttributes
+                );
+      }
+    }
+  }
+}
+
+/**
+  Modifies the attributes for several memory regions in the global coherency
+  domain of the processor.
+
+  The regions are sorted by base address, and adjacent regions with the same
+  CPU arch attributes are set in a single call to the CPU Arch Protocol. All
+  the regions are checked, and the GCD memory map entries covering them are
+  split, before any attribute is changed. If the CPU Arch Protocol fails, the
+  attributes already set through it are restored from the GCD memory map.
+
+  @param  RangeCount             Number of entries in Ranges
+  @param  Ranges                 The memory regions and their attributes. The
+                                 array is sorted in place.
+
+  @retval EFI_SUCCESS           The attributes were set for all the memory regions.
+  @retval EFI_INVALID_PARAMETER RangeCount is zero, Ranges is NULL, the length of
+                                a region is zero, or two regions overlap.
+  @retval EFI_UNSUPPORTED       The processor does not support one or more bytes of a
+                                memory region, or the attributes of a region are not
+                                supported for it.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough system resources to modify the
+                                attributes of the memory regions.
+  @retval EFI_NOT_AVAILABLE_YET The attributes cannot be set because CPU architectural
+                                protocol is not available yet.
+
+**/
+EFI_STATUS
+CoreSetMemorySpaceAttributesList (
+  IN     UINTN                   RangeCount,
+  IN OUT GCD_MEMORY_SPACE_RANGE  *Ranges
+  )
+{
+  EFI_STATUS              Status;
+  GCD_MEMORY_SPACE_RANGE  Swap;
+  LIST_ENTRY              *StartLink;
+  LIST_ENTRY              *EndLink;
+  LIST_ENTRY              *Link;
+  EFI_GCD_MAP_ENTRY       *Entry;
+  UINTN                   Index;
+  UINTN                   RunStart;
+  UINTN                   RunEnd;
+  UINT64                  CpuArchAttributes;
+
+  DEBUG ((DEBUG_GCD, "GCD:SetMemorySpaceAttributesList(Count=%d)\n", RangeCount));
+
+  if ((RangeCount == 0) || (Ranges == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  QuickSort (Ranges, RangeCount, sizeof (GCD_MEMORY_SPACE_RANGE), CoreCompareMemorySpaceRange, &Swap);
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (Ranges[Index].Length == 0) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if ((Index > 0) && (Ranges[Index].BaseAddress - Ranges[Index - 1].BaseAddress < Ranges[Index - 1].Length)) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  CoreWaitForParallelDriverInitAps ();
+  CoreAcquireGcdMemoryLock ();
+
+  //
+  // Check all the regions first, so that no attribute is changed if one of
+  // them cannot be set.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = CoreSearchGcdMapEntry (Ranges[Index].BaseAddress, Ranges[Index].Length, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    if (EFI_ERROR (Status)) {
+      Status = EFI_UNSUPPORTED;
+      goto Done;
+    }
+
+    for (Link = StartLink; Link != EndLink->ForwardLink; Link = Link->ForwardLink) {
+      Entry  = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+      Status = CoreCheckGcdMapEntryAttributes (Entry, Ranges[Index].BaseAddress, Ranges[Index].Length, Ranges[Index].Attributes);
+      if (EFI_ERROR (Status)) {
+        goto Done;
+      }
+    }
+
+    if ((ConverToCpuArchAttributes (Ranges[Index].Attributes) != 0) && (gCpu == NULL)) {
+      Status = EFI_NOT_AVAILABLE_YET;
+      goto Done;
+    }
+  }
+
+  //
+  // Split the entries at the boundaries of the regions. This is the only step
+  // that allocates memory, so the steps below cannot fail half way on it.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    Status = CoreSplitGcdMemoryMapEntries (Ranges[Index].BaseAddress, Ranges[Index].Length);
+    if (EFI_ERROR (Status)) {
+      goto Merge;
+    }
+  }
+
+  //
+  // Set the CPU arch attributes of each run of adjacent regions at once. The
+  // GCD map still holds the previous attributes, and they are set back for
+  // the regions already done if the CPU Arch Protocol fails.
+  //
+  for (RunStart = 0; RunStart < RangeCount; RunStart = RunEnd) {
+    CpuArchAttributes = ConverToCpuArchAttributes (Ranges[RunStart].Attributes);
+    for (RunEnd = RunStart + 1; RunEnd < RangeCount; RunEnd++) {
+      if ((Ranges[RunEnd].BaseAddress != Ranges[RunEnd - 1].BaseAddress + Ranges[RunEnd - 1].Length) ||
+          (ConverToCpuArchAttributes (Ranges[RunEnd].Attributes) != CpuArchAttributes))
+      {
+        break;
+      }
+    }
+
+    if (CpuArchAttributes != 0) {
+      Status = gCpu->SetMemoryAttributes (
+                       gCpu,
+                       Ranges[RunStart].BaseAddress,
+                       Ranges[RunEnd - 1].BaseAddress + Ranges[RunEnd - 1].Length - Ranges[RunStart].BaseAddress,
+                       CpuArchAttributes
+                       );
+      if (EFI_ERROR (Status)) {
+        CoreRestoreCpuArchAttributes (RunEnd, Ranges);
+        goto Merge;
+      }
+    }
+  }
+
+  //
+  // Update the GCD map, the regions are now covered by whole entries.
+  //
+  for (Index = 0; Index < RangeCount; Index++) {
+    CoreSearchGcdMapEntry (Ranges[Index].BaseAddress, Ranges[Index].Length, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    for (Link = StartLink; Link != EndLink->ForwardLink; Link = Link->ForwardLink) {
+      Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+      CoreSetGcdMapEntryAttributes (Entry, Ranges[Index].Attributes);
+    }
+  }
+
+Merge:
+  for (Index = 0; Index < RangeCount; Index++) {
+    CoreMergeGcdMemoryMapEntries (Ranges[Index].BaseAddress, Ranges[Index].Length);
+  }
+
+Done:
+  DEBUG ((DEBUG_GCD, "  Status = %r\n", Status));
+
+  CoreReleaseGcdMemoryLock ();
+  CoreDumpGcdMemorySpaceMap (FALSE);
+
+  return Status;
+}
+
 /**
   Modifies the capabilities for a memory region in the global coherency domain of the
   processor.
@@ -2637,6 +3146,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfMemorySpace) - 1;
 
   InsertHeadList (&mGcdMemorySpaceMap, &Entry->Link);
+  MemoryMapTreeInsert (&mGcdMemorySpaceTree, &Entry->TreeNode);
 
   CoreDumpGcdMemorySpaceMap (TRUE);
 
@@ -2649,6 +3159,7 @@ CoreInitializeGcdServices (
   Entry->EndAddress = LShiftU64 (1, SizeOfIoSpace) - 1;
 
   InsertHeadList (&mGcdIoSpaceMap, &Entry->Link);
+  MemoryMapTreeInsert (&mGcdIoSpaceTree, &Entry->TreeNode);
 
   CoreDumpGcdIoSpaceMap (TRUE);
 
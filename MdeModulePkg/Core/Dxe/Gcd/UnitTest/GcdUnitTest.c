@@ -0,0 +1,1313 @@
+/** @file
+  This is a host-based unit test for the GCD memory space map of the DXE core.
+
+  Gcd.c and MemoryProtection.c are built as is, with the services they call
+  from the rest of the DXE core replaced here. The CPU Arch Protocol is a fake
+  that keeps the attributes it is given for each page of a window of system
+  memory, and can be made to fail on a given call.
+
+  Every lookup in the index of the GCD memory space map is checked against a
+  linear walk of mGcdMemorySpaceMap while memory spaces are added and removed.
+  CoreSplitGcdMemoryMapEntries() and CoreMergeGcdMemoryMapEntries() are checked
+  on their own, and CoreSetMemorySpaceAttributesList() and
+  SetUefiImageMemoryRanges() are checked to coalesce adjacent ranges into one
+  call to the CPU Arch Protocol, and to leave the GCD map and the page
+  attributes in step when that call fails.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/ImagePropertiesRecordLib.h>
+#include "DxeMain.h"
+
+#define UNIT_TEST_NAME     "DXE Core GCD Memory Space Map Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+///
+/// Width of the memory space, as in the CPU HOB.
+///
+#define TEST_MEMORY_SPACE_WIDTH  36
+
+///
+/// The window of system memory whose page attributes the fake CPU Arch
+/// Protocol keeps.
+///
+#define TEST_MEMORY_BASE   SIZE_1MB
+#define TEST_MEMORY_PAGES  64
+#define TEST_MEMORY_END    (TEST_MEMORY_BASE + EFI_PAGES_TO_SIZE (TEST_MEMORY_PAGES))
+
+#define TEST_CAPABILITIES  (EFI_MEMORY_UC | EFI_MEMORY_WB | EFI_MEMORY_RP | EFI_MEMORY_RO | EFI_MEMORY_XP)
+
+#define TEST_PAGE(Index)  (TEST_MEMORY_BASE + EFI_PAGES_TO_SIZE (Index))
+
+#define TEST_RANDOM_OPERATIONS  2000
+#define TEST_RANDOM_LOOKUPS     64
+
+//
+// Gcd.c internals.
+//
+extern LIST_ENTRY         mGcdMemorySpaceMap;
+extern MEMORY_MAP_TREE    mGcdMemorySpaceTree;
+extern EFI_GCD_MAP_ENTRY  mGcdMemorySpaceMapEntryTemplate;
+
+EFI_STATUS
+CoreSearchGcdMapEntry (
+  IN  EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN  UINT64                Length,
+  OUT LIST_ENTRY            **StartLink,
+  OUT LIST_ENTRY            **EndLink,
+  IN  LIST_ENTRY            *Map
+  );
+
+EFI_STATUS
+CoreInternalAddMemorySpace (
+  IN EFI_GCD_MEMORY_TYPE   GcdMemoryType,
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length,
+  IN UINT64                Capabilities
+  );
+
+EFI_STATUS
+CoreSplitGcdMemoryMapEntries (
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length
+  );
+
+VOID
+CoreMergeGcdMemoryMapEntries (
+  IN EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN UINT64                Length
+  );
+
+//
+// MemoryProtection.c internals.
+//
+VOID
+SetUefiImageMemoryRanges (
+  IN GCD_MEMORY_SPACE_RANGE  *Ranges,
+  IN UINTN                   RangeCount
+  );
+
+EFI_HANDLE                 gDxeCoreImageHandle  = NULL;
+EFI_LOADED_IMAGE_PROTOCOL  *gDxeCoreLoadedImage = NULL;
+EFI_CPU_ARCH_PROTOCOL      *gCpu                = NULL;
+EFI_RUNTIME_ARCH_PROTOCOL  *gRuntime            = NULL;
+EFI_SMM_BASE2_PROTOCOL     *gSmmBase2           = NULL;
+VOID                       *gHobList            = NULL;
+BOOLEAN                    mOnGuarding          = FALSE;
+
+EFI_MEMORY_TYPE_INFORMATION  gMemoryTypeInformation[EfiMaxMemoryType + 1];
+
+EFI_CPU_ARCH_PROTOCOL  mTestCpu;
+
+///
+/// The attributes the fake CPU Arch Protocol was last given for each page of
+/// the window.
+///
+UINT64  mTestPageAttributes[TEST_MEMORY_PAGES];
+///
+/// Number of calls to the fake CPU Arch Protocol, and the call that fails, 0
+/// if none does.
+///
+UINTN  mTestCpuCallCount;
+UINTN  mTestCpuFailingCall;
+///
+/// Set when the fake CPU Arch Protocol is called outside of the window.
+///
+BOOLEAN  mTestCpuOutsideWindow;
+
+/**
+  Marks a lock as acquired.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->Lock = EfiLockAcquired;
+}
+
+/**
+  Marks a lock as released.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  Lock->Lock = EfiLockReleased;
+}
+
+/**
+  Frees pool allocated for the GCD map entries.
+
+  @param  Buffer             The buffer.
+
+  @retval EFI_SUCCESS        Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  There is no pool to initialize.
+
+**/
+VOID
+CoreInitializePool (
+  VOID
+  )
+{
+}
+
+/**
+  There are no memory type information bins.
+
+  @param  Start              The start of the range.
+  @param  Length             The length of the range.
+
+**/
+VOID
+CoreSetMemoryTypeInformationRange (
+  IN EFI_PHYSICAL_ADDRESS  Start,
+  IN UINT64                Length
+  )
+{
+}
+
+/**
+  There is no UEFI memory map to add the memory to.
+
+  @param  Type               The memory type.
+  @param  Start              The start of the range.
+  @param  NumberOfPages      The number of pages of the range.
+  @param  Attribute          The attributes of the range.
+
+**/
+VOID
+CoreAddMemoryDescriptor (
+  IN EFI_MEMORY_TYPE       Type,
+  IN EFI_PHYSICAL_ADDRESS  Start,
+  IN UINT64                NumberOfPages,
+  IN UINT64                Attribute
+  )
+{
+}
+
+/**
+  There is no UEFI memory map to update.
+
+  @param  Start              The start of the range.
+  @param  NumberOfPages      The number of pages of the range.
+  @param  NewAttributes      The new capabilities of the range.
+
+**/
+VOID
+CoreUpdateMemoryAttributes (
+  IN EFI_PHYSICAL_ADDRESS  Start,
+  IN UINT64                NumberOfPages,
+  IN UINT64                NewAttributes
+  )
+{
+}
+
+/**
+  There are no pages to free.
+
+  @param  Memory             The base of the pages.
+  @param  NumberOfPages      The number of pages.
+
+  @retval EFI_NOT_FOUND      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreFreePages (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  There are no HOBs.
+
+  @param  Type               The HOB type.
+
+  @return NULL.
+
+**/
+VOID *
+EFIAPI
+GetFirstHob (
+  IN UINT16  Type
+  )
+{
+  return NULL;
+}
+
+/**
+  There are no HOBs.
+
+  @param  Type               The HOB type.
+  @param  HobStart           The HOB to start from.
+
+  @return NULL.
+
+**/
+VOID *
+EFIAPI
+GetNextHob (
+  IN UINT16      Type,
+  IN CONST VOID  *HobStart
+  )
+{
+  return NULL;
+}
+
+/**
+  There are no HOBs.
+
+  @param  Guid               The GUID of the HOB.
+
+  @return NULL.
+
+**/
+VOID *
+EFIAPI
+GetFirstGuidHob (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  return NULL;
+}
+
+/**
+  There are no events.
+
+  @param  Type               The event type.
+  @param  NotifyTpl          The notification TPL.
+  @param  NotifyFunction     The notification function.
+  @param  NotifyContext      The notification context.
+  @param  Event              The event, not created.
+
+  @retval EFI_UNSUPPORTED    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreCreateEvent (
+  IN UINT32            Type,
+  IN EFI_TPL           NotifyTpl,
+  IN EFI_EVENT_NOTIFY  NotifyFunction  OPTIONAL,
+  IN VOID              *NotifyContext  OPTIONAL,
+  OUT EFI_EVENT        *Event
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  There are no events.
+
+  @param  UserEvent          The event.
+
+  @retval EFI_INVALID_PARAMETER  Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreCloseEvent (
+  IN EFI_EVENT  UserEvent
+  )
+{
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  There is no protocol database.
+
+  @param  Protocol           The protocol.
+  @param  Event              The event to signal.
+  @param  Registration       The registration, not returned.
+
+  @retval EFI_UNSUPPORTED    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreRegisterProtocolNotify (
+  IN EFI_GUID   *Protocol,
+  IN EFI_EVENT  Event,
+  OUT  VOID     **Registration
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  There is no protocol database.
+
+  @param  Protocol           The protocol.
+  @param  Registration       The registration.
+  @param  Interface          The interface, not returned.
+
+  @retval EFI_NOT_FOUND      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  There are no driver init phases running on APs.
+
+**/
+VOID
+CoreWaitForParallelDriverInitAps (
+  VOID
+  )
+{
+}
+
+/**
+  Heap guard is disabled.
+
+**/
+VOID
+HeapGuardCpuArchProtocolNotify (
+  VOID
+  )
+{
+}
+
+/**
+  There are no images to protect.
+
+  @param  ImageBase          The base of the image.
+  @param  ImageSize          The size of the image.
+  @param  Alignment          The section alignment of the image.
+  @param  ImageRecord        The image record, not filled in.
+
+  @retval EFI_UNSUPPORTED    Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CreateImagePropertiesRecord (
+  IN  CONST   VOID                     *ImageBase,
+  IN  CONST   UINT64                   ImageSize,
+  IN  CONST   UINT32                   *Alignment OPTIONAL,
+  OUT         IMAGE_PROPERTIES_RECORD  *ImageRecord
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Keeps the attributes of the pages of the window, or fails on the call
+  selected by mTestCpuFailingCall.
+
+  @param  This               The CPU Arch Protocol.
+  @param  BaseAddress        The start of the range.
+  @param  Length             The length of the range.
+  @param  Attributes         The attributes of the range.
+
+  @retval EFI_SUCCESS        The attributes were kept.
+  @retval EFI_DEVICE_ERROR   This is the failing call.
+
+**/
+EFI_STATUS
+EFIAPI
+TestSetMemoryAttributes (
+  IN EFI_CPU_ARCH_PROTOCOL  *This,
+  IN EFI_PHYSICAL_ADDRESS   BaseAddress,
+  IN UINT64                 Length,
+  IN UINT64                 Attributes
+  )
+{
+  UINTN  Index;
+
+  mTestCpuCallCount++;
+  if (mTestCpuCallCount == mTestCpuFailingCall) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if ((BaseAddress < TEST_MEMORY_BASE) || (BaseAddress + Length > TEST_MEMORY_END)) {
+    mTestCpuOutsideWindow = TRUE;
+    return EFI_SUCCESS;
+  }
+
+  for (Index = 0; Index < EFI_SIZE_TO_PAGES (Length); Index++) {
+    mTestPageAttributes[EFI_SIZE_TO_PAGES (BaseAddress - TEST_MEMORY_BASE) + Index] = Attributes;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns a pseudo-random number.
+
+  @param[in, out] Seed    The state of the generator.
+
+  @return The next number of the sequence.
+
+**/
+UINT32
+TestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Frees the GCD memory space map and starts it over with a single
+  non-existent entry, as CoreInitializeGcdServices() does.
+
+**/
+VOID
+TestResetGcdMap (
+  VOID
+  )
+{
+  EFI_GCD_MAP_ENTRY  *Entry;
+
+  while (!IsListEmpty (&mGcdMemorySpaceMap)) {
+    Entry = CR (GetFirstNode (&mGcdMemorySpaceMap), EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    MemoryMapTreeRemove (&mGcdMemorySpaceTree, &Entry->TreeNode);
+    RemoveEntryList (&Entry->Link);
+    FreePool (Entry);
+  }
+
+  Entry = AllocateCopyPool (sizeof (EFI_GCD_MAP_ENTRY), &mGcdMemorySpaceMapEntryTemplate);
+  ASSERT (Entry != NULL);
+  Entry->EndAddress = LShiftU64 (1, TEST_MEMORY_SPACE_WIDTH) - 1;
+
+  InsertHeadList (&mGcdMemorySpaceMap, &Entry->Link);
+  MemoryMapTreeInsert (&mGcdMemorySpaceTree, &Entry->TreeNode);
+}
+
+/**
+  Finds the entry of the GCD memory space map that contains an address by
+  walking the list.
+
+  @param[in] Address      The address.
+
+  @return The entry, or NULL if none contains Address.
+
+**/
+EFI_GCD_MAP_ENTRY *
+TestFindEntry (
+  IN EFI_PHYSICAL_ADDRESS  Address
+  )
+{
+  LIST_ENTRY         *Link;
+  EFI_GCD_MAP_ENTRY  *Entry;
+
+  for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    if ((Address >= Entry->BaseAddress) && (Address <= Entry->EndAddress)) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Counts the entries of the GCD memory space map by walking the list.
+
+  @return The number of entries.
+
+**/
+UINTN
+TestCountEntries (
+  VOID
+  )
+{
+  LIST_ENTRY  *Link;
+  UINTN       Count;
+
+  Count = 0;
+  for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+  Checks that the index of the GCD memory space map finds every entry by its
+  first and last address, and every pair of adjacent entries, as a walk of
+  the list does.
+
+  @retval TRUE            The index matches the list.
+  @retval FALSE           A lookup did not match.
+
+**/
+BOOLEAN
+CheckGcdIndex (
+  VOID
+  )
+{
+  LIST_ENTRY         *Link;
+  LIST_ENTRY         *StartLink;
+  LIST_ENTRY         *EndLink;
+  EFI_GCD_MAP_ENTRY  *Entry;
+  EFI_GCD_MAP_ENTRY  *Next;
+  EFI_STATUS         Status;
+
+  if (mGcdMemorySpaceTree.Count != TestCountEntries ()) {
+    return FALSE;
+  }
+
+  for (Link = mGcdMemorySpaceMap.ForwardLink; Link != &mGcdMemorySpaceMap; Link = Link->ForwardLink) {
+    Entry  = CR (Link, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    Status = CoreSearchGcdMapEntry (Entry->BaseAddress, 1, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    if (EFI_ERROR (Status) || (StartLink != Link) || (EndLink != Link)) {
+      return FALSE;
+    }
+
+    Status = CoreSearchGcdMapEntry (Entry->EndAddress, 1, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    if (EFI_ERROR (Status) || (StartLink != Link) || (EndLink != Link)) {
+      return FALSE;
+    }
+
+    if (Link->ForwardLink == &mGcdMemorySpaceMap) {
+      continue;
+    }
+
+    //
+    // The entries are sorted and leave no hole.
+    //
+    Next = CR (Link->ForwardLink, EFI_GCD_MAP_ENTRY, Link, EFI_GCD_MAP_SIGNATURE);
+    if (Next->BaseAddress != Entry->EndAddress + 1) {
+      return FALSE;
+    }
+
+    Status = CoreSearchGcdMapEntry (Entry->EndAddress, 2, &StartLink, &EndLink, &mGcdMemorySpaceMap);
+    if (EFI_ERROR (Status) || (StartLink != Link) || (EndLink != Link->ForwardLink)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Checks the GCD attributes and the attributes given to the fake CPU Arch
+  Protocol for each page of the window.
+
+  @param[in] Expected     The GCD attributes expected for each page.
+
+  @retval TRUE            The attributes of every page are as expected.
+  @retval FALSE           The attributes of a page are not.
+
+**/
+BOOLEAN
+CheckPageAttributes (
+  IN UINT64  *Expected
+  )
+{
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR  Descriptor;
+  UINTN                            Index;
+
+  for (Index = 0; Index < TEST_MEMORY_PAGES; Index++) {
+    if (EFI_ERROR (CoreGetMemorySpaceDescriptor (TEST_PAGE (Index), &Descriptor)) ||
+        (Descriptor.Attributes != Expected[Index]) ||
+        (mTestPageAttributes[Index] != (Expected[Index] & (EFI_CACHE_ATTRIBUTE_MASK | EFI_MEMORY_ATTRIBUTE_MASK))))
+    {
+      DEBUG ((DEBUG_ERROR, "Page %Lu: GCD %Lx CPU %Lx expected %Lx\n", (UINT64)Index, Descriptor.Attributes, mTestPageAttributes[Index], Expected[Index]));
+      return FALSE;
+    }
+  }
+
+  return !mTestCpuOutsideWindow;
+}
+
+/**
+  Starts the GCD memory space map over, without any memory space added.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED  The map was reset.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EmptyGcdMapSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TestResetGcdMap ();
+  gCpu = NULL;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Starts the GCD memory space map over with the window added as write-back
+  system memory, and installs the fake CPU Arch Protocol.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED                      The window was added.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The window could not be added.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SystemMemorySetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TestResetGcdMap ();
+
+  ZeroMem (&mTestCpu, sizeof (mTestCpu));
+  mTestCpu.SetMemoryAttributes = TestSetMemoryAttributes;
+  gCpu                         = &mTestCpu;
+
+  ZeroMem (mTestPageAttributes, sizeof (mTestPageAttributes));
+  mTestCpuFailingCall   = 0;
+  mTestCpuOutsideWindow = FALSE;
+
+  if (EFI_ERROR (CoreInternalAddMemorySpace (EfiGcdMemoryTypeSystemMemory, TEST_MEMORY_BASE, TEST_MEMORY_END - TEST_MEMORY_BASE, TEST_CAPABILITIES))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  if (EFI_ERROR (CoreSetMemorySpaceAttributes (TEST_MEMORY_BASE, TEST_MEMORY_END - TEST_MEMORY_BASE, EFI_MEMORY_WB))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTestCpuCallCount = 0;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Adds and removes memory spaces at random, and checks every lookup made in
+  the index of the GCD memory space map against a walk of the list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexMatchesList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST EFI_GCD_MEMORY_TYPE  Types[] = {
+    EfiGcdMemoryTypeReserved,
+    EfiGcdMemoryTypeSystemMemory,
+    EfiGcdMemoryTypeMemoryMappedIo
+  };
+  UINT32                           Seed;
+  UINTN                            Operation;
+  UINTN                            Lookup;
+  EFI_PHYSICAL_ADDRESS             Address;
+  UINT64                           Length;
+  EFI_GCD_MAP_ENTRY                *Entry;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR  Descriptor;
+  EFI_STATUS                       Status;
+  EFI_STATUS                       Expected;
+
+  Seed = 7;
+  for (Operation = 0; Operation < TEST_RANDOM_OPERATIONS; Operation++) {
+    Address = EFI_PAGES_TO_SIZE ((UINT64)(TestRandom (&Seed) % SIZE_64KB));
+    Length  = EFI_PAGES_TO_SIZE ((UINT64)(TestRandom (&Seed) % 64) + 1);
+    Entry   = TestFindEntry (Address);
+    UT_ASSERT_NOT_NULL (Entry);
+
+    if ((Entry->GcdMemoryType != EfiGcdMemoryTypeNonExistent) && ((TestRandom (&Seed) % 3) == 0)) {
+      //
+      // Remove the part of an existing memory space that starts at Address.
+      //
+      Length = MIN (Length, Entry->EndAddress - Address + 1);
+      UT_ASSERT_NOT_EFI_ERROR (CoreRemoveMemorySpace (Address, Length));
+    } else {
+      //
+      // Adding memory space only succeeds over non-existent memory.
+      //
+      Expected = EFI_ACCESS_DENIED;
+      if ((Entry->GcdMemoryType == EfiGcdMemoryTypeNonExistent) && (Address + Length - 1 <= Entry->EndAddress)) {
+        Expected = EFI_SUCCESS;
+      }
+
+      Status = CoreInternalAddMemorySpace (Types[TestRandom (&Seed) % ARRAY_SIZE (Types)], Address, Length, TEST_CAPABILITIES);
+      UT_ASSERT_STATUS_EQUAL (Status, Expected);
+    }
+
+    UT_ASSERT_TRUE (CheckGcdIndex ());
+
+    for (Lookup = 0; Lookup < TEST_RANDOM_LOOKUPS; Lookup++) {
+      Address = MultU64x32 (TestRandom (&Seed), 37) % SIZE_512MB;
+      Entry   = TestFindEntry (Address);
+      UT_ASSERT_NOT_NULL (Entry);
+      UT_ASSERT_NOT_EFI_ERROR (CoreGetMemorySpaceDescriptor (Address, &Descriptor));
+      UT_ASSERT_EQUAL (Descriptor.BaseAddress, Entry->BaseAddress);
+      UT_ASSERT_EQUAL (Descriptor.Length, Entry->EndAddress - Entry->BaseAddress + 1);
+    }
+  }
+
+  //
+  // Nothing is found past the end of the memory space.
+  //
+  Address = LShiftU64 (1, TEST_MEMORY_SPACE_WIDTH);
+  UT_ASSERT_STATUS_EQUAL (CoreGetMemorySpaceDescriptor (Address, &Descriptor), EFI_NOT_FOUND);
+  UT_ASSERT_STATUS_EQUAL (CoreInternalAddMemorySpace (EfiGcdMemoryTypeSystemMemory, Address - EFI_PAGE_SIZE, SIZE_8KB, 0), EFI_UNSUPPORTED);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that CoreSplitGcdMemoryMapEntries() splits the entries at the
+  boundaries of a region, and only there, and that
+  CoreMergeGcdMemoryMapEntries() merges them back unless their attributes
+  differ.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SplitAndMergeEntries (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN              Count;
+  EFI_GCD_MAP_ENTRY  *Entry;
+
+  Count = TestCountEntries ();
+
+  //
+  // A region inside an entry splits it in three.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (CoreSplitGcdMemoryMapEntries (TEST_PAGE (4), EFI_PAGES_TO_SIZE (8)));
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 2);
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+  Entry = TestFindEntry (TEST_PAGE (4));
+  UT_ASSERT_EQUAL (Entry->BaseAddress, TEST_PAGE (4));
+  UT_ASSERT_EQUAL (Entry->EndAddress, TEST_PAGE (12) - 1);
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (3))->BaseAddress, TEST_MEMORY_BASE);
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (12))->EndAddress, TEST_MEMORY_END - 1);
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (12))->Attributes, EFI_MEMORY_WB);
+
+  //
+  // A region that already starts and ends on entry boundaries is left alone.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (CoreSplitGcdMemoryMapEntries (TEST_PAGE (4), EFI_PAGES_TO_SIZE (8)));
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 2);
+
+  //
+  // A region across two entries splits the first one below it and the last
+  // one above it.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (CoreSplitGcdMemoryMapEntries (TEST_PAGE (2), EFI_PAGES_TO_SIZE (12)));
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 4);
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (2))->BaseAddress, TEST_PAGE (2));
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (13))->EndAddress, TEST_PAGE (14) - 1);
+
+  //
+  // A region that is not in the map is not split.
+  //
+  UT_ASSERT_STATUS_EQUAL (
+    CoreSplitGcdMemoryMapEntries (LShiftU64 (1, TEST_MEMORY_SPACE_WIDTH) - EFI_PAGE_SIZE, SIZE_8KB),
+    EFI_UNSUPPORTED
+    );
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 4);
+
+  //
+  // Entries with other attributes are not merged.
+  //
+  TestFindEntry (TEST_PAGE (4))->Attributes |= EFI_MEMORY_RO;
+  CoreMergeGcdMemoryMapEntries (TEST_MEMORY_BASE, TEST_MEMORY_END - TEST_MEMORY_BASE);
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 2);
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (4))->BaseAddress, TEST_PAGE (4));
+  UT_ASSERT_EQUAL (TestFindEntry (TEST_PAGE (4))->EndAddress, TEST_PAGE (12) - 1);
+
+  TestFindEntry (TEST_PAGE (4))->Attributes &= ~EFI_MEMORY_RO;
+  CoreMergeGcdMemoryMapEntries (TEST_PAGE (4), EFI_PAGE_SIZE);
+  UT_ASSERT_EQUAL (TestCountEntries (), Count);
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that CoreSetMemorySpaceAttributesList() sets each run of adjacent
+  regions with the same attributes in one call to the CPU Arch Protocol, and
+  that it changes nothing when a region is refused.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AttributesListCoalesced (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GCD_MEMORY_SPACE_RANGE           Ranges[3];
+  UINT64                           Expected[TEST_MEMORY_PAGES];
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR  Descriptor;
+  UINTN                            Count;
+  UINTN                            Index;
+
+  for (Index = 0; Index < TEST_MEMORY_PAGES; Index++) {
+    Expected[Index] = EFI_MEMORY_WB;
+  }
+
+  Count = TestCountEntries ();
+
+  //
+  // Out of order, the first two are adjacent with the same attributes.
+  //
+  Ranges[0].BaseAddress = TEST_PAGE (12);
+  Ranges[0].Length      = EFI_PAGES_TO_SIZE (2);
+  Ranges[0].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Ranges[1].BaseAddress = TEST_PAGE (4);
+  Ranges[1].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  Ranges[2].BaseAddress = TEST_PAGE (0);
+  Ranges[2].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[2].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+
+  UT_ASSERT_NOT_EFI_ERROR (CoreSetMemorySpaceAttributesList (ARRAY_SIZE (Ranges), Ranges));
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 2);
+
+  for (Index = 0; Index < 8; Index++) {
+    Expected[Index] = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  }
+
+  Expected[12] = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Expected[13] = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+
+  //
+  // The entries of the adjacent regions are merged.
+  //
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 3);
+  UT_ASSERT_NOT_EFI_ERROR (CoreGetMemorySpaceDescriptor (TEST_PAGE (5), &Descriptor));
+  UT_ASSERT_EQUAL (Descriptor.BaseAddress, TEST_MEMORY_BASE);
+  UT_ASSERT_EQUAL (Descriptor.Length, EFI_PAGES_TO_SIZE (8));
+
+  //
+  // Overlapping regions are refused before anything is done.
+  //
+  mTestCpuCallCount     = 0;
+  Ranges[0].BaseAddress = TEST_PAGE (20);
+  Ranges[0].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[0].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Ranges[1].BaseAddress = TEST_PAGE (23);
+  Ranges[1].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  UT_ASSERT_STATUS_EQUAL (CoreSetMemorySpaceAttributesList (2, Ranges), EFI_INVALID_PARAMETER);
+
+  //
+  // So is the whole list when the attributes of one region are not supported.
+  //
+  Ranges[1].BaseAddress = TEST_PAGE (24);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_WP;
+  UT_ASSERT_STATUS_EQUAL (CoreSetMemorySpaceAttributesList (2, Ranges), EFI_UNSUPPORTED);
+
+  //
+  // And when a region is not in the map.
+  //
+  Ranges[1].BaseAddress = LShiftU64 (1, TEST_MEMORY_SPACE_WIDTH);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  UT_ASSERT_STATUS_EQUAL (CoreSetMemorySpaceAttributesList (2, Ranges), EFI_UNSUPPORTED);
+
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 0);
+  UT_ASSERT_EQUAL (TestCountEntries (), Count + 3);
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Makes the CPU Arch Protocol fail on each run of regions given to
+  CoreSetMemorySpaceAttributesList() in turn, and checks that the runs already
+  set are set back to the attributes the GCD map still holds, and that the
+  entries split for the regions are merged back.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AttributesListRollback (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GCD_MEMORY_SPACE_RANGE  Ranges[3];
+  UINT64                  Expected[TEST_MEMORY_PAGES];
+  UINTN                   Count;
+  UINTN                   Index;
+  UINTN                   FailingCall;
+
+  //
+  // Keep a different attribute below the regions, so that the entries that
+  // are set back cannot merge with everything around them.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (CoreSetMemorySpaceAttributes (TEST_PAGE (0), EFI_PAGES_TO_SIZE (2), EFI_MEMORY_WB | EFI_MEMORY_XP));
+  for (Index = 0; Index < TEST_MEMORY_PAGES; Index++) {
+    Expected[Index] = EFI_MEMORY_WB;
+  }
+
+  Expected[0] = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Expected[1] = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Count       = TestCountEntries ();
+
+  for (FailingCall = 1; FailingCall <= ARRAY_SIZE (Ranges); FailingCall++) {
+    Ranges[0].BaseAddress = TEST_PAGE (4);
+    Ranges[0].Length      = EFI_PAGES_TO_SIZE (2);
+    Ranges[0].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+    Ranges[1].BaseAddress = TEST_PAGE (6);
+    Ranges[1].Length      = EFI_PAGES_TO_SIZE (3);
+    Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+    Ranges[2].BaseAddress = TEST_PAGE (10);
+    Ranges[2].Length      = EFI_PAGES_TO_SIZE (2);
+    Ranges[2].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+
+    mTestCpuCallCount   = 0;
+    mTestCpuFailingCall = FailingCall;
+    UT_ASSERT_STATUS_EQUAL (CoreSetMemorySpaceAttributesList (ARRAY_SIZE (Ranges), Ranges), EFI_DEVICE_ERROR);
+
+    //
+    // Every region up to the failing one is set back, one call per entry.
+    //
+    UT_ASSERT_EQUAL (mTestCpuCallCount, 2 * FailingCall);
+    UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+    UT_ASSERT_EQUAL (TestCountEntries (), Count);
+    UT_ASSERT_TRUE (CheckGcdIndex ());
+  }
+
+  //
+  // The same regions are set once the CPU Arch Protocol works again.
+  //
+  mTestCpuCallCount   = 0;
+  mTestCpuFailingCall = 0;
+  UT_ASSERT_NOT_EFI_ERROR (CoreSetMemorySpaceAttributesList (ARRAY_SIZE (Ranges), Ranges));
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 3);
+  for (Index = 4; Index < 12; Index++) {
+    Expected[Index] = EFI_MEMORY_WB | ((Index >= 6 && Index < 9) ? EFI_MEMORY_XP : EFI_MEMORY_RO);
+  }
+
+  Expected[9] = EFI_MEMORY_WB;
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that SetUefiImageMemoryRanges() sets the adjacent pieces of an image
+  with the same attributes in one call to the CPU Arch Protocol.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ImageRangesCoalesced (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GCD_MEMORY_SPACE_RANGE  Ranges[4];
+  UINT64                  Expected[TEST_MEMORY_PAGES];
+  UINTN                   Index;
+
+  //
+  // The headers and data of an image in two GCD pieces, its code, and more
+  // data.
+  //
+  Ranges[0].BaseAddress = TEST_PAGE (16);
+  Ranges[0].Length      = EFI_PAGES_TO_SIZE (1);
+  Ranges[0].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Ranges[1].BaseAddress = TEST_PAGE (17);
+  Ranges[1].Length      = EFI_PAGES_TO_SIZE (1);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Ranges[2].BaseAddress = TEST_PAGE (18);
+  Ranges[2].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[2].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  Ranges[3].BaseAddress = TEST_PAGE (22);
+  Ranges[3].Length      = EFI_PAGES_TO_SIZE (2);
+  Ranges[3].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+
+  SetUefiImageMemoryRanges (Ranges, ARRAY_SIZE (Ranges));
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 3);
+
+  for (Index = 0; Index < TEST_MEMORY_PAGES; Index++) {
+    Expected[Index] = EFI_MEMORY_WB;
+  }
+
+  for (Index = 16; Index < 24; Index++) {
+    Expected[Index] = EFI_MEMORY_WB | ((Index >= 18 && Index < 22) ? EFI_MEMORY_RO : EFI_MEMORY_XP);
+  }
+
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+
+  //
+  // Unprotecting the image restores it in one call.
+  //
+  mTestCpuCallCount = 0;
+  for (Index = 0; Index < ARRAY_SIZE (Ranges); Index++) {
+    Ranges[Index].Attributes = EFI_MEMORY_WB;
+  }
+
+  SetUefiImageMemoryRanges (Ranges, ARRAY_SIZE (Ranges));
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 1);
+
+  for (Index = 16; Index < 24; Index++) {
+    Expected[Index] = EFI_MEMORY_WB;
+  }
+
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+  UT_ASSERT_EQUAL (TestCountEntries (), 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Makes the CPU Arch Protocol fail once while SetUefiImageMemoryRanges() sets
+  the pieces of an image together, and checks that the pieces are then set
+  one by one.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ImageRangesFallback (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GCD_MEMORY_SPACE_RANGE  Ranges[3];
+  UINT64                  Expected[TEST_MEMORY_PAGES];
+  UINTN                   Index;
+
+  Ranges[0].BaseAddress = TEST_PAGE (32);
+  Ranges[0].Length      = EFI_PAGES_TO_SIZE (2);
+  Ranges[0].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+  Ranges[1].BaseAddress = TEST_PAGE (34);
+  Ranges[1].Length      = EFI_PAGES_TO_SIZE (4);
+  Ranges[1].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_RO;
+  Ranges[2].BaseAddress = TEST_PAGE (38);
+  Ranges[2].Length      = EFI_PAGES_TO_SIZE (2);
+  Ranges[2].Attributes  = EFI_MEMORY_WB | EFI_MEMORY_XP;
+
+  //
+  // The second run fails, the first one is set back, and then each piece is
+  // set on its own.
+  //
+  mTestCpuFailingCall = 2;
+  SetUefiImageMemoryRanges (Ranges, ARRAY_SIZE (Ranges));
+  UT_ASSERT_EQUAL (mTestCpuCallCount, 2 + 2 + ARRAY_SIZE (Ranges));
+
+  for (Index = 0; Index < TEST_MEMORY_PAGES; Index++) {
+    Expected[Index] = EFI_MEMORY_WB;
+  }
+
+  for (Index = 32; Index < 40; Index++) {
+    Expected[Index] = EFI_MEMORY_WB | ((Index >= 34 && Index < 38) ? EFI_MEMORY_RO : EFI_MEMORY_XP);
+  }
+
+  UT_ASSERT_TRUE (CheckPageAttributes (Expected));
+  UT_ASSERT_TRUE (CheckGcdIndex ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  GCD memory space map and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MapTests;
+  UNIT_TEST_SUITE_HANDLE      AttributeTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&MapTests, Framework, "GCD Memory Space Map Tests", "GcdMap", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the GCD map tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (MapTests, "Index lookups match the map", "IndexMatchesList", IndexMatchesList, EmptyGcdMapSetup, NULL, NULL);
+  AddTestCase (MapTests, "Split and merge the entries of a region", "SplitAndMergeEntries", SplitAndMergeEntries, SystemMemorySetup, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&AttributeTests, Framework, "GCD Memory Space Attribute Tests", "GcdAttributes", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the GCD attribute tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (AttributeTests, "Adjacent regions are set together", "AttributesListCoalesced", AttributesListCoalesced, SystemMemorySetup, NULL, NULL);
+  AddTestCase (AttributeTests, "Regions are set back when the CPU fails", "AttributesListRollback", AttributesListRollback, SystemMemorySetup, NULL, NULL);
+  AddTestCase (AttributeTests, "Image pieces are set together", "ImageRangesCoalesced", ImageRangesCoalesced, SystemMemorySetup, NULL, NULL);
+  AddTestCase (AttributeTests, "Image pieces are set one by one when the CPU fails", "ImageRangesFallback", ImageRangesFallback, SystemMemorySetup, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
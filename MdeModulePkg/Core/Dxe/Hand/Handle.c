@@ -10,12 +10,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Handle.h"
 
 //
-// mProtocolDatabase     - A list of all protocols in the system.  (simple list for now)
+// Number of buckets in mProtocolHashTable.  Must be a power of 2.
+//
+#define PROTOCOL_HASH_BUCKET_COUNT  64
+
+//
+// mProtocolDatabase     - A list of all protocols in the system, in creation order
+// mProtocolHashTable    - The protocols in the system, hashed by protocol GUID
 // gHandleList           - A list of all the handles in the system
 // gProtocolDatabaseLock - Lock to protect the mProtocolDatabase
 // gHandleDatabaseKey    -  The Key to show that the handle has been created/modified
 //
 LIST_ENTRY          mProtocolDatabase     = INITIALIZE_LIST_HEAD_VARIABLE (mProtocolDatabase);
+LIST_ENTRY          mProtocolHashTable[PROTOCOL_HASH_BUCKET_COUNT];
 LIST_ENTRY          gHandleList           = INITIALIZE_LIST_HEAD_VARIABLE (gHandleList);
 EFI_LOCK            gProtocolDatabaseLock = EFI_INITIALIZE_LOCK_VARIABLE (TPL_NOTIFY);
 UINT64              gHandleDatabaseKey    = 0;
@@ -90,6 +97,12 @@ CoreInitializeHandleServices (
   VOID
   )
 {
+  UINTN  Index;
+
+  for (Index = 0; Index < PROTOCOL_HASH_BUCKET_COUNT; Index++) {
+    InitializeListHead (&mProtocolHashTable[Index]);
+  }
+
   gOrderedHandleList = OrderedCollectionInit (PointerCompare, PointerCompare);
 
   if (gOrderedHandleList == NULL) {
@@ -130,6 +143,59 @@ CoreValidateHandle (
   return EFI_INVALID_PARAMETER;
 }
 
+/**
+  Returns the index of the hash bucket of a GUID, in a hash table of GUIDs.
+
+  @param  Guid                   The GUID.
+  @param  BucketCount            The number of buckets of the table. Must be a
+                                 power of 2.
+
+  @return The index of the bucket of Guid, below BucketCount.
+
+**/
+UINTN
+CoreGetGuidHashIndex (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           BucketCount
+  )
+{
+  UINT32  Hash;
+
+  ASSERT ((BucketCount & (BucketCount - 1)) == 0);
+
+  //
+  // GUIDs are random enough that folding the four 32-bit words together
+  // spreads them evenly across the buckets.
+  //
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)Guid);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)Guid + 1);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)Guid + 2);
+  Hash ^= ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (BucketCount - 1);
+}
+
+/**
+  Returns the mProtocolHashTable bucket that holds the protocol entry for
+  the requested protocol.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The ID of the protocol
+
+  @return Head of the hash bucket list
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetProtocolHashBucket (
+  IN EFI_GUID  *Protocol
+  )
+{
+  return &mProtocolHashTable[CoreGetGuidHashIndex (Protocol, PROTOCOL_HASH_BUCKET_COUNT)];
+}
+
 /**
   Finds the protocol entry for the requested protocol.
   The gProtocolDatabaseLock must be owned
@@ -146,6 +212,7 @@ CoreFindProtocolEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY      *Bucket;
   LIST_ENTRY      *Link;
   PROTOCOL_ENTRY  *Item;
   PROTOCOL_ENTRY  *ProtEntry;
@@ -153,15 +220,16 @@ CoreFindProtocolEntry (
   ASSERT_LOCKED (&gProtocolDatabaseLock);
 
   //
-  // Search the database for the matching GUID
+  // Search the hash bucket of the database for the matching GUID
   //
 
   ProtEntry = NULL;
-  for (Link = mProtocolDatabase.ForwardLink;
-       Link != &mProtocolDatabase;
+  Bucket    = CoreGetProtocolHashBucket (Protocol);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    Item = CR (Link, PROTOCOL_ENTRY, HashLink, PROTOCOL_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->ProtocolID, Protocol)) {
       //
       // This is the protocol entry
@@ -192,12 +260,132 @@ CoreFindProtocolEntry (
       // Add it to protocol database
       //
       InsertTailList (&mProtocolDatabase, &ProtEntry->AllEntries);
+      InsertTailList (Bucket, &ProtEntry->HashLink);
     }
   }
 
   return ProtEntry;
 }
 
+/**
+  Records a protocol interface that was just added to the Protocols list of
+  its handle.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle the protocol interface was added to
+  @param  Prot                   The protocol interface
+
+**/
+STATIC
+VOID
+CoreAddHandleProtocolSlot (
+  IN IHANDLE             *Handle,
+  IN PROTOCOL_INTERFACE  *Prot
+  )
+{
+  if (Handle->ProtocolCount < HANDLE_PROTOCOL_SLOT_COUNT) {
+    Handle->ProtocolSlots[Handle->ProtocolCount] = Prot;
+  }
+
+  Handle->ProtocolCount++;
+}
+
+/**
+  Forgets a protocol interface that was just removed from the Protocols list
+  of its handle.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle the protocol interface was removed from
+  @param  Prot                   The protocol interface
+
+**/
+STATIC
+VOID
+CoreRemoveHandleProtocolSlot (
+  IN IHANDLE             *Handle,
+  IN PROTOCOL_INTERFACE  *Prot
+  )
+{
+  UINTN               Index;
+  LIST_ENTRY          *Link;
+  PROTOCOL_INTERFACE  *Item;
+
+  ASSERT (Handle->ProtocolCount > 0);
+
+  if (Handle->ProtocolCount <= HANDLE_PROTOCOL_SLOT_COUNT) {
+    //
+    // Move the last slot into the one being released
+    //
+    for (Index = 0; Index < Handle->ProtocolCount; Index++) {
+      if (Handle->ProtocolSlots[Index] == Prot) {
+        Handle->ProtocolSlots[Index] = Handle->ProtocolSlots[Handle->ProtocolCount - 1];
+        break;
+      }
+    }
+
+    ASSERT (Index < Handle->ProtocolCount);
+    Handle->ProtocolCount--;
+    return;
+  }
+
+  Handle->ProtocolCount--;
+  if (Handle->ProtocolCount == HANDLE_PROTOCOL_SLOT_COUNT) {
+    //
+    // The remaining protocol interfaces fit in the lookup array again
+    //
+    Index = 0;
+    for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
+      Item                         = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+      Handle->ProtocolSlots[Index] = Item;
+      Index++;
+    }
+
+    ASSERT (Index == HANDLE_PROTOCOL_SLOT_COUNT);
+  }
+}
+
+/**
+  Finds the protocol interface installed on a handle for a protocol entry.
+  A protocol can be installed at most once on a handle.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Handle                 The handle to search the protocol on
+  @param  ProtEntry              The protocol entry of the protocol
+
+  @return Protocol instance (NULL: Not found)
+
+**/
+STATIC
+PROTOCOL_INTERFACE *
+CoreFindHandleProtocol (
+  IN IHANDLE         *Handle,
+  IN PROTOCOL_ENTRY  *ProtEntry
+  )
+{
+  UINTN               Index;
+  LIST_ENTRY          *Link;
+  PROTOCOL_INTERFACE  *Prot;
+
+  if (Handle->ProtocolCount <= HANDLE_PROTOCOL_SLOT_COUNT) {
+    for (Index = 0; Index < Handle->ProtocolCount; Index++) {
+      if (Handle->ProtocolSlots[Index]->Protocol == ProtEntry) {
+        return Handle->ProtocolSlots[Index];
+      }
+    }
+
+    return NULL;
+  }
+
+  for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
+      return Prot;
+    }
+  }
+
+  return NULL;
+}
+
 /**
   Finds the protocol instance for the requested handle and protocol.
   Note: This function doesn't do parameters checking, it's caller's responsibility
@@ -219,7 +407,6 @@ CoreFindProtocolInterface (
 {
   PROTOCOL_INTERFACE  *Prot;
   PROTOCOL_ENTRY      *ProtEntry;
-  LIST_ENTRY          *Link;
 
   ASSERT_LOCKED (&gProtocolDatabaseLock);
   Prot = NULL;
@@ -231,17 +418,11 @@ CoreFindProtocolInterface (
   ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
   if (ProtEntry != NULL) {
     //
-    // Look at each protocol interface for any matches
+    // Each protocol appears at most once on a handle, so the only
+    // candidate is the interface installed for this protocol entry
     //
-    for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
-      //
-      // If this protocol interface matches, remove it
-      //
-      Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
-      if ((Prot->Interface == Interface) && (Prot->Protocol == ProtEntry)) {
-        break;
-      }
-
+    Prot = CoreFindHandleProtocol (Handle, ProtEntry);
+    if ((Prot != NULL) && (Prot->Interface != Interface)) {
       Prot = NULL;
     }
   }
@@ -563,6 +744,7 @@ CoreInstallProtocolInterfaceNotify (
   // protocol list for this handle
   //
   InsertHeadList (&Handle->Protocols, &Prot->Link);
+  CoreAddHandleProtocolSlot (Handle, Prot);
 
   //
   // Add this protocol interface to the tail of the
@@ -570,6 +752,12 @@ CoreInstallProtocolInterfaceNotify (
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
 
+  //
+  // Let the dispatcher evaluate again the DEPEX of the drivers waiting for
+  // this protocol, even if the notifications are not fired yet
+  //
+  CoreDepexProtocolInstalled (&ProtEntry->ProtocolID);
+
   //
   // Notify the notification list for this protocol
   //
@@ -873,6 +1061,7 @@ CoreUninstallProtocolInterface (
     // Remove the protocol interface from the handle
     //
     RemoveEntryList (&Prot->Link);
+    CoreRemoveHandleProtocolSlot (Handle, Prot);
 
     //
     // Free the memory
@@ -999,25 +1188,18 @@ CoreGetProtocolInterface (
   IN  EFI_GUID    *Protocol
   )
 {
-  PROTOCOL_ENTRY      *ProtEntry;
-  PROTOCOL_INTERFACE  *Prot;
-  IHANDLE             *Handle;
-  LIST_ENTRY          *Link;
-
-  Handle = (IHANDLE *)UserHandle;
+  PROTOCOL_ENTRY  *ProtEntry;
 
   //
-  // Look at each protocol interface for a match
+  // Resolve the GUID once through the protocol database, then match the
+  // handle's protocol interfaces by protocol entry
   //
-  for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
-    Prot      = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
-    ProtEntry = Prot->Protocol;
-    if (CompareGuid (&ProtEntry->ProtocolID, Protocol)) {
-      return Prot;
-    }
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry == NULL) {
+    return NULL;
   }
 
-  return NULL;
+  return CoreFindHandleProtocol ((IHANDLE *)UserHandle, ProtEntry);
 }
 
 /**
@@ -11,18 +11,34 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define EFI_HANDLE_SIGNATURE  SIGNATURE_32('h','n','d','l')
 
+///
+/// Number of protocol interfaces a handle tracks in its inline lookup array.
+/// Handles carrying more protocols than this fall back to walking the
+/// Protocols list. Most handles carry fewer: an image handle has two, a
+/// partition has about six (device path, block I/O, block I/O 2, disk I/O,
+/// disk I/O 2 and partition info). On X64 the array and ProtocolCount add
+/// 56 bytes to each IHANDLE.
+///
+#define HANDLE_PROTOCOL_SLOT_COUNT  6
+
+struct _PROTOCOL_INTERFACE;
+
 ///
 /// IHANDLE - contains a list of protocol handles
 ///
 typedef struct {
-  UINTN         Signature;
+  UINTN                         Signature;
   /// All handles list of IHANDLE
-  LIST_ENTRY    AllHandles;
+  LIST_ENTRY                    AllHandles;
   /// List of PROTOCOL_INTERFACE's for this handle
-  LIST_ENTRY    Protocols;
-  UINTN         LocateRequest;
+  LIST_ENTRY                    Protocols;
+  UINTN                         LocateRequest;
   /// The Handle Database Key value when this handle was last created or modified
-  UINT64        Key;
+  UINT64                        Key;
+  /// Number of PROTOCOL_INTERFACE's on the Protocols list
+  UINTN                         ProtocolCount;
+  /// The PROTOCOL_INTERFACE's of the handle, valid while ProtocolCount <= HANDLE_PROTOCOL_SLOT_COUNT
+  struct _PROTOCOL_INTERFACE    *ProtocolSlots[HANDLE_PROTOCOL_SLOT_COUNT];
 } IHANDLE;
 
 #define ASSERT_IS_HANDLE(a)  ASSERT((a)->Signature == EFI_HANDLE_SIGNATURE)
@@ -34,10 +50,12 @@ typedef struct {
 /// database.  Each handler that supports this protocol is listed, along
 /// with a list of registered notifies.
 ///
-typedef struct {
+typedef struct _PROTOCOL_ENTRY {
   UINTN         Signature;
   /// Link Entry inserted to mProtocolDatabase
   LIST_ENTRY    AllEntries;
+  /// Link Entry inserted to the mProtocolHashTable bucket of ProtocolID
+  LIST_ENTRY    HashLink;
   /// ID of the protocol
   EFI_GUID      ProtocolID;
   /// All protocol interfaces
@@ -52,7 +70,7 @@ typedef struct {
 /// PROTOCOL_INTERFACE - each protocol installed on a handle is tracked
 /// with a protocol interface structure
 ///
-typedef struct {
+typedef struct _PROTOCOL_INTERFACE {
   UINTN             Signature;
   /// Link on IHANDLE.Protocols
   LIST_ENTRY        Link;
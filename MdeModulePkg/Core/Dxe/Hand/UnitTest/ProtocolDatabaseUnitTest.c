@@ -0,0 +1,1273 @@
+/** @file
+  This is a host-based unit test for the protocol database of the DXE core.
+
+  Handle.c, Locate.c and Notify.c are built as is, with the services they call
+  from the rest of the DXE core replaced here. Protocols are installed on and
+  uninstalled from many handles, with more protocols on some handles than fit
+  in their inline lookup array, and every lookup is checked against a model of
+  the expected database.
+
+  Dependency.c is built as well, as CoreInstallProtocolInterface() flags the
+  drivers whose DEPEX waits for the installed protocol. The DEPEX waiter tests
+  index the DEPEX of drivers, install protocols, and check the drivers flagged,
+  including after a driver is scheduled and its waiters are removed.
+
+  The benchmark compares the cycles per lookup of a protocol entry through the
+  hash buckets and through a linear walk of mProtocolDatabase, and of
+  CoreHandleProtocol(), for several protocol counts. It only runs when the test
+  is started with the --benchmark argument.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "DxeMain.h"
+#include "Handle.h"
+
+#define UNIT_TEST_NAME     "DXE Core Protocol Database Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_GUID_COUNT    1024
+#define TEST_HANDLE_COUNT  128
+
+///
+/// The most protocols installed on a handle by the tests, more than
+/// HANDLE_PROTOCOL_SLOT_COUNT.
+///
+#define TEST_MAX_PROTOCOLS_PER_HANDLE  (2 * HANDLE_PROTOCOL_SLOT_COUNT)
+
+#define BENCHMARK_LOOKUPS  100000
+
+///
+/// Room for the DEPEX of the drivers of the DEPEX waiter tests.
+///
+#define TEST_DEPEX_SIZE  (4 * (1 + sizeof (EFI_GUID)) + 4)
+
+///
+/// Number of buckets of the DEPEX waiter index in Dependency.c.
+///
+#define TEST_DEPEX_WAITER_BUCKET_COUNT  64
+
+extern LIST_ENTRY  mProtocolDatabase;
+
+EFI_HANDLE  gDxeCoreImageHandle = NULL;
+
+///
+/// Set when the test is started with the --benchmark argument.
+///
+BOOLEAN  mRunBenchmark = FALSE;
+
+EFI_GUID    *mTestGuids;
+EFI_HANDLE  mTestHandles[TEST_HANDLE_COUNT];
+///
+/// The interface expected on each handle for each GUID, NULL if none.
+///
+VOID        **mTestModel;
+UINT8       mTestInterfaces[TEST_HANDLE_COUNT * TEST_GUID_COUNT];
+EFI_TPL     mTestTpl         = TPL_APPLICATION;
+UINTN       mTestSignalCount = 0;
+
+/**
+  Marks a lock as acquired.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->Lock = EfiLockAcquired;
+}
+
+/**
+  Marks a lock as released.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  Lock->Lock = EfiLockReleased;
+}
+
+/**
+  Marks a lock as acquired, or fails if it is already held.
+
+  @param  Lock               The lock.
+
+  @retval EFI_SUCCESS        The lock is acquired.
+  @retval EFI_ACCESS_DENIED  The lock is already held.
+
+**/
+EFI_STATUS
+CoreAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  if (Lock->Lock == EfiLockAcquired) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Lock->Lock = EfiLockAcquired;
+  return EFI_SUCCESS;
+}
+
+/**
+  Raises the task priority level.
+
+  @param  NewTpl  The new task priority level.
+
+  @return The previous task priority level.
+
+**/
+EFI_TPL
+EFIAPI
+CoreRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl   = mTestTpl;
+  mTestTpl = NewTpl;
+  return OldTpl;
+}
+
+/**
+  Restores the task priority level.
+
+  @param  NewTpl  The task priority level to restore.
+
+**/
+VOID
+EFIAPI
+CoreRestoreTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  mTestTpl = NewTpl;
+}
+
+/**
+  Counts the protocol notify events signaled.
+
+  @param  UserEvent          The event.
+
+  @retval EFI_SUCCESS        Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreSignalEvent (
+  IN EFI_EVENT  UserEvent
+  )
+{
+  mTestSignalCount++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Frees pool allocated by the protocol database.
+
+  @param  Buffer             The buffer.
+
+  @retval EFI_SUCCESS        Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  There are no drivers to connect.
+
+  @param  ControllerHandle     The controller.
+  @param  DriverImageHandle    The drivers.
+  @param  RemainingDevicePath  The remaining device path.
+  @param  Recursive            Whether to connect recursively.
+
+  @retval EFI_NOT_FOUND        Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreConnectController (
+  IN  EFI_HANDLE                ControllerHandle,
+  IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+  IN  BOOLEAN                   Recursive
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  There are no drivers to disconnect.
+
+  @param  ControllerHandle     The controller.
+  @param  DriverImageHandle    The driver.
+  @param  ChildHandle          The child.
+
+  @retval EFI_SUCCESS          Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreDisconnectController (
+  IN  EFI_HANDLE  ControllerHandle,
+  IN  EFI_HANDLE  DriverImageHandle  OPTIONAL,
+  IN  EFI_HANDLE  ChildHandle        OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  All the architectural protocols are available.
+
+  @retval EFI_SUCCESS        Always.
+
+**/
+EFI_STATUS
+CoreAllEfiServicesAvailable (
+  VOID
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns a pseudo-random number.
+
+  @param[in, out] Seed    The state of the generator.
+
+  @return The next number of the sequence.
+
+**/
+UINT32
+TestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Creates random GUIDs, distinct from those of the other tests, and an empty
+  model of the database.
+
+  @param[in] Seed         The seed of the GUIDs.
+
+  @retval UNIT_TEST_PASSED                  The GUIDs were created.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+
+**/
+UNIT_TEST_STATUS
+TestCreateGuids (
+  IN UINT32  Seed
+  )
+{
+  UINTN  Index;
+
+  mTestGuids = AllocatePool (TEST_GUID_COUNT * sizeof (EFI_GUID));
+  mTestModel = AllocateZeroPool (TEST_HANDLE_COUNT * TEST_GUID_COUNT * sizeof (VOID *));
+  if ((mTestGuids == NULL) || (mTestModel == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  for (Index = 0; Index < TEST_GUID_COUNT * sizeof (EFI_GUID) / sizeof (UINT32); Index++) {
+    ((UINT32 *)mTestGuids)[Index] = TestRandom (&Seed) ^ (TestRandom (&Seed) << 16);
+  }
+
+  ZeroMem (mTestHandles, sizeof (mTestHandles));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the GUIDs and the model.
+
+**/
+VOID
+TestFreeGuids (
+  VOID
+  )
+{
+  FreePool (mTestGuids);
+  FreePool (mTestModel);
+}
+
+/**
+  Returns the model entry of a protocol on a test handle.
+
+  @param[in] HandleIndex  The index of the handle in mTestHandles.
+  @param[in] GuidIndex    The index of the protocol in mTestGuids.
+
+  @return The model entry.
+
+**/
+VOID **
+TestModel (
+  IN UINTN  HandleIndex,
+  IN UINTN  GuidIndex
+  )
+{
+  return &mTestModel[HandleIndex * TEST_GUID_COUNT + GuidIndex];
+}
+
+/**
+  Returns the number of protocols installed on a test handle in the model.
+
+  @param[in] HandleIndex  The index of the handle in mTestHandles.
+  @param[in] GuidCount    The number of GUIDs used by the test.
+
+  @return The number of protocols.
+
+**/
+UINTN
+TestModelCount (
+  IN UINTN  HandleIndex,
+  IN UINTN  GuidCount
+  )
+{
+  UINTN  GuidIndex;
+  UINTN  Count;
+
+  Count = 0;
+  for (GuidIndex = 0; GuidIndex < GuidCount; GuidIndex++) {
+    if (*TestModel (HandleIndex, GuidIndex) != NULL) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Installs a protocol on a test handle, creating the handle if needed, and
+  records it in the model.
+
+  @param[in] HandleIndex  The index of the handle in mTestHandles.
+  @param[in] GuidIndex    The index of the protocol in mTestGuids.
+
+  @return The status of CoreInstallProtocolInterface().
+
+**/
+EFI_STATUS
+TestInstall (
+  IN UINTN  HandleIndex,
+  IN UINTN  GuidIndex
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Interface;
+
+  Interface = &mTestInterfaces[HandleIndex * TEST_GUID_COUNT + GuidIndex];
+  Status    = CoreInstallProtocolInterface (&mTestHandles[HandleIndex], &mTestGuids[GuidIndex], EFI_NATIVE_INTERFACE, Interface);
+  if (!EFI_ERROR (Status)) {
+    *TestModel (HandleIndex, GuidIndex) = Interface;
+  }
+
+  return Status;
+}
+
+/**
+  Uninstalls a protocol from a test handle and records it in the model. The
+  handle is gone once its last protocol is uninstalled.
+
+  @param[in] HandleIndex  The index of the handle in mTestHandles.
+  @param[in] GuidIndex    The index of the protocol in mTestGuids.
+  @param[in] GuidCount    The number of GUIDs used by the test.
+
+  @return The status of CoreUninstallProtocolInterface().
+
+**/
+EFI_STATUS
+TestUninstall (
+  IN UINTN  HandleIndex,
+  IN UINTN  GuidIndex,
+  IN UINTN  GuidCount
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = CoreUninstallProtocolInterface (mTestHandles[HandleIndex], &mTestGuids[GuidIndex], *TestModel (HandleIndex, GuidIndex));
+  if (!EFI_ERROR (Status)) {
+    *TestModel (HandleIndex, GuidIndex) = NULL;
+    if (TestModelCount (HandleIndex, GuidCount) == 0) {
+      mTestHandles[HandleIndex] = NULL;
+    }
+  }
+
+  return Status;
+}
+
+/**
+  Uninstalls every protocol left on the test handles.
+
+  @param[in] GuidCount    The number of GUIDs used by the test.
+
+  @retval TRUE            Every protocol was uninstalled.
+  @retval FALSE           An uninstallation failed.
+
+**/
+BOOLEAN
+TestUninstallAll (
+  IN UINTN  GuidCount
+  )
+{
+  UINTN  HandleIndex;
+  UINTN  GuidIndex;
+
+  for (HandleIndex = 0; HandleIndex < TEST_HANDLE_COUNT; HandleIndex++) {
+    for (GuidIndex = 0; GuidIndex < GuidCount; GuidIndex++) {
+      if ((*TestModel (HandleIndex, GuidIndex) != NULL) &&
+          EFI_ERROR (TestUninstall (HandleIndex, GuidIndex, GuidCount)))
+      {
+        return FALSE;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Checks that CoreHandleProtocol(), CoreProtocolsPerHandle(),
+  CoreLocateHandleBuffer() and CoreLocateProtocol() match the model.
+
+  @param[in] GuidCount    The number of GUIDs used by the test.
+
+  @retval TRUE            The protocol database matches the model.
+  @retval FALSE           A lookup did not match.
+
+**/
+BOOLEAN
+CheckDatabase (
+  IN UINTN  GuidCount
+  )
+{
+  UINTN       HandleIndex;
+  UINTN       GuidIndex;
+  UINTN       Count;
+  UINTN       Index;
+  VOID        *Interface;
+  EFI_STATUS  Status;
+  EFI_GUID    **Protocols;
+  EFI_HANDLE  *Handles;
+  BOOLEAN     Match;
+
+  Match = TRUE;
+  for (HandleIndex = 0; HandleIndex < TEST_HANDLE_COUNT && Match; HandleIndex++) {
+    if (mTestHandles[HandleIndex] == NULL) {
+      continue;
+    }
+
+    for (GuidIndex = 0; GuidIndex < GuidCount; GuidIndex++) {
+      Status = CoreHandleProtocol (mTestHandles[HandleIndex], &mTestGuids[GuidIndex], &Interface);
+      if (*TestModel (HandleIndex, GuidIndex) == NULL) {
+        Match &= (BOOLEAN)(Status == EFI_UNSUPPORTED);
+      } else {
+        Match &= (BOOLEAN)(!EFI_ERROR (Status) && (Interface == *TestModel (HandleIndex, GuidIndex)));
+      }
+    }
+
+    Status = CoreProtocolsPerHandle (mTestHandles[HandleIndex], &Protocols, &Count);
+    if (EFI_ERROR (Status)) {
+      return FALSE;
+    }
+
+    Match &= (BOOLEAN)(Count == TestModelCount (HandleIndex, GuidCount));
+    FreePool (Protocols);
+  }
+
+  for (GuidIndex = 0; GuidIndex < GuidCount && Match; GuidIndex++) {
+    Count = 0;
+    for (HandleIndex = 0; HandleIndex < TEST_HANDLE_COUNT; HandleIndex++) {
+      if (*TestModel (HandleIndex, GuidIndex) != NULL) {
+        Count++;
+      }
+    }
+
+    Status = CoreLocateHandleBuffer (ByProtocol, &mTestGuids[GuidIndex], NULL, &Index, &Handles);
+    if (Count == 0) {
+      Match &= (BOOLEAN)(Status == EFI_NOT_FOUND);
+      Match &= (BOOLEAN)(CoreLocateProtocol (&mTestGuids[GuidIndex], NULL, &Interface) == EFI_NOT_FOUND);
+    } else {
+      Match &= (BOOLEAN)(!EFI_ERROR (Status) && (Index == Count));
+      if (!EFI_ERROR (Status)) {
+        FreePool (Handles);
+      }
+
+      Match &= (BOOLEAN)!EFI_ERROR (CoreLocateProtocol (&mTestGuids[GuidIndex], NULL, &Interface));
+    }
+  }
+
+  return Match;
+}
+
+/**
+  Creates the protocol database.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED                      The database was created.
+  @retval  UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  Out of memory.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ProtocolDatabaseSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC BOOLEAN  Initialized = FALSE;
+
+  if (!Initialized) {
+    if (EFI_ERROR (CoreInitializeHandleServices ())) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    Initialized = TRUE;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that a handle finds its protocols while they are installed and
+  uninstalled one at a time, as the number of protocols on the handle goes
+  above and back below HANDLE_PROTOCOL_SLOT_COUNT.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HandleSlotsOverflow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    GuidIndex;
+  UINTN    Order[TEST_MAX_PROTOCOLS_PER_HANDLE];
+  UINTN    Index;
+  UINTN    Swap;
+  UINT32   Seed;
+  IHANDLE  *Handle;
+
+  UT_ASSERT_EQUAL (TestCreateGuids (3), UNIT_TEST_PASSED);
+
+  for (GuidIndex = 0; GuidIndex < TEST_MAX_PROTOCOLS_PER_HANDLE; GuidIndex++) {
+    UT_ASSERT_NOT_EFI_ERROR (TestInstall (0, GuidIndex));
+    Handle = (IHANDLE *)mTestHandles[0];
+    UT_ASSERT_EQUAL (Handle->ProtocolCount, GuidIndex + 1);
+    UT_ASSERT_TRUE (CheckDatabase (TEST_MAX_PROTOCOLS_PER_HANDLE));
+  }
+
+  //
+  // A protocol is installed at most once on a handle.
+  //
+  UT_ASSERT_STATUS_EQUAL (TestInstall (0, HANDLE_PROTOCOL_SLOT_COUNT), EFI_INVALID_PARAMETER);
+
+  //
+  // Uninstall in a random order, so that the lookup array is rebuilt from
+  // the Protocols list with holes in the order of installation.
+  //
+  Seed = 5;
+  for (Index = 0; Index < ARRAY_SIZE (Order); Index++) {
+    Order[Index] = Index;
+  }
+
+  for (Index = ARRAY_SIZE (Order) - 1; Index > 0; Index--) {
+    GuidIndex        = TestRandom (&Seed) % (Index + 1);
+    Swap             = Order[Index];
+    Order[Index]     = Order[GuidIndex];
+    Order[GuidIndex] = Swap;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Order); Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (TestUninstall (0, Order[Index], TEST_MAX_PROTOCOLS_PER_HANDLE));
+    UT_ASSERT_TRUE (CheckDatabase (TEST_MAX_PROTOCOLS_PER_HANDLE));
+  }
+
+  UT_ASSERT_TRUE (mTestHandles[0] == NULL);
+
+  TestFreeGuids ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Installs and uninstalls protocols of many GUIDs on many handles at random,
+  and checks every lookup against the model.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LookupsMatchModel (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN       GuidCount;
+  UINTN       Step;
+  UINTN       HandleIndex;
+  UINTN       GuidIndex;
+  UINT32      Seed;
+  EFI_STATUS  Status;
+  VOID        *Interface;
+
+  UT_ASSERT_EQUAL (TestCreateGuids (7), UNIT_TEST_PASSED);
+
+  //
+  // More GUIDs than hash buckets, and handles with up to twice as many
+  // protocols as fit in their lookup array.
+  //
+  GuidCount = 256;
+  Seed      = 9;
+  for (Step = 0; Step < 4096; Step++) {
+    HandleIndex = TestRandom (&Seed) % TEST_HANDLE_COUNT;
+    GuidIndex   = TestRandom (&Seed) % GuidCount;
+    if (*TestModel (HandleIndex, GuidIndex) != NULL) {
+      UT_ASSERT_NOT_EFI_ERROR (TestUninstall (HandleIndex, GuidIndex, GuidCount));
+    } else if (TestModelCount (HandleIndex, GuidCount) < TEST_MAX_PROTOCOLS_PER_HANDLE) {
+      UT_ASSERT_NOT_EFI_ERROR (TestInstall (HandleIndex, GuidIndex));
+    }
+
+    if ((Step % 512) == 511) {
+      UT_ASSERT_TRUE (CheckDatabase (GuidCount));
+    }
+  }
+
+  UT_ASSERT_TRUE (CheckDatabase (GuidCount));
+
+  //
+  // An interface that is not the installed one is not found.
+  //
+  for (HandleIndex = 0; HandleIndex < TEST_HANDLE_COUNT; HandleIndex++) {
+    for (GuidIndex = 0; GuidIndex < GuidCount; GuidIndex++) {
+      if (*TestModel (HandleIndex, GuidIndex) != NULL) {
+        Interface = (UINT8 *)*TestModel (HandleIndex, GuidIndex) + 1;
+        Status    = CoreUninstallProtocolInterface (mTestHandles[HandleIndex], &mTestGuids[GuidIndex], Interface);
+        UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+        break;
+      }
+    }
+  }
+
+  UT_ASSERT_TRUE (TestUninstallAll (GuidCount));
+  UT_ASSERT_TRUE (CheckDatabase (GuidCount));
+
+  TestFreeGuids ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Appends an opcode, and the GUID of a test protocol for EFI_DEP_PUSH, to a
+  DEPEX.
+
+  @param[in, out] Cursor    The end of the DEPEX, moved past the opcode.
+  @param[in]      Opcode    The opcode.
+  @param[in]      GuidIndex The index of the protocol in mTestGuids, for
+                            EFI_DEP_PUSH.
+
+**/
+VOID
+TestAppendDepex (
+  IN OUT UINT8  **Cursor,
+  IN     UINT8  Opcode,
+  IN     UINTN  GuidIndex
+  )
+{
+  **Cursor = Opcode;
+  (*Cursor)++;
+  if (Opcode == EFI_DEP_PUSH) {
+    CopyGuid ((EFI_GUID *)*Cursor, &mTestGuids[GuidIndex]);
+    *Cursor += sizeof (EFI_GUID);
+  }
+}
+
+/**
+  Creates a driver entry with a DEPEX and preprocesses it, as the dispatcher
+  does when the driver is discovered.
+
+  @param[in] Depex        The DEPEX.
+  @param[in] DepexSize    The size of the DEPEX in bytes.
+
+  @return The driver entry, or NULL if out of memory.
+
+**/
+EFI_CORE_DRIVER_ENTRY *
+TestCreateDriver (
+  IN UINT8  *Depex,
+  IN UINTN  DepexSize
+  )
+{
+  EFI_CORE_DRIVER_ENTRY  *DriverEntry;
+
+  DriverEntry = AllocateZeroPool (sizeof (EFI_CORE_DRIVER_ENTRY));
+  if (DriverEntry == NULL) {
+    return NULL;
+  }
+
+  DriverEntry->Signature = EFI_CORE_DRIVER_ENTRY_SIGNATURE;
+  DriverEntry->Depex     = AllocateCopyPool (DepexSize, Depex);
+  DriverEntry->DepexSize = DepexSize;
+  InitializeListHead (&DriverEntry->DepexWaiters);
+  if (DriverEntry->Depex == NULL) {
+    FreePool (DriverEntry);
+    return NULL;
+  }
+
+  CorePreProcessDepex (DriverEntry);
+  return DriverEntry;
+}
+
+/**
+  Removes the waiters of a driver, as the dispatcher does when it schedules
+  the driver, and frees the driver entry.
+
+  @param[in] DriverEntry  The driver entry.
+
+**/
+VOID
+TestFreeDriver (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  CoreRemoveDepexWaiters (DriverEntry);
+  FreePool (DriverEntry->Depex);
+  FreePool (DriverEntry);
+}
+
+/**
+  Counts the DEPEX waiters of a driver.
+
+  @param[in] DriverEntry  The driver entry.
+
+  @return The number of waiters.
+
+**/
+UINTN
+TestCountWaiters (
+  IN EFI_CORE_DRIVER_ENTRY  *DriverEntry
+  )
+{
+  LIST_ENTRY  *Link;
+  UINTN       Count;
+
+  Count = 0;
+  for (Link = DriverEntry->DepexWaiters.ForwardLink; Link != &DriverEntry->DepexWaiters; Link = Link->ForwardLink) {
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+  Checks that CoreIndexDepex() indexes the protocols a DEPEX pushes only when
+  the DEPEX can be skipped until one of them is installed, and that
+  CoreDepexProtocolInstalled() flags exactly the drivers waiting for the
+  installed protocol, even when other GUIDs share its hash bucket.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DepexWaitersFlagged (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8                  Depex[TEST_DEPEX_SIZE];
+  UINT8                  *Cursor;
+  EFI_CORE_DRIVER_ENTRY  *Both;
+  EFI_CORE_DRIVER_ENTRY  *One;
+  EFI_CORE_DRIVER_ENTRY  *Not;
+  EFI_CORE_DRIVER_ENTRY  *Truncated;
+  EFI_CORE_DRIVER_ENTRY  *Colliding;
+  UINTN                  Collision;
+
+  UT_ASSERT_EQUAL (TestCreateGuids (13), UNIT_TEST_PASSED);
+
+  //
+  // Find a GUID that shares the hash bucket of GUID 4.
+  //
+  for (Collision = 5; Collision < TEST_GUID_COUNT; Collision++) {
+    if (CoreGetGuidHashIndex (&mTestGuids[Collision], TEST_DEPEX_WAITER_BUCKET_COUNT) ==
+        CoreGetGuidHashIndex (&mTestGuids[4], TEST_DEPEX_WAITER_BUCKET_COUNT))
+    {
+      break;
+    }
+  }
+
+  UT_ASSERT_TRUE (Collision < TEST_GUID_COUNT);
+
+  //
+  // PUSH 0 PUSH 1 AND END
+  //
+  Cursor = Depex;
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 0);
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 1);
+  TestAppendDepex (&Cursor, EFI_DEP_AND, 0);
+  TestAppendDepex (&Cursor, EFI_DEP_END, 0);
+  Both = TestCreateDriver (Depex, Cursor - Depex);
+  UT_ASSERT_NOT_NULL (Both);
+  UT_ASSERT_TRUE (Both->DepexIndexed);
+  UT_ASSERT_EQUAL (TestCountWaiters (Both), 2);
+
+  //
+  // PUSH 1 END
+  //
+  Cursor = Depex;
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 1);
+  TestAppendDepex (&Cursor, EFI_DEP_END, 0);
+  One = TestCreateDriver (Depex, Cursor - Depex);
+  UT_ASSERT_NOT_NULL (One);
+  UT_ASSERT_TRUE (One->DepexIndexed);
+  UT_ASSERT_EQUAL (TestCountWaiters (One), 1);
+
+  //
+  // PUSH 2 NOT END turns TRUE when GUID 2 is uninstalled, so it is not
+  // indexed and is evaluated on every pass.
+  //
+  Cursor = Depex;
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 2);
+  TestAppendDepex (&Cursor, EFI_DEP_NOT, 0);
+  TestAppendDepex (&Cursor, EFI_DEP_END, 0);
+  Not = TestCreateDriver (Depex, Cursor - Depex);
+  UT_ASSERT_NOT_NULL (Not);
+  UT_ASSERT_FALSE (Not->DepexIndexed);
+
+  //
+  // A PUSH cut short is not indexed either.
+  //
+  Cursor = Depex;
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 3);
+  Truncated = TestCreateDriver (Depex, Cursor - Depex - 1);
+  UT_ASSERT_NOT_NULL (Truncated);
+  UT_ASSERT_FALSE (Truncated->DepexIndexed);
+  UT_ASSERT_EQUAL (TestCountWaiters (Truncated), 0);
+
+  //
+  // PUSH 4 END
+  //
+  Cursor = Depex;
+  TestAppendDepex (&Cursor, EFI_DEP_PUSH, 4);
+  TestAppendDepex (&Cursor, EFI_DEP_END, 0);
+  Colliding = TestCreateDriver (Depex, Cursor - Depex);
+  UT_ASSERT_NOT_NULL (Colliding);
+  UT_ASSERT_TRUE (Colliding->DepexIndexed);
+
+  //
+  // The DEPEX are evaluated once after they are discovered.
+  //
+  UT_ASSERT_FALSE (CoreIsSchedulable (Both));
+  UT_ASSERT_FALSE (CoreIsSchedulable (One));
+  UT_ASSERT_TRUE (CoreIsSchedulable (Not));
+  Both->DepexReevaluate      = FALSE;
+  One->DepexReevaluate       = FALSE;
+  Colliding->DepexReevaluate = FALSE;
+
+  //
+  // A GUID in the same bucket as the one a driver waits for does not flag it.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (0, Collision));
+  UT_ASSERT_FALSE (Colliding->DepexReevaluate);
+  UT_ASSERT_FALSE (Both->DepexReevaluate);
+  UT_ASSERT_FALSE (One->DepexReevaluate);
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (0, 1));
+  UT_ASSERT_TRUE (Both->DepexReevaluate);
+  UT_ASSERT_TRUE (One->DepexReevaluate);
+  UT_ASSERT_FALSE (Colliding->DepexReevaluate);
+  UT_ASSERT_FALSE (CoreIsSchedulable (Both));
+  UT_ASSERT_TRUE (CoreIsSchedulable (One));
+  Both->DepexReevaluate = FALSE;
+  One->DepexReevaluate  = FALSE;
+
+  //
+  // Installing GUID 1 on another handle flags the drivers again.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (1, 1));
+  UT_ASSERT_TRUE (Both->DepexReevaluate);
+  Both->DepexReevaluate = FALSE;
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (1, 0));
+  UT_ASSERT_TRUE (Both->DepexReevaluate);
+  UT_ASSERT_TRUE (CoreIsSchedulable (Both));
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (1, 4));
+  UT_ASSERT_TRUE (Colliding->DepexReevaluate);
+
+  TestFreeDriver (Both);
+  TestFreeDriver (One);
+  TestFreeDriver (Not);
+  TestFreeDriver (Truncated);
+  TestFreeDriver (Colliding);
+
+  UT_ASSERT_TRUE (TestUninstallAll (TEST_GUID_COUNT));
+  TestFreeGuids ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Schedules drivers, which removes their DEPEX waiters, while other drivers
+  still wait for the same protocols, and checks that installing the
+  protocols afterwards only flags the drivers still waiting. The entries of
+  the scheduled drivers are freed first, so that a waiter left behind is
+  caught as a use after free.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ScheduledDriverWaitersRemoved (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8                  Depex[TEST_DEPEX_SIZE];
+  UINT8                  *Cursor;
+  EFI_CORE_DRIVER_ENTRY  *Drivers[TEST_HANDLE_COUNT];
+  UINTN                  Index;
+
+  UT_ASSERT_EQUAL (TestCreateGuids (17), UNIT_TEST_PASSED);
+
+  //
+  // Every driver waits for GUID 0 and GUID 1 + Index % 4, pushing GUID 0
+  // twice: PUSH 0 PUSH n AND PUSH 0 AND END.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (Drivers); Index++) {
+    Cursor = Depex;
+    TestAppendDepex (&Cursor, EFI_DEP_PUSH, 0);
+    TestAppendDepex (&Cursor, EFI_DEP_PUSH, 1 + Index % 4);
+    TestAppendDepex (&Cursor, EFI_DEP_AND, 0);
+    TestAppendDepex (&Cursor, EFI_DEP_PUSH, 0);
+    TestAppendDepex (&Cursor, EFI_DEP_AND, 0);
+    TestAppendDepex (&Cursor, EFI_DEP_END, 0);
+    Drivers[Index] = TestCreateDriver (Depex, Cursor - Depex);
+    UT_ASSERT_NOT_NULL (Drivers[Index]);
+    UT_ASSERT_TRUE (Drivers[Index]->DepexIndexed);
+    UT_ASSERT_EQUAL (TestCountWaiters (Drivers[Index]), 3);
+    Drivers[Index]->DepexReevaluate = FALSE;
+  }
+
+  //
+  // Schedule every other driver, with its waiters still registered.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (Drivers); Index += 2) {
+    CoreRemoveDepexWaiters (Drivers[Index]);
+    UT_ASSERT_FALSE (Drivers[Index]->DepexIndexed);
+    UT_ASSERT_EQUAL (TestCountWaiters (Drivers[Index]), 0);
+    FreePool (Drivers[Index]->Depex);
+    FreePool (Drivers[Index]);
+    Drivers[Index] = NULL;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (0, 2));
+  for (Index = 1; Index < ARRAY_SIZE (Drivers); Index += 2) {
+    UT_ASSERT_EQUAL (Drivers[Index]->DepexReevaluate, (BOOLEAN)(Index % 4 == 1));
+    Drivers[Index]->DepexReevaluate = FALSE;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (0, 0));
+  for (Index = 1; Index < ARRAY_SIZE (Drivers); Index += 2) {
+    UT_ASSERT_TRUE (Drivers[Index]->DepexReevaluate);
+    UT_ASSERT_EQUAL (CoreIsSchedulable (Drivers[Index]), (BOOLEAN)(Index % 4 == 1));
+    TestFreeDriver (Drivers[Index]);
+  }
+
+  //
+  // Nothing waits any more.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (1, 0));
+  UT_ASSERT_NOT_EFI_ERROR (TestInstall (1, 4));
+
+  UT_ASSERT_TRUE (TestUninstallAll (TEST_GUID_COUNT));
+  TestFreeGuids ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Finds the protocol entry of a GUID by walking mProtocolDatabase, as
+  CoreFindProtocolEntry() did before the hash buckets.
+
+  @param[in] Protocol     The GUID of the protocol.
+
+  @return The protocol entry, or NULL if there is none.
+
+**/
+PROTOCOL_ENTRY *
+LinearFindProtocolEntry (
+  IN EFI_GUID  *Protocol
+  )
+{
+  LIST_ENTRY      *Link;
+  PROTOCOL_ENTRY  *Item;
+
+  for (Link = mProtocolDatabase.ForwardLink; Link != &mProtocolDatabase; Link = Link->ForwardLink) {
+    Item = CR (Link, PROTOCOL_ENTRY, AllEntries, PROTOCOL_ENTRY_SIGNATURE);
+    if (CompareGuid (&Item->ProtocolID, Protocol)) {
+      return Item;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Reports the cycles per protocol entry lookup through the hash buckets and
+  through a linear walk of mProtocolDatabase, and per CoreHandleProtocol()
+  call, as more protocols are installed.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ProtocolDatabaseBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  GuidCounts[] = { 64, 256, 1024 };
+  UINTN               Pass;
+  UINTN               Index;
+  UINTN               GuidIndex;
+  UINTN               HandleIndex;
+  UINTN               Installed;
+  UINT32              Seed;
+  UINT64              Start;
+  UINT64              HashCycles;
+  UINT64              LinearCycles;
+  UINT64              HandleProtocolCycles;
+  PROTOCOL_ENTRY      *Entry;
+  VOID                *Interface;
+
+  UT_ASSERT_EQUAL (TestCreateGuids (11), UNIT_TEST_PASSED);
+
+  Installed = 0;
+  for (Pass = 0; Pass < ARRAY_SIZE (GuidCounts); Pass++) {
+    //
+    // Each GUID is installed on one handle, four protocols per handle.
+    //
+    for ( ; Installed < GuidCounts[Pass]; Installed++) {
+      UT_ASSERT_NOT_EFI_ERROR (TestInstall (Installed % TEST_HANDLE_COUNT, Installed));
+    }
+
+    Seed = 13;
+    CoreAcquireProtocolLock ();
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      Entry = CoreFindProtocolEntry (&mTestGuids[TestRandom (&Seed) % Installed], FALSE);
+      ASSERT (Entry != NULL);
+    }
+
+    HashCycles = AsmReadTsc () - Start;
+
+    Seed  = 13;
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      Entry = LinearFindProtocolEntry (&mTestGuids[TestRandom (&Seed) % Installed]);
+      ASSERT (Entry != NULL);
+    }
+
+    LinearCycles = AsmReadTsc () - Start;
+    CoreReleaseProtocolLock ();
+
+    Seed  = 13;
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      GuidIndex   = TestRandom (&Seed) % Installed;
+      HandleIndex = GuidIndex % TEST_HANDLE_COUNT;
+      CoreHandleProtocol (mTestHandles[HandleIndex], &mTestGuids[GuidIndex], &Interface);
+    }
+
+    HandleProtocolCycles = AsmReadTsc () - Start;
+
+    UT_LOG_INFO (
+      "%d protocols: %ld cycles per hashed entry lookup, %ld per linear walk, %ld per HandleProtocol\n",
+      Installed,
+      DivU64x32 (HashCycles, BENCHMARK_LOOKUPS),
+      DivU64x32 (LinearCycles, BENCHMARK_LOOKUPS),
+      DivU64x32 (HandleProtocolCycles, BENCHMARK_LOOKUPS)
+      );
+  }
+
+  UT_ASSERT_TRUE (TestUninstallAll (Installed));
+
+  TestFreeGuids ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Main entry point to the unit test.
+
+  @retval EFI_SUCCESS       The unit test ran.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      DatabaseTests;
+  UNIT_TEST_SUITE_HANDLE      DepexTests;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&DatabaseTests, Framework, "Protocol Database Tests", "ProtocolDatabase", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the protocol database tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DatabaseTests, "Handles with more protocols than lookup slots", "HandleSlotsOverflow", HandleSlotsOverflow, ProtocolDatabaseSetup, NULL, NULL);
+  AddTestCase (DatabaseTests, "Lookups match the installed protocols", "LookupsMatchModel", LookupsMatchModel, ProtocolDatabaseSetup, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&DepexTests, Framework, "DEPEX Waiter Tests", "DepexWaiters", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the DEPEX waiter tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (DepexTests, "Installed protocols flag the drivers waiting for them", "DepexWaitersFlagged", DepexWaitersFlagged, ProtocolDatabaseSetup, NULL, NULL);
+  AddTestCase (DepexTests, "Scheduled drivers no longer wait", "ScheduledDriverWaitersRemoved", ScheduledDriverWaitersRemoved, ProtocolDatabaseSetup, NULL, NULL);
+
+  if (mRunBenchmark) {
+    Status = CreateUnitTestSuite (&BenchmarkTests, Framework, "Protocol Database Benchmark", "ProtocolDatabaseBenchmark", NULL, NULL);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the protocol database benchmark.\n"));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto EXIT;
+    }
+
+    AddTestCase (BenchmarkTests, "Cycles per lookup vs. protocol count", "Benchmark", ProtocolDatabaseBenchmark, ProtocolDatabaseSetup, NULL, NULL);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  The benchmark only runs with the --benchmark argument.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  mRunBenchmark = (BOOLEAN)((Argc > 1) && (AsciiStrCmp (Argv[1], "--benchmark") == 0));
+  return UnitTestingEntry ();
+}
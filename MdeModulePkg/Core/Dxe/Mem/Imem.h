@@ -9,22 +9,33 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _IMEM_H_
 #define _IMEM_H_
 
+#include "MemoryMapTree.h"
+
 //
 // MEMORY_MAP_ENTRY
 //
 
 #define MEMORY_MAP_SIGNATURE  SIGNATURE_32('m','m','a','p')
 typedef struct {
-  UINTN              Signature;
-  LIST_ENTRY         Link;
-  BOOLEAN            FromPages;
-
-  EFI_MEMORY_TYPE    Type;
-  UINT64             Start;
-  UINT64             End;
-
-  UINT64             VirtualStart;
-  UINT64             Attribute;
+  UINTN                   Signature;
+  LIST_ENTRY              Link;
+  BOOLEAN                 FromPages;
+
+  EFI_MEMORY_TYPE         Type;
+  UINT64                  Start;
+  UINT64                  End;
+
+  UINT64                  VirtualStart;
+  UINT64                  Attribute;
+
+  ///
+  /// Node in the index of all the descriptors by start address.
+  ///
+  MEMORY_MAP_TREE_NODE    AddressNode;
+  ///
+  /// Node in the index of the free descriptors that can be allocated from.
+  ///
+  MEMORY_MAP_TREE_NODE    FreeNode;
 } MEMORY_MAP;
 
 //
@@ -99,6 +110,37 @@ CoreFreePoolI (
   OUT EFI_MEMORY_TYPE  *PoolType OPTIONAL
   );
 
+/**
+  Get the size of the pool slab statistics reported in the memory profile.
+
+  @return The size in bytes of the MEMORY_PROFILE_POOL_STATS record and the
+          MEMORY_PROFILE_POOL_CLASS records following it, or 0 if the slab
+          allocator is disabled.
+
+**/
+UINTN
+CoreGetPoolStatsSize (
+  VOID
+  );
+
+/**
+  Copy the pool slab statistics into the memory profile.
+
+  Slabs may have been created or released since CoreGetPoolStatsSize() was
+  called, so the records that do not fit in Buffer are dropped.
+
+  @param  Buffer                 The buffer receiving the statistics
+  @param  BufferSize             The size in bytes of Buffer
+
+  @return The size in bytes of the statistics copied into Buffer.
+
+**/
+UINTN
+CoreCopyPoolStats (
+  OUT VOID   *Buffer,
+  IN  UINTN  BufferSize
+  );
+
 /**
   Enter critical section by gaining lock on gMemoryLock.
 
@@ -0,0 +1,576 @@
+/** @file
+  Red-black tree of memory map descriptors ordered by start address.
+
+  The algorithms follow "Introduction to Algorithms" by Cormen et al., with
+  NULL leaves. The largest range size of each subtree is kept up to date on
+  the path to the root on insertion and removal, and locally on rotations.
+
+Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Library/DebugLib.h>
+#include "MemoryMapTree.h"
+
+/**
+  Returns the start address of the range of a node.
+
+  @param[in] Tree         The tree of the node.
+  @param[in] Node         The node.
+
+  @return The first address of the range.
+
+**/
+UINT64
+MemoryMapTreeStart (
+  IN MEMORY_MAP_TREE       *Tree,
+  IN MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  UINT64  Start;
+  UINT64  End;
+
+  Tree->GetRange (Node, &Start, &End);
+  return Start;
+}
+
+/**
+  Recomputes the largest range size of the subtree rooted at a node from its
+  own range and from its children.
+
+  @param[in]      Tree    The tree of the node.
+  @param[in, out] Node    The node.
+
+**/
+VOID
+MemoryMapTreeRecompute (
+  IN     MEMORY_MAP_TREE       *Tree,
+  IN OUT MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  UINT64  Start;
+  UINT64  End;
+  UINT64  MaxSize;
+
+  Tree->GetRange (Node, &Start, &End);
+  MaxSize = (End >= Start) ? End - Start + 1 : 0;
+
+  if ((Node->Left != NULL) && (Node->Left->MaxSize > MaxSize)) {
+    MaxSize = Node->Left->MaxSize;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxSize > MaxSize)) {
+    MaxSize = Node->Right->MaxSize;
+  }
+
+  Node->MaxSize = MaxSize;
+}
+
+/**
+  Recomputes the largest range sizes from a node up to the root.
+
+  @param[in] Tree         The tree of the node.
+  @param[in] Node         The node to start from, or NULL.
+
+**/
+VOID
+MemoryMapTreeRecomputePath (
+  IN MEMORY_MAP_TREE       *Tree,
+  IN MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  while (Node != NULL) {
+    MemoryMapTreeRecompute (Tree, Node);
+    Node = Node->Parent;
+  }
+}
+
+/**
+  Replaces a child of the parent of a node, or the root, by another node.
+
+  @param[in, out] Tree    The tree.
+  @param[in]      Node    The node to replace.
+  @param[in]      Child   The node that takes the place of Node, or NULL.
+
+**/
+VOID
+MemoryMapTreeReplaceChild (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN     MEMORY_MAP_TREE_NODE  *Node,
+  IN     MEMORY_MAP_TREE_NODE  *Child
+  )
+{
+  if (Node->Parent == NULL) {
+    Tree->Root = Child;
+  } else if (Node == Node->Parent->Left) {
+    Node->Parent->Left = Child;
+  } else {
+    Node->Parent->Right = Child;
+  }
+}
+
+/**
+  Rotates the subtree rooted at a node to the left.
+
+  @param[in, out] Tree    The tree.
+  @param[in, out] Node    The root of the subtree, with a right child.
+
+**/
+VOID
+MemoryMapTreeRotateLeft (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN OUT MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Pivot;
+
+  Pivot       = Node->Right;
+  Node->Right = Pivot->Left;
+  if (Pivot->Left != NULL) {
+    Pivot->Left->Parent = Node;
+  }
+
+  Pivot->Parent = Node->Parent;
+  MemoryMapTreeReplaceChild (Tree, Node, Pivot);
+  Pivot->Left  = Node;
+  Node->Parent = Pivot;
+
+  MemoryMapTreeRecompute (Tree, Node);
+  MemoryMapTreeRecompute (Tree, Pivot);
+}
+
+/**
+  Rotates the subtree rooted at a node to the right.
+
+  @param[in, out] Tree    The tree.
+  @param[in, out] Node    The root of the subtree, with a left child.
+
+**/
+VOID
+MemoryMapTreeRotateRight (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN OUT MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Pivot;
+
+  Pivot      = Node->Left;
+  Node->Left = Pivot->Right;
+  if (Pivot->Right != NULL) {
+    Pivot->Right->Parent = Node;
+  }
+
+  Pivot->Parent = Node->Parent;
+  MemoryMapTreeReplaceChild (Tree, Node, Pivot);
+  Pivot->Right = Node;
+  Node->Parent = Pivot;
+
+  MemoryMapTreeRecompute (Tree, Node);
+  MemoryMapTreeRecompute (Tree, Pivot);
+}
+
+/**
+  Checks whether a node is red. NULL leaves are black.
+
+  @param[in] Node         The node, or NULL.
+
+  @retval TRUE            The node is red.
+  @retval FALSE           The node is black.
+
+**/
+BOOLEAN
+MemoryMapTreeIsRed (
+  IN MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  return (BOOLEAN)((Node != NULL) && Node->Red);
+}
+
+/**
+  Inserts a node in the tree, by the start address of its range.
+
+  @param[in, out] Tree    The tree.
+  @param[in]      Node    The node to insert, not in any tree.
+
+**/
+VOID
+MemoryMapTreeInsert (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN     MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Parent;
+  MEMORY_MAP_TREE_NODE  *Current;
+  MEMORY_MAP_TREE_NODE  *Grand;
+  MEMORY_MAP_TREE_NODE  *Uncle;
+  UINT64                Start;
+
+  Start   = MemoryMapTreeStart (Tree, Node);
+  Parent  = NULL;
+  Current = Tree->Root;
+  while (Current != NULL) {
+    Parent = Current;
+    if (Start < MemoryMapTreeStart (Tree, Current)) {
+      Current = Current->Left;
+    } else {
+      Current = Current->Right;
+    }
+  }
+
+  Node->Parent = Parent;
+  Node->Left   = NULL;
+  Node->Right  = NULL;
+  Node->Red    = TRUE;
+
+  if (Parent == NULL) {
+    Tree->Root = Node;
+  } else if (Start < MemoryMapTreeStart (Tree, Parent)) {
+    Parent->Left = Node;
+  } else {
+    Parent->Right = Node;
+  }
+
+  Tree->Count++;
+  MemoryMapTreeRecomputePath (Tree, Node);
+
+  //
+  // Restore the red-black properties. Rotations keep the largest range
+  // sizes of the subtrees above them.
+  //
+  while (MemoryMapTreeIsRed (Node->Parent)) {
+    Parent = Node->Parent;
+    Grand  = Parent->Parent;
+    if (Parent == Grand->Left) {
+      Uncle = Grand->Right;
+      if (MemoryMapTreeIsRed (Uncle)) {
+        Parent->Red = FALSE;
+        Uncle->Red  = FALSE;
+        Grand->Red  = TRUE;
+        Node        = Grand;
+        continue;
+      }
+
+      if (Node == Parent->Right) {
+        MemoryMapTreeRotateLeft (Tree, Parent);
+        Node   = Parent;
+        Parent = Node->Parent;
+      }
+
+      Parent->Red = FALSE;
+      Grand->Red  = TRUE;
+      MemoryMapTreeRotateRight (Tree, Grand);
+    } else {
+      Uncle = Grand->Left;
+      if (MemoryMapTreeIsRed (Uncle)) {
+        Parent->Red = FALSE;
+        Uncle->Red  = FALSE;
+        Grand->Red  = TRUE;
+        Node        = Grand;
+        continue;
+      }
+
+      if (Node == Parent->Left) {
+        MemoryMapTreeRotateRight (Tree, Parent);
+        Node   = Parent;
+        Parent = Node->Parent;
+      }
+
+      Parent->Red = FALSE;
+      Grand->Red  = TRUE;
+      MemoryMapTreeRotateLeft (Tree, Grand);
+    }
+  }
+
+  Tree->Root->Red = FALSE;
+}
+
+/**
+  Removes a node from the tree.
+
+  @param[in, out] Tree    The tree.
+  @param[in]      Node    The node to remove, in Tree.
+
+**/
+VOID
+MemoryMapTreeRemove (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN     MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Spliced;
+  MEMORY_MAP_TREE_NODE  *Child;
+  MEMORY_MAP_TREE_NODE  *Parent;
+  MEMORY_MAP_TREE_NODE  *Sibling;
+  BOOLEAN               SplicedRed;
+
+  ASSERT (Tree->Count > 0);
+
+  //
+  // Splice out Node if it has at most one child, or else its successor,
+  // which then takes the place of Node.
+  //
+  Spliced = Node;
+  if ((Node->Left != NULL) && (Node->Right != NULL)) {
+    Spliced = Node->Right;
+    while (Spliced->Left != NULL) {
+      Spliced = Spliced->Left;
+    }
+  }
+
+  Child      = (Spliced->Left != NULL) ? Spliced->Left : Spliced->Right;
+  Parent     = Spliced->Parent;
+  SplicedRed = Spliced->Red;
+
+  if (Child != NULL) {
+    Child->Parent = Parent;
+  }
+
+  MemoryMapTreeReplaceChild (Tree, Spliced, Child);
+
+  if (Spliced != Node) {
+    if (Parent == Node) {
+      Parent = Spliced;
+    }
+
+    Spliced->Parent = Node->Parent;
+    Spliced->Left   = Node->Left;
+    Spliced->Right  = Node->Right;
+    Spliced->Red    = Node->Red;
+    MemoryMapTreeReplaceChild (Tree, Node, Spliced);
+    if (Spliced->Left != NULL) {
+      Spliced->Left->Parent = Spliced;
+    }
+
+    if (Spliced->Right != NULL) {
+      Spliced->Right->Parent = Spliced;
+    }
+  }
+
+  Tree->Count--;
+  MemoryMapTreeRecomputePath (Tree, Parent);
+
+  Node->Parent = NULL;
+  Node->Left   = NULL;
+  Node->Right  = NULL;
+
+  if (SplicedRed) {
+    return;
+  }
+
+  //
+  // A black node was removed from the path through Child.
+  //
+  while ((Child != Tree->Root) && !MemoryMapTreeIsRed (Child)) {
+    if (Child == Parent->Left) {
+      Sibling = Parent->Right;
+      if (Sibling->Red) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        MemoryMapTreeRotateLeft (Tree, Parent);
+        Sibling = Parent->Right;
+      }
+
+      if (!MemoryMapTreeIsRed (Sibling->Left) && !MemoryMapTreeIsRed (Sibling->Right)) {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+        continue;
+      }
+
+      if (!MemoryMapTreeIsRed (Sibling->Right)) {
+        Sibling->Left->Red = FALSE;
+        Sibling->Red       = TRUE;
+        MemoryMapTreeRotateRight (Tree, Sibling);
+        Sibling = Parent->Right;
+      }
+
+      Sibling->Red        = Parent->Red;
+      Parent->Red         = FALSE;
+      Sibling->Right->Red = FALSE;
+      MemoryMapTreeRotateLeft (Tree, Parent);
+    } else {
+      Sibling = Parent->Left;
+      if (Sibling->Red) {
+        Sibling->Red = FALSE;
+        Parent->Red  = TRUE;
+        MemoryMapTreeRotateRight (Tree, Parent);
+        Sibling = Parent->Left;
+      }
+
+      if (!MemoryMapTreeIsRed (Sibling->Left) && !MemoryMapTreeIsRed (Sibling->Right)) {
+        Sibling->Red = TRUE;
+        Child        = Parent;
+        Parent       = Child->Parent;
+        continue;
+      }
+
+      if (!MemoryMapTreeIsRed (Sibling->Left)) {
+        Sibling->Right->Red = FALSE;
+        Sibling->Red        = TRUE;
+        MemoryMapTreeRotateLeft (Tree, Sibling);
+        Sibling = Parent->Left;
+      }
+
+      Sibling->Red       = Parent->Red;
+      Parent->Red        = FALSE;
+      Sibling->Left->Red = FALSE;
+      MemoryMapTreeRotateRight (Tree, Parent);
+    }
+
+    Child = Tree->Root;
+  }
+
+  if (Child != NULL) {
+    Child->Red = FALSE;
+  }
+}
+
+/**
+  Updates the tree after the range of a node was shrunk in place. The range
+  must stay between the ranges of the previous and the next nodes.
+
+  @param[in] Tree         The tree.
+  @param[in] Node         The node whose range was changed, in Tree.
+
+**/
+VOID
+MemoryMapTreeUpdate (
+  IN MEMORY_MAP_TREE       *Tree,
+  IN MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  MemoryMapTreeRecomputePath (Tree, Node);
+}
+
+/**
+  Finds the node with the highest start address not above an address.
+
+  @param[in] Tree         The tree.
+  @param[in] Address      The address to look up.
+
+  @return The node found, or NULL if all the nodes start above Address.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeFindFloor (
+  IN MEMORY_MAP_TREE  *Tree,
+  IN UINT64           Address
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Current;
+  MEMORY_MAP_TREE_NODE  *Found;
+
+  Found   = NULL;
+  Current = Tree->Root;
+  while (Current != NULL) {
+    if (MemoryMapTreeStart (Tree, Current) <= Address) {
+      Found   = Current;
+      Current = Current->Right;
+    } else {
+      Current = Current->Left;
+    }
+  }
+
+  return Found;
+}
+
+/**
+  Finds the node with the highest start address below a limit in a subtree,
+  among the nodes whose range is at least a given size.
+
+  @param[in] Tree         The tree.
+  @param[in] Node         The root of the subtree, or NULL.
+  @param[in] Limit        The start address of the node must be below Limit.
+  @param[in] MinSize      The minimum size in bytes of the range of the node.
+
+  @return The node found, or NULL if there is none.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeFindLastFitInSubtree (
+  IN MEMORY_MAP_TREE       *Tree,
+  IN MEMORY_MAP_TREE_NODE  *Node,
+  IN UINT64                Limit,
+  IN UINT64                MinSize
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Found;
+  UINT64                Start;
+  UINT64                End;
+
+  //
+  // Subtrees without a range large enough are skipped as a whole.
+  //
+  while ((Node != NULL) && (Node->MaxSize >= MinSize)) {
+    Tree->GetRange (Node, &Start, &End);
+    if (Start >= Limit) {
+      Node = Node->Left;
+      continue;
+    }
+
+    Found = MemoryMapTreeFindLastFitInSubtree (Tree, Node->Right, Limit, MinSize);
+    if (Found != NULL) {
+      return Found;
+    }
+
+    if ((End >= Start) && (End - Start + 1 >= MinSize)) {
+      return Node;
+    }
+
+    Node = Node->Left;
+  }
+
+  return NULL;
+}
+
+/**
+  Finds the node with the highest start address below a limit, among the
+  nodes whose range is at least a given size.
+
+  @param[in] Tree         The tree.
+  @param[in] Limit        The start address of the node must be below Limit.
+  @param[in] MinSize      The minimum size in bytes of the range of the node.
+
+  @return The node found, or NULL if there is none.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeFindLastFit (
+  IN MEMORY_MAP_TREE  *Tree,
+  IN UINT64           Limit,
+  IN UINT64           MinSize
+  )
+{
+  return MemoryMapTreeFindLastFitInSubtree (Tree, Tree->Root, Limit, MinSize);
+}
+
+/**
+  Returns the node that follows a node in start address order.
+
+  @param[in] Node         A node of a tree.
+
+  @return The next node, or NULL if Node is the last one.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeNext (
+  IN MEMORY_MAP_TREE_NODE  *Node
+  )
+{
+  if (Node->Right != NULL) {
+    Node = Node->Right;
+    while (Node->Left != NULL) {
+      Node = Node->Left;
+    }
+
+    return Node;
+  }
+
+  while ((Node->Parent != NULL) && (Node == Node->Parent->Right)) {
+    Node = Node->Parent;
+  }
+
+  return Node->Parent;
+}
@@ -0,0 +1,140 @@
+/** @file
+  Red-black tree of memory map descriptors ordered by start address, used to
+  index the memory map of the DXE core.
+
+  The tree nodes are embedded in the descriptors, so that no memory is
+  allocated to index a descriptor. The range of a descriptor is read back
+  through a callback of the tree, and every node also records the largest
+  range size in its subtree, to find a free range large enough without
+  walking through the smaller ones.
+
+Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MEMORY_MAP_TREE_H_
+#define _MEMORY_MAP_TREE_H_
+
+typedef struct _MEMORY_MAP_TREE_NODE MEMORY_MAP_TREE_NODE;
+
+struct _MEMORY_MAP_TREE_NODE {
+  MEMORY_MAP_TREE_NODE    *Parent;
+  MEMORY_MAP_TREE_NODE    *Left;
+  MEMORY_MAP_TREE_NODE    *Right;
+  BOOLEAN                 Red;
+  ///
+  /// The largest range size in bytes in the subtree rooted at this node.
+  ///
+  UINT64                  MaxSize;
+};
+
+/**
+  Returns the range of the descriptor that embeds a tree node.
+
+  @param[in]  Node        The tree node.
+  @param[out] Start       The first address of the range.
+  @param[out] End         The last address of the range.
+
+**/
+typedef
+VOID
+(*MEMORY_MAP_TREE_GET_RANGE)(
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+typedef struct {
+  MEMORY_MAP_TREE_NODE         *Root;
+  UINTN                        Count;
+  MEMORY_MAP_TREE_GET_RANGE    GetRange;
+} MEMORY_MAP_TREE;
+
+/**
+  Inserts a node in the tree, by the start address of its range.
+
+  @param[in, out] Tree    The tree.
+  @param[in]      Node    The node to insert, not in any tree.
+
+**/
+VOID
+MemoryMapTreeInsert (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN     MEMORY_MAP_TREE_NODE  *Node
+  );
+
+/**
+  Removes a node from the tree.
+
+  @param[in, out] Tree    The tree.
+  @param[in]      Node    The node to remove, in Tree.
+
+**/
+VOID
+MemoryMapTreeRemove (
+  IN OUT MEMORY_MAP_TREE       *Tree,
+  IN     MEMORY_MAP_TREE_NODE  *Node
+  );
+
+/**
+  Updates the tree after the range of a node was shrunk in place. The range
+  must stay between the ranges of the previous and the next nodes.
+
+  @param[in] Tree         The tree.
+  @param[in] Node         The node whose range was changed, in Tree.
+
+**/
+VOID
+MemoryMapTreeUpdate (
+  IN MEMORY_MAP_TREE       *Tree,
+  IN MEMORY_MAP_TREE_NODE  *Node
+  );
+
+/**
+  Finds the node with the highest start address not above an address.
+
+  @param[in] Tree         The tree.
+  @param[in] Address      The address to look up.
+
+  @return The node found, or NULL if all the nodes start above Address.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeFindFloor (
+  IN MEMORY_MAP_TREE  *Tree,
+  IN UINT64           Address
+  );
+
+/**
+  Finds the node with the highest start address below a limit, among the
+  nodes whose range is at least a given size.
+
+  @param[in] Tree         The tree.
+  @param[in] Limit        The start address of the node must be below Limit.
+  @param[in] MinSize      The minimum size in bytes of the range of the node.
+
+  @return The node found, or NULL if there is none.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeFindLastFit (
+  IN MEMORY_MAP_TREE  *Tree,
+  IN UINT64           Limit,
+  IN UINT64           MinSize
+  );
+
+/**
+  Returns the node that follows a node in start address order.
+
+  @param[in] Node         A node of a tree.
+
+  @return The next node, or NULL if Node is the last one.
+
+**/
+MEMORY_MAP_TREE_NODE *
+MemoryMapTreeNext (
+  IN MEMORY_MAP_TREE_NODE  *Node
+  );
+
+#endif
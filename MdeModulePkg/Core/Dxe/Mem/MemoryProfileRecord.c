@@ -1483,6 +1483,8 @@ MemoryProfileGetDataSize (
     }
   }
 
+  TotalSize += CoreGetPoolStatsSize ();
+
   return TotalSize;
 }
 
@@ -1490,11 +1492,15 @@ MemoryProfileGetDataSize (
   Copy memory profile data.
 
   @param ProfileBuffer  The buffer to hold memory profile data.
+  @param ProfileSize    The size of the buffer, as returned by MemoryProfileGetDataSize().
+
+  @return The size of the memory profile data copied into the buffer.
 
 **/
-VOID
+UINTN
 MemoryProfileCopyData (
-  IN VOID  *ProfileBuffer
+  IN VOID   *ProfileBuffer,
+  IN UINTN  ProfileSize
   )
 {
   MEMORY_PROFILE_CONTEXT           *Context;
@@ -1509,10 +1515,11 @@ MemoryProfileCopyData (
   LIST_ENTRY                       *AllocLink;
   UINTN                            PdbSize;
   UINTN                            ActionStringSize;
+  UINTN                            Size;
 
   ContextData = GetMemoryProfileContext ();
   if (ContextData == NULL) {
-    return;
+    return 0;
   }
 
   Context = ProfileBuffer;
@@ -1560,6 +1567,13 @@ MemoryProfileCopyData (
 
     DriverInfo = (MEMORY_PROFILE_DRIVER_INFO *)AllocInfo;
   }
+
+  //
+  // The pool statistics take the rest of the buffer, or less if slabs were
+  // released since its size was computed.
+  //
+  Size = (UINTN)DriverInfo - (UINTN)ProfileBuffer;
+  return Size + CoreCopyPoolStats (DriverInfo, ProfileSize - Size);
 }
 
 /**
@@ -1604,8 +1618,7 @@ ProfileProtocolGetData (
     return EFI_BUFFER_TOO_SMALL;
   }
 
-  *ProfileSize = Size;
-  MemoryProfileCopyData (ProfileBuffer);
+  *ProfileSize = MemoryProfileCopyData (ProfileBuffer, Size);
 
   mMemoryProfileGettingStatus = MemoryProfileGettingStatus;
   return EFI_SUCCESS;
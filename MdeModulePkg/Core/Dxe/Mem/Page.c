@@ -46,6 +46,30 @@ UINTN       mFreeMapStack = 0;
 LIST_ENTRY  mFreeMemoryMapEntryList           = INITIALIZE_LIST_HEAD_VARIABLE (mFreeMemoryMapEntryList);
 BOOLEAN     mMemoryTypeInformationInitialized = FALSE;
 
+VOID
+MemoryMapAddressRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+VOID
+MemoryMapFreeRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+///
+/// Index of all the descriptors of gMemoryMap, including the ones on the
+/// temporary descriptor stack, by start address
+///
+MEMORY_MAP_TREE  mMemoryMapTree = { NULL, 0, MemoryMapAddressRange };
+///
+/// Index of the descriptors of free memory that pages are allocated from
+///
+MEMORY_MAP_TREE  mFreeMemoryMapTree = { NULL, 0, MemoryMapFreeRange };
+
 EFI_MEMORY_TYPE_STATISTICS  mMemoryTypeStatistics[EfiMaxMemoryType + 1] = {
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, TRUE,  FALSE },  // EfiReservedMemoryType
   { 0, MAX_ALLOC_ADDRESS, 0, 0, EfiMaxMemoryType, FALSE, FALSE },  // EfiLoaderCode
@@ -119,6 +143,152 @@ CoreReleaseMemoryLock (
   CoreReleaseLock (&gMemoryLock);
 }
 
+/**
+  Internal function.  Returns the range of a descriptor in mMemoryMapTree.
+
+  @param  Node                   The address node of the descriptor
+  @param  Start                  The first address of the descriptor
+  @param  End                    The last address of the descriptor
+
+**/
+VOID
+MemoryMapAddressRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  )
+{
+  MEMORY_MAP  *Entry;
+
+  Entry  = CR (Node, MEMORY_MAP, AddressNode, MEMORY_MAP_SIGNATURE);
+  *Start = Entry->Start;
+  *End   = Entry->End;
+}
+
+/**
+  Internal function.  Returns the range of a descriptor in mFreeMemoryMapTree.
+
+  @param  Node                   The free node of the descriptor
+  @param  Start                  The first address of the descriptor
+  @param  End                    The last address of the descriptor
+
+**/
+VOID
+MemoryMapFreeRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  )
+{
+  MEMORY_MAP  *Entry;
+
+  Entry  = CR (Node, MEMORY_MAP, FreeNode, MEMORY_MAP_SIGNATURE);
+  *Start = Entry->Start;
+  *End   = Entry->End;
+}
+
+/**
+  Internal function.  Checks whether pages can be allocated from a descriptor.
+  The type and attributes of a descriptor never change while it is in the map.
+
+  @param  Entry                  The descriptor
+
+  @retval TRUE                   The descriptor is in mFreeMemoryMapTree
+  @retval FALSE                  The descriptor is not in mFreeMemoryMapTree
+
+**/
+BOOLEAN
+IsFreeMemoryMapEntry (
+  IN MEMORY_MAP  *Entry
+  )
+{
+  //
+  // Don't allocate out of Special-Purpose memory.
+  //
+  return (BOOLEAN)((Entry->Type == EfiConventionalMemory) && ((Entry->Attribute & EFI_MEMORY_SP) == 0));
+}
+
+/**
+  Internal function.  Adds a descriptor to the indexes of the memory map.
+
+  @param  Entry                  The descriptor, with its range set
+
+**/
+VOID
+InsertMemoryMapIndex (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  MemoryMapTreeInsert (&mMemoryMapTree, &Entry->AddressNode);
+  if (IsFreeMemoryMapEntry (Entry)) {
+    MemoryMapTreeInsert (&mFreeMemoryMapTree, &Entry->FreeNode);
+  }
+}
+
+/**
+  Internal function.  Removes a descriptor from the indexes of the memory map.
+
+  @param  Entry                  The descriptor
+
+**/
+VOID
+RemoveMemoryMapIndex (
+  IN OUT MEMORY_MAP  *Entry
+  )
+{
+  MemoryMapTreeRemove (&mMemoryMapTree, &Entry->AddressNode);
+  if (IsFreeMemoryMapEntry (Entry)) {
+    MemoryMapTreeRemove (&mFreeMemoryMapTree, &Entry->FreeNode);
+  }
+}
+
+/**
+  Internal function.  Updates the indexes of the memory map after the range
+  of a descriptor was clipped.
+
+  @param  Entry                  The descriptor
+
+**/
+VOID
+UpdateMemoryMapIndex (
+  IN MEMORY_MAP  *Entry
+  )
+{
+  MemoryMapTreeUpdate (&mMemoryMapTree, &Entry->AddressNode);
+  if (IsFreeMemoryMapEntry (Entry)) {
+    MemoryMapTreeUpdate (&mFreeMemoryMapTree, &Entry->FreeNode);
+  }
+}
+
+/**
+  Internal function.  Finds the descriptor that covers an address.
+
+  @param  Address                The address to look up
+
+  @return The descriptor, or NULL if no descriptor covers Address
+
+**/
+MEMORY_MAP *
+FindMemoryMapEntry (
+  IN UINT64  Address
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Node;
+  MEMORY_MAP            *Entry;
+
+  Node = MemoryMapTreeFindFloor (&mMemoryMapTree, Address);
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  Entry = CR (Node, MEMORY_MAP, AddressNode, MEMORY_MAP_SIGNATURE);
+  if (Entry->End < Address) {
+    return NULL;
+  }
+
+  return Entry;
+}
+
 /**
   Internal function.  Removes a descriptor entry.
 
@@ -130,6 +300,7 @@ RemoveMemoryMapEntry (
   IN OUT MEMORY_MAP  *Entry
   )
 {
+  RemoveMemoryMapIndex (Entry);
   RemoveEntryList (&Entry->Link);
   Entry->Link.ForwardLink = NULL;
 
@@ -161,7 +332,6 @@ CoreAddRange (
   IN UINT64                Attribute
   )
 {
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
 
   ASSERT ((Start & EFI_PAGE_MASK) == 0);
@@ -203,30 +373,25 @@ CoreAddRange (
   CoreNotifySignalList (&gEfiEventMemoryMapChangeGuid);
 
   //
-  // Look for adjoining memory descriptor
+  // Look for adjoining memory descriptors, which are the descriptors just
+  // below and just above the range in the index
   //
 
   // Two memory descriptors can only be merged if they have the same Type
   // and the same Attribute
   //
 
-  Link = gMemoryMap.ForwardLink;
-  while (Link != &gMemoryMap) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    Link  = Link->ForwardLink;
-
-    if (Entry->Type != Type) {
-      continue;
-    }
-
-    if (Entry->Attribute != Attribute) {
-      continue;
-    }
-
-    if (Entry->End + 1 == Start) {
+  if (Start != 0) {
+    Entry = FindMemoryMapEntry (Start - 1);
+    if ((Entry != NULL) && (Entry->Type == Type) && (Entry->Attribute == Attribute) && (Entry->End + 1 == Start)) {
       Start = Entry->Start;
       RemoveMemoryMapEntry (Entry);
-    } else if (Entry->Start == End + 1) {
+    }
+  }
+
+  if (End != MAX_UINT64) {
+    Entry = FindMemoryMapEntry (End + 1);
+    if ((Entry != NULL) && (Entry->Type == Type) && (Entry->Attribute == Attribute) && (Entry->Start == End + 1)) {
       End = Entry->End;
       RemoveMemoryMapEntry (Entry);
     }
@@ -244,6 +409,7 @@ CoreAddRange (
   mMapStack[mMapDepth].VirtualStart = 0;
   mMapStack[mMapDepth].Attribute    = Attribute;
   InsertTailList (&gMemoryMap, &mMapStack[mMapDepth].Link);
+  InsertMemoryMapIndex (&mMapStack[mMapDepth]);
 
   mMapDepth += 1;
   ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -315,9 +481,10 @@ CoreFreeMemoryMapStack (
   VOID
   )
 {
-  MEMORY_MAP  *Entry;
-  MEMORY_MAP  *Entry2;
-  LIST_ENTRY  *Link2;
+  MEMORY_MAP            *Entry;
+  MEMORY_MAP            *Entry2;
+  LIST_ENTRY            *Link2;
+  MEMORY_MAP_TREE_NODE  *Node;
 
   ASSERT_LOCKED (&gMemoryLock);
 
@@ -350,18 +517,24 @@ CoreFreeMemoryMapStack (
       //
       // Move this entry to general memory
       //
+      RemoveMemoryMapIndex (&mMapStack[mMapDepth]);
       RemoveEntryList (&mMapStack[mMapDepth].Link);
       mMapStack[mMapDepth].Link.ForwardLink = NULL;
 
       CopyMem (Entry, &mMapStack[mMapDepth], sizeof (MEMORY_MAP));
       Entry->FromPages = TRUE;
+      InsertMemoryMapIndex (Entry);
 
       //
-      // Find insertion location
+      // Find insertion location, before the next entry in general memory.
+      // The entries in general memory are sorted by address in gMemoryMap,
+      // and only the few ones on the stack are not.
       //
-      for (Link2 = gMemoryMap.ForwardLink; Link2 != &gMemoryMap; Link2 = Link2->ForwardLink) {
-        Entry2 = CR (Link2, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-        if (Entry2->FromPages && (Entry2->Start > Entry->Start)) {
+      Link2 = &gMemoryMap;
+      for (Node = MemoryMapTreeNext (&Entry->AddressNode); Node != NULL; Node = MemoryMapTreeNext (Node)) {
+        Entry2 = CR (Node, MEMORY_MAP, AddressNode, MEMORY_MAP_SIGNATURE);
+        if (Entry2->FromPages) {
+          Link2 = &Entry2->Link;
           break;
         }
       }
@@ -843,7 +1016,6 @@ CoreConvertPagesEx (
   UINT64           RangeEnd;
   UINT64           Attribute;
   EFI_MEMORY_TYPE  MemType;
-  LIST_ENTRY       *Link;
   MEMORY_MAP       *Entry;
 
   Entry         = NULL;
@@ -868,15 +1040,8 @@ CoreConvertPagesEx (
     //
     // Find the entry that the covers the range
     //
-    for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-      Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-      if ((Entry->Start <= Start) && (Entry->End > Start)) {
-        break;
-      }
-    }
-
-    if (Link == &gMemoryMap) {
+    Entry = FindMemoryMapEntry (Start);
+    if (Entry == NULL) {
       DEBUG ((DEBUG_ERROR | DEBUG_PAGE, "ConvertPages: failed to find range %lx - %lx\n", Start, End));
       return EFI_NOT_FOUND;
     }
@@ -962,11 +1127,15 @@ CoreConvertPagesEx (
       // Clip start
       //
       Entry->Start = RangeEnd + 1;
+      if (Entry->Start <= Entry->End) {
+        UpdateMemoryMapIndex (Entry);
+      }
     } else if (Entry->End == RangeEnd) {
       //
       // Clip end
       //
       Entry->End = Start - 1;
+      UpdateMemoryMapIndex (Entry);
     } else {
       //
       // Pull it out of the center, clip current
@@ -988,9 +1157,11 @@ CoreConvertPagesEx (
 
       Entry->End = Start - 1;
       ASSERT (Entry->Start < Entry->End);
+      UpdateMemoryMapIndex (Entry);
 
       Entry = &mMapStack[mMapDepth];
       InsertTailList (&gMemoryMap, &Entry->Link);
+      InsertMemoryMapIndex (Entry);
 
       mMapDepth += 1;
       ASSERT (mMapDepth < MAX_MAP_DEPTH);
@@ -1137,13 +1308,13 @@ CoreFindFreePagesI (
   IN BOOLEAN          NeedGuard
   )
 {
-  UINT64      NumberOfBytes;
-  UINT64      Target;
-  UINT64      DescStart;
-  UINT64      DescEnd;
-  UINT64      DescNumberOfBytes;
-  LIST_ENTRY  *Link;
-  MEMORY_MAP  *Entry;
+  UINT64                NumberOfBytes;
+  UINT64                Target;
+  UINT64                DescStart;
+  UINT64                DescEnd;
+  UINT64                DescNumberOfBytes;
+  MEMORY_MAP_TREE_NODE  *Node;
+  MEMORY_MAP            *Entry;
 
   if ((MaxAddress < EFI_PAGE_MASK) || (NumberOfPages == 0)) {
     return 0;
@@ -1173,31 +1344,25 @@ CoreFindFreePagesI (
   NumberOfBytes = LShiftU64 (NumberOfPages, EFI_PAGE_SHIFT);
   Target        = 0;
 
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-
-    //
-    // If it's not a free entry, don't bother with it
-    //
-    if (Entry->Type != EfiConventionalMemory) {
-      continue;
-    }
-
-    //
-    // Don't allocate out of Special-Purpose memory.
-    //
-    if ((Entry->Attribute & EFI_MEMORY_SP) != 0) {
-      continue;
-    }
+  //
+  // Walk the free entries that start below the max allowed address and are
+  // large enough, from the highest one down. The first one that satisfies the
+  // request gives the highest range, so the walk stops there.
+  //
+  for (Node = MemoryMapTreeFindLastFit (&mFreeMemoryMapTree, MaxAddress, NumberOfBytes);
+       Node != NULL;
+       Node = MemoryMapTreeFindLastFit (&mFreeMemoryMapTree, Entry->Start, NumberOfBytes))
+  {
+    Entry = CR (Node, MEMORY_MAP, FreeNode, MEMORY_MAP_SIGNATURE);
 
     DescStart = Entry->Start;
     DescEnd   = Entry->End;
 
     //
-    // If desc is past max allowed address or below min allowed address, skip it
+    // If desc is below min allowed address, so are all the remaining ones
     //
-    if ((DescStart >= MaxAddress) || (DescEnd < MinAddress)) {
-      continue;
+    if (DescEnd < MinAddress) {
+      break;
     }
 
     //
@@ -1228,23 +1393,19 @@ CoreFindFreePagesI (
         continue;
       }
 
-      //
-      // If this is the best match so far remember it
-      //
-      if (DescEnd > Target) {
-        if (NeedGuard) {
-          DescEnd = AdjustMemoryS (
-                      DescEnd + 1 - DescNumberOfBytes,
-                      DescNumberOfBytes,
-                      NumberOfBytes
-                      );
-          if (DescEnd == 0) {
-            continue;
-          }
+      if (NeedGuard) {
+        DescEnd = AdjustMemoryS (
+                    DescEnd + 1 - DescNumberOfBytes,
+                    DescNumberOfBytes,
+                    NumberOfBytes
+                    );
+        if (DescEnd == 0) {
+          continue;
         }
-
-        Target = DescEnd;
       }
+
+      Target = DescEnd;
+      break;
     }
   }
 
@@ -1654,7 +1815,6 @@ CoreInternalFreePages (
   )
 {
   EFI_STATUS  Status;
-  LIST_ENTRY  *Link;
   MEMORY_MAP  *Entry;
   UINTN       Alignment;
   BOOLEAN     IsGuarded;
@@ -1668,21 +1828,8 @@ CoreInternalFreePages (
   // Find the entry that the covers the range
   //
   IsGuarded = FALSE;
-  Entry     = NULL;
-  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
-    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
-    if ((Entry->Start <= Memory) && (Entry->End > Memory)) {
-      break;
-    }
-  }
-
-  if (Link == &gMemoryMap) {
-    Status = EFI_NOT_FOUND;
-    goto Done;
-  }
-
+  Entry     = FindMemoryMapEntry (Memory);
   if (Entry == NULL) {
-    ASSERT (Entry != NULL);
     Status = EFI_NOT_FOUND;
     goto Done;
   }
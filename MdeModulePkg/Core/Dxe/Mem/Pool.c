@@ -21,6 +21,12 @@ typedef struct {
 
 #define POOL_HEAD_SIGNATURE      SIGNATURE_32('p','h','d','0')
 #define POOLPAGE_HEAD_SIGNATURE  SIGNATURE_32('p','h','d','1')
+#define POOLSLAB_HEAD_SIGNATURE  SIGNATURE_32('p','h','d','2')
+
+//
+// For entries served from a slab, Reserved holds the byte offset of the
+// entry from the start of its POOL_SLAB.
+//
 typedef struct {
   UINT32             Signature;
   UINT32             Reserved;
@@ -59,6 +65,47 @@ STATIC CONST UINT16  mPoolSizeTable[] = {
 
 #define MAX_POOL_SIZE  (MAX_ADDRESS - POOL_OVERHEAD)
 
+//
+// Size classes are multiples of 64 bytes, so any size up to the largest
+// class can be mapped to its class index through a byte table.
+//
+#define POOL_INDEX_SHIFT        6
+#define POOL_INDEX_TABLE_COUNT  (29824 >> POOL_INDEX_SHIFT)
+
+STATIC UINT8  mPoolIndexTable[POOL_INDEX_TABLE_COUNT];
+
+//
+// A slab is a run of pages holding entries of a single size class. Slabs
+// with at least one free entry are linked on the per-class slab list of
+// the pool that owns them.
+//
+#define POOL_SLAB_SIGNATURE  SIGNATURE_32('p','s','l','b')
+typedef struct {
+  UINT32        Signature;
+  UINT32        Index;
+  UINTN         NoPages;
+  UINTN         TotalCount;
+  UINTN         UsedCount;
+  LIST_ENTRY    FreeList;
+  LIST_ENTRY    Link;
+} POOL_SLAB;
+
+#define SIZE_OF_POOL_SLAB  ALIGN_VALUE (sizeof (POOL_SLAB), 64)
+
+//
+// Minimum number of entries a slab holds, which decides how many pages the
+// slabs of the larger size classes span.
+//
+#define POOL_SLAB_MIN_ENTRIES  4
+
+typedef struct {
+  UINTN    SlabCount;
+  UINTN    SlabPages;
+  UINTN    TotalCount;
+  UINTN    UsedCount;
+  UINTN    ReleasedCount;
+} POOL_SLAB_STATS;
+
 //
 // Globals
 //
@@ -69,6 +116,8 @@ typedef struct {
   UINTN              Used;
   EFI_MEMORY_TYPE    MemoryType;
   LIST_ENTRY         FreeList[MAX_POOL_LIST];
+  LIST_ENTRY         SlabList[MAX_POOL_LIST];
+  POOL_SLAB_STATS    SlabStats[MAX_POOL_LIST];
   LIST_ENTRY         Link;
 } POOL;
 
@@ -95,16 +144,38 @@ UINTN
 GetPoolIndexFromSize (
   UINTN  Size
   )
+{
+  if (Size == 0) {
+    return 0;
+  }
+
+  if (Size > LIST_TO_SIZE (MAX_POOL_LIST - 1)) {
+    return MAX_POOL_LIST;
+  }
+
+  return mPoolIndexTable[(Size - 1) >> POOL_INDEX_SHIFT];
+}
+
+/**
+  Initialize the size class lists of a pool head.
+
+  @param  Pool          The pool head to initialize.
+
+**/
+STATIC
+VOID
+InitializePoolLists (
+  IN OUT POOL  *Pool
+  )
 {
   UINTN  Index;
 
   for (Index = 0; Index < MAX_POOL_LIST; Index++) {
-    if (mPoolSizeTable[Index] >= Size) {
-      return Index;
-    }
+    InitializeListHead (&Pool->FreeList[Index]);
+    InitializeListHead (&Pool->SlabList[Index]);
   }
 
-  return MAX_POOL_LIST;
+  ZeroMem (Pool->SlabStats, sizeof (Pool->SlabStats));
 }
 
 /**
@@ -118,14 +189,24 @@ CoreInitializePool (
 {
   UINTN  Type;
   UINTN  Index;
+  UINTN  Slot;
+
+  ASSERT (POOL_INDEX_TABLE_COUNT << POOL_INDEX_SHIFT == LIST_TO_SIZE (MAX_POOL_LIST - 1));
+
+  Index = 0;
+  for (Slot = 0; Slot < POOL_INDEX_TABLE_COUNT; Slot++) {
+    while (LIST_TO_SIZE (Index) < ((Slot + 1) << POOL_INDEX_SHIFT)) {
+      Index++;
+    }
+
+    mPoolIndexTable[Slot] = (UINT8)Index;
+  }
 
   for (Type = 0; Type < EfiMaxMemoryType; Type++) {
     mPoolHead[Type].Signature  = 0;
     mPoolHead[Type].Used       = 0;
     mPoolHead[Type].MemoryType = (EFI_MEMORY_TYPE)Type;
-    for (Index = 0; Index < MAX_POOL_LIST; Index++) {
-      InitializeListHead (&mPoolHead[Type].FreeList[Index]);
-    }
+    InitializePoolLists (&mPoolHead[Type]);
   }
 }
 
@@ -144,7 +225,6 @@ LookupPoolHead (
 {
   LIST_ENTRY  *Link;
   POOL        *Pool;
-  UINTN       Index;
 
   if ((UINT32)MemoryType < EfiMaxMemoryType) {
     return &mPoolHead[MemoryType];
@@ -171,9 +251,7 @@ LookupPoolHead (
     Pool->Signature  = POOL_SIGNATURE;
     Pool->Used       = 0;
     Pool->MemoryType = MemoryType;
-    for (Index = 0; Index < MAX_POOL_LIST; Index++) {
-      InitializeListHead (&Pool->FreeList[Index]);
-    }
+    InitializePoolLists (Pool);
 
     InsertHeadList (&mPoolHeadList, &Pool->Link);
 
@@ -336,6 +414,87 @@ CoreAllocatePoolPagesI (
   return Buffer;
 }
 
+/**
+  Internal function.  Takes a free entry of the given size class from a slab
+  of the pool, allocating a new slab if none of the slabs has a free entry.
+  Caller must have the memory lock held
+
+  @param  Pool                   The pool head of the memory type
+  @param  Index                  The size class of the entry
+  @param  Granularity            Bits to align.
+
+  @return The entry, or NULL
+
+**/
+STATIC
+POOL_HEAD *
+CoreAllocatePoolSlabEntry (
+  IN POOL   *Pool,
+  IN UINTN  Index,
+  IN UINTN  Granularity
+  )
+{
+  POOL_SLAB  *Slab;
+  POOL_FREE  *Free;
+  POOL_HEAD  *Head;
+  UINTN      EntrySize;
+  UINTN      NoPages;
+  UINTN      Offset;
+
+  EntrySize = LIST_TO_SIZE (Index);
+
+  if (IsListEmpty (&Pool->SlabList[Index])) {
+    NoPages = EFI_SIZE_TO_PAGES (SIZE_OF_POOL_SLAB + POOL_SLAB_MIN_ENTRIES * EntrySize);
+    NoPages = ALIGN_VALUE (NoPages, EFI_SIZE_TO_PAGES (Granularity));
+    Slab    = CoreAllocatePoolPagesI (Pool->MemoryType, NoPages, Granularity, FALSE);
+    if (Slab == NULL) {
+      return NULL;
+    }
+
+    Slab->Signature  = POOL_SLAB_SIGNATURE;
+    Slab->Index      = (UINT32)Index;
+    Slab->NoPages    = NoPages;
+    Slab->TotalCount = 0;
+    Slab->UsedCount  = 0;
+    InitializeListHead (&Slab->FreeList);
+
+    for (Offset = SIZE_OF_POOL_SLAB;
+         Offset + EntrySize <= EFI_PAGES_TO_SIZE (NoPages);
+         Offset += EntrySize)
+    {
+      Free            = (POOL_FREE *)((CHAR8 *)Slab + Offset);
+      Free->Signature = POOL_FREE_SIGNATURE;
+      Free->Index     = (UINT32)Index;
+      InsertTailList (&Slab->FreeList, &Free->Link);
+      Slab->TotalCount++;
+    }
+
+    InsertHeadList (&Pool->SlabList[Index], &Slab->Link);
+
+    Pool->SlabStats[Index].SlabCount++;
+    Pool->SlabStats[Index].SlabPages  += NoPages;
+    Pool->SlabStats[Index].TotalCount += Slab->TotalCount;
+  }
+
+  Slab = CR (Pool->SlabList[Index].ForwardLink, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+  Free = CR (Slab->FreeList.ForwardLink, POOL_FREE, Link, POOL_FREE_SIGNATURE);
+  RemoveEntryList (&Free->Link);
+
+  Slab->UsedCount++;
+  Pool->SlabStats[Index].UsedCount++;
+
+  //
+  // Only slabs with free entries stay on the slab list
+  //
+  if (IsListEmpty (&Slab->FreeList)) {
+    RemoveEntryList (&Slab->Link);
+  }
+
+  Head           = (POOL_HEAD *)Free;
+  Head->Reserved = (UINT32)((UINTN)Head - (UINTN)Slab);
+  return Head;
+}
+
 /**
   Internal function to allocate pool of a particular type.
   Caller must have the memory lock held
@@ -367,6 +526,7 @@ CoreAllocatePoolI (
   UINTN      Granularity;
   BOOLEAN    HasPoolTail;
   BOOLEAN    PageAsPool;
+  BOOLEAN    FromSlab;
 
   ASSERT_LOCKED (&mPoolMemoryLock);
 
@@ -413,7 +573,8 @@ CoreAllocatePoolI (
     return NULL;
   }
 
-  Head = NULL;
+  Head     = NULL;
+  FromSlab = FALSE;
 
   //
   // If allocation is over max size, just allocate pages for the request
@@ -434,6 +595,15 @@ CoreAllocatePoolI (
     goto Done;
   }
 
+  //
+  // Serve the request from a slab of its size class if slabs are enabled
+  //
+  if (FeaturePcdGet (PcdDxeCorePoolSlabAllocator)) {
+    Head     = CoreAllocatePoolSlabEntry (Pool, Index, Granularity);
+    FromSlab = TRUE;
+    goto Done;
+  }
+
   //
   // If there's no free pool in the proper list size, go get some more pages
   //
@@ -516,7 +686,14 @@ Done:
     //
     // If we have a pool buffer, fill in the header & tail info
     //
-    Head->Signature = (PageAsPool) ? POOLPAGE_HEAD_SIGNATURE : POOL_HEAD_SIGNATURE;
+    if (PageAsPool) {
+      Head->Signature = POOLPAGE_HEAD_SIGNATURE;
+    } else if (FromSlab) {
+      Head->Signature = POOLSLAB_HEAD_SIGNATURE;
+    } else {
+      Head->Signature = POOL_HEAD_SIGNATURE;
+    }
+
     Head->Size      = Size;
     Head->Type      = (EFI_MEMORY_TYPE)PoolType;
     Buffer          = Head->Data;
@@ -676,6 +853,113 @@ CoreFreePoolPagesWithGuard (
   }
 }
 
+/**
+  Internal function.  Returns an empty slab to free memory.
+
+  @param  Pool                   The pool head owning the slab
+  @param  Slab                   The slab to release
+
+**/
+STATIC
+VOID
+CoreFreePoolSlab (
+  IN POOL       *Pool,
+  IN POOL_SLAB  *Slab
+  )
+{
+  POOL_SLAB_STATS  *Stats;
+
+  ASSERT (Slab->UsedCount == 0);
+
+  Stats = &Pool->SlabStats[Slab->Index];
+  Stats->SlabCount--;
+  Stats->SlabPages  -= Slab->NoPages;
+  Stats->TotalCount -= Slab->TotalCount;
+  Stats->ReleasedCount++;
+
+  RemoveEntryList (&Slab->Link);
+  Slab->Signature = 0;
+  CoreFreePoolPagesI (
+    Pool->MemoryType,
+    (EFI_PHYSICAL_ADDRESS)(UINTN)Slab,
+    Slab->NoPages
+    );
+}
+
+/**
+  Internal function.  Returns an entry to the slab it was taken from. The
+  slab is released once its last entry is freed, unless it is the only slab
+  left with free entries for its size class.
+
+  @param  Pool                   The pool head owning the slab
+  @param  Slab                   The slab holding the entry
+  @param  Head                   The entry to free
+
+**/
+STATIC
+VOID
+CoreFreePoolSlabEntry (
+  IN POOL       *Pool,
+  IN POOL_SLAB  *Slab,
+  IN POOL_HEAD  *Head
+  )
+{
+  POOL_FREE  *Free;
+  UINTN      Index;
+
+  Index = Slab->Index;
+
+  //
+  // A full slab is not on the slab list, put it back now it has a free entry
+  //
+  if (IsListEmpty (&Slab->FreeList)) {
+    InsertHeadList (&Pool->SlabList[Index], &Slab->Link);
+  }
+
+  Free            = (POOL_FREE *)Head;
+  Free->Signature = POOL_FREE_SIGNATURE;
+  Free->Index     = (UINT32)Index;
+  InsertHeadList (&Slab->FreeList, &Free->Link);
+
+  ASSERT (Slab->UsedCount > 0);
+  Slab->UsedCount--;
+  Pool->SlabStats[Index].UsedCount--;
+
+  if ((Slab->UsedCount == 0) &&
+      (Pool->SlabList[Index].ForwardLink != Pool->SlabList[Index].BackLink))
+  {
+    CoreFreePoolSlab (Pool, Slab);
+  }
+}
+
+/**
+  Internal function.  Releases the empty slabs cached by a pool head.
+
+  @param  Pool                   The pool head owning the slabs
+
+**/
+STATIC
+VOID
+CoreFreePoolEmptySlabs (
+  IN POOL  *Pool
+  )
+{
+  LIST_ENTRY  *Link;
+  POOL_SLAB   *Slab;
+  UINTN       Index;
+
+  for (Index = 0; Index < MAX_POOL_LIST; Index++) {
+    Link = Pool->SlabList[Index].ForwardLink;
+    while (Link != &Pool->SlabList[Index]) {
+      Slab = CR (Link, POOL_SLAB, Link, POOL_SLAB_SIGNATURE);
+      Link = Link->ForwardLink;
+      if (Slab->UsedCount == 0) {
+        CoreFreePoolSlab (Pool, Slab);
+      }
+    }
+  }
+}
+
 /**
   Internal function to free a pool entry.
   Caller must have the memory lock held
@@ -707,6 +991,7 @@ CoreFreePoolI (
   BOOLEAN    IsGuarded;
   BOOLEAN    HasPoolTail;
   BOOLEAN    PageAsPool;
+  POOL_SLAB  *Slab;
 
   ASSERT (Buffer != NULL);
   //
@@ -716,15 +1001,26 @@ CoreFreePoolI (
   ASSERT (Head != NULL);
 
   if ((Head->Signature != POOL_HEAD_SIGNATURE) &&
-      (Head->Signature != POOLPAGE_HEAD_SIGNATURE))
+      (Head->Signature != POOLPAGE_HEAD_SIGNATURE) &&
+      (Head->Signature != POOLSLAB_HEAD_SIGNATURE))
   {
     ASSERT (
       Head->Signature == POOL_HEAD_SIGNATURE ||
-      Head->Signature == POOLPAGE_HEAD_SIGNATURE
+      Head->Signature == POOLPAGE_HEAD_SIGNATURE ||
+      Head->Signature == POOLSLAB_HEAD_SIGNATURE
       );
     return EFI_INVALID_PARAMETER;
   }
 
+  Slab = NULL;
+  if (Head->Signature == POOLSLAB_HEAD_SIGNATURE) {
+    Slab = (POOL_SLAB *)((UINTN)Head - Head->Reserved);
+    ASSERT (Slab->Signature == POOL_SLAB_SIGNATURE);
+    if (Slab->Signature != POOL_SLAB_SIGNATURE) {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
   IsGuarded = IsPoolTypeToGuard (Head->Type) &&
               IsMemoryGuarded ((EFI_PHYSICAL_ADDRESS)(UINTN)Head);
   HasPoolTail = !(IsGuarded &&
@@ -807,6 +1103,11 @@ CoreFreePoolI (
         NoPages
         );
     }
+  } else if (Slab != NULL) {
+    //
+    // Return the entry to the slab it came from
+    //
+    CoreFreePoolSlabEntry (Pool, Slab, Head);
   } else {
     //
     // Put the pool entry onto the free pool list
@@ -874,9 +1175,176 @@ CoreFreePoolI (
   // list entry for that memory type
   //
   if (((UINT32)Pool->MemoryType >= MEMORY_TYPE_OEM_RESERVED_MIN) && (Pool->Used == 0)) {
+    CoreFreePoolEmptySlabs (Pool);
     RemoveEntryList (&Pool->Link);
     CoreFreePoolI (Pool, NULL);
   }
 
   return EFI_SUCCESS;
 }
+
+/**
+  Internal function.  Collects the slab statistics of a pool head into
+  memory profile pool class records.
+
+  @param  Pool                   The pool head to report
+  @param  PoolClass              The buffer receiving the records, or NULL
+                                 to only count them
+  @param  MaxCount               The number of records PoolClass can hold
+
+  @return The number of size classes of the pool that own slabs.
+
+**/
+STATIC
+UINTN
+CoreCollectPoolSlabStats (
+  IN  POOL                       *Pool,
+  OUT MEMORY_PROFILE_POOL_CLASS  *PoolClass OPTIONAL,
+  IN  UINTN                      MaxCount
+  )
+{
+  POOL_SLAB_STATS  *Stats;
+  UINTN            Index;
+  UINTN            Count;
+
+  Count = 0;
+  for (Index = 0; Index < MAX_POOL_LIST; Index++) {
+    Stats = &Pool->SlabStats[Index];
+    if ((Stats->SlabCount == 0) && (Stats->ReleasedCount == 0)) {
+      continue;
+    }
+
+    if ((PoolClass != NULL) && (Count < MaxCount)) {
+      PoolClass[Count].Header.Signature  = MEMORY_PROFILE_POOL_CLASS_SIGNATURE;
+      PoolClass[Count].Header.Length     = sizeof (MEMORY_PROFILE_POOL_CLASS);
+      PoolClass[Count].Header.Revision   = MEMORY_PROFILE_POOL_CLASS_REVISION;
+      PoolClass[Count].MemoryType        = Pool->MemoryType;
+      PoolClass[Count].ObjectSize        = LIST_TO_SIZE (Index);
+      PoolClass[Count].SlabCount         = Stats->SlabCount;
+      PoolClass[Count].SlabPages         = Stats->SlabPages;
+      PoolClass[Count].TotalObjects      = Stats->TotalCount;
+      PoolClass[Count].UsedObjects       = Stats->UsedCount;
+      PoolClass[Count].ReleasedSlabCount = Stats->ReleasedCount;
+    }
+
+    Count++;
+  }
+
+  return Count;
+}
+
+/**
+  Internal function.  Collects the slab statistics of all pool heads.
+  Caller must have the memory lock held
+
+  @param  PoolClass              The buffer receiving the records, or NULL
+                                 to only count them
+  @param  MaxCount               The number of records PoolClass can hold
+
+  @return The number of records describing the pool slabs.
+
+**/
+STATIC
+UINTN
+CoreCollectAllPoolSlabStats (
+  OUT MEMORY_PROFILE_POOL_CLASS  *PoolClass OPTIONAL,
+  IN  UINTN                      MaxCount
+  )
+{
+  LIST_ENTRY  *Link;
+  POOL        *Pool;
+  UINTN       Type;
+  UINTN       Count;
+
+  Count = 0;
+  for (Type = 0; Type < EfiMaxMemoryType; Type++) {
+    Count += CoreCollectPoolSlabStats (
+               &mPoolHead[Type],
+               (PoolClass == NULL) ? NULL : &PoolClass[MIN (Count, MaxCount)],
+               (Count < MaxCount) ? MaxCount - Count : 0
+               );
+  }
+
+  for (Link = mPoolHeadList.ForwardLink; Link != &mPoolHeadList; Link = Link->ForwardLink) {
+    Pool   = CR (Link, POOL, Link, POOL_SIGNATURE);
+    Count += CoreCollectPoolSlabStats (
+               Pool,
+               (PoolClass == NULL) ? NULL : &PoolClass[MIN (Count, MaxCount)],
+               (Count < MaxCount) ? MaxCount - Count : 0
+               );
+  }
+
+  return Count;
+}
+
+/**
+  Get the size of the pool slab statistics reported in the memory profile.
+
+  @return The size in bytes of the MEMORY_PROFILE_POOL_STATS record and the
+          MEMORY_PROFILE_POOL_CLASS records following it, or 0 if the slab
+          allocator is disabled.
+
+**/
+UINTN
+CoreGetPoolStatsSize (
+  VOID
+  )
+{
+  UINTN  Count;
+
+  if (!FeaturePcdGet (PcdDxeCorePoolSlabAllocator)) {
+    return 0;
+  }
+
+  CoreAcquireLock (&mPoolMemoryLock);
+  Count = CoreCollectAllPoolSlabStats (NULL, 0);
+  CoreReleaseLock (&mPoolMemoryLock);
+
+  return sizeof (MEMORY_PROFILE_POOL_STATS) + Count * sizeof (MEMORY_PROFILE_POOL_CLASS);
+}
+
+/**
+  Copy the pool slab statistics into the memory profile.
+
+  Slabs may have been created or released since CoreGetPoolStatsSize() was
+  called, so the records that do not fit in Buffer are dropped.
+
+  @param  Buffer                 The buffer receiving the statistics
+  @param  BufferSize             The size in bytes of Buffer
+
+  @return The size in bytes of the statistics copied into Buffer.
+
+**/
+UINTN
+CoreCopyPoolStats (
+  OUT VOID   *Buffer,
+  IN  UINTN  BufferSize
+  )
+{
+  MEMORY_PROFILE_POOL_STATS  *PoolStats;
+  UINTN                      MaxCount;
+  UINTN                      Count;
+
+  if (!FeaturePcdGet (PcdDxeCorePoolSlabAllocator) ||
+      (BufferSize < sizeof (MEMORY_PROFILE_POOL_STATS)))
+  {
+    return 0;
+  }
+
+  MaxCount = (BufferSize - sizeof (MEMORY_PROFILE_POOL_STATS)) / sizeof (MEMORY_PROFILE_POOL_CLASS);
+
+  PoolStats = Buffer;
+  CoreAcquireLock (&mPoolMemoryLock);
+  Count = CoreCollectAllPoolSlabStats ((MEMORY_PROFILE_POOL_CLASS *)(PoolStats + 1), MaxCount);
+  CoreReleaseLock (&mPoolMemoryLock);
+
+  Count = MIN (Count, MaxCount);
+
+  PoolStats->Header.Signature = MEMORY_PROFILE_POOL_STATS_SIGNATURE;
+  PoolStats->Header.Length    = sizeof (MEMORY_PROFILE_POOL_STATS);
+  PoolStats->Header.Revision  = MEMORY_PROFILE_POOL_STATS_REVISION;
+  PoolStats->PoolClassCount   = (UINT32)Count;
+  ZeroMem (PoolStats->Reserved, sizeof (PoolStats->Reserved));
+
+  return sizeof (MEMORY_PROFILE_POOL_STATS) + Count * sizeof (MEMORY_PROFILE_POOL_CLASS);
+}
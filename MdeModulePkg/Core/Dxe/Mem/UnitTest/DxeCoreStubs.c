@@ -0,0 +1,453 @@
+/** @file
+  Minimal DXE core services for the host-based tests of the page and pool
+  allocators.
+
+  Page.c and Pool.c are built as is. The services they call from the rest of
+  the DXE core are replaced here: the locks only track their state, heap guard
+  and memory protection are disabled, and there is no GCD memory space map to
+  promote memory from.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Imem.h"
+#include "HeapGuard.h"
+
+EFI_HANDLE                                 gDxeCoreImageHandle      = NULL;
+EFI_MEMORY_ATTRIBUTE_PROTOCOL              *gMemoryAttributeProtocol = NULL;
+EFI_LOAD_FIXED_ADDRESS_CONFIGURATION_TABLE  gLoadModuleAtFixAddressConfigurationTable;
+LIST_ENTRY                                 mGcdMemorySpaceMap = INITIALIZE_LIST_HEAD_VARIABLE (mGcdMemorySpaceMap);
+BOOLEAN                                    mOnGuarding        = FALSE;
+
+/**
+  Marks a lock as acquired.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreAcquireLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockReleased);
+  Lock->Lock = EfiLockAcquired;
+}
+
+/**
+  Marks a lock as released.
+
+  @param  Lock        The lock.
+
+**/
+VOID
+CoreReleaseLock (
+  IN EFI_LOCK  *Lock
+  )
+{
+  ASSERT (Lock->Lock == EfiLockAcquired);
+  Lock->Lock = EfiLockReleased;
+}
+
+/**
+  Marks a lock as acquired, or fails if it is already held.
+
+  @param  Lock               The lock.
+
+  @retval EFI_SUCCESS        The lock is acquired.
+  @retval EFI_ACCESS_DENIED  The lock is already held.
+
+**/
+EFI_STATUS
+CoreAcquireLockOrFail (
+  IN EFI_LOCK  *Lock
+  )
+{
+  if (Lock->Lock == EfiLockAcquired) {
+    return EFI_ACCESS_DENIED;
+  }
+
+  Lock->Lock = EfiLockAcquired;
+  return EFI_SUCCESS;
+}
+
+/**
+  The GCD memory space map is empty, there is nothing to lock.
+
+**/
+VOID
+CoreAcquireGcdMemoryLock (
+  VOID
+  )
+{
+}
+
+/**
+  The GCD memory space map is empty, there is nothing to unlock.
+
+**/
+VOID
+CoreReleaseGcdMemoryLock (
+  VOID
+  )
+{
+}
+
+/**
+  There is no GCD memory space map.
+
+  @param  BaseAddress        The base address of the memory space.
+  @param  Descriptor         The GCD descriptor, not filled in.
+
+  @retval EFI_NOT_FOUND      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreGetMemorySpaceDescriptor (
+  IN  EFI_PHYSICAL_ADDRESS             BaseAddress,
+  OUT EFI_GCD_MEMORY_SPACE_DESCRIPTOR  *Descriptor
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  There are no events to signal.
+
+  @param  EventGroup         The event group.
+
+**/
+VOID
+CoreNotifySignalList (
+  IN EFI_GUID  *EventGroup
+  )
+{
+}
+
+/**
+  Memory profiling is disabled.
+
+  @param CallerAddress  The caller address.
+  @param Action         The profile action.
+  @param MemoryType     The memory type.
+  @param Size           The buffer size.
+  @param Buffer         The buffer.
+  @param ActionString   The string for the action.
+
+  @retval EFI_UNSUPPORTED     Always.
+
+**/
+EFI_STATUS
+EFIAPI
+CoreUpdateProfile (
+  IN EFI_PHYSICAL_ADDRESS   CallerAddress,
+  IN MEMORY_PROFILE_ACTION  Action,
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Size,
+  IN VOID                   *Buffer,
+  IN CHAR8                  *ActionString OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  The memory attributes table is not installed.
+
+  @param  MemoryType         The type of the allocated or freed memory.
+
+**/
+VOID
+InstallMemoryAttributesTableOnMemoryAllocation (
+  IN EFI_MEMORY_TYPE  MemoryType
+  )
+{
+}
+
+/**
+  Memory protection is disabled.
+
+  @param  OldType            The old memory type.
+  @param  NewType            The new memory type.
+  @param  Memory             The base address of the range.
+  @param  Length             The length of the range.
+
+  @retval EFI_SUCCESS        Always.
+
+**/
+EFI_STATUS
+EFIAPI
+ApplyMemoryProtectionPolicy (
+  IN  EFI_MEMORY_TYPE       OldType,
+  IN  EFI_MEMORY_TYPE       NewType,
+  IN  EFI_PHYSICAL_ADDRESS  Memory,
+  IN  UINT64                Length
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  The memory map returned by CoreGetMemoryMap() is left as is.
+
+  @param  MemoryMap          The memory map.
+  @param  MemoryMapSize      The size of the memory map.
+  @param  DescriptorSize     The size of a descriptor.
+
+**/
+VOID
+MergeMemoryMap (
+  IN OUT EFI_MEMORY_DESCRIPTOR  *MemoryMap,
+  IN OUT UINTN                  *MemoryMapSize,
+  IN UINTN                      DescriptorSize
+  )
+{
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  GuardType          The type of guard.
+
+  @retval FALSE              Always.
+
+**/
+BOOLEAN
+IsHeapGuardEnabled (
+  UINT8  GuardType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  MemoryType         The memory type.
+  @param  AllocateType       The allocation type.
+
+  @retval FALSE              Always.
+
+**/
+BOOLEAN
+IsPageTypeToGuard (
+  IN EFI_MEMORY_TYPE    MemoryType,
+  IN EFI_ALLOCATE_TYPE  AllocateType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  MemoryType         The pool type.
+
+  @retval FALSE              Always.
+
+**/
+BOOLEAN
+IsPoolTypeToGuard (
+  IN EFI_MEMORY_TYPE  MemoryType
+  )
+{
+  return FALSE;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Address            The address to check.
+
+  @retval FALSE              Always.
+
+**/
+BOOLEAN
+EFIAPI
+IsMemoryGuarded (
+  IN EFI_PHYSICAL_ADDRESS  Address
+  )
+{
+  return FALSE;
+}
+
+/**
+  Heap guard is disabled, convert the pages without guard.
+
+  @param  Start              The first address of the range.
+  @param  NumberOfPages      The number of pages.
+  @param  NewType            The new memory type.
+
+  @return The status of CoreConvertPages().
+
+**/
+EFI_STATUS
+CoreConvertPagesWithGuard (
+  IN UINT64           Start,
+  IN UINTN            NumberOfPages,
+  IN EFI_MEMORY_TYPE  NewType
+  )
+{
+  return CoreConvertPages (Start, NumberOfPages, NewType);
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Memory             The base address of the range.
+  @param  NumberOfPages      The number of pages.
+
+**/
+VOID
+SetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Start              The start of the free range.
+  @param  Size               The size of the free range.
+  @param  SizeRequested      The size requested.
+
+  @return The unchanged end of the range.
+
+**/
+UINT64
+AdjustMemoryS (
+  IN UINT64  Start,
+  IN UINT64  Size,
+  IN UINT64  SizeRequested
+  )
+{
+  ASSERT (FALSE);
+  return Start + Size - 1;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Memory             The base address of the range.
+  @param  NumberOfPages      The number of pages.
+
+**/
+VOID
+UnsetGuardForMemory (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NumberOfPages
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Memory             The base address of the pages to free.
+  @param  NumberOfPages      The number of pages to free.
+
+**/
+VOID
+AdjustMemoryF (
+  IN OUT EFI_PHYSICAL_ADDRESS  *Memory,
+  IN OUT UINTN                 *NumberOfPages
+  )
+{
+  ASSERT (FALSE);
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Memory             The base address of the pool pages.
+  @param  NoPages            The number of pages.
+  @param  Size               The size of the pool entry.
+
+  @return The unchanged pool head.
+
+**/
+VOID *
+AdjustPoolHeadA (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NoPages,
+  IN UINTN                 Size
+  )
+{
+  ASSERT (FALSE);
+  return (VOID *)(UINTN)Memory;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  Memory             The pool head.
+  @param  NoPages            The number of pages.
+  @param  Size               The size of the pool entry.
+
+  @return The unchanged pool head.
+
+**/
+VOID *
+AdjustPoolHeadF (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 NoPages,
+  IN UINTN                 Size
+  )
+{
+  ASSERT (FALSE);
+  return (VOID *)(UINTN)Memory;
+}
+
+/**
+  Heap guard is disabled.
+
+  @param  BaseAddress        The base address of the freed pages.
+  @param  Pages              The number of pages.
+
+**/
+VOID
+EFIAPI
+GuardFreedPagesChecked (
+  IN  EFI_PHYSICAL_ADDRESS  BaseAddress,
+  IN  UINTN                 Pages
+  )
+{
+}
+
+/**
+  Heap guard is disabled.
+
+**/
+VOID
+EFIAPI
+DumpGuardedMemoryBitmap (
+  VOID
+  )
+{
+}
+
+/**
+  Heap guard is disabled, there are no freed pages to promote.
+
+  @param  StartAddress       Not used.
+  @param  EndAddress         Not used.
+
+  @retval FALSE              Always.
+
+**/
+BOOLEAN
+PromoteGuardedFreePages (
+  OUT EFI_PHYSICAL_ADDRESS  *StartAddress,
+  OUT EFI_PHYSICAL_ADDRESS  *EndAddress
+  )
+{
+  return FALSE;
+}
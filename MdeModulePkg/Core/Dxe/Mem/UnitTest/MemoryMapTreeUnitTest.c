@@ -0,0 +1,1306 @@
+/** @file
+  This is a host-based unit test for the memory map trees of the DXE core.
+
+  A simplified page allocator carves allocations from the top of the highest
+  free descriptor that is large enough and merges freed descriptors with their
+  free neighbors, as the DXE core does. Every lookup made through the trees is
+  checked against a linear walk of the descriptor list. The benchmark reports
+  the allocate/free cycles per second of both for several memory map sizes.
+
+  The page allocator tests run Page.c itself over a buffer of host memory and
+  check CoreAddRange(), CoreFindFreePagesI() and the page conversions against
+  a linear walk of gMemoryMap.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "DxeMain.h"
+#include "Imem.h"
+
+#define UNIT_TEST_NAME     "DXE Core Memory Map Tree Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_DESCRIPTOR_COUNT  16384
+#define TEST_MEMORY_BASE       SIZE_1MB
+
+#define TEST_DESCRIPTOR_SIGNATURE  SIGNATURE_32 ('t', 'm', 'a', 'p')
+
+///
+/// The host memory given to the page allocator. The last TEST_WINDOW_PAGES
+/// pages are not given as free memory, CoreAddRange() adds other ranges there.
+///
+#define TEST_PAGE_MEMORY_PAGES  4096
+#define TEST_WINDOW_PAGES       64
+
+typedef struct {
+  UINTN                   Signature;
+  LIST_ENTRY              Link;
+  BOOLEAN                 Free;
+  UINT64                  Start;
+  UINT64                  End;
+  MEMORY_MAP_TREE_NODE    AddressNode;
+  MEMORY_MAP_TREE_NODE    FreeNode;
+} TEST_DESCRIPTOR;
+
+VOID
+TestAddressRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+VOID
+TestFreeRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  );
+
+//
+// Page.c internals.
+//
+extern MEMORY_MAP_TREE  mMemoryMapTree;
+extern MEMORY_MAP_TREE  mFreeMemoryMapTree;
+
+VOID
+CoreAddRange (
+  IN EFI_MEMORY_TYPE       Type,
+  IN EFI_PHYSICAL_ADDRESS  Start,
+  IN EFI_PHYSICAL_ADDRESS  End,
+  IN UINT64                Attribute
+  );
+
+VOID
+CoreFreeMemoryMapStack (
+  VOID
+  );
+
+MEMORY_MAP *
+FindMemoryMapEntry (
+  IN UINT64  Address
+  );
+
+UINT64
+CoreFindFreePagesI (
+  IN UINT64           MaxAddress,
+  IN UINT64           MinAddress,
+  IN UINT64           NumberOfPages,
+  IN EFI_MEMORY_TYPE  NewType,
+  IN UINTN            Alignment,
+  IN BOOLEAN          NeedGuard
+  );
+
+TEST_DESCRIPTOR  *mDescriptors;
+
+LIST_ENTRY       mDescriptorPool = INITIALIZE_LIST_HEAD_VARIABLE (mDescriptorPool);
+LIST_ENTRY       mTestMemoryMap  = INITIALIZE_LIST_HEAD_VARIABLE (mTestMemoryMap);
+MEMORY_MAP_TREE  mTestAddressTree = { NULL, 0, TestAddressRange };
+MEMORY_MAP_TREE  mTestFreeTree    = { NULL, 0, TestFreeRange };
+
+///
+/// TRUE to look descriptors up in the trees, FALSE to walk the descriptor list
+/// and leave the trees alone.
+///
+BOOLEAN  mUseTrees;
+///
+/// TRUE to check every lookup made in the trees against the descriptor list.
+///
+BOOLEAN  mCrossCheck;
+///
+/// Set when a lookup in the trees did not match the descriptor list.
+///
+BOOLEAN  mMismatch;
+///
+/// The host memory given to the page allocator.
+///
+EFI_PHYSICAL_ADDRESS  mPageMemory;
+EFI_PHYSICAL_ADDRESS  mPageMemoryEnd;
+
+/**
+  Returns the range of a descriptor in the address tree.
+
+  @param[in]  Node        The address node of the descriptor.
+  @param[out] Start       The first address of the descriptor.
+  @param[out] End         The last address of the descriptor.
+
+**/
+VOID
+TestAddressRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  )
+{
+  TEST_DESCRIPTOR  *Descriptor;
+
+  Descriptor = CR (Node, TEST_DESCRIPTOR, AddressNode, TEST_DESCRIPTOR_SIGNATURE);
+  *Start     = Descriptor->Start;
+  *End       = Descriptor->End;
+}
+
+/**
+  Returns the range of a descriptor in the free tree.
+
+  @param[in]  Node        The free node of the descriptor.
+  @param[out] Start       The first address of the descriptor.
+  @param[out] End         The last address of the descriptor.
+
+**/
+VOID
+TestFreeRange (
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  OUT UINT64                *Start,
+  OUT UINT64                *End
+  )
+{
+  TEST_DESCRIPTOR  *Descriptor;
+
+  Descriptor = CR (Node, TEST_DESCRIPTOR, FreeNode, TEST_DESCRIPTOR_SIGNATURE);
+  *Start     = Descriptor->Start;
+  *End       = Descriptor->End;
+}
+
+/**
+  Adds a descriptor to the memory map.
+
+  @param[in] Free         TRUE if the range is free.
+  @param[in] Start        The first address of the range.
+  @param[in] End          The last address of the range.
+
+  @return The descriptor.
+
+**/
+TEST_DESCRIPTOR *
+AddDescriptor (
+  IN BOOLEAN  Free,
+  IN UINT64   Start,
+  IN UINT64   End
+  )
+{
+  TEST_DESCRIPTOR  *Descriptor;
+
+  ASSERT (!IsListEmpty (&mDescriptorPool));
+  Descriptor = CR (GetFirstNode (&mDescriptorPool), TEST_DESCRIPTOR, Link, TEST_DESCRIPTOR_SIGNATURE);
+  RemoveEntryList (&Descriptor->Link);
+
+  Descriptor->Free  = Free;
+  Descriptor->Start = Start;
+  Descriptor->End   = End;
+  InsertTailList (&mTestMemoryMap, &Descriptor->Link);
+
+  if (mUseTrees) {
+    MemoryMapTreeInsert (&mTestAddressTree, &Descriptor->AddressNode);
+    if (Free) {
+      MemoryMapTreeInsert (&mTestFreeTree, &Descriptor->FreeNode);
+    }
+  }
+
+  return Descriptor;
+}
+
+/**
+  Removes a descriptor from the memory map.
+
+  @param[in] Descriptor   The descriptor.
+
+**/
+VOID
+RemoveDescriptor (
+  IN TEST_DESCRIPTOR  *Descriptor
+  )
+{
+  if (mUseTrees) {
+    MemoryMapTreeRemove (&mTestAddressTree, &Descriptor->AddressNode);
+    if (Descriptor->Free) {
+      MemoryMapTreeRemove (&mTestFreeTree, &Descriptor->FreeNode);
+    }
+  }
+
+  RemoveEntryList (&Descriptor->Link);
+  InsertTailList (&mDescriptorPool, &Descriptor->Link);
+}
+
+/**
+  Sets up an empty memory map with a pool of descriptors.
+
+  @retval TRUE            The memory map is set up.
+  @retval FALSE           The descriptors could not be allocated.
+
+**/
+BOOLEAN
+CreateMemoryMap (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  mDescriptors = AllocateZeroPool (TEST_DESCRIPTOR_COUNT * sizeof (TEST_DESCRIPTOR));
+  if (mDescriptors == NULL) {
+    return FALSE;
+  }
+
+  InitializeListHead (&mDescriptorPool);
+  InitializeListHead (&mTestMemoryMap);
+  for (Index = 0; Index < TEST_DESCRIPTOR_COUNT; Index++) {
+    mDescriptors[Index].Signature = TEST_DESCRIPTOR_SIGNATURE;
+    InsertTailList (&mDescriptorPool, &mDescriptors[Index].Link);
+  }
+
+  mTestAddressTree.Root  = NULL;
+  mTestAddressTree.Count = 0;
+  mTestFreeTree.Root     = NULL;
+  mTestFreeTree.Count    = 0;
+  mMismatch              = FALSE;
+  return TRUE;
+}
+
+/**
+  Frees the descriptors of the memory map.
+
+**/
+VOID
+FreeMemoryMap (
+  VOID
+  )
+{
+  FreePool (mDescriptors);
+  mDescriptors = NULL;
+}
+
+/**
+  Finds the descriptor that covers an address by walking the descriptor list.
+
+  @param[in] Address      The address to look up.
+
+  @return The descriptor, or NULL if no descriptor covers Address.
+
+**/
+TEST_DESCRIPTOR *
+LinearFindDescriptor (
+  IN UINT64  Address
+  )
+{
+  LIST_ENTRY       *Link;
+  TEST_DESCRIPTOR  *Descriptor;
+
+  for (Link = mTestMemoryMap.ForwardLink; Link != &mTestMemoryMap; Link = Link->ForwardLink) {
+    Descriptor = CR (Link, TEST_DESCRIPTOR, Link, TEST_DESCRIPTOR_SIGNATURE);
+    if ((Descriptor->Start <= Address) && (Descriptor->End >= Address)) {
+      return Descriptor;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Finds the descriptor that covers an address.
+
+  @param[in] Address      The address to look up.
+
+  @return The descriptor, or NULL if no descriptor covers Address.
+
+**/
+TEST_DESCRIPTOR *
+FindDescriptor (
+  IN UINT64  Address
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Node;
+  TEST_DESCRIPTOR       *Descriptor;
+
+  if (!mUseTrees) {
+    return LinearFindDescriptor (Address);
+  }
+
+  Descriptor = NULL;
+  Node       = MemoryMapTreeFindFloor (&mTestAddressTree, Address);
+  if (Node != NULL) {
+    Descriptor = CR (Node, TEST_DESCRIPTOR, AddressNode, TEST_DESCRIPTOR_SIGNATURE);
+    if (Descriptor->End < Address) {
+      Descriptor = NULL;
+    }
+  }
+
+  if (mCrossCheck && (Descriptor != LinearFindDescriptor (Address))) {
+    mMismatch = TRUE;
+  }
+
+  return Descriptor;
+}
+
+/**
+  Finds the highest free descriptor large enough by walking the descriptor list.
+
+  @param[in] Size         The size in bytes needed.
+
+  @return The descriptor, or NULL if no free descriptor is large enough.
+
+**/
+TEST_DESCRIPTOR *
+LinearFindFreeDescriptor (
+  IN UINT64  Size
+  )
+{
+  LIST_ENTRY       *Link;
+  TEST_DESCRIPTOR  *Descriptor;
+  TEST_DESCRIPTOR  *Best;
+
+  Best = NULL;
+  for (Link = mTestMemoryMap.ForwardLink; Link != &mTestMemoryMap; Link = Link->ForwardLink) {
+    Descriptor = CR (Link, TEST_DESCRIPTOR, Link, TEST_DESCRIPTOR_SIGNATURE);
+    if (!Descriptor->Free || (Descriptor->End - Descriptor->Start + 1 < Size)) {
+      continue;
+    }
+
+    if ((Best == NULL) || (Descriptor->Start > Best->Start)) {
+      Best = Descriptor;
+    }
+  }
+
+  return Best;
+}
+
+/**
+  Finds the highest free descriptor large enough.
+
+  @param[in] Size         The size in bytes needed.
+
+  @return The descriptor, or NULL if no free descriptor is large enough.
+
+**/
+TEST_DESCRIPTOR *
+FindFreeDescriptor (
+  IN UINT64  Size
+  )
+{
+  MEMORY_MAP_TREE_NODE  *Node;
+  TEST_DESCRIPTOR       *Descriptor;
+
+  if (!mUseTrees) {
+    return LinearFindFreeDescriptor (Size);
+  }
+
+  Descriptor = NULL;
+  Node       = MemoryMapTreeFindLastFit (&mTestFreeTree, MAX_UINT64, Size);
+  if (Node != NULL) {
+    Descriptor = CR (Node, TEST_DESCRIPTOR, FreeNode, TEST_DESCRIPTOR_SIGNATURE);
+  }
+
+  if (mCrossCheck && (Descriptor != LinearFindFreeDescriptor (Size))) {
+    mMismatch = TRUE;
+  }
+
+  return Descriptor;
+}
+
+/**
+  Allocates a range from the top of the highest free descriptor large enough.
+
+  @param[in] Size         The size in bytes to allocate.
+
+  @return The base address of the range, or 0 if no free descriptor is large enough.
+
+**/
+UINT64
+TestAllocate (
+  IN UINT64  Size
+  )
+{
+  TEST_DESCRIPTOR  *Descriptor;
+  UINT64           End;
+
+  Descriptor = FindFreeDescriptor (Size);
+  if (Descriptor == NULL) {
+    return 0;
+  }
+
+  End = Descriptor->End;
+  if (Descriptor->End - Descriptor->Start + 1 == Size) {
+    RemoveDescriptor (Descriptor);
+  } else {
+    Descriptor->End -= Size;
+    if (mUseTrees) {
+      MemoryMapTreeUpdate (&mTestAddressTree, &Descriptor->AddressNode);
+      MemoryMapTreeUpdate (&mTestFreeTree, &Descriptor->FreeNode);
+    }
+  }
+
+  AddDescriptor (FALSE, End - Size + 1, End);
+  return End - Size + 1;
+}
+
+/**
+  Frees an allocated range and merges it with its free neighbors.
+
+  @param[in] Address      The base address of the range.
+
+  @retval TRUE            The range was freed.
+  @retval FALSE           Address is not the base address of an allocated range.
+
+**/
+BOOLEAN
+TestFree (
+  IN UINT64  Address
+  )
+{
+  TEST_DESCRIPTOR  *Descriptor;
+  TEST_DESCRIPTOR  *Neighbor;
+  UINT64           Start;
+  UINT64           End;
+
+  Descriptor = FindDescriptor (Address);
+  if ((Descriptor == NULL) || Descriptor->Free || (Descriptor->Start != Address)) {
+    return FALSE;
+  }
+
+  Start = Descriptor->Start;
+  End   = Descriptor->End;
+  RemoveDescriptor (Descriptor);
+
+  Neighbor = FindDescriptor (Start - 1);
+  if ((Neighbor != NULL) && Neighbor->Free) {
+    Start = Neighbor->Start;
+    RemoveDescriptor (Neighbor);
+  }
+
+  Neighbor = FindDescriptor (End + 1);
+  if ((Neighbor != NULL) && Neighbor->Free) {
+    End = Neighbor->End;
+    RemoveDescriptor (Neighbor);
+  }
+
+  AddDescriptor (TRUE, Start, End);
+  return TRUE;
+}
+
+/**
+  Checks the red-black properties, the order and the largest range sizes of a
+  subtree.
+
+  @param[in]  Tree        The tree.
+  @param[in]  Node        The root of the subtree, or NULL.
+  @param[in]  Low         All the start addresses of the subtree must be at least Low.
+  @param[in]  High        All the start addresses of the subtree must be at most High.
+  @param[out] Count       The number of nodes of the subtree.
+
+  @return The black height of the subtree, or -1 if a property does not hold.
+
+**/
+INTN
+CheckSubtree (
+  IN  MEMORY_MAP_TREE       *Tree,
+  IN  MEMORY_MAP_TREE_NODE  *Node,
+  IN  UINT64                Low,
+  IN  UINT64                High,
+  OUT UINTN                 *Count
+  )
+{
+  UINT64  Start;
+  UINT64  End;
+  UINT64  MaxSize;
+  UINTN   LeftCount;
+  UINTN   RightCount;
+  INTN    LeftHeight;
+  INTN    RightHeight;
+
+  *Count = 0;
+  if (Node == NULL) {
+    return 1;
+  }
+
+  Tree->GetRange (Node, &Start, &End);
+  if ((Start < Low) || (Start > High)) {
+    return -1;
+  }
+
+  if (Node->Red &&
+      (((Node->Left != NULL) && Node->Left->Red) || ((Node->Right != NULL) && Node->Right->Red)))
+  {
+    return -1;
+  }
+
+  if (((Node->Left != NULL) && (Node->Left->Parent != Node)) ||
+      ((Node->Right != NULL) && (Node->Right->Parent != Node)))
+  {
+    return -1;
+  }
+
+  LeftHeight  = CheckSubtree (Tree, Node->Left, Low, Start, &LeftCount);
+  RightHeight = CheckSubtree (Tree, Node->Right, Start, High, &RightCount);
+  if ((LeftHeight < 0) || (LeftHeight != RightHeight)) {
+    return -1;
+  }
+
+  MaxSize = End - Start + 1;
+  if ((Node->Left != NULL) && (Node->Left->MaxSize > MaxSize)) {
+    MaxSize = Node->Left->MaxSize;
+  }
+
+  if ((Node->Right != NULL) && (Node->Right->MaxSize > MaxSize)) {
+    MaxSize = Node->Right->MaxSize;
+  }
+
+  if (Node->MaxSize != MaxSize) {
+    return -1;
+  }
+
+  *Count = LeftCount + RightCount + 1;
+  return LeftHeight + (Node->Red ? 0 : 1);
+}
+
+/**
+  Checks a tree.
+
+  @param[in] Tree         The tree.
+
+  @retval TRUE            The tree is a valid red-black tree.
+  @retval FALSE           A property of the tree does not hold.
+
+**/
+BOOLEAN
+CheckTree (
+  IN MEMORY_MAP_TREE  *Tree
+  )
+{
+  UINTN  Count;
+
+  if ((Tree->Root != NULL) && (Tree->Root->Red || (Tree->Root->Parent != NULL))) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)((CheckSubtree (Tree, Tree->Root, 0, MAX_UINT64, &Count) > 0) && (Count == Tree->Count));
+}
+
+/**
+  Returns a pseudo-random number.
+
+  @param[in, out] Seed    The state of the generator.
+
+  @return The next number of the sequence.
+
+**/
+UINT32
+TestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Fragments the memory map to about a number of descriptors, by allocating
+  ranges and freeing every other one.
+
+  @param[in]  Descriptors   The number of descriptors to reach.
+  @param[out] Allocated     The base addresses of the ranges still allocated.
+  @param[out] Count         The number of ranges still allocated.
+
+**/
+VOID
+FragmentMemoryMap (
+  IN  UINTN   Descriptors,
+  OUT UINT64  *Allocated,
+  OUT UINTN   *Count
+  )
+{
+  UINT32  Seed;
+  UINTN   Index;
+  UINT64  Address;
+
+  Seed   = 1;
+  *Count = 0;
+  AddDescriptor (TRUE, TEST_MEMORY_BASE, TEST_MEMORY_BASE + MultU64x32 (Descriptors, SIZE_1MB) - 1);
+
+  for (Index = 0; Index < Descriptors; Index++) {
+    Address = TestAllocate (EFI_PAGES_TO_SIZE (1 + TestRandom (&Seed) % 16));
+    ASSERT (Address != 0);
+    if ((Index & 1) == 0) {
+      Allocated[(*Count)++] = Address;
+    } else {
+      TestFree (Address);
+    }
+  }
+}
+
+/**
+  Allocates and frees ranges at random and checks the trees against the
+  descriptor list on every step.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TreesMatchList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  *Allocated;
+  UINTN   Count;
+  UINTN   Step;
+  UINTN   Index;
+  UINT32  Seed;
+  UINT64  Address;
+
+  Allocated = AllocatePool (TEST_DESCRIPTOR_COUNT * sizeof (UINT64));
+  UT_ASSERT_NOT_NULL (Allocated);
+  UT_ASSERT_TRUE (CreateMemoryMap ());
+  mUseTrees   = TRUE;
+  mCrossCheck = TRUE;
+
+  FragmentMemoryMap (256, Allocated, &Count);
+  UT_ASSERT_TRUE (CheckTree (&mTestAddressTree));
+  UT_ASSERT_TRUE (CheckTree (&mTestFreeTree));
+
+  Seed = 7;
+  for (Step = 0; Step < 4096; Step++) {
+    if ((Count > 0) && (((TestRandom (&Seed) & 1) == 0) || (Count == TEST_DESCRIPTOR_COUNT / 4))) {
+      Index = TestRandom (&Seed) % Count;
+      UT_ASSERT_TRUE (TestFree (Allocated[Index]));
+      Allocated[Index] = Allocated[--Count];
+    } else {
+      Address = TestAllocate (EFI_PAGES_TO_SIZE (1 + TestRandom (&Seed) % 64));
+      if (Address != 0) {
+        Allocated[Count++] = Address;
+      }
+    }
+
+    UT_ASSERT_FALSE (mMismatch);
+    if ((Step % 64) == 0) {
+      UT_ASSERT_TRUE (CheckTree (&mTestAddressTree));
+      UT_ASSERT_TRUE (CheckTree (&mTestFreeTree));
+    }
+  }
+
+  //
+  // Freeing everything merges the memory map back into one free descriptor.
+  //
+  while (Count > 0) {
+    UT_ASSERT_TRUE (TestFree (Allocated[--Count]));
+  }
+
+  UT_ASSERT_FALSE (mMismatch);
+  UT_ASSERT_EQUAL (mTestAddressTree.Count, 1);
+  UT_ASSERT_EQUAL (mTestFreeTree.Count, 1);
+  UT_ASSERT_TRUE (CheckTree (&mTestAddressTree));
+  UT_ASSERT_TRUE (CheckTree (&mTestFreeTree));
+
+  FreeMemoryMap ();
+  FreePool (Allocated);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures the allocate/free cycles per second with and without the trees for
+  several memory map sizes.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TreeBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  DescriptorCounts[] = { 64, 512, 4096 };
+  UINT64              *Allocated;
+  UINTN               CountIndex;
+  UINTN               Count;
+  UINTN               Cycles;
+  UINTN               Index;
+  UINTN               Slot;
+  UINT32              Seed;
+  UINT64              Address;
+  clock_t             Start;
+  double              Seconds[2];
+  UINTN               Pass;
+
+  Allocated = AllocatePool (TEST_DESCRIPTOR_COUNT * sizeof (UINT64));
+  UT_ASSERT_NOT_NULL (Allocated);
+  mCrossCheck = FALSE;
+
+  for (CountIndex = 0; CountIndex < ARRAY_SIZE (DescriptorCounts); CountIndex++) {
+    Cycles = 16384;
+    for (Pass = 0; Pass < 2; Pass++) {
+      UT_ASSERT_TRUE (CreateMemoryMap ());
+      mUseTrees = (BOOLEAN)(Pass == 1);
+      FragmentMemoryMap (DescriptorCounts[CountIndex], Allocated, &Count);
+
+      //
+      // Every cycle allocates a range and frees another one, which keeps the
+      // number of descriptors about the same.
+      //
+      Seed  = 3;
+      Start = clock ();
+      for (Index = 0; Index < Cycles; Index++) {
+        Address = TestAllocate (EFI_PAGES_TO_SIZE (1 + TestRandom (&Seed) % 16));
+        UT_ASSERT_NOT_EQUAL (Address, 0);
+        Slot = TestRandom (&Seed) % Count;
+        UT_ASSERT_TRUE (TestFree (Allocated[Slot]));
+        Allocated[Slot] = Address;
+      }
+
+      Seconds[Pass] = MAX ((double)(clock () - Start) / CLOCKS_PER_SEC, 1e-6);
+      FreeMemoryMap ();
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "%5u descriptors: %10lu cycles/s linear, %10lu cycles/s trees\n",
+      DescriptorCounts[CountIndex],
+      (UINT64)(Cycles / Seconds[0]),
+      (UINT64)(Cycles / Seconds[1])
+      ));
+  }
+
+  FreePool (Allocated);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Finds the descriptor of gMemoryMap that covers an address by walking the list.
+
+  @param[in] Address      The address to look up.
+
+  @return The descriptor, or NULL if no descriptor covers Address.
+
+**/
+MEMORY_MAP *
+LinearFindMemoryMapEntry (
+  IN UINT64  Address
+  )
+{
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if ((Entry->Start <= Address) && (Entry->End >= Address)) {
+      return Entry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Finds the highest free range of gMemoryMap by walking the list. The range
+  must end on an Alignment boundary and lie within [MinAddress, MaxAddress].
+
+  @param[in] MaxAddress     The highest address of the range.
+  @param[in] MinAddress     The lowest address of the range.
+  @param[in] NumberOfPages  The number of pages of the range.
+  @param[in] Alignment      The alignment of the end of the range.
+
+  @return The base address of the range, or 0 if no free range is large enough.
+
+**/
+UINT64
+LinearFindFreePages (
+  IN UINT64  MaxAddress,
+  IN UINT64  MinAddress,
+  IN UINT64  NumberOfPages,
+  IN UINTN   Alignment
+  )
+{
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+  UINT64      Size;
+  UINT64      End;
+  UINT64      Target;
+  UINT64      Best;
+
+  Size       = EFI_PAGES_TO_SIZE (NumberOfPages);
+  MaxAddress = ((MaxAddress + 1) & ~(UINT64)EFI_PAGE_MASK) - 1;
+  Best       = 0;
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if ((Entry->Type != EfiConventionalMemory) || ((Entry->Attribute & EFI_MEMORY_SP) != 0)) {
+      continue;
+    }
+
+    End = MIN (Entry->End, MaxAddress);
+    if (End < Entry->Start) {
+      continue;
+    }
+
+    End = (End + 1) & ~((UINT64)Alignment - 1);
+    if (End < Entry->Start + Size) {
+      continue;
+    }
+
+    Target = End - Size;
+    if ((Target >= MinAddress) && (Target > Best)) {
+      Best = Target;
+    }
+  }
+
+  return Best;
+}
+
+/**
+  Checks the indexes of gMemoryMap against the list: every descriptor is found
+  through the address tree, the free tree holds exactly the free descriptors,
+  and no two neighbors with the same type and attributes were left unmerged.
+
+  @retval TRUE            The indexes match the list.
+  @retval FALSE           A lookup or a tree property does not match.
+
+**/
+BOOLEAN
+MemoryMapMatchesList (
+  VOID
+  )
+{
+  LIST_ENTRY  *Link;
+  MEMORY_MAP  *Entry;
+  MEMORY_MAP  *Neighbor;
+  UINTN       Count;
+  UINTN       FreeCount;
+
+  Count     = 0;
+  FreeCount = 0;
+  for (Link = gMemoryMap.ForwardLink; Link != &gMemoryMap; Link = Link->ForwardLink) {
+    Entry = CR (Link, MEMORY_MAP, Link, MEMORY_MAP_SIGNATURE);
+    if ((FindMemoryMapEntry (Entry->Start) != Entry) || (FindMemoryMapEntry (Entry->End) != Entry)) {
+      return FALSE;
+    }
+
+    Neighbor = FindMemoryMapEntry (Entry->End + 1);
+    if (Neighbor != LinearFindMemoryMapEntry (Entry->End + 1)) {
+      return FALSE;
+    }
+
+    if ((Neighbor != NULL) && (Neighbor->Type == Entry->Type) && (Neighbor->Attribute == Entry->Attribute)) {
+      return FALSE;
+    }
+
+    Count++;
+    if ((Entry->Type == EfiConventionalMemory) && ((Entry->Attribute & EFI_MEMORY_SP) == 0)) {
+      FreeCount++;
+    }
+  }
+
+  return (BOOLEAN)((Count == mMemoryMapTree.Count) &&
+                   (FreeCount == mFreeMemoryMapTree.Count) &&
+                   CheckTree (&mMemoryMapTree) &&
+                   CheckTree (&mFreeMemoryMapTree));
+}
+
+/**
+  Adds a range to the memory map with CoreAddRange(), as the GCD services do.
+
+  @param[in] Type         The memory type of the range.
+  @param[in] Start        The first address of the range.
+  @param[in] Pages        The number of pages of the range.
+  @param[in] Attribute    The attributes of the range.
+
+**/
+VOID
+TestAddRange (
+  IN EFI_MEMORY_TYPE       Type,
+  IN EFI_PHYSICAL_ADDRESS  Start,
+  IN UINTN                 Pages,
+  IN UINT64                Attribute
+  )
+{
+  CoreAcquireMemoryLock ();
+  CoreAddRange (Type, Start, Start + EFI_PAGES_TO_SIZE (Pages) - 1, Attribute);
+  CoreFreeMemoryMapStack ();
+  CoreReleaseMemoryLock ();
+}
+
+/**
+  Gives a buffer of host memory to the page allocator, in two halves added
+  top half first so that CoreAddRange() has to merge them.
+
+**/
+VOID
+EFIAPI
+PageAllocatorSetup (
+  VOID
+  )
+{
+  UINTN  Pages;
+
+  mPageMemory = (EFI_PHYSICAL_ADDRESS)(UINTN)AllocateAlignedPages (TEST_PAGE_MEMORY_PAGES, SIZE_64KB);
+  ASSERT (mPageMemory != 0);
+  mPageMemoryEnd = mPageMemory + EFI_PAGES_TO_SIZE (TEST_PAGE_MEMORY_PAGES - TEST_WINDOW_PAGES);
+
+  Pages = (TEST_PAGE_MEMORY_PAGES - TEST_WINDOW_PAGES) / 2;
+  CoreAddMemoryDescriptor (EfiConventionalMemory, mPageMemory + EFI_PAGES_TO_SIZE (Pages), Pages, EFI_MEMORY_WB);
+  CoreAddMemoryDescriptor (EfiConventionalMemory, mPageMemory, Pages, EFI_MEMORY_WB);
+}
+
+/**
+  Checks that CoreAddRange() merges a range with the neighbors of the same type
+  and attributes only.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AddRangeMergesNeighbors (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_MAP            *Entry;
+  EFI_PHYSICAL_ADDRESS  Window;
+
+  //
+  // The two halves of the free memory were merged, below the page of memory
+  // map descriptors taken from the top.
+  //
+  Entry = FindMemoryMapEntry (mPageMemory);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->Type, EfiConventionalMemory);
+  UT_ASSERT_EQUAL (Entry->Start, mPageMemory);
+  UT_ASSERT_TRUE (Entry->End > mPageMemory + EFI_PAGES_TO_SIZE ((TEST_PAGE_MEMORY_PAGES - TEST_WINDOW_PAGES) / 2));
+
+  Window = mPageMemoryEnd;
+  UT_ASSERT_EQUAL ((UINTN)FindMemoryMapEntry (Window), (UINTN)NULL);
+
+  TestAddRange (EfiReservedMemoryType, Window + EFI_PAGES_TO_SIZE (16), 16, 0);
+  TestAddRange (EfiReservedMemoryType, Window + EFI_PAGES_TO_SIZE (48), 16, 0);
+  TestAddRange (EfiReservedMemoryType, Window + EFI_PAGES_TO_SIZE (32), 16, 0);
+  Entry = FindMemoryMapEntry (Window + EFI_PAGES_TO_SIZE (16));
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->Start, Window + EFI_PAGES_TO_SIZE (16));
+  UT_ASSERT_EQUAL (Entry->End, Window + EFI_PAGES_TO_SIZE (64) - 1);
+
+  //
+  // Different attributes or a different type are not merged.
+  //
+  TestAddRange (EfiReservedMemoryType, Window + EFI_PAGES_TO_SIZE (8), 8, EFI_MEMORY_UC);
+  TestAddRange (EfiACPIMemoryNVS, Window, 8, 0);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Window + EFI_PAGES_TO_SIZE (16))->Start, Window + EFI_PAGES_TO_SIZE (16));
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Window + EFI_PAGES_TO_SIZE (8))->End, Window + EFI_PAGES_TO_SIZE (16) - 1);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Window)->Type, EfiACPIMemoryNVS);
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+
+  //
+  // None of it is free memory.
+  //
+  UT_ASSERT_EQUAL (CoreFindFreePagesI (mPageMemory + EFI_PAGES_TO_SIZE (TEST_PAGE_MEMORY_PAGES) - 1, mPageMemoryEnd, 1, EfiBootServicesData, EFI_PAGE_SIZE, FALSE), 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that AllocateAddress, AllocateMaxAddress and partial frees split and
+  merge the descriptors of the memory map.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConvertPagesSplitsAndMerges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_MAP            *Entry;
+  EFI_PHYSICAL_ADDRESS  Address;
+  EFI_PHYSICAL_ADDRESS  Memory;
+  UINT64                FreeStart;
+  UINT64                FreeEnd;
+  UINTN                 Count;
+
+  Entry = FindMemoryMapEntry (mPageMemory);
+  UT_ASSERT_NOT_NULL (Entry);
+  FreeStart = Entry->Start;
+  FreeEnd   = Entry->End;
+  Count     = mMemoryMapTree.Count;
+
+  //
+  // Allocating in the middle of a free descriptor splits it in three.
+  //
+  Address = mPageMemory + EFI_PAGES_TO_SIZE (64);
+  Memory  = Address;
+  UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePages (AllocateAddress, EfiLoaderData, 8, &Memory));
+  UT_ASSERT_EQUAL (Memory, Address);
+  Entry = FindMemoryMapEntry (Address);
+  UT_ASSERT_EQUAL (Entry->Type, EfiLoaderData);
+  UT_ASSERT_EQUAL (Entry->Start, Address);
+  UT_ASSERT_EQUAL (Entry->End, Address + EFI_PAGES_TO_SIZE (8) - 1);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Address - 1)->End, Address - 1);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Address + EFI_PAGES_TO_SIZE (8))->Start, Address + EFI_PAGES_TO_SIZE (8));
+  UT_ASSERT_EQUAL (mMemoryMapTree.Count, Count + 2);
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+
+  //
+  // The pages are no longer free, and free pages cannot be freed.
+  //
+  Memory = Address + EFI_PAGE_SIZE;
+  UT_ASSERT_STATUS_EQUAL (CoreAllocatePages (AllocateAddress, EfiLoaderData, 1, &Memory), EFI_NOT_FOUND);
+  UT_ASSERT_STATUS_EQUAL (CoreFreePages (Address + EFI_PAGES_TO_SIZE (8), 1), EFI_NOT_FOUND);
+
+  //
+  // Freeing the middle page splits the allocation, freeing the rest merges
+  // everything back into the original free descriptor.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Address + EFI_PAGES_TO_SIZE (4), 1));
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Address + EFI_PAGES_TO_SIZE (4))->Type, EfiConventionalMemory);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Address)->End, Address + EFI_PAGES_TO_SIZE (4) - 1);
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (Address + EFI_PAGES_TO_SIZE (5))->Start, Address + EFI_PAGES_TO_SIZE (5));
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+
+  UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Address, 4));
+  UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Address + EFI_PAGES_TO_SIZE (5), 3));
+  Entry = FindMemoryMapEntry (Address);
+  UT_ASSERT_EQUAL (Entry->Start, FreeStart);
+  UT_ASSERT_EQUAL (Entry->End, FreeEnd);
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+
+  //
+  // AllocateMaxAddress takes the highest free pages below the address.
+  //
+  Address = mPageMemory + EFI_PAGES_TO_SIZE (256);
+  Memory  = Address - 1;
+  UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePages (AllocateMaxAddress, EfiBootServicesData, 16, &Memory));
+  UT_ASSERT_EQUAL (Memory, Address - EFI_PAGES_TO_SIZE (16));
+  UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Memory, 16));
+  Entry = FindMemoryMapEntry (Address);
+  UT_ASSERT_EQUAL (Entry->Start, FreeStart);
+  UT_ASSERT_EQUAL (Entry->End, FreeEnd);
+  UT_ASSERT_EQUAL (mMemoryMapTree.Count, Count);
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Allocates and frees pages at random through CoreAllocatePages() and
+  CoreFreePages(), and checks every allocation and CoreFindFreePagesI() for
+  several limits and alignments against a linear walk of gMemoryMap.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PagesMatchList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST EFI_MEMORY_TYPE  Types[] = { EfiBootServicesData, EfiLoaderData, EfiACPIReclaimMemory };
+  STATIC CONST UINTN            Alignments[] = { EFI_PAGE_SIZE, SIZE_64KB, SIZE_2MB };
+  EFI_PHYSICAL_ADDRESS          *Allocated;
+  UINTN                         *Pages;
+  UINTN                         Count;
+  UINTN                         Step;
+  UINTN                         Index;
+  UINTN                         Size;
+  UINT32                        Seed;
+  UINT64                        Expected;
+  UINT64                        MaxAddress;
+  UINT64                        MinAddress;
+  EFI_PHYSICAL_ADDRESS          Memory;
+  EFI_STATUS                    Status;
+
+  Allocated = AllocatePool (TEST_PAGE_MEMORY_PAGES * sizeof (EFI_PHYSICAL_ADDRESS));
+  Pages     = AllocatePool (TEST_PAGE_MEMORY_PAGES * sizeof (UINTN));
+  UT_ASSERT_NOT_NULL (Allocated);
+  UT_ASSERT_NOT_NULL (Pages);
+
+  Count = 0;
+  Seed  = 11;
+  for (Step = 0; Step < 4096; Step++) {
+    if ((Count > 0) && ((TestRandom (&Seed) % 3) == 0)) {
+      Index = TestRandom (&Seed) % Count;
+      UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Allocated[Index], Pages[Index]));
+      Count--;
+      Allocated[Index] = Allocated[Count];
+      Pages[Index]     = Pages[Count];
+    } else {
+      Size     = 1 + TestRandom (&Seed) % 32;
+      Expected = LinearFindFreePages (MAX_ALLOC_ADDRESS, 0, Size, DEFAULT_PAGE_ALLOCATION_GRANULARITY);
+      Status   = CoreAllocatePages (AllocateAnyPages, Types[TestRandom (&Seed) % ARRAY_SIZE (Types)], Size, &Memory);
+      if (Expected == 0) {
+        UT_ASSERT_STATUS_EQUAL (Status, EFI_OUT_OF_RESOURCES);
+      } else {
+        UT_ASSERT_NOT_EFI_ERROR (Status);
+        UT_ASSERT_EQUAL (Memory, Expected);
+        Allocated[Count] = Memory;
+        Pages[Count]     = Size;
+        Count++;
+      }
+    }
+
+    if ((Step % 16) == 0) {
+      UT_ASSERT_TRUE (MemoryMapMatchesList ());
+
+      //
+      // Look up ranges below and above random limits within the buffer.
+      //
+      for (Index = 0; Index < ARRAY_SIZE (Alignments); Index++) {
+        MaxAddress = mPageMemory + EFI_PAGES_TO_SIZE (TestRandom (&Seed) % TEST_PAGE_MEMORY_PAGES) + TestRandom (&Seed) % EFI_PAGE_SIZE;
+        MinAddress = mPageMemory + EFI_PAGES_TO_SIZE (TestRandom (&Seed) % (TEST_PAGE_MEMORY_PAGES / 2));
+        Size       = 1 + TestRandom (&Seed) % 64;
+        UT_ASSERT_EQUAL (
+          CoreFindFreePagesI (MaxAddress, 0, Size, EfiBootServicesData, Alignments[Index], FALSE),
+          LinearFindFreePages (MaxAddress, 0, Size, Alignments[Index])
+          );
+        UT_ASSERT_EQUAL (
+          CoreFindFreePagesI (MaxAddress, MinAddress, Size, EfiBootServicesData, Alignments[Index], FALSE),
+          LinearFindFreePages (MaxAddress, MinAddress, Size, Alignments[Index])
+          );
+      }
+    }
+  }
+
+  while (Count > 0) {
+    Count--;
+    UT_ASSERT_NOT_EFI_ERROR (CoreFreePages (Allocated[Count], Pages[Count]));
+  }
+
+  UT_ASSERT_TRUE (MemoryMapMatchesList ());
+  UT_ASSERT_EQUAL (FindMemoryMapEntry (mPageMemory)->Type, EfiConventionalMemory);
+
+  FreePool (Allocated);
+  FreePool (Pages);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Main entry point to the unit test.
+
+  @retval EFI_SUCCESS       The unit test ran.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TreeTests;
+  UNIT_TEST_SUITE_HANDLE      PageTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&TreeTests, Framework, "Memory Map Tree Tests", "MemoryMapTree", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the memory map tree tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (TreeTests, "Tree lookups match the descriptor list", "TreesMatchList", TreesMatchList, NULL, NULL, NULL);
+  AddTestCase (TreeTests, "Allocate/free cycles per second vs. map size", "Benchmark", TreeBenchmark, NULL, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&PageTests, Framework, "Page Allocator Tests", "PageAllocator", PageAllocatorSetup, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the page allocator tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (PageTests, "CoreAddRange() merges neighbors of the same type", "AddRangeMergesNeighbors", AddRangeMergesNeighbors, NULL, NULL, NULL);
+  AddTestCase (PageTests, "Page conversions split and merge descriptors", "ConvertPagesSplitsAndMerges", ConvertPagesSplitsAndMerges, NULL, NULL, NULL);
+  AddTestCase (PageTests, "Page allocations match the memory map list", "PagesMatchList", PagesMatchList, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,426 @@
+/** @file
+  This is a host-based unit test for the pool allocator of the DXE core.
+
+  Pool.c and Page.c run over a buffer of host memory with the slab allocator
+  enabled. The tests go through CoreAllocatePool() and CoreFreePool() and
+  check the slab statistics that the pool reports to the memory profile.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "DxeMain.h"
+#include "Imem.h"
+
+#define UNIT_TEST_NAME     "DXE Core Pool Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+///
+/// The host memory given to the page allocator, and a memory type reserved
+/// for OEM use, whose pool head is created on demand.
+///
+#define TEST_POOL_MEMORY_PAGES  1024
+#define TEST_POOL_OEM_TYPE      ((EFI_MEMORY_TYPE)0x70000000)
+
+//
+// The entry sizes of the size classes served from slabs.
+//
+STATIC CONST UINT32  mSlabClassSizes[] = { 128, 256, 384, 640, 1024, 1664, 2688 };
+
+/**
+  Returns a pseudo-random number.
+
+  @param[in, out] Seed    The state of the generator.
+
+  @return The next number of the sequence.
+
+**/
+UINT32
+TestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Gives a buffer of host memory to the page allocator and initializes the pool
+  heads, so that the pool tests start without any slab.
+
+**/
+VOID
+EFIAPI
+PoolSlabSetup (
+  VOID
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Memory;
+
+  Memory = (EFI_PHYSICAL_ADDRESS)(UINTN)AllocateAlignedPages (TEST_POOL_MEMORY_PAGES, SIZE_64KB);
+  ASSERT (Memory != 0);
+  CoreAddMemoryDescriptor (EfiConventionalMemory, Memory, TEST_POOL_MEMORY_PAGES, EFI_MEMORY_WB);
+
+  CoreInitializePool ();
+}
+
+/**
+  Gets the slab statistics that the memory profile reports for a size class
+  of a pool.
+
+  @param  MemoryType         The memory type of the pool.
+  @param  ObjectSize         The entry size of the size class.
+  @param  Class              Returns the statistics, zeroed if the pool has no
+                             record for the size class.
+
+**/
+STATIC
+VOID
+GetPoolClass (
+  IN  EFI_MEMORY_TYPE            MemoryType,
+  IN  UINT32                     ObjectSize,
+  OUT MEMORY_PROFILE_POOL_CLASS  *Class
+  )
+{
+  MEMORY_PROFILE_POOL_STATS  *Stats;
+  MEMORY_PROFILE_POOL_CLASS  *PoolClass;
+  UINTN                      Size;
+  UINTN                      Index;
+
+  ZeroMem (Class, sizeof (*Class));
+
+  Size  = CoreGetPoolStatsSize ();
+  Stats = AllocatePool (Size);
+  ASSERT (Stats != NULL);
+  Size = CoreCopyPoolStats (Stats, Size);
+  ASSERT (Stats->Header.Signature == MEMORY_PROFILE_POOL_STATS_SIGNATURE);
+  ASSERT (Size == sizeof (*Stats) + Stats->PoolClassCount * sizeof (*PoolClass));
+
+  PoolClass = (MEMORY_PROFILE_POOL_CLASS *)(Stats + 1);
+  for (Index = 0; Index < Stats->PoolClassCount; Index++) {
+    if ((PoolClass[Index].MemoryType == MemoryType) && (PoolClass[Index].ObjectSize == ObjectSize)) {
+      CopyMem (Class, &PoolClass[Index], sizeof (*Class));
+      break;
+    }
+  }
+
+  FreePool (Stats);
+}
+
+/**
+  Checks that the entries of a size class are carved from slabs without
+  overlapping, that freeing them releases all slabs but one, and that the
+  entry freed last is the next one handed out.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SlabEntriesAreReused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VOID                       *Buffers[100];
+  VOID                       *Buffer;
+  MEMORY_PROFILE_POOL_CLASS  Start;
+  MEMORY_PROFILE_POOL_CLASS  Full;
+  MEMORY_PROFILE_POOL_CLASS  Class;
+  UINTN                      Index;
+  UINTN                      Other;
+  UINTN                      Distance;
+
+  UT_ASSERT_TRUE (FeaturePcdGet (PcdDxeCorePoolSlabAllocator));
+
+  GetPoolClass (EfiBootServicesData, 128, &Start);
+
+  //
+  // 64 bytes and the pool head and tail fit in the smallest size class.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (Buffers); Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePool (EfiBootServicesData, 64, &Buffers[Index]));
+    SetMem (Buffers[Index], 64, (UINT8)Index);
+  }
+
+  GetPoolClass (EfiBootServicesData, 128, &Full);
+  UT_ASSERT_EQUAL (Full.UsedObjects, Start.UsedObjects + ARRAY_SIZE (Buffers));
+  UT_ASSERT_TRUE (Full.TotalObjects >= Full.UsedObjects);
+  UT_ASSERT_TRUE (Full.SlabCount > 1);
+  UT_ASSERT_TRUE (Full.SlabPages >= Full.SlabCount);
+
+  for (Index = 0; Index < ARRAY_SIZE (Buffers); Index++) {
+    for (Other = Index + 1; Other < ARRAY_SIZE (Buffers); Other++) {
+      Distance = (UINTN)Buffers[Index] > (UINTN)Buffers[Other] ?
+                 (UINTN)Buffers[Index] - (UINTN)Buffers[Other] :
+                 (UINTN)Buffers[Other] - (UINTN)Buffers[Index];
+      UT_ASSERT_TRUE (Distance >= 128);
+    }
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Buffers); Index++) {
+    UT_ASSERT_EQUAL (*(UINT8 *)Buffers[Index], (UINT8)Index);
+    UT_ASSERT_NOT_EFI_ERROR (CoreFreePool (Buffers[Index]));
+  }
+
+  //
+  // Only the last slab with free entries is kept.
+  //
+  GetPoolClass (EfiBootServicesData, 128, &Class);
+  UT_ASSERT_EQUAL (Class.UsedObjects, Start.UsedObjects);
+  UT_ASSERT_EQUAL (Class.SlabCount, 1);
+  UT_ASSERT_EQUAL (Class.ReleasedSlabCount, Full.ReleasedSlabCount + Full.SlabCount - 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePool (EfiBootServicesData, 64, &Buffer));
+  UT_ASSERT_EQUAL ((UINTN)Buffer, (UINTN)Buffers[ARRAY_SIZE (Buffers) - 1]);
+  UT_ASSERT_NOT_EFI_ERROR (CoreFreePool (Buffer));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that each slab size class serves the requests it is large enough
+  for, and that requests of a page or more bypass the slabs.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SlabSizeClasses (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_PROFILE_POOL_CLASS  Before[ARRAY_SIZE (mSlabClassSizes)];
+  MEMORY_PROFILE_POOL_CLASS  After;
+  VOID                       *Buffer;
+  UINTN                      Size;
+  UINTN                      Index;
+  UINTN                      Grown;
+  UINTN                      LastGrown;
+
+  LastGrown = 0;
+  for (Size = 1; Size <= 2 * EFI_PAGE_SIZE; Size += 37) {
+    for (Index = 0; Index < ARRAY_SIZE (mSlabClassSizes); Index++) {
+      GetPoolClass (EfiBootServicesData, mSlabClassSizes[Index], &Before[Index]);
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePool (EfiBootServicesData, Size, &Buffer));
+    SetMem (Buffer, Size, 0xA5);
+
+    Grown = ARRAY_SIZE (mSlabClassSizes);
+    for (Index = 0; Index < ARRAY_SIZE (mSlabClassSizes); Index++) {
+      GetPoolClass (EfiBootServicesData, mSlabClassSizes[Index], &After);
+      if (After.UsedObjects != Before[Index].UsedObjects) {
+        UT_ASSERT_EQUAL (After.UsedObjects, Before[Index].UsedObjects + 1);
+        UT_ASSERT_EQUAL (Grown, ARRAY_SIZE (mSlabClassSizes));
+        Grown = Index;
+      }
+    }
+
+    if (Size >= EFI_PAGE_SIZE) {
+      UT_ASSERT_EQUAL (Grown, ARRAY_SIZE (mSlabClassSizes));
+    } else if (Grown < ARRAY_SIZE (mSlabClassSizes)) {
+      UT_ASSERT_TRUE (mSlabClassSizes[Grown] > Size);
+      UT_ASSERT_TRUE (Grown >= LastGrown);
+      LastGrown = Grown;
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (CoreFreePool (Buffer));
+  }
+
+  //
+  // The largest slab size class serves requests well below a page.
+  //
+  UT_ASSERT_EQUAL (LastGrown, ARRAY_SIZE (mSlabClassSizes) - 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Allocates and frees pool of random sizes and types, and checks that no
+  allocation overwrites another and that the slab statistics return to their
+  start values once everything is freed.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SlabRandomAllocFree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST EFI_MEMORY_TYPE  Types[] = { EfiBootServicesData, EfiRuntimeServicesData, TEST_POOL_OEM_TYPE };
+  MEMORY_PROFILE_POOL_CLASS     Start[ARRAY_SIZE (mSlabClassSizes)];
+  MEMORY_PROFILE_POOL_CLASS     Class;
+  VOID                          *Buffers[256];
+  UINTN                         Sizes[256];
+  UINT8                         Patterns[256];
+  UINTN                         Count;
+  UINTN                         Step;
+  UINTN                         Index;
+  UINTN                         Offset;
+  UINT32                        Seed;
+
+  for (Index = 0; Index < ARRAY_SIZE (mSlabClassSizes); Index++) {
+    GetPoolClass (EfiBootServicesData, mSlabClassSizes[Index], &Start[Index]);
+  }
+
+  Count = 0;
+  Seed  = 23;
+  for (Step = 0; Step < 8192; Step++) {
+    if ((Count == ARRAY_SIZE (Buffers)) || ((Count > 0) && ((TestRandom (&Seed) % 5) < 2))) {
+      Index = TestRandom (&Seed) % Count;
+      for (Offset = 0; Offset < Sizes[Index]; Offset++) {
+        UT_ASSERT_EQUAL (((UINT8 *)Buffers[Index])[Offset], Patterns[Index]);
+      }
+
+      UT_ASSERT_NOT_EFI_ERROR (CoreFreePool (Buffers[Index]));
+      Count--;
+      Buffers[Index]  = Buffers[Count];
+      Sizes[Index]    = Sizes[Count];
+      Patterns[Index] = Patterns[Count];
+    } else {
+      //
+      // Mostly slab sized requests, with some that take pages.
+      //
+      if ((TestRandom (&Seed) % 16) == 0) {
+        Sizes[Count] = EFI_PAGE_SIZE + TestRandom (&Seed) % (4 * EFI_PAGE_SIZE);
+      } else {
+        Sizes[Count] = 1 + TestRandom (&Seed) % 2600;
+      }
+
+      Patterns[Count] = (UINT8)Step;
+      UT_ASSERT_NOT_EFI_ERROR (CoreAllocatePool (Types[TestRandom (&Seed) % ARRAY_SIZE (Types)], Sizes[Count], &Buffers[Count]));
+      SetMem (Buffers[Count], Sizes[Count], Patterns[Count]);
+      Count++;
+    }
+  }
+
+  while (Count > 0) {
+    Count--;
+    UT_ASSERT_NOT_EFI_ERROR (CoreFreePool (Buffers[Count]));
+  }
+
+  //
+  // The OEM pool head is freed with its last entry, and releases its slabs.
+  //
+  for (Index = 0; Index < ARRAY_SIZE (mSlabClassSizes); Index++) {
+    GetPoolClass (EfiBootServicesData, mSlabClassSizes[Index], &Class);
+    UT_ASSERT_EQUAL (Class.UsedObjects, Start[Index].UsedObjects);
+    GetPoolClass (EfiRuntimeServicesData, mSlabClassSizes[Index], &Class);
+    UT_ASSERT_EQUAL (Class.UsedObjects, 0);
+    GetPoolClass (TEST_POOL_OEM_TYPE, mSlabClassSizes[Index], &Class);
+    UT_ASSERT_EQUAL (Class.SlabCount, 0);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Main entry point to the unit test.
+
+  @retval EFI_SUCCESS       The unit test ran.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PoolTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&PoolTests, Framework, "Pool Slab Allocator Tests", "PoolSlab", PoolSlabSetup, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the pool slab allocator tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (PoolTests, "Slab entries are freed and reused", "SlabEntriesAreReused", SlabEntriesAreReused, NULL, NULL, NULL);
+  AddTestCase (PoolTests, "Requests map to the slab size classes", "SlabSizeClasses", SlabSizeClasses, NULL, NULL, NULL);
+  AddTestCase (PoolTests, "Random pool allocations keep their contents", "SlabRandomAllocFree", SlabRandomAllocFree, NULL, NULL, NULL);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -59,6 +59,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define MEMORY_TYPE_OS_RESERVED_MIN   0x80000000
 #define MEMORY_TYPE_OEM_RESERVED_MIN  0x70000000
 
+//
+// Number of GCD descriptor pieces of the sections of an image whose attributes are set together
+//
+#define IMAGE_MEMORY_RANGE_BATCH_SIZE  32
+
 #define PREVIOUS_MEMORY_DESCRIPTOR(MemoryDescriptor, Size) \
   ((EFI_MEMORY_DESCRIPTOR *)((UINT8 *)(MemoryDescriptor) - (Size)))
 
@@ -181,17 +186,93 @@ GetUefiImageProtectionPolicy (
 }
 
 /**
-  Set UEFI image memory attributes.
+  Set the memory attributes of the pieces of a UEFI image range, in the GCD and
+  in the page tables.
 
-  @param[in]  BaseAddress            Specified start address
-  @param[in]  Length                 Specified length
-  @param[in]  Attributes             Specified attributes
+  @param[in]  Ranges                 The pieces of the range and their attributes
+  @param[in]  RangeCount             Number of entries in Ranges
 **/
 VOID
-SetUefiImageMemoryAttributes (
-  IN UINT64  BaseAddress,
-  IN UINT64  Length,
-  IN UINT64  Attributes
+SetUefiImageMemoryRanges (
+  IN GCD_MEMORY_SPACE_RANGE  *Ranges,
+  IN UINTN                   RangeCount
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STATUS  RangeStatus;
+  UINTN       Index;
+
+  if (RangeCount == 0) {
+    return;
+  }
+
+  // Call into the GCD to update the attributes there. It will call into the CPU Arch protocol to update the
+  // page table attributes, once for all the adjacent pieces that have the same attributes
+  Status = CoreSetMemorySpaceAttributesList (RangeCount, Ranges);
+
+  for (Index = 0; Index < RangeCount; Index++) {
+    if (EFI_ERROR (Status)) {
+      // the whole list is refused if one piece fails, so set the pieces one by one to still protect the others
+      RangeStatus = CoreSetMemorySpaceAttributes (
+                      Ranges[Index].BaseAddress,
+                      Ranges[Index].Length,
+                      Ranges[Index].Attributes
+                      );
+
+      if (EFI_ERROR (RangeStatus)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a failed on %llx of length %llx with attributes %llx - %r\n",
+          __func__,
+          Ranges[Index].BaseAddress,
+          Ranges[Index].Length,
+          Ranges[Index].Attributes,
+          RangeStatus
+          ));
+        ASSERT_EFI_ERROR (RangeStatus);
+      }
+    }
+
+    if (((Ranges[Index].Attributes & (EFI_MEMORY_ATTRIBUTE_MASK | EFI_CACHE_ATTRIBUTE_MASK)) == 0) && (gCpu != NULL)) {
+      // if the passed hardware attributes are 0, CoreSetMemorySpaceAttributes() will not call into the CPU Arch protocol
+      // to set the attributes, so we need to do it manually here. This can be the case when we are unprotecting an
+      // image if no caching attributes are set. If gCpu has not been populated yet, we'll still have updated the GCD
+      // descriptor and we should sync the attributes with the CPU Arch protocol when it is available.
+      RangeStatus = gCpu->SetMemoryAttributes (gCpu, Ranges[Index].BaseAddress, Ranges[Index].Length, 0);
+      if (EFI_ERROR (RangeStatus)) {
+        DEBUG ((
+          DEBUG_ERROR,
+          "%a failed to update page table for %llx of length %llx with attributes 0 - %r\n",
+          __func__,
+          Ranges[Index].BaseAddress,
+          Ranges[Index].Length,
+          RangeStatus
+          ));
+        ASSERT_EFI_ERROR (RangeStatus);
+      }
+    }
+  }
+}
+
+/**
+  Collect the GCD pieces of a UEFI image range and the attributes to set on
+  them. The collected pieces are set once Ranges is full.
+
+  @param[in]      BaseAddress        Specified start address
+  @param[in]      Length             Specified length
+  @param[in]      Attributes         Specified attributes
+  @param[in, out] Ranges             The pieces collected so far, with room
+                                     for IMAGE_MEMORY_RANGE_BATCH_SIZE entries
+  @param[in, out] RangeCount         Number of entries in Ranges
+**/
+STATIC
+VOID
+CollectUefiImageMemoryRanges (
+  IN     UINT64                  BaseAddress,
+  IN     UINT64                  Length,
+  IN     UINT64                  Attributes,
+  IN OUT GCD_MEMORY_SPACE_RANGE  *Ranges,
+  IN OUT UINTN                   *RangeCount
   )
 {
   EFI_STATUS                       Status;
@@ -219,7 +300,7 @@ SetUefiImageMemoryAttributes (
         Status
         ));
       ASSERT_EFI_ERROR (Status);
-      return;
+      break;
     }
 
     DescEnd = Descriptor.BaseAddress + Descriptor.Length;
@@ -260,44 +341,14 @@ SetUefiImageMemoryAttributes (
       }
     }
 
-    // Call into the GCD to update the attributes there. It will call into the CPU Arch protocol to update the
-    // page table attributes
-    Status = CoreSetMemorySpaceAttributes (
-               CurrentAddress,
-               CurrentLength,
-               FinalAttributes
-               );
-
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        DEBUG_ERROR,
-        "%a failed on %llx of length %llx with attributes %llx - %r\n",
-        __func__,
-        CurrentAddress,
-        CurrentLength,
-        FinalAttributes,
-        Status
-        ));
-      ASSERT_EFI_ERROR (Status);
-    }
-
-    if (((FinalAttributes & (EFI_MEMORY_ATTRIBUTE_MASK | EFI_CACHE_ATTRIBUTE_MASK)) == 0) && (gCpu != NULL)) {
-      // if the passed hardware attributes are 0, CoreSetMemorySpaceAttributes() will not call into the CPU Arch protocol
-      // to set the attributes, so we need to do it manually here. This can be the case when we are unprotecting an
-      // image if no caching attributes are set. If gCpu has not been populated yet, we'll still have updated the GCD
-      // descriptor and we should sync the attributes with the CPU Arch protocol when it is available.
-      Status = gCpu->SetMemoryAttributes (gCpu, CurrentAddress, CurrentLength, 0);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR,
-          "%a failed to update page table for %llx of length %llx with attributes 0 - %r\n",
-          __func__,
-          CurrentAddress,
-          CurrentLength,
-          Status
-          ));
-        ASSERT_EFI_ERROR (Status);
-      }
+    // collect the pieces of the range, and set their attributes in the GCD and the page tables together
+    Ranges[*RangeCount].BaseAddress = CurrentAddress;
+    Ranges[*RangeCount].Length      = CurrentLength;
+    Ranges[*RangeCount].Attributes  = FinalAttributes;
+    (*RangeCount)++;
+    if (*RangeCount == IMAGE_MEMORY_RANGE_BATCH_SIZE) {
+      SetUefiImageMemoryRanges (Ranges, *RangeCount);
+      *RangeCount = 0;
     }
 
     // we may have started in the middle of a descriptor, so we need to move to the beginning of the next descriptor,
@@ -306,6 +357,28 @@ SetUefiImageMemoryAttributes (
   }
 }
 
+/**
+  Set UEFI image memory attributes.
+
+  @param[in]  BaseAddress            Specified start address
+  @param[in]  Length                 Specified length
+  @param[in]  Attributes             Specified attributes
+**/
+VOID
+SetUefiImageMemoryAttributes (
+  IN UINT64  BaseAddress,
+  IN UINT64  Length,
+  IN UINT64  Attributes
+  )
+{
+  GCD_MEMORY_SPACE_RANGE  Ranges[IMAGE_MEMORY_RANGE_BATCH_SIZE];
+  UINTN                   RangeCount;
+
+  RangeCount = 0;
+  CollectUefiImageMemoryRanges (BaseAddress, Length, Attributes, Ranges, &RangeCount);
+  SetUefiImageMemoryRanges (Ranges, RangeCount);
+}
+
 /**
   Set UEFI image protection attributes.
 
@@ -322,8 +395,11 @@ SetUefiImageProtectionAttributes (
   LIST_ENTRY                            *ImageRecordCodeSectionList;
   UINT64                                CurrentBase;
   UINT64                                ImageEnd;
+  GCD_MEMORY_SPACE_RANGE                Ranges[IMAGE_MEMORY_RANGE_BATCH_SIZE];
+  UINTN                                 RangeCount;
 
   ImageRecordCodeSectionList = &ImageRecord->CodeSegmentList;
+  RangeCount                 = 0;
 
   CurrentBase = ImageRecord->ImageBase;
   ImageEnd    = ImageRecord->ImageBase + ImageRecord->ImageSize;
@@ -344,20 +420,24 @@ SetUefiImageProtectionAttributes (
       //
       // DATA
       //
-      SetUefiImageMemoryAttributes (
+      CollectUefiImageMemoryRanges (
         CurrentBase,
         ImageRecordCodeSection->CodeSegmentBase - CurrentBase,
-        EFI_MEMORY_XP
+        EFI_MEMORY_XP,
+        Ranges,
+        &RangeCount
         );
     }
 
     //
     // CODE
     //
-    SetUefiImageMemoryAttributes (
+    CollectUefiImageMemoryRanges (
       ImageRecordCodeSection->CodeSegmentBase,
       ImageRecordCodeSection->CodeSegmentSize,
-      EFI_MEMORY_RO
+      EFI_MEMORY_RO,
+      Ranges,
+      &RangeCount
       );
     CurrentBase = ImageRecordCodeSection->CodeSegmentBase + ImageRecordCodeSection->CodeSegmentSize;
   }
@@ -370,13 +450,20 @@ SetUefiImageProtectionAttributes (
     //
     // DATA
     //
-    SetUefiImageMemoryAttributes (
+    CollectUefiImageMemoryRanges (
       CurrentBase,
       ImageEnd - CurrentBase,
-      EFI_MEMORY_XP
+      EFI_MEMORY_XP,
+      Ranges,
+      &RangeCount
       );
   }
 
+  //
+  // Set the attributes of all the sections together
+  //
+  SetUefiImageMemoryRanges (Ranges, RangeCount);
+
   return;
 }
 
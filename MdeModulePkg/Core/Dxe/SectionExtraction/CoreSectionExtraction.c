@@ -27,6 +27,10 @@
   3) A support protocol is not found, and the data is not available to be read
      without it.  This results in EFI_PROTOCOL_ERROR.
 
+  If PcdDxeCoreParallelSectionExtraction is set, the blocks of a multi-block
+  LZMA section are decoded on the APs when that section is extracted. All the
+  other encapsulation sections are extracted on the BSP.
+
 Copyright (c) 2006 - 2018, Intel Corporation. All rights reserved.<BR>
 SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -92,6 +96,40 @@ typedef struct {
   VOID                        *Registration;
 } RPN_EVENT_CONTEXT;
 
+//
+// The blocks of one multi-block section, decoded by the BSP and the APs. The
+// BSP validates every block and allocates all the buffers before the APs are
+// started, so the APs only run the block decode handler.
+//
+typedef struct {
+  CONST UINT8                              *Source;
+  CONST UINT32                             *Offsets;
+  UINT32                                   BlockSize;
+  UINT32                                   BlockCount;
+  UINT32                                   DecodedSize;
+  EXTRACT_GUIDED_SECTION_DECODE_HANDLER    DecodeHandler;
+  UINT8                                    *OutputBuffer;
+  UINT8                                    *ScratchBuffers;
+  UINT32                                   ScratchSize;
+  UINT32                                   WorkerCount;
+  volatile UINT32                          NextWorker;
+  volatile UINT32                          NextBlock;
+  volatile UINT32                          DecodedBlocks;
+  volatile UINT32                          Failed;
+} CORE_MULTI_BLOCK_EXTRACT_JOB;
+
+//
+// Largest lc + lp of an LZMA block decoded on an AP. The probability tables
+// for larger values do not fit in the 64KB LZMA scratch buffer, and the
+// decoder ASSERTs instead of failing when its scratch buffer runs out.
+//
+#define CORE_AP_LZMA_MAX_LC_LP  4
+
+//
+// An LZMA stream starts with a properties byte and the 64-bit decoded size.
+//
+#define CORE_LZMA_HEADER_SIZE  13
+
 /**
   The ExtractSection() function processes the input section and
   allocates a buffer from the pool in which it returns the section
@@ -640,6 +678,304 @@ CreateGuidedExtractionRpnEvent (
                                 );
 }
 
+/**
+  Decode the blocks of a multi-block section. This runs on the APs and on the
+  BSP. Each processor takes a scratch buffer, then decodes blocks until none
+  are left.
+
+  @param  Buffer                 The CORE_MULTI_BLOCK_EXTRACT_JOB to work on.
+
+**/
+VOID
+EFIAPI
+CoreDecodeBlocksProcedure (
+  IN OUT VOID  *Buffer
+  )
+{
+  CORE_MULTI_BLOCK_EXTRACT_JOB  *Job;
+  UINT32                        Worker;
+  UINT32                        Block;
+  UINT32                        BlockDecodedSize;
+  VOID                          *ScratchBuffer;
+  VOID                          *BlockBuffer;
+  UINT32                        AuthenticationStatus;
+  RETURN_STATUS                 Status;
+
+  Job    = (CORE_MULTI_BLOCK_EXTRACT_JOB *)Buffer;
+  Worker = InterlockedIncrement (&Job->NextWorker) - 1;
+  if (Worker >= Job->WorkerCount) {
+    return;
+  }
+
+  ScratchBuffer = Job->ScratchBuffers + Worker * Job->ScratchSize;
+  while (Job->Failed == 0) {
+    Block = InterlockedIncrement (&Job->NextBlock) - 1;
+    if (Block >= Job->BlockCount) {
+      break;
+    }
+
+    if (Block == Job->BlockCount - 1) {
+      BlockDecodedSize = Job->DecodedSize - Block * Job->BlockSize;
+    } else {
+      BlockDecodedSize = Job->BlockSize;
+    }
+
+    BlockBuffer = Job->OutputBuffer + Block * Job->BlockSize;
+    Status      = Job->DecodeHandler (
+                         Job->Source + Job->Offsets[Block],
+                         &BlockBuffer,
+                         ScratchBuffer,
+                         &AuthenticationStatus
+                         );
+    if (RETURN_ERROR (Status) || (AuthenticationStatus != 0)) {
+      Job->Failed = 1;
+      break;
+    }
+
+    if (BlockBuffer != Job->OutputBuffer + Block * Job->BlockSize) {
+      CopyMem (Job->OutputBuffer + Block * Job->BlockSize, BlockBuffer, BlockDecodedSize);
+    }
+
+    InterlockedIncrement (&Job->DecodedBlocks);
+  }
+}
+
+/**
+  Extract a multi-block LZMA GUIDed section, decoding its blocks in parallel
+  on the BSP and the APs.
+
+  This is only attempted if PcdDxeCoreParallelSectionExtraction is set, the
+  MP services protocol is available and the section has at least two blocks.
+  Each block must be an LZMA GUIDed section. Anything else is left to the
+  regular extraction on the BSP.
+
+  @param  GuidedHeader           The multi-block GUIDed section.
+  @param  OutputBuffer           Returns the allocated buffer holding the
+                                 decoded section.
+  @param  OutputSize             Returns the size of OutputBuffer.
+  @param  AuthenticationStatus   Returns the authentication status of the
+                                 extraction.
+
+  @retval EFI_SUCCESS            The section was decoded into OutputBuffer.
+  @retval EFI_UNSUPPORTED        The section can not be decoded on the APs.
+                                 Nothing was allocated.
+  @retval EFI_OUT_OF_RESOURCES   A buffer could not be allocated.
+  @retval EFI_ABORTED            A block failed to decode.
+
+**/
+EFI_STATUS
+CoreExtractMultiBlockSectionOnAps (
+  IN  EFI_GUID_DEFINED_SECTION  *GuidedHeader,
+  OUT VOID                      **OutputBuffer,
+  OUT UINTN                     *OutputSize,
+  OUT UINT32                    *AuthenticationStatus
+  )
+{
+  EFI_STATUS                               Status;
+  EFI_MP_SERVICES_PROTOCOL                 *MpServices;
+  UINTN                                    NumberOfProcessors;
+  UINTN                                    NumberOfEnabledProcessors;
+  CONST LZMA_MULTI_BLOCK_HEADER            *Header;
+  UINTN                                    SourceSize;
+  UINTN                                    IndexEnd;
+  UINT32                                   Block;
+  UINT32                                   BlockStart;
+  UINT32                                   BlockEnd;
+  UINT32                                   BlockDecodedSize;
+  UINT32                                   BlockScratchSize;
+  UINT16                                   BlockAttributes;
+  UINT32                                   BlockSectionSize;
+  UINT32                                   BlockDataOffset;
+  EFI_GUID_DEFINED_SECTION                 *BlockHeader;
+  EFI_GUID                                 *BlockGuid;
+  EXTRACT_GUIDED_SECTION_GET_INFO_HANDLER  GetInfoHandler;
+  UINT8                                    LzmaProperties;
+  CORE_MULTI_BLOCK_EXTRACT_JOB             Job;
+  EFI_EVENT                                WaitEvent;
+
+  if (!FeaturePcdGet (PcdDxeCoreParallelSectionExtraction)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = CoreLocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (
+                         MpServices,
+                         &NumberOfProcessors,
+                         &NumberOfEnabledProcessors
+                         );
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (&Job, sizeof (Job));
+  if (IS_SECTION2 (GuidedHeader)) {
+    Job.Source = (UINT8 *)GuidedHeader + ((EFI_GUID_DEFINED_SECTION2 *)GuidedHeader)->DataOffset;
+    SourceSize = SECTION2_SIZE (GuidedHeader) - ((EFI_GUID_DEFINED_SECTION2 *)GuidedHeader)->DataOffset;
+  } else {
+    Job.Source = (UINT8 *)GuidedHeader + GuidedHeader->DataOffset;
+    SourceSize = SECTION_SIZE (GuidedHeader) - GuidedHeader->DataOffset;
+  }
+
+  //
+  // Validate the multi-block header and every block on the BSP.
+  //
+  Header = (CONST LZMA_MULTI_BLOCK_HEADER *)Job.Source;
+  if ((SourceSize < sizeof (LZMA_MULTI_BLOCK_HEADER)) ||
+      (Header->Signature != LZMA_MULTI_BLOCK_SIGNATURE) ||
+      (Header->BlockCount < 2) ||
+      (Header->BlockSize == 0) ||
+      (Header->DecodedSize == 0) ||
+      ((UINT64)Header->BlockSize * (Header->BlockCount - 1) >= Header->DecodedSize) ||
+      ((UINT64)Header->BlockSize * Header->BlockCount < Header->DecodedSize))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  IndexEnd = sizeof (LZMA_MULTI_BLOCK_HEADER) + ((UINTN)Header->BlockCount + 1) * sizeof (UINT32);
+  if (IndexEnd > SourceSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Job.Offsets     = (CONST UINT32 *)(Header + 1);
+  Job.BlockSize   = Header->BlockSize;
+  Job.BlockCount  = Header->BlockCount;
+  Job.DecodedSize = Header->DecodedSize;
+
+  Status = ExtractGuidedSectionGetHandlers (&gLzmaCustomDecompressGuid, &GetInfoHandler, &Job.DecodeHandler);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  for (Block = 0; Block < Job.BlockCount; Block++) {
+    BlockStart = Job.Offsets[Block];
+    BlockEnd   = Job.Offsets[Block + 1];
+    if ((BlockStart < IndexEnd) || (BlockEnd > SourceSize) || (BlockEnd < BlockStart) ||
+        (BlockEnd - BlockStart < sizeof (EFI_GUID_DEFINED_SECTION2)) ||
+        ((((UINTN)Job.Source + BlockStart) & 0x3) != 0))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    BlockHeader = (EFI_GUID_DEFINED_SECTION *)(Job.Source + BlockStart);
+    if (BlockHeader->CommonHeader.Type != EFI_SECTION_GUID_DEFINED) {
+      return EFI_UNSUPPORTED;
+    }
+
+    if (IS_SECTION2 (BlockHeader)) {
+      BlockGuid        = &((EFI_GUID_DEFINED_SECTION2 *)BlockHeader)->SectionDefinitionGuid;
+      BlockSectionSize = SECTION2_SIZE (BlockHeader);
+      BlockDataOffset  = ((EFI_GUID_DEFINED_SECTION2 *)BlockHeader)->DataOffset;
+    } else {
+      BlockGuid        = &BlockHeader->SectionDefinitionGuid;
+      BlockSectionSize = SECTION_SIZE (BlockHeader);
+      BlockDataOffset  = BlockHeader->DataOffset;
+    }
+
+    if ((BlockSectionSize > BlockEnd - BlockStart) || (BlockDataOffset < sizeof (EFI_GUID_DEFINED_SECTION)) ||
+        (BlockDataOffset > BlockSectionSize) || (BlockSectionSize - BlockDataOffset < CORE_LZMA_HEADER_SIZE))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    //
+    // Every block is an LZMA section, decoded on the APs by the LZMA handler
+    // of ExtractGuidedSectionLib. That handler only works on the caller's
+    // buffers: it does not call boot services, allocate memory or read PCDs,
+    // and its ASSERTs only check arguments validated here.
+    //
+    if (!CompareGuid (BlockGuid, &gLzmaCustomDecompressGuid)) {
+      return EFI_UNSUPPORTED;
+    }
+
+    LzmaProperties = *((UINT8 *)BlockHeader + BlockDataOffset);
+    if ((LzmaProperties >= 9 * 5 * 5) ||
+        ((LzmaProperties % 9) + (LzmaProperties / 9) % 5 > CORE_AP_LZMA_MAX_LC_LP))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    Status = GetInfoHandler (BlockHeader, &BlockDecodedSize, &BlockScratchSize, &BlockAttributes);
+    if (EFI_ERROR (Status) ||
+        (BlockDecodedSize != MIN (Job.BlockSize, Job.DecodedSize - Block * Job.BlockSize)))
+    {
+      return EFI_UNSUPPORTED;
+    }
+
+    Job.ScratchSize = MAX (Job.ScratchSize, ALIGN_VALUE (BlockScratchSize, sizeof (UINT64)));
+  }
+
+  //
+  // Allocate the output buffer and a scratch buffer per processor.
+  //
+  Job.WorkerCount  = (UINT32)MIN (NumberOfEnabledProcessors, Job.BlockCount);
+  Job.OutputBuffer = AllocatePool (Job.DecodedSize);
+  if (Job.OutputBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Job.ScratchSize != 0) {
+    Job.ScratchBuffers = AllocatePool ((UINTN)Job.ScratchSize * Job.WorkerCount);
+    if (Job.ScratchBuffers == NULL) {
+      CoreFreePool (Job.OutputBuffer);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  //
+  // Start the APs without blocking, so that the BSP decodes blocks alongside
+  // them, then wait for WaitEvent: the APs still use Job until it is signaled.
+  // MP services signal WaitEvent from a TPL_NOTIFY timer, so from TPL_NOTIFY up
+  // StartupAllAPs() blocks instead, and the BSP decodes the blocks left over.
+  // Either way, if the APs can not be started, the BSP decodes every block.
+  //
+  WaitEvent = NULL;
+  if (gEfiCurrentTpl < TPL_NOTIFY) {
+    Status = CoreCreateEvent (0, TPL_NOTIFY, NULL, NULL, &WaitEvent);
+    if (EFI_ERROR (Status)) {
+      WaitEvent = NULL;
+    }
+  }
+
+  Status = MpServices->StartupAllAPs (
+                         MpServices,
+                         CoreDecodeBlocksProcedure,
+                         FALSE,
+                         WaitEvent,
+                         0,
+                         &Job,
+                         NULL
+                         );
+  CoreDecodeBlocksProcedure (&Job);
+
+  if (WaitEvent != NULL) {
+    if (!EFI_ERROR (Status)) {
+      while (CoreCheckEvent (WaitEvent) == EFI_NOT_READY) {
+        CpuPause ();
+      }
+    }
+
+    CoreCloseEvent (WaitEvent);
+  }
+
+  if (Job.ScratchBuffers != NULL) {
+    CoreFreePool (Job.ScratchBuffers);
+  }
+
+  if ((Job.Failed != 0) || (Job.DecodedBlocks != Job.BlockCount)) {
+    CoreFreePool (Job.OutputBuffer);
+    return EFI_ABORTED;
+  }
+
+  *OutputBuffer         = Job.OutputBuffer;
+  *OutputSize           = Job.DecodedSize;
+  *AuthenticationStatus = 0;
+  return EFI_SUCCESS;
+}
+
 /**
   Worker function.  Constructor for new child nodes.
 
@@ -840,16 +1176,36 @@ CreateChildNode (
 
       if (VerifyGuidedSectionGuid (Node->EncapsulationGuid, &GuidedExtraction)) {
         //
-        // NewStreamBuffer is always allocated by ExtractSection... No caller
-        // allocation here.
+        // Multi-block LZMA sections handled by DxeCore's own ExtractGuidedSectionLib
+        // handlers may be decoded on the APs. Everything else, and any multi-block
+        // section that can not be decoded there, is extracted on the BSP.
         //
-        Status = GuidedExtraction->ExtractSection (
-                                     GuidedExtraction,
-                                     GuidedHeader,
-                                     &NewStreamBuffer,
-                                     &NewStreamBufferSize,
-                                     &AuthenticationStatus
-                                     );
+        Status = EFI_UNSUPPORTED;
+        if ((GuidedExtraction == &mCustomGuidedSectionExtractionProtocol) &&
+            CompareGuid (Node->EncapsulationGuid, &gLzmaMultiBlockCustomDecompressGuid))
+        {
+          Status = CoreExtractMultiBlockSectionOnAps (
+                     GuidedHeader,
+                     &NewStreamBuffer,
+                     &NewStreamBufferSize,
+                     &AuthenticationStatus
+                     );
+        }
+
+        if (EFI_ERROR (Status)) {
+          //
+          // NewStreamBuffer is always allocated by ExtractSection... No caller
+          // allocation here.
+          //
+          Status = GuidedExtraction->ExtractSection (
+                                       GuidedExtraction,
+                                       GuidedHeader,
+                                       &NewStreamBuffer,
+                                       &NewStreamBufferSize,
+                                       &AuthenticationStatus
+                                       );
+        }
+
         if (EFI_ERROR (Status)) {
           CoreFreePool (*ChildNode);
           return EFI_PROTOCOL_ERROR;
@@ -27,6 +27,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/MemoryTypeInformation.h>
 #include <Guid/MemoryAllocationHob.h>
 #include <Guid/FirmwareFileSystem2.h>
+#include <Guid/FvFileIndex.h>
 
 #include <Library/DebugLib.h>
 #include <Library/PeimEntryPoint.h>
@@ -70,6 +71,23 @@ InstallIplPermanentMemoryPpis (
   IN VOID                       *Ppi
   );
 
+/**
+   Searches the FV file index HOB of a firmware volume for the DxeCore.
+
+   @param  VolumeHandle     The firmware volume to search.
+   @param  FileHandle       Returns the DxeCore file handle when found.
+
+   @retval EFI_SUCCESS      The volume is indexed and contains DxeCore.
+   @retval EFI_NOT_FOUND    The volume is indexed and does not contain DxeCore.
+   @retval EFI_UNSUPPORTED  The volume has no file index.
+
+**/
+EFI_STATUS
+DxeIplFindDxeCoreInFileIndex (
+  IN  EFI_PEI_FV_HANDLE    VolumeHandle,
+  OUT EFI_PEI_FILE_HANDLE  *FileHandle
+  );
+
 /**
    Searches DxeCore in all firmware Volumes and loads the first
    instance that contains DxeCore.
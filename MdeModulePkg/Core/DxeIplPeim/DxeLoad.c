@@ -458,6 +458,60 @@ DxeLoadCore (
   return EFI_OUT_OF_RESOURCES;
 }
 
+/**
+   Searches the FV file index HOB of a firmware volume for the DxeCore.
+
+   @param  VolumeHandle     The firmware volume to search.
+   @param  FileHandle       Returns the DxeCore file handle when found.
+
+   @retval EFI_SUCCESS      The volume is indexed and contains DxeCore.
+   @retval EFI_NOT_FOUND    The volume is indexed and does not contain DxeCore.
+   @retval EFI_UNSUPPORTED  The volume has no file index.
+
+**/
+EFI_STATUS
+DxeIplFindDxeCoreInFileIndex (
+  IN  EFI_PEI_FV_HANDLE    VolumeHandle,
+  OUT EFI_PEI_FILE_HANDLE  *FileHandle
+  )
+{
+  EFI_STATUS           Status;
+  EFI_FV_INFO          VolumeInfo;
+  EFI_HOB_GUID_TYPE    *GuidHob;
+  EDKII_FV_FILE_INDEX  *FileIndex;
+  UINT32               *FileOffset;
+  EFI_FFS_FILE_HEADER  *FfsHeader;
+  UINT32               Index;
+
+  Status = PeiServicesFfsGetVolumeInfo (VolumeHandle, &VolumeInfo);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  GuidHob = GetFirstGuidHob (&gEdkiiFvFileIndexGuid);
+  while (GuidHob != NULL) {
+    FileIndex = GET_GUID_HOB_DATA (GuidHob);
+    if ((FileIndex->FvBase == (EFI_PHYSICAL_ADDRESS)(UINTN)VolumeInfo.FvStart) &&
+        (FileIndex->FvLength == VolumeInfo.FvSize))
+    {
+      FileOffset = EDKII_FV_FILE_INDEX_OFFSETS (FileIndex);
+      for (Index = 0; Index < FileIndex->FileCount; Index++) {
+        FfsHeader = (EFI_FFS_FILE_HEADER *)((UINTN)FileIndex->FvBase + FileOffset[Index]);
+        if (FfsHeader->Type == EFI_FV_FILETYPE_DXE_CORE) {
+          *FileHandle = (EFI_PEI_FILE_HANDLE)FfsHeader;
+          return EFI_SUCCESS;
+        }
+      }
+
+      return EFI_NOT_FOUND;
+    }
+
+    GuidHob = GetNextGuidHob (&gEdkiiFvFileIndexGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
 /**
    Searches DxeCore in all firmware Volumes and loads the first
    instance that contains DxeCore.
@@ -492,10 +546,18 @@ DxeIplFindDxeCore (
     }
 
     //
-    // Find the DxeCore file type from the beginning in this firmware volume.
+    // Volumes extracted by the PEI Core come with an index of their already
+    // validated files, use it rather than walking the volume again.
     //
     FileHandle = NULL;
-    Status     = PeiServicesFfsFindNextFile (EFI_FV_FILETYPE_DXE_CORE, VolumeHandle, &FileHandle);
+    Status     = DxeIplFindDxeCoreInFileIndex (VolumeHandle, &FileHandle);
+    if (Status == EFI_UNSUPPORTED) {
+      //
+      // Find the DxeCore file type from the beginning in this firmware volume.
+      //
+      Status = PeiServicesFfsFindNextFile (EFI_FV_FILETYPE_DXE_CORE, VolumeHandle, &FileHandle);
+    }
+
     if (!EFI_ERROR (Status)) {
       //
       // Find DxeCore FileHandle in this volume, then we skip other firmware volume and
@@ -1388,6 +1388,156 @@ GetFvUsedSize (
   return FALSE;
 }
 
+/**
+  Check that a walk of a firmware volume with FindFileEx() stopped at the end
+  of its files, and not at a file with a bad checksum. FindFileEx() returns
+  EFI_NOT_FOUND in both cases.
+
+  @param FvHeader   Pointer to the firmware volume image.
+  @param LastFile   The last file FindFileEx() returned.
+
+  @retval TRUE      No file follows LastFile, other than pad and deleted files.
+  @retval FALSE     A file follows LastFile that FindFileEx() did not return.
+
+**/
+STATIC
+BOOLEAN
+IsFvFileWalkComplete (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FvHeader,
+  IN EFI_FFS_FILE_HEADER         *LastFile
+  )
+{
+  EFI_FFS_FILE_HEADER  *FfsFileHeader;
+  UINT8                ErasePolarity;
+  UINT32               FileLength;
+  UINT64               FileOffset;
+
+  ErasePolarity = (UINT8)(((FvHeader->Attributes & EFI_FVB2_ERASE_POLARITY) != 0) ? 1 : 0);
+  FileLength    = IS_FFS_FILE2 (LastFile) ? FFS_FILE2_SIZE (LastFile) : FFS_FILE_SIZE (LastFile);
+  FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)LastFile + GET_OCCUPIED_SIZE (FileLength, 8));
+  FileOffset    = (UINTN)FfsFileHeader - (UINTN)FvHeader;
+
+  while (FileOffset < FvHeader->FvLength - sizeof (EFI_FFS_FILE_HEADER)) {
+    switch (GetFileState (ErasePolarity, FfsFileHeader)) {
+      case EFI_FILE_HEADER_CONSTRUCTION:
+      case EFI_FILE_HEADER_INVALID:
+        FileLength = IS_FFS_FILE2 (FfsFileHeader) ? sizeof (EFI_FFS_FILE_HEADER2) : sizeof (EFI_FFS_FILE_HEADER);
+        break;
+
+      case EFI_FILE_DATA_VALID:
+      case EFI_FILE_MARKED_FOR_UPDATE:
+        //
+        // FindFileEx() walks over valid pad files only.
+        //
+        if ((FfsFileHeader->Type != EFI_FV_FILETYPE_FFS_PAD) || (CalculateHeaderChecksum (FfsFileHeader) != 0)) {
+          return FALSE;
+        }
+
+        FileLength = GET_OCCUPIED_SIZE (IS_FFS_FILE2 (FfsFileHeader) ? FFS_FILE2_SIZE (FfsFileHeader) : FFS_FILE_SIZE (FfsFileHeader), 8);
+        break;
+
+      case EFI_FILE_DELETED:
+        FileLength = GET_OCCUPIED_SIZE (IS_FFS_FILE2 (FfsFileHeader) ? FFS_FILE2_SIZE (FfsFileHeader) : FFS_FILE_SIZE (FfsFileHeader), 8);
+        break;
+
+      default:
+        return TRUE;
+    }
+
+    FileOffset   += FileLength;
+    FfsFileHeader = (EFI_FFS_FILE_HEADER *)((UINT8 *)FfsFileHeader + FileLength);
+  }
+
+  return TRUE;
+}
+
+/**
+  Publish an EDKII_FV_FILE_INDEX HOB describing the files of a firmware volume
+  image found in an FV file, so that DxeIpl and the DXE Core can use the list
+  of already validated files instead of walking the volume again.
+
+  @param FvHeader   Pointer to the firmware volume image, at its final address.
+
+**/
+VOID
+BuildFvFileIndexHob (
+  IN EFI_FIRMWARE_VOLUME_HEADER  *FvHeader
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PEI_FILE_HANDLE  FileHandle;
+  EFI_PEI_FILE_HANDLE  LastFileHandle;
+  EDKII_FV_FILE_INDEX  *FileIndex;
+  UINT32               *FileOffset;
+  UINT32               FileCount;
+  UINTN                IndexSize;
+
+  if (!CompareGuid (&FvHeader->FileSystemGuid, &gEfiFirmwareFileSystem2Guid) &&
+      !CompareGuid (&FvHeader->FileSystemGuid, &gEfiFirmwareFileSystem3Guid))
+  {
+    return;
+  }
+
+  PERF_INMODULE_BEGIN ("FvFileIndex");
+
+  //
+  // FindFileEx() verifies the header and data checksums of every file it
+  // walks over, so count first and then record the offsets.
+  //
+  FileCount      = 0;
+  FileHandle     = NULL;
+  LastFileHandle = NULL;
+  while (!EFI_ERROR (FindFileEx ((EFI_PEI_FV_HANDLE)FvHeader, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL))) {
+    LastFileHandle = FileHandle;
+    FileCount++;
+  }
+
+  //
+  // An index that stops at a corrupt file would hide the files after it; do
+  // not publish one, so that DxeIpl and the DXE Core walk the volume.
+  //
+  if (LastFileHandle == NULL) {
+    PERF_INMODULE_END ("FvFileIndex");
+    return;
+  }
+
+  if (!IsFvFileWalkComplete (FvHeader, (EFI_FFS_FILE_HEADER *)LastFileHandle)) {
+    DEBUG ((DEBUG_ERROR, "%a: FV at %p has a file with a bad checksum after file %d, not indexed\n", __func__, FvHeader, FileCount));
+    PERF_INMODULE_END ("FvFileIndex");
+    return;
+  }
+
+  IndexSize = sizeof (EDKII_FV_FILE_INDEX) + FileCount * sizeof (UINT32);
+  if (IndexSize > 0xFFF8 - sizeof (EFI_HOB_GUID_TYPE)) {
+    DEBUG ((DEBUG_INFO, "%a: FV at %p has too many files (%d) to index\n", __func__, FvHeader, FileCount));
+    PERF_INMODULE_END ("FvFileIndex");
+    return;
+  }
+
+  FileIndex = BuildGuidHob (&gEdkiiFvFileIndexGuid, IndexSize);
+  if (FileIndex == NULL) {
+    PERF_INMODULE_END ("FvFileIndex");
+    return;
+  }
+
+  FileIndex->FvBase    = (EFI_PHYSICAL_ADDRESS)(UINTN)FvHeader;
+  FileIndex->FvLength  = FvHeader->FvLength;
+  FileIndex->FileCount = 0;
+  FileOffset           = EDKII_FV_FILE_INDEX_OFFSETS (FileIndex);
+
+  FileHandle = NULL;
+  while (FileIndex->FileCount < FileCount) {
+    Status = FindFileEx ((EFI_PEI_FV_HANDLE)FvHeader, NULL, EFI_FV_FILETYPE_ALL, &FileHandle, NULL);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    FileOffset[FileIndex->FileCount++] = (UINT32)((UINTN)FileHandle - (UINTN)FvHeader);
+  }
+
+  PERF_INMODULE_END ("FvFileIndex");
+}
+
 /**
   Get FV image(s) from the FV type file, then install FV INFO(2) PPI, Build FV(2, 3) HOB.
 
@@ -1599,6 +1749,8 @@ ProcessFvFile (
       &FileInfo.FileName
       );
 
+    BuildFvFileIndexHob (FvHeader);
+
     Index++;
   } while (TRUE);
 
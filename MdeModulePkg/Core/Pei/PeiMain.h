@@ -51,6 +51,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AprioriFileName.h>
 #include <Guid/MigratedFvInfo.h>
 #include <Guid/DelayedDispatch.h>
+#include <Guid/FvFileIndex.h>
 
 ///
 /// It is an FFS type extension used for PeiFindFileEx. It indicates current
@@ -74,6 +75,11 @@ typedef union {
 #define CALLBACK_NOTIFY_GROWTH_STEP  32
 #define DISPATCH_NOTIFY_GROWTH_STEP  8
 
+///
+/// Minimum number of PPI hash index entries per PEI_PPI_LIST_POINTERS
+///
+#define PPI_INDEX_SIZE_FACTOR  4
+
 typedef struct {
   UINTN                    CurrentCount;
   UINTN                    MaxCount;
@@ -82,6 +88,15 @@ typedef struct {
   /// MaxCount number of entries.
   ///
   PEI_PPI_LIST_POINTERS    *PpiPtrs;
+  ///
+  /// Open addressing hash table over PpiPtrs by PPI GUID, HashSize entries, at
+  /// least PPI_INDEX_SIZE_FACTOR times MaxCount.
+  /// Each non-zero entry is the index of a PPI in PpiPtrs plus 1. As it holds
+  /// no pointers, only the table itself moves when memory is migrated. NULL if
+  /// the PPIs are searched linearly.
+  ///
+  UINT16                   *HashTable;
+  UINTN                    HashSize;
 } PEI_PPI_LIST;
 
 typedef struct {
@@ -708,6 +723,55 @@ ProcessNotify (
   IN INTN               NotifyStopIndex
   );
 
+/**
+  Rebuilds the hash index of the PPI list, sized for MaxCount PPIs.
+
+  If the index cannot be allocated, it is dropped and the PPIs are searched
+  linearly.
+
+  @param PpiList            The PPI list.
+
+**/
+VOID
+RebuildPpiIndex (
+  IN OUT PEI_PPI_LIST  *PpiList
+  );
+
+/**
+  Adds the PPIs installed from LastCount on to the hash index of the PPI list.
+
+  @param PpiList            The PPI list.
+  @param LastCount          The number of PPIs before the installation.
+
+**/
+VOID
+UpdatePpiIndex (
+  IN OUT PEI_PPI_LIST  *PpiList,
+  IN     UINTN         LastCount
+  );
+
+/**
+  Finds the next PPI with a GUID in a range of the PPI list.
+
+  @param PpiList            The PPI list.
+  @param Guid               The GUID of the PPI.
+  @param Previous           The index of the previous PPI found, or the index
+                            before the start of the range.
+  @param Stop               The index after the end of the range, which must
+                            not be greater than the number of PPIs.
+
+  @return The smallest index greater than Previous and smaller than Stop of a
+          PPI with the GUID, or -1 if there is none.
+
+**/
+INTN
+FindNextPpi (
+  IN PEI_PPI_LIST    *PpiList,
+  IN CONST EFI_GUID  *Guid,
+  IN INTN            Previous,
+  IN INTN            Stop
+  );
+
 /**
   Process PpiList from SEC phase.
 
@@ -224,6 +224,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs + OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.HashTable != NULL) {
+          OldCoreData->PpiData.PpiList.HashTable = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.HashTable + OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs + OldCoreData->HeapOffset);
         }
@@ -259,6 +263,10 @@ PeiCore (
           OldCoreData->PpiData.PpiList.PpiPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.PpiList.PpiPtrs - OldCoreData->HeapOffset);
         }
 
+        if (OldCoreData->PpiData.PpiList.HashTable != NULL) {
+          OldCoreData->PpiData.PpiList.HashTable = (UINT16 *)((UINT8 *)OldCoreData->PpiData.PpiList.HashTable - OldCoreData->HeapOffset);
+        }
+
         if (OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
           OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs = (PEI_PPI_LIST_POINTERS *)((UINT8 *)OldCoreData->PpiData.CallbackNotifyList.NotifyPtrs - OldCoreData->HeapOffset);
         }
@@ -166,7 +166,8 @@ ConvertPpiPointers (
   UINT8  Index;
 
   //
-  // Convert normal PPIs.
+  // Convert normal PPIs. The hash index of the PPI list holds indexes in
+  // PpiPtrs and is keyed by GUID values, which don't change here.
   //
   for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
     ConvertSinglePpiPointer (
@@ -528,6 +529,8 @@ InternalPeiInstallPpi (
     PpiList++;
   }
 
+  UpdatePpiIndex (PpiListPointer, LastCount);
+
   //
   // Process any callback level notifies for newly installed PPIs.
   //
@@ -595,6 +598,7 @@ PeiReInstallPpi (
 {
   PEI_CORE_INSTANCE  *PrivateData;
   UINTN              Index;
+  BOOLEAN            SameGuid;
 
   if ((OldPpi == NULL) || (NewPpi == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -624,7 +628,11 @@ PeiReInstallPpi (
   // Replace the old PPI with the new one.
   //
   DEBUG ((DEBUG_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
+  SameGuid                                        = CompareGuid (OldPpi->Guid, NewPpi->Guid);
   PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi = (EFI_PEI_PPI_DESCRIPTOR *)NewPpi;
+  if (!SameGuid) {
+    RebuildPpiIndex (&PrivateData->PpiData.PpiList);
+  }
 
   //
   // Process any callback level notifies for the newly installed PPI.
@@ -668,8 +676,7 @@ PeiLocatePpi (
   )
 {
   PEI_CORE_INSTANCE       *PrivateData;
-  UINTN                   Index;
-  EFI_GUID                *CheckGuid;
+  INTN                    Index;
   EFI_PEI_PPI_DESCRIPTOR  *TempPtr;
 
   PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
@@ -677,37 +684,29 @@ PeiLocatePpi (
   //
   // Search the data base for the matching instance of the GUIDed PPI.
   //
-  for (Index = 0; Index < PrivateData->PpiData.PpiList.CurrentCount; Index++) {
-    TempPtr   = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
-    CheckGuid = TempPtr->Guid;
-
-    //
-    // Don't use CompareGuid function here for performance reasons.
-    // Instead we compare the GUID as INT32 at a time and branch
-    // on the first failed comparison.
-    //
-    if ((((INT32 *)Guid)[0] == ((INT32 *)CheckGuid)[0]) &&
-        (((INT32 *)Guid)[1] == ((INT32 *)CheckGuid)[1]) &&
-        (((INT32 *)Guid)[2] == ((INT32 *)CheckGuid)[2]) &&
-        (((INT32 *)Guid)[3] == ((INT32 *)CheckGuid)[3]))
-    {
-      if (Instance == 0) {
-        if (PpiDescriptor != NULL) {
-          *PpiDescriptor = TempPtr;
-        }
-
-        if (Ppi != NULL) {
-          *Ppi = TempPtr->Ppi;
-        }
+  Index = -1;
+  do {
+    Index = FindNextPpi (
+              &PrivateData->PpiData.PpiList,
+              Guid,
+              Index,
+              (INTN)PrivateData->PpiData.PpiList.CurrentCount
+              );
+    if (Index < 0) {
+      return EFI_NOT_FOUND;
+    }
+  } while (Instance-- > 0);
 
-        return EFI_SUCCESS;
-      }
+  TempPtr = PrivateData->PpiData.PpiList.PpiPtrs[Index].Ppi;
+  if (PpiDescriptor != NULL) {
+    *PpiDescriptor = TempPtr;
+  }
 
-      Instance--;
-    }
+  if (Ppi != NULL) {
+    *Ppi = TempPtr->Ppi;
   }
 
-  return EFI_NOT_FOUND;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -981,30 +980,26 @@ ProcessNotify (
 
     CheckGuid = NotifyDescriptor->Guid;
 
-    for (Index2 = InstallStartIndex; Index2 < InstallStopIndex; Index2++) {
+    //
+    // The matching PPIs are found in install order. A notification function
+    // may install PPIs, so the PPI list is looked up again for each of them.
+    //
+    for (Index2 = FindNextPpi (&PrivateData->PpiData.PpiList, CheckGuid, InstallStartIndex - 1, InstallStopIndex);
+         Index2 >= 0;
+         Index2 = FindNextPpi (&PrivateData->PpiData.PpiList, CheckGuid, Index2, InstallStopIndex))
+    {
       SearchGuid = PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi->Guid;
-      //
-      // Don't use CompareGuid function here for performance reasons.
-      // Instead we compare the GUID as INT32 at a time and branch
-      // on the first failed comparison.
-      //
-      if ((((INT32 *)SearchGuid)[0] == ((INT32 *)CheckGuid)[0]) &&
-          (((INT32 *)SearchGuid)[1] == ((INT32 *)CheckGuid)[1]) &&
-          (((INT32 *)SearchGuid)[2] == ((INT32 *)CheckGuid)[2]) &&
-          (((INT32 *)SearchGuid)[3] == ((INT32 *)CheckGuid)[3]))
-      {
-        DEBUG ((
-          DEBUG_INFO,
-          "Notify: PPI Guid: %g, Peim notify entry point: %p\n",
-          SearchGuid,
-          NotifyDescriptor->Notify
-          ));
-        NotifyDescriptor->Notify (
-                            (EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
-                            NotifyDescriptor,
-                            (PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi)->Ppi
-                            );
-      }
+      DEBUG ((
+        DEBUG_INFO,
+        "Notify: PPI Guid: %g, Peim notify entry point: %p\n",
+        SearchGuid,
+        NotifyDescriptor->Notify
+        ));
+      NotifyDescriptor->Notify (
+                          (EFI_PEI_SERVICES **)GetPeiServicesTablePointer (),
+                          NotifyDescriptor,
+                          (PrivateData->PpiData.PpiList.PpiPtrs[Index2].Ppi)->Ppi
+                          );
     }
   }
 }
@@ -0,0 +1,232 @@
+/** @file
+  Hash index of the PEI PPI database by PPI GUID.
+
+  The index is an open addressing hash table with linear probing, at most a
+  quarter full. It holds indexes in PpiPtrs rather than pointers, so it stays valid when
+  the PPI descriptors are migrated from temporary memory, and is only rebuilt
+  when PpiPtrs grows or a reinstallation changes the GUID of a PPI.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PeiMain.h"
+
+///
+/// Ranges up to this number of PPIs are searched linearly, which is faster
+/// than probing the hash table for the few PPIs installed at once.
+///
+#define PPI_INDEX_LINEAR_SEARCH_LIMIT  8
+
+/**
+  Compares two GUIDs.
+
+  Don't use CompareGuid function here for performance reasons.
+  Instead we compare the GUID as INT32 at a time and branch
+  on the first failed comparison.
+
+  @param Guid1              The first GUID.
+  @param Guid2              The second GUID.
+
+  @retval TRUE              The GUIDs are equal.
+  @retval FALSE             The GUIDs are different.
+
+**/
+BOOLEAN
+IsSamePpiGuid (
+  IN CONST EFI_GUID  *Guid1,
+  IN CONST EFI_GUID  *Guid2
+  )
+{
+  return (BOOLEAN)((((INT32 *)Guid1)[0] == ((INT32 *)Guid2)[0]) &&
+                   (((INT32 *)Guid1)[1] == ((INT32 *)Guid2)[1]) &&
+                   (((INT32 *)Guid1)[2] == ((INT32 *)Guid2)[2]) &&
+                   (((INT32 *)Guid1)[3] == ((INT32 *)Guid2)[3]));
+}
+
+/**
+  Returns the first bucket of the probe sequence of a PPI GUID.
+
+  @param PpiList            The PPI list.
+  @param Guid               The GUID of the PPI.
+
+  @return The bucket index.
+
+**/
+UINTN
+GetPpiIndexBucket (
+  IN PEI_PPI_LIST    *PpiList,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  //
+  // This is the fold of CoreGetGuidHashIndex() in the DXE core, which hashes
+  // protocol GUIDs. The PEI core is a separate module that cannot call DXE
+  // core functions, and no library class hashes GUIDs, so the fold is kept
+  // here. It reads the GUID 32 bits at a time, as IsSamePpiGuid() does.
+  //
+  Hash  = ((UINT32 *)Guid)[0];
+  Hash ^= ((UINT32 *)Guid)[1];
+  Hash ^= ((UINT32 *)Guid)[2];
+  Hash ^= ((UINT32 *)Guid)[3];
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (PpiList->HashSize - 1);
+}
+
+/**
+  Adds a PPI to the hash index of the PPI list.
+
+  @param PpiList            The PPI list.
+  @param Index              The index of the PPI in PpiPtrs.
+
+**/
+VOID
+InsertPpiIndex (
+  IN OUT PEI_PPI_LIST  *PpiList,
+  IN     UINTN         Index
+  )
+{
+  UINTN  Bucket;
+
+  Bucket = GetPpiIndexBucket (PpiList, PpiList->PpiPtrs[Index].Ppi->Guid);
+  while (PpiList->HashTable[Bucket] != 0) {
+    Bucket = (Bucket + 1) & (PpiList->HashSize - 1);
+  }
+
+  PpiList->HashTable[Bucket] = (UINT16)(Index + 1);
+}
+
+/**
+  Rebuilds the hash index of the PPI list, sized for MaxCount PPIs.
+
+  If the index cannot be allocated, it is dropped and the PPIs are searched
+  linearly.
+
+  @param PpiList            The PPI list.
+
+**/
+VOID
+RebuildPpiIndex (
+  IN OUT PEI_PPI_LIST  *PpiList
+  )
+{
+  UINTN  HashSize;
+  UINTN  Index;
+
+  if (PpiList->MaxCount >= MAX_UINT16) {
+    PpiList->HashTable = NULL;
+    PpiList->HashSize  = 0;
+    return;
+  }
+
+  //
+  // Keep the probe sequences short, as a lookup walks all of its own. Like
+  // PpiPtrs, a table that is too small is left behind in the heap, which PEI
+  // cannot free.
+  //
+  HashSize = GetPowerOfTwo32 ((UINT32)PpiList->MaxCount) * PPI_INDEX_SIZE_FACTOR;
+  if (HashSize < PpiList->MaxCount * PPI_INDEX_SIZE_FACTOR) {
+    HashSize *= 2;
+  }
+
+  if ((PpiList->HashTable == NULL) || (PpiList->HashSize < HashSize)) {
+    PpiList->HashTable = AllocatePool (HashSize * sizeof (UINT16));
+    if (PpiList->HashTable == NULL) {
+      PpiList->HashSize = 0;
+      return;
+    }
+
+    PpiList->HashSize = HashSize;
+  }
+
+  ZeroMem (PpiList->HashTable, PpiList->HashSize * sizeof (UINT16));
+  for (Index = 0; Index < PpiList->CurrentCount; Index++) {
+    InsertPpiIndex (PpiList, Index);
+  }
+}
+
+/**
+  Adds the PPIs installed from LastCount on to the hash index of the PPI list.
+
+  @param PpiList            The PPI list.
+  @param LastCount          The number of PPIs before the installation.
+
+**/
+VOID
+UpdatePpiIndex (
+  IN OUT PEI_PPI_LIST  *PpiList,
+  IN     UINTN         LastCount
+  )
+{
+  UINTN  Index;
+
+  if ((PpiList->HashTable == NULL) || (PpiList->HashSize < PpiList->MaxCount * PPI_INDEX_SIZE_FACTOR)) {
+    RebuildPpiIndex (PpiList);
+    return;
+  }
+
+  for (Index = LastCount; Index < PpiList->CurrentCount; Index++) {
+    InsertPpiIndex (PpiList, Index);
+  }
+}
+
+/**
+  Finds the next PPI with a GUID in a range of the PPI list.
+
+  @param PpiList            The PPI list.
+  @param Guid               The GUID of the PPI.
+  @param Previous           The index of the previous PPI found, or the index
+                            before the start of the range.
+  @param Stop               The index after the end of the range, which must
+                            not be greater than the number of PPIs.
+
+  @return The smallest index greater than Previous and smaller than Stop of a
+          PPI with the GUID, or -1 if there is none.
+
+**/
+INTN
+FindNextPpi (
+  IN PEI_PPI_LIST    *PpiList,
+  IN CONST EFI_GUID  *Guid,
+  IN INTN            Previous,
+  IN INTN            Stop
+  )
+{
+  INTN   Index;
+  INTN   Found;
+  UINTN  Bucket;
+
+  if ((PpiList->HashTable == NULL) || (Stop - Previous <= PPI_INDEX_LINEAR_SEARCH_LIMIT)) {
+    for (Index = Previous + 1; Index < Stop; Index++) {
+      if (IsSamePpiGuid (PpiList->PpiPtrs[Index].Ppi->Guid, Guid)) {
+        return Index;
+      }
+    }
+
+    return -1;
+  }
+
+  //
+  // All the instances of the GUID are in its probe sequence, which ends at
+  // the first empty bucket. Take the earliest one installed after Previous.
+  //
+  Found = Stop;
+  for (Bucket = GetPpiIndexBucket (PpiList, Guid);
+       PpiList->HashTable[Bucket] != 0;
+       Bucket = (Bucket + 1) & (PpiList->HashSize - 1))
+  {
+    Index = (INTN)PpiList->HashTable[Bucket] - 1;
+    if ((Index > Previous) && (Index < Found) &&
+        IsSamePpiGuid (PpiList->PpiPtrs[Index].Ppi->Guid, Guid))
+    {
+      Found = Index;
+    }
+  }
+
+  return (Found < Stop) ? Found : -1;
+}
@@ -0,0 +1,103 @@
+/** @file
+  Minimal PEI core services for the host-based test of the PPI database.
+
+  Ppi.c and PpiIndex.c are built as is. The services they call from the rest
+  of the PEI core are replaced here: the PEI services table pointer is a plain
+  global, and there is no PEI core image or SEC HOB data to migrate.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../../PeiMain.h"
+
+EFI_PEI_SERVICES  mTestPeiServices;
+EFI_PEI_SERVICES  *mTestPeiServicesPointer = &mTestPeiServices;
+
+/**
+  Returns the PEI services table pointer passed to the notification functions.
+
+  @return The pointer to the PEI services table pointer.
+
+**/
+CONST EFI_PEI_SERVICES **
+EFIAPI
+GetPeiServicesTablePointer (
+  VOID
+  )
+{
+  return (CONST EFI_PEI_SERVICES **)&mTestPeiServicesPointer;
+}
+
+/**
+  There is no SEC HOB data.
+
+  @param PeiServices        The PEI services table.
+  @param SecHobList         The SEC HOB list.
+
+  @retval EFI_UNSUPPORTED   Always.
+
+**/
+EFI_STATUS
+PeiInstallSecHobData (
+  IN CONST EFI_PEI_SERVICES  **PeiServices,
+  IN EFI_HOB_GENERIC_HEADER  *SecHobList
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  There is no PEI core image.
+
+  @param FileHandle         The handle of the file.
+  @param Pe32Data           The PE32 image, not set.
+
+  @retval EFI_NOT_FOUND     Always.
+
+**/
+EFI_STATUS
+PeiGetPe32Data (
+  IN     EFI_PEI_FILE_HANDLE  FileHandle,
+  OUT    VOID                 **Pe32Data
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+/**
+  There is no PEI core image.
+
+  @param Pe32Data           The PE32 image.
+  @param EntryPoint         The entry point, not set.
+
+  @retval RETURN_UNSUPPORTED  Always.
+
+**/
+RETURN_STATUS
+EFIAPI
+PeCoffLoaderGetEntryPoint (
+  IN  VOID  *Pe32Data,
+  OUT VOID  **EntryPoint
+  )
+{
+  return RETURN_UNSUPPORTED;
+}
+
+/**
+  The PEI core is not started from SEC.
+
+  @param SecCoreData        The SEC hand-off data.
+  @param PpiList            The PPIs installed by SEC.
+
+**/
+VOID
+EFIAPI
+_ModuleEntryPoint (
+  IN CONST  EFI_SEC_PEI_HAND_OFF    *SecCoreData,
+  IN CONST  EFI_PEI_PPI_DESCRIPTOR  *PpiList
+  )
+{
+  ASSERT (FALSE);
+}
@@ -0,0 +1,1029 @@
+/** @file
+  This is a host-based unit test for the hash index of the PEI PPI database.
+
+  PPIs are installed, reinstalled and notified through the PPI services of
+  Ppi.c, over a PEI_CORE_INSTANCE of the test. Every lookup made through the
+  index is checked against a linear walk of the PPI list, while PpiPtrs grows
+  by PPI_GROWTH_STEP entries, after a reinstallation that changes the GUID of
+  a PPI, after the PPI database is moved to other memory and when there is no
+  index. The notification tests check that ProcessNotify() only calls each
+  notification function for the PPIs of the range it is given.
+
+  The benchmark compares the cycles per PeiLocatePpi() call through the index
+  with the cycles per linear walk of the PPI list, for 16 to 1024 installed
+  PPIs. It depends on the host, so it only runs when the test is started with
+  the --benchmark argument.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "../../PeiMain.h"
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "PEI Core PPI Index Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_PPI_COUNT   1024
+#define TEST_GUID_COUNT  64
+
+#define BENCHMARK_LOOKUPS  100000
+
+extern EFI_PEI_SERVICES  mTestPeiServices;
+
+///
+/// Set when the test is started with the --benchmark argument.
+///
+BOOLEAN  mRunBenchmark = FALSE;
+
+EFI_GUID                *mTestGuids;
+EFI_PEI_PPI_DESCRIPTOR  *mTestDescriptors;
+UINTN                   mTestDescriptorCount;
+UINTN                   *mTestNotifyCounts;
+BOOLEAN                 mTestInstallOnNotify;
+PEI_CORE_INSTANCE       mTestPrivateData;
+PEI_PPI_LIST            *mTestPpiList = &mTestPrivateData.PpiData.PpiList;
+CONST EFI_PEI_SERVICES  **mTestPs     = (CONST EFI_PEI_SERVICES **)&mTestPrivateData.Ps;
+
+/**
+  Returns a pseudo-random number.
+
+  @param[in, out] Seed    The state of the generator.
+
+  @return The next number of the sequence.
+
+**/
+UINT32
+TestRandom (
+  IN OUT UINT32  *Seed
+  )
+{
+  *Seed = *Seed * 1103515245 + 12345;
+  return *Seed >> 8;
+}
+
+/**
+  Creates an empty PPI database, the descriptors to install and their GUIDs.
+
+  @param[in] GuidCount    The number of distinct GUIDs.
+
+  @retval TRUE            The PPI database was created.
+  @retval FALSE           Out of memory.
+
+**/
+BOOLEAN
+CreatePpiList (
+  IN UINTN  GuidCount
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  ZeroMem (&mTestPrivateData, sizeof (mTestPrivateData));
+  mTestPrivateData.Signature = PEI_CORE_HANDLE_SIGNATURE;
+  mTestPrivateData.Ps        = &mTestPeiServices;
+
+  mTestDescriptorCount = 0;
+  mTestInstallOnNotify = FALSE;
+  mTestGuids           = AllocatePool (GuidCount * sizeof (EFI_GUID));
+  mTestDescriptors     = AllocateZeroPool (TEST_PPI_COUNT * sizeof (EFI_PEI_PPI_DESCRIPTOR));
+  mTestNotifyCounts    = AllocateZeroPool (TEST_PPI_COUNT * sizeof (UINTN));
+  if ((mTestGuids == NULL) || (mTestDescriptors == NULL) || (mTestNotifyCounts == NULL)) {
+    return FALSE;
+  }
+
+  Seed = 11;
+  for (Index = 0; Index < GuidCount * sizeof (EFI_GUID) / sizeof (UINT32); Index++) {
+    ((UINT32 *)mTestGuids)[Index] = TestRandom (&Seed) ^ (TestRandom (&Seed) << 16);
+  }
+
+  return TRUE;
+}
+
+/**
+  Frees the PPI database.
+
+**/
+VOID
+FreePpiList (
+  VOID
+  )
+{
+  if (mTestPpiList->PpiPtrs != NULL) {
+    FreePool (mTestPpiList->PpiPtrs);
+  }
+
+  if (mTestPpiList->HashTable != NULL) {
+    FreePool (mTestPpiList->HashTable);
+  }
+
+  if (mTestPrivateData.PpiData.CallbackNotifyList.NotifyPtrs != NULL) {
+    FreePool (mTestPrivateData.PpiData.CallbackNotifyList.NotifyPtrs);
+  }
+
+  if (mTestPrivateData.PpiData.DispatchNotifyList.NotifyPtrs != NULL) {
+    FreePool (mTestPrivateData.PpiData.DispatchNotifyList.NotifyPtrs);
+  }
+
+  FreePool (mTestGuids);
+  FreePool (mTestDescriptors);
+  FreePool (mTestNotifyCounts);
+  ZeroMem (&mTestPrivateData, sizeof (mTestPrivateData));
+}
+
+/**
+  Returns a new PPI descriptor, which is its own PPI.
+
+  @param[in] GuidIndex    The index in mTestGuids of the GUID of the PPI.
+
+  @return The descriptor.
+
+**/
+EFI_PEI_PPI_DESCRIPTOR *
+TestNewPpi (
+  IN UINTN  GuidIndex
+  )
+{
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+
+  ASSERT (mTestDescriptorCount < TEST_PPI_COUNT);
+  Descriptor        = &mTestDescriptors[mTestDescriptorCount++];
+  Descriptor->Flags = EFI_PEI_PPI_DESCRIPTOR_PPI;
+  Descriptor->Guid  = &mTestGuids[GuidIndex];
+  Descriptor->Ppi   = Descriptor;
+  return Descriptor;
+}
+
+/**
+  Installs PPIs as a single PPI list, through PeiInstallPpi().
+
+  @param[in] Guids        The index in mTestGuids of the GUID of each PPI.
+  @param[in] Count        The number of PPIs to install.
+
+  @return The status returned by PeiInstallPpi().
+
+**/
+EFI_STATUS
+TestInstallPpis (
+  IN UINTN  *Guids,
+  IN UINTN  Count
+  )
+{
+  EFI_PEI_PPI_DESCRIPTOR  *First;
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+  UINTN                   Index;
+
+  First      = NULL;
+  Descriptor = NULL;
+  for (Index = 0; Index < Count; Index++) {
+    Descriptor = TestNewPpi (Guids[Index]);
+    if (First == NULL) {
+      First = Descriptor;
+    }
+  }
+
+  Descriptor->Flags |= EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+  return PeiInstallPpi (mTestPs, First);
+}
+
+/**
+  Finds the next PPI with a GUID in a range of the PPI list, linearly.
+
+  @param[in] Guid         The GUID of the PPI.
+  @param[in] Previous     The index before the first one to check.
+  @param[in] Stop         The index after the last one to check.
+
+  @return The index of the PPI, or -1 if there is none.
+
+**/
+INTN
+LinearFindNextPpi (
+  IN CONST EFI_GUID  *Guid,
+  IN INTN            Previous,
+  IN INTN            Stop
+  )
+{
+  INTN  Index;
+
+  for (Index = Previous + 1; Index < Stop; Index++) {
+    if (CompareGuid (mTestPpiList->PpiPtrs[Index].Ppi->Guid, Guid)) {
+      return Index;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  Checks that all the instances of every GUID are found by FindNextPpi() and
+  PeiLocatePpi() as through a linear walk, in the whole PPI list and in a
+  random range of it.
+
+  @param[in, out] Seed    The state of the random generator.
+
+  @retval TRUE            The lookups match the PPI list.
+  @retval FALSE           A lookup did not match.
+
+**/
+BOOLEAN
+CheckPpiLookups (
+  IN OUT UINT32  *Seed
+  )
+{
+  UINTN                   GuidIndex;
+  UINTN                   Instance;
+  INTN                    Index;
+  INTN                    Previous;
+  INTN                    Start;
+  INTN                    Stop;
+  EFI_GUID                Guid;
+  EFI_STATUS              Status;
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+
+  for (GuidIndex = 0; GuidIndex < TEST_GUID_COUNT; GuidIndex++) {
+    CopyMem (&Guid, &mTestGuids[GuidIndex], sizeof (Guid));
+    Stop     = (INTN)mTestPpiList->CurrentCount;
+    Previous = -1;
+    Instance = 0;
+    do {
+      Index = FindNextPpi (mTestPpiList, &Guid, Previous, Stop);
+      if (Index != LinearFindNextPpi (&Guid, Previous, Stop)) {
+        return FALSE;
+      }
+
+      Status = PeiLocatePpi (mTestPs, &Guid, Instance, &Descriptor, NULL);
+      if ((Index < 0) ? (Status != EFI_NOT_FOUND) : (EFI_ERROR (Status) || (Descriptor != mTestPpiList->PpiPtrs[Index].Ppi))) {
+        return FALSE;
+      }
+
+      Previous = Index;
+      Instance++;
+    } while (Index >= 0);
+
+    Start = (INTN)(TestRandom (Seed) % (mTestPpiList->CurrentCount + 1)) - 1;
+    Stop  = Start + 1 + (INTN)(TestRandom (Seed) % (UINTN)((INTN)mTestPpiList->CurrentCount - Start));
+    if (FindNextPpi (mTestPpiList, &Guid, Start, Stop) != LinearFindNextPpi (&Guid, Start, Stop)) {
+      return FALSE;
+    }
+  }
+
+  //
+  // A GUID that was never installed
+  //
+  SetMem (&Guid, sizeof (Guid), 0xA5);
+  return (BOOLEAN)(FindNextPpi (mTestPpiList, &Guid, -1, (INTN)mTestPpiList->CurrentCount) == -1);
+}
+
+/**
+  Checks that the index is sized for MaxCount PPIs, holds every PPI once and
+  that the lookups through it match the PPI list.
+
+  @param[in, out] Seed    The state of the random generator.
+
+  @retval TRUE            The index matches the PPI list.
+  @retval FALSE           The index is missing, too small or does not match.
+
+**/
+BOOLEAN
+CheckPpiIndex (
+  IN OUT UINT32  *Seed
+  )
+{
+  UINTN  Bucket;
+  UINTN  Entries;
+
+  if ((mTestPpiList->HashTable == NULL) ||
+      (mTestPpiList->HashSize < mTestPpiList->MaxCount * PPI_INDEX_SIZE_FACTOR) ||
+      ((mTestPpiList->HashSize & (mTestPpiList->HashSize - 1)) != 0))
+  {
+    return FALSE;
+  }
+
+  Entries = 0;
+  for (Bucket = 0; Bucket < mTestPpiList->HashSize; Bucket++) {
+    if (mTestPpiList->HashTable[Bucket] != 0) {
+      if (mTestPpiList->HashTable[Bucket] > mTestPpiList->CurrentCount) {
+        return FALSE;
+      }
+
+      Entries++;
+    }
+  }
+
+  return (BOOLEAN)((Entries == mTestPpiList->CurrentCount) && CheckPpiLookups (Seed));
+}
+
+/**
+  Notification function that counts the calls for each PPI, and installs
+  another PPI with the same GUID when mTestInstallOnNotify is set.
+
+  @param[in] PeiServices        The PEI services table.
+  @param[in] NotifyDescriptor   The notify descriptor.
+  @param[in] Ppi                The PPI, which is its own descriptor.
+
+  @retval EFI_SUCCESS           Always.
+
+**/
+EFI_STATUS
+EFIAPI
+TestNotify (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  )
+{
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+  EFI_STATUS              Status;
+
+  Descriptor = (EFI_PEI_PPI_DESCRIPTOR *)Ppi;
+  ASSERT (CompareGuid (Descriptor->Guid, NotifyDescriptor->Guid));
+  mTestNotifyCounts[Descriptor - mTestDescriptors]++;
+
+  if (mTestInstallOnNotify) {
+    mTestInstallOnNotify = FALSE;
+    Descriptor           = TestNewPpi (NotifyDescriptor->Guid - mTestGuids);
+    Descriptor->Flags   |= EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+    Status               = PeiInstallPpi (mTestPs, Descriptor);
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Checks that the notification function was called exactly once for each PPI
+  with a GUID among a range of descriptors, and never for the other PPIs, then
+  clears the counts.
+
+  @param[in] GuidIndex    The index in mTestGuids of the GUID notified.
+  @param[in] Start        The first descriptor of the range.
+  @param[in] Stop         The descriptor after the range.
+
+  @retval TRUE            The calls match the range.
+  @retval FALSE           A PPI was not notified, or notified when it should not.
+
+**/
+BOOLEAN
+CheckNotified (
+  IN UINTN  GuidIndex,
+  IN UINTN  Start,
+  IN UINTN  Stop
+  )
+{
+  UINTN    Index;
+  BOOLEAN  Expected;
+  BOOLEAN  Match;
+
+  Match = TRUE;
+  for (Index = 0; Index < mTestDescriptorCount; Index++) {
+    Expected = (BOOLEAN)((Index >= Start) && (Index < Stop) &&
+                         (mTestDescriptors[Index].Guid == &mTestGuids[GuidIndex]));
+    if (mTestNotifyCounts[Index] != (Expected ? 1 : 0)) {
+      Match = FALSE;
+    }
+  }
+
+  ZeroMem (mTestNotifyCounts, TEST_PPI_COUNT * sizeof (UINTN));
+  return Match;
+}
+
+/**
+  Checks that lookups in the index match a linear walk of the PPI list while
+  PPIs are installed in batches, with many instances of each GUID.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexMatchesList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Guids[8];
+  UINTN   Count;
+  UINTN   Index;
+  UINT32  Seed;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  Seed = 5;
+  while (mTestDescriptorCount < TEST_PPI_COUNT - ARRAY_SIZE (Guids)) {
+    Count = 1 + TestRandom (&Seed) % ARRAY_SIZE (Guids);
+    for (Index = 0; Index < Count; Index++) {
+      Guids[Index] = TestRandom (&Seed) % TEST_GUID_COUNT;
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, Count));
+    UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+  }
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the index is resized each time PpiPtrs grows by PPI_GROWTH_STEP
+  entries, including when it grows in the middle of a PPI list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexGrowsWithPpiList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Guids[PPI_GROWTH_STEP + 3];
+  UINTN   Guid;
+  UINTN   Index;
+  UINTN   MaxCount;
+  UINT32  Seed;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  //
+  // One PPI at a time, across three growths of PpiPtrs.
+  //
+  Seed = 7;
+  for (Index = 0; Index <= 3 * PPI_GROWTH_STEP; Index++) {
+    MaxCount = mTestPpiList->MaxCount;
+    Guid     = TestRandom (&Seed) % TEST_GUID_COUNT;
+    UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guid, 1));
+    if (Index == MaxCount) {
+      UT_ASSERT_EQUAL (mTestPpiList->MaxCount, MaxCount + PPI_GROWTH_STEP);
+    } else {
+      UT_ASSERT_EQUAL (mTestPpiList->MaxCount, MaxCount);
+    }
+
+    UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+  }
+
+  UT_ASSERT_EQUAL (mTestPpiList->MaxCount, 4 * PPI_GROWTH_STEP);
+
+  //
+  // A single PPI list that fills PpiPtrs, and grows it before its last PPIs.
+  //
+  MaxCount = mTestPpiList->MaxCount;
+  for (Index = 0; Index < ARRAY_SIZE (Guids); Index++) {
+    Guids[Index] = TestRandom (&Seed) % TEST_GUID_COUNT;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, ARRAY_SIZE (Guids)));
+  UT_ASSERT_EQUAL (mTestPpiList->MaxCount, MaxCount + PPI_GROWTH_STEP);
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that PeiReInstallPpi() rebuilds the index when the new PPI has
+  another GUID, and leaves it as is when the GUID is the same.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReinstallChangesGuid (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                   Guids[40];
+  UINTN                   Index;
+  UINTN                   PpiIndex;
+  UINT32                  Seed;
+  UINT16                  *HashTable;
+  UINT16                  *OldHashTable;
+  EFI_PEI_PPI_DESCRIPTOR  *OldPpi;
+  EFI_PEI_PPI_DESCRIPTOR  *NewPpi;
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  for (Index = 0; Index < ARRAY_SIZE (Guids); Index++) {
+    Guids[Index] = Index % 8;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, ARRAY_SIZE (Guids)));
+
+  //
+  // Replace the third instance of GUID 2 by a PPI with GUID 9, which is not
+  // installed yet.
+  //
+  OldPpi = mTestPpiList->PpiPtrs[18].Ppi;
+  NewPpi = TestNewPpi (9);
+  UT_ASSERT_NOT_EFI_ERROR (PeiReInstallPpi (mTestPs, OldPpi, NewPpi));
+  UT_ASSERT_TRUE (mTestPpiList->PpiPtrs[18].Ppi == NewPpi);
+
+  UT_ASSERT_NOT_EFI_ERROR (PeiLocatePpi (mTestPs, &mTestGuids[9], 0, &Descriptor, NULL));
+  UT_ASSERT_TRUE (Descriptor == NewPpi);
+  UT_ASSERT_STATUS_EQUAL (PeiLocatePpi (mTestPs, &mTestGuids[9], 1, &Descriptor, NULL), EFI_NOT_FOUND);
+  UT_ASSERT_NOT_EFI_ERROR (PeiLocatePpi (mTestPs, &mTestGuids[2], 2, &Descriptor, NULL));
+  UT_ASSERT_TRUE (Descriptor == mTestPpiList->PpiPtrs[26].Ppi);
+  UT_ASSERT_STATUS_EQUAL (PeiLocatePpi (mTestPs, &mTestGuids[2], 4, &Descriptor, NULL), EFI_NOT_FOUND);
+  Seed = 9;
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  //
+  // The same GUID again: the index is not touched.
+  //
+  HashTable = AllocateCopyPool (mTestPpiList->HashSize * sizeof (UINT16), mTestPpiList->HashTable);
+  UT_ASSERT_NOT_NULL (HashTable);
+  OldHashTable = mTestPpiList->HashTable;
+  OldPpi       = NewPpi;
+  NewPpi       = TestNewPpi (9);
+  UT_ASSERT_NOT_EFI_ERROR (PeiReInstallPpi (mTestPs, OldPpi, NewPpi));
+  UT_ASSERT_TRUE (mTestPpiList->HashTable == OldHashTable);
+  UT_ASSERT_MEM_EQUAL (mTestPpiList->HashTable, HashTable, mTestPpiList->HashSize * sizeof (UINT16));
+  UT_ASSERT_NOT_EFI_ERROR (PeiLocatePpi (mTestPs, &mTestGuids[9], 0, &Descriptor, NULL));
+  UT_ASSERT_TRUE (Descriptor == NewPpi);
+  FreePool (HashTable);
+
+  //
+  // A PPI that is no longer installed cannot be reinstalled.
+  //
+  UT_ASSERT_STATUS_EQUAL (PeiReInstallPpi (mTestPs, OldPpi, TestNewPpi (3)), EFI_NOT_FOUND);
+
+  //
+  // Random reinstallations, with a GUID that may or may not change.
+  //
+  for (Index = 0; Index < 16; Index++) {
+    PpiIndex = TestRandom (&Seed) % mTestPpiList->CurrentCount;
+    NewPpi   = TestNewPpi (TestRandom (&Seed) % TEST_GUID_COUNT);
+    UT_ASSERT_NOT_EFI_ERROR (PeiReInstallPpi (mTestPs, mTestPpiList->PpiPtrs[PpiIndex].Ppi, NewPpi));
+    UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+  }
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the index stays valid when the PPI database is moved.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexSurvivesMigration (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                   Guid;
+  UINTN                   Index;
+  UINT32                  Seed;
+  EFI_GUID                *OldGuids;
+  EFI_PEI_PPI_DESCRIPTOR  *OldDescriptors;
+  UINT16                  *OldHashTable;
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  Seed = 9;
+  for (Index = 0; Index < 300; Index++) {
+    Guid = TestRandom (&Seed) % TEST_GUID_COUNT;
+    UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guid, 1));
+  }
+
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  //
+  // Move the descriptors and GUIDs as the PEI core migrates them out of
+  // temporary memory, and the hash table with the heap. The old copies are
+  // poisoned so that any pointer left behind is caught.
+  //
+  OldGuids                = mTestGuids;
+  OldDescriptors          = mTestDescriptors;
+  OldHashTable            = mTestPpiList->HashTable;
+  mTestGuids              = AllocateCopyPool (TEST_GUID_COUNT * sizeof (EFI_GUID), OldGuids);
+  mTestDescriptors        = AllocateCopyPool (TEST_PPI_COUNT * sizeof (EFI_PEI_PPI_DESCRIPTOR), OldDescriptors);
+  mTestPpiList->HashTable = AllocateCopyPool (mTestPpiList->HashSize * sizeof (UINT16), OldHashTable);
+  UT_ASSERT_NOT_NULL (mTestGuids);
+  UT_ASSERT_NOT_NULL (mTestDescriptors);
+  UT_ASSERT_NOT_NULL (mTestPpiList->HashTable);
+
+  for (Index = 0; Index < mTestPpiList->CurrentCount; Index++) {
+    Descriptor                       = &mTestDescriptors[mTestPpiList->PpiPtrs[Index].Ppi - OldDescriptors];
+    Descriptor->Guid                 = &mTestGuids[Descriptor->Guid - OldGuids];
+    Descriptor->Ppi                  = Descriptor;
+    mTestPpiList->PpiPtrs[Index].Ppi = Descriptor;
+  }
+
+  SetMem (OldGuids, TEST_GUID_COUNT * sizeof (EFI_GUID), 0xAF);
+  SetMem (OldDescriptors, TEST_PPI_COUNT * sizeof (EFI_PEI_PPI_DESCRIPTOR), 0xAF);
+  SetMem (OldHashTable, mTestPpiList->HashSize * sizeof (UINT16), 0xAF);
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  FreePool (OldGuids);
+  FreePool (OldDescriptors);
+  FreePool (OldHashTable);
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that the PPIs are searched linearly when there is no index, and that
+  the next installation builds it again.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LookupsFallBackWithoutIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                   Guids[100];
+  UINTN                   Guid;
+  UINTN                   Index;
+  UINTN                   MaxCount;
+  UINT32                  Seed;
+  UINT16                  *HashTable;
+  EFI_PEI_PPI_DESCRIPTOR  *NewPpi;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  Seed = 13;
+  for (Index = 0; Index < ARRAY_SIZE (Guids); Index++) {
+    Guids[Index] = TestRandom (&Seed) % TEST_GUID_COUNT;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, ARRAY_SIZE (Guids)));
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  //
+  // The host MemoryAllocationLib cannot be made to fail, so leave the index
+  // as RebuildPpiIndex() does when AllocatePool() returns NULL.
+  //
+  FreePool (mTestPpiList->HashTable);
+  mTestPpiList->HashTable = NULL;
+  mTestPpiList->HashSize  = 0;
+  UT_ASSERT_TRUE (CheckPpiLookups (&Seed));
+
+  Guid = 0;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guid, 1));
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  //
+  // A PPI list too large for the UINT16 entries of the index: a reinstall
+  // that changes a GUID drops the index instead of rebuilding it.
+  //
+  HashTable              = mTestPpiList->HashTable;
+  MaxCount               = mTestPpiList->MaxCount;
+  mTestPpiList->MaxCount = MAX_UINT16;
+  NewPpi                 = TestNewPpi ((Guids[50] + 1) % TEST_GUID_COUNT);
+  UT_ASSERT_NOT_EFI_ERROR (PeiReInstallPpi (mTestPs, mTestPpiList->PpiPtrs[50].Ppi, NewPpi));
+  UT_ASSERT_TRUE (mTestPpiList->HashTable == NULL);
+  UT_ASSERT_EQUAL (mTestPpiList->HashSize, 0);
+  UT_ASSERT_TRUE (CheckPpiLookups (&Seed));
+  FreePool (HashTable);
+
+  mTestPpiList->MaxCount = MaxCount;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guid, 1));
+  UT_ASSERT_TRUE (CheckPpiIndex (&Seed));
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks that callback and dispatch notifications are called once for each
+  matching PPI in the range passed to ProcessNotify(): all the PPIs when the
+  notification is registered, the new PPIs on an installation, the new PPI on
+  a reinstallation, and only the PPIs installed since the last dispatch.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NotifyRanges (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                      Guids[20];
+  UINTN                      Guid;
+  UINTN                      Index;
+  UINTN                      Start;
+  EFI_PEI_NOTIFY_DESCRIPTOR  Notify1;
+  EFI_PEI_NOTIFY_DESCRIPTOR  Notify3;
+  EFI_PEI_NOTIFY_DESCRIPTOR  Dispatch0;
+  EFI_PEI_PPI_DESCRIPTOR     *NewPpi;
+
+  UT_ASSERT_TRUE (CreatePpiList (TEST_GUID_COUNT));
+
+  for (Index = 0; Index < ARRAY_SIZE (Guids); Index++) {
+    Guids[Index] = Index % 4;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, ARRAY_SIZE (Guids)));
+
+  //
+  // Registering a callback notifies all the PPIs installed before.
+  //
+  Notify1.Flags  = EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+  Notify1.Guid   = &mTestGuids[1];
+  Notify1.Notify = TestNotify;
+  UT_ASSERT_NOT_EFI_ERROR (PeiNotifyPpi (mTestPs, &Notify1));
+  UT_ASSERT_TRUE (CheckNotified (1, 0, mTestDescriptorCount));
+
+  //
+  // An installation only notifies its own PPIs, whether the range is searched
+  // through the index or linearly.
+  //
+  Start = mTestDescriptorCount;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, 12));
+  UT_ASSERT_TRUE (CheckNotified (1, Start, mTestDescriptorCount));
+
+  Start = mTestDescriptorCount;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guids[1], 3));
+  UT_ASSERT_TRUE (CheckNotified (1, Start, mTestDescriptorCount));
+
+  Guid = 2;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Guid, 1));
+  UT_ASSERT_TRUE (CheckNotified (1, 0, 0));
+
+  //
+  // A reinstallation that changes the GUID to the notified one only notifies
+  // the new PPI.
+  //
+  NewPpi = TestNewPpi (1);
+  UT_ASSERT_NOT_EFI_ERROR (PeiReInstallPpi (mTestPs, mTestPpiList->PpiPtrs[2].Ppi, NewPpi));
+  UT_ASSERT_TRUE (CheckNotified (1, NewPpi - mTestDescriptors, mTestDescriptorCount));
+
+  //
+  // A notification function that installs a PPI with the same GUID: the new
+  // PPI is notified by its own installation, not a second time by the range
+  // being notified.
+  //
+  mTestInstallOnNotify = TRUE;
+  Notify3.Flags        = EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+  Notify3.Guid         = &mTestGuids[3];
+  Notify3.Notify       = TestNotify;
+  UT_ASSERT_NOT_EFI_ERROR (PeiNotifyPpi (mTestPs, &Notify3));
+  UT_ASSERT_FALSE (mTestInstallOnNotify);
+  UT_ASSERT_TRUE (CheckNotified (3, 0, mTestDescriptorCount));
+
+  //
+  // A dispatch notification is called for the PPIs installed before the last
+  // dispatch, then only for those installed since.
+  //
+  mTestPpiList->LastDispatchedCount = mTestPpiList->CurrentCount;
+  Dispatch0.Flags                   = EFI_PEI_PPI_DESCRIPTOR_NOTIFY_DISPATCH | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST;
+  Dispatch0.Guid                    = &mTestGuids[0];
+  Dispatch0.Notify                  = TestNotify;
+  UT_ASSERT_NOT_EFI_ERROR (PeiNotifyPpi (mTestPs, &Dispatch0));
+  UT_ASSERT_TRUE (CheckNotified (0, 0, 0));
+  ProcessDispatchNotifyList (&mTestPrivateData);
+  UT_ASSERT_TRUE (CheckNotified (0, 0, mTestDescriptorCount));
+
+  ZeroMem (Guids, sizeof (Guids));
+  Start = mTestDescriptorCount;
+  UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (Guids, 9));
+  UT_ASSERT_TRUE (CheckNotified (0, 0, 0));
+  ProcessDispatchNotifyList (&mTestPrivateData);
+  UT_ASSERT_TRUE (CheckNotified (0, Start, mTestDescriptorCount));
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports the cycles per PeiLocatePpi() call through the index and per
+  linear walk of the PPI list, as more PPIs are installed.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PpiIndexBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN      PpiCounts[] = { 16, 64, 256, TEST_PPI_COUNT };
+  UINTN                   Pass;
+  UINTN                   Index;
+  UINTN                   Installed;
+  UINT32                  Seed;
+  UINT64                  Start;
+  UINT64                  IndexCycles;
+  UINT64                  LinearCycles;
+  EFI_STATUS              Status;
+  EFI_PEI_PPI_DESCRIPTOR  *Descriptor;
+  INTN                    Found;
+
+  //
+  // Each PPI has a GUID of its own.
+  //
+  UT_ASSERT_TRUE (CreatePpiList (TEST_PPI_COUNT));
+
+  Installed = 0;
+  for (Pass = 0; Pass < ARRAY_SIZE (PpiCounts); Pass++) {
+    for ( ; Installed < PpiCounts[Pass]; Installed++) {
+      UT_ASSERT_NOT_EFI_ERROR (TestInstallPpis (&Installed, 1));
+    }
+
+    Seed  = 13;
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      Status = PeiLocatePpi (mTestPs, &mTestGuids[TestRandom (&Seed) % Installed], 0, &Descriptor, NULL);
+      ASSERT_EFI_ERROR (Status);
+    }
+
+    IndexCycles = AsmReadTsc () - Start;
+
+    Seed  = 13;
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      Found = LinearFindNextPpi (&mTestGuids[TestRandom (&Seed) % Installed], -1, (INTN)mTestPpiList->CurrentCount);
+      ASSERT (Found >= 0);
+    }
+
+    LinearCycles = AsmReadTsc () - Start;
+
+    UT_LOG_INFO (
+      "%Lu PPIs: %Lu cycles per indexed PeiLocatePpi(), %Lu per linear walk\n",
+      (UINT64)Installed,
+      DivU64x32 (IndexCycles, BENCHMARK_LOOKUPS),
+      DivU64x32 (LinearCycles, BENCHMARK_LOOKUPS)
+      );
+  }
+
+  FreePpiList ();
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Main entry point to the unit test.
+
+  @retval EFI_SUCCESS       The unit test ran.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+  UNIT_TEST_SUITE_HANDLE      NotifyTests;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "PPI Index Tests", "PpiIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the PPI index tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (IndexTests, "Index lookups match the PPI list", "IndexMatchesList", IndexMatchesList, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Index grows with the PPI list", "IndexGrowsWithPpiList", IndexGrowsWithPpiList, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Reinstallation that changes the GUID", "ReinstallChangesGuid", ReinstallChangesGuid, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Index survives migration", "Migration", IndexSurvivesMigration, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Lookups fall back to a linear walk without index", "LookupsFallBackWithoutIndex", LookupsFallBackWithoutIndex, NULL, NULL, NULL);
+
+  Status = CreateUnitTestSuite (&NotifyTests, Framework, "PPI Notify Tests", "PpiNotify", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the PPI notify tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (NotifyTests, "Notifications cover the PPIs of their range", "NotifyRanges", NotifyRanges, NULL, NULL, NULL);
+
+  if (mRunBenchmark) {
+    Status = CreateUnitTestSuite (&BenchmarkTests, Framework, "PPI Index Benchmark", "PpiIndexBenchmark", NULL, NULL);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the PPI index benchmark.\n"));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto EXIT;
+    }
+
+    AddTestCase (BenchmarkTests, "Cycles per PeiLocatePpi() vs. PPI count", "Benchmark", PpiIndexBenchmark, NULL, NULL, NULL);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  The benchmark only runs with the --benchmark argument.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  mRunBenchmark = (BOOLEAN)((Argc > 1) && (AsciiStrCmp (Argv[1], "--benchmark") == 0));
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,47 @@
+/** @file
+  FV file index HOB.
+
+  The PEI Core publishes one of these HOBs for every firmware volume it
+  extracts from an encapsulation section. The index lists the FFS files of the
+  volume, which the PEI Core validated while building it, so that later
+  consumers of the same in-memory volume (DxeIpl, the DXE Core) can use the
+  list instead of walking and re-validating the volume again. No HOB is
+  published for a volume holding a file with a bad checksum.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_FV_FILE_INDEX_H_
+#define EDKII_FV_FILE_INDEX_H_
+
+#define EDKII_FV_FILE_INDEX_GUID \
+  { 0xb322e521, 0xb362, 0x4511, { 0xb5, 0x0a, 0xa5, 0x06, 0xfb, 0xa9, 0xb4, 0x3d } }
+
+typedef struct {
+  ///
+  /// Base address and length of the firmware volume the index describes.
+  /// Consumers must only use the index for a volume at exactly this address
+  /// and of exactly this length.
+  ///
+  EFI_PHYSICAL_ADDRESS    FvBase;
+  UINT64                  FvLength;
+  ///
+  /// Number of entries in the offset array that follows this structure.
+  ///
+  UINT32                  FileCount;
+  //
+  // UINT32               FileOffset[FileCount];
+  //
+  // Offsets from FvBase of the headers of all non-pad FFS files in the
+  // volume, in volume order. The header and data checksums of every listed
+  // file have been verified.
+  //
+} EDKII_FV_FILE_INDEX;
+
+#define EDKII_FV_FILE_INDEX_OFFSETS(Index)  ((UINT32 *)((EDKII_FV_FILE_INDEX *)(Index) + 1))
+
+extern EFI_GUID  gEdkiiFvFileIndexGuid;
+
+#endif
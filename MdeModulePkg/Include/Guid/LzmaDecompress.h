@@ -23,7 +23,44 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define LZMAF86_CUSTOM_DECOMPRESS_GUID  \
   { 0xD42AE6BD, 0x1352, 0x4bfb, { 0x90, 0x9A, 0xCA, 0x72, 0xA6, 0xEA, 0xE8, 0x89 } }
 
+///
+/// The Global ID used to identify a section of an FFS file of type
+/// EFI_SECTION_GUID_DEFINED, whose contents have been compressed using LZMA
+/// as a sequence of independently decodable blocks.
+///
+#define LZMA_MULTI_BLOCK_CUSTOM_DECOMPRESS_GUID  \
+  { 0xA369715F, 0xB8CA, 0x4F9C, { 0xBB, 0xA2, 0xAA, 0xC6, 0x5C, 0x32, 0x10, 0xF7 } }
+
+#define LZMA_MULTI_BLOCK_SIGNATURE  SIGNATURE_32 ('L', 'Z', 'M', 'B')
+
+#pragma pack(1)
+
+///
+/// Header at the start of the data of a multi-block LZMA GUIDed section.
+///
+/// It is followed by an array of BlockCount + 1 UINT32 offsets, relative to
+/// the start of this header. Block N starts at Offset[N], which is 4-byte
+/// aligned, and ends before Offset[N + 1]. Each block is itself a GUIDed
+/// section of LZMA_CUSTOM_DECOMPRESS_GUID that decodes to BlockSize bytes,
+/// except for the last block which holds the remainder of DecodedSize.
+///
+/// Block N therefore lands at N * BlockSize in the decoded image, and is
+/// decoded by passing it to ExtractGuidedSectionDecode(), or to the decode
+/// handler registered for LZMA_CUSTOM_DECOMPRESS_GUID. Blocks can be decoded
+/// in any order, on different processors, or only for the range a consumer
+/// actually needs.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    BlockSize;
+  UINT32    BlockCount;
+  UINT32    DecodedSize;
+} LZMA_MULTI_BLOCK_HEADER;
+
+#pragma pack()
+
 extern GUID  gLzmaCustomDecompressGuid;
 extern GUID  gLzmaF86CustomDecompressGuid;
+extern GUID  gLzmaMultiBlockCustomDecompressGuid;
 
 #endif
@@ -24,7 +24,14 @@ typedef struct {
 } MEMORY_PROFILE_COMMON_HEADER;
 
 #define MEMORY_PROFILE_CONTEXT_SIGNATURE  SIGNATURE_32 ('M','P','C','T')
-#define MEMORY_PROFILE_CONTEXT_REVISION   0x0002
+#define MEMORY_PROFILE_CONTEXT_REVISION   0x0003
+
+//
+// Revision 0x0003 of the context adds the optional POOL_STATS record, and the
+// POOL_CLASS records following it, at the end of the UEFI memory profile. A
+// profile whose context has an older revision does not have them.
+//
+#define MEMORY_PROFILE_CONTEXT_POOL_STATS_REVISION  0x0003
 
 typedef struct {
   MEMORY_PROFILE_COMMON_HEADER    Header;
@@ -179,6 +186,30 @@ typedef struct {
   // MEMORY_PROFILE_DESCRIPTOR     MemoryDescriptor[MemoryRangeCount];
 } MEMORY_PROFILE_MEMORY_RANGE;
 
+#define MEMORY_PROFILE_POOL_CLASS_SIGNATURE  SIGNATURE_32 ('M','P','P','C')
+#define MEMORY_PROFILE_POOL_CLASS_REVISION   0x0001
+
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER    Header;
+  EFI_MEMORY_TYPE                 MemoryType;
+  UINT32                          ObjectSize;
+  UINT64                          SlabCount;
+  UINT64                          SlabPages;
+  UINT64                          TotalObjects;
+  UINT64                          UsedObjects;
+  UINT64                          ReleasedSlabCount;
+} MEMORY_PROFILE_POOL_CLASS;
+
+#define MEMORY_PROFILE_POOL_STATS_SIGNATURE  SIGNATURE_32 ('M','P','P','S')
+#define MEMORY_PROFILE_POOL_STATS_REVISION   0x0001
+
+typedef struct {
+  MEMORY_PROFILE_COMMON_HEADER    Header;
+  UINT32                          PoolClassCount;
+  UINT8                           Reserved[4];
+  // MEMORY_PROFILE_POOL_CLASS     PoolClass[PoolClassCount];
+} MEMORY_PROFILE_POOL_STATS;
+
 //
 // UEFI memory profile layout:
 // +--------------------------------+
@@ -196,6 +227,13 @@ typedef struct {
 // +--------------------------------+
 // | ALLOC_INFO(n, mn)              |
 // +--------------------------------+
+// | POOL_STATS                     | (context revision 0x0003 or later, only when
+// |                                |  the slab pool allocator is enabled)
+// +--------------------------------+
+// | POOL_CLASS(1)                  |
+// +--------------------------------+
+// | POOL_CLASS(r)                  |
+// +--------------------------------+
 //
 
 typedef struct _EDKII_MEMORY_PROFILE_PROTOCOL EDKII_MEMORY_PROFILE_PROTOCOL;
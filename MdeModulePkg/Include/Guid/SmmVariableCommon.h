@@ -77,6 +77,10 @@ typedef struct {
 // The payload for this function is SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO
 //
 #define SMM_VARIABLE_FUNCTION_GET_RUNTIME_CACHE_INFO  14
+//
+// The payload for this function is SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH.
+//
+#define SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH  15
 
 ///
 /// Size of SMM communicate header, without including the payload.
@@ -139,6 +143,12 @@ typedef struct {
   VARIABLE_STORE_HEADER    *RuntimeHobCache;
   VARIABLE_STORE_HEADER    *RuntimeNvCache;
   VARIABLE_STORE_HEADER    *RuntimeVolatileCache;
+  ///
+  /// Optional, may be NULL or left out of the communicate buffer. When it is
+  /// provided, the MM variable driver sets it to 0 and increments it each time
+  /// a reclaimed variable store is flushed to the runtime cache.
+  ///
+  UINT32                   *ReclaimCount;
 } SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT;
 
 typedef struct {
@@ -148,4 +158,20 @@ typedef struct {
   BOOLEAN    AuthenticatedVariableUsage;
 } SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO;
 
+///
+/// This structure is used to communicate with SMI handler by SetVariable batch.
+/// It is followed by EntryCount SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE entries,
+/// each starting at a UINTN aligned offset from the start of this structure.
+///
+typedef struct {
+  UINTN    EntryCount;
+  UINTN    ProcessedCount;     // Return number of entries set successfully
+} SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH;
+
+///
+/// Size of a SetVariable batch entry, including the padding to the next entry.
+///
+#define SMM_VARIABLE_BATCH_ENTRY_SIZE(NameSize, DataSize) \
+  ALIGN_VALUE (OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) + (NameSize) + (DataSize), sizeof (UINTN))
+
 #endif // _SMM_VARIABLE_COMMON_H_
@@ -35,6 +35,11 @@ typedef struct {
   /// TRUE indicates all HOB variables have been flushed in flash.
   ///
   BOOLEAN    HobFlushComplete;
+  ///
+  /// Incremented each time a reclaimed variable store is flushed to the runtime
+  /// cache, which moves the variables inside the runtime cache.
+  ///
+  UINT32     ReclaimCount;
 } CACHE_INFO_FLAG;
 
 typedef struct {
@@ -0,0 +1,87 @@
+/** @file
+  Parallel Driver Init Protocol is related to EDK II-specific implementation of
+  the DXE Core and intended for use by DXE drivers with a long-running init phase
+  that only touches the driver's own data, such as hashing or table building. The
+  DXE Core runs that phase on an AP while it dispatches other drivers.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __PARALLEL_DRIVER_INIT_H__
+#define __PARALLEL_DRIVER_INIT_H__
+
+#define EDKII_PARALLEL_DRIVER_INIT_PROTOCOL_GUID \
+  { \
+    0x4fda2184, 0xc820, 0x403e, { 0x92, 0xff, 0xde, 0xa8, 0xfb, 0x2e, 0xfd, 0x2f } \
+  }
+
+typedef struct _EDKII_PARALLEL_DRIVER_INIT_PROTOCOL EDKII_PARALLEL_DRIVER_INIT_PROTOCOL;
+
+/**
+  A phase of the init of a driver.
+
+  @param[in] Context    The context passed to RunParallel().
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_PARALLEL_DRIVER_INIT_PROCEDURE)(
+  IN VOID  *Context
+  );
+
+/**
+  Runs a phase of the init of a driver in parallel with the dispatch of other
+  drivers, then completes the init on the BSP.
+
+  Procedure runs on an AP, so it must not call EFI services or protocols and
+  must only touch data that nothing else uses until Completion runs. If no AP
+  is available, or the DXE dispatcher is not running, Procedure runs on the BSP
+  before this service returns.
+
+  The AP stays busy until Procedure returns, so EFI_MP_SERVICES_PROTOCOL
+  StartupAllAPs() returns EFI_NOT_READY meanwhile. The DXE Core waits for
+  Procedure to return before it changes memory attributes through the GCD, as
+  a cache attribute change is synchronized on every AP.
+
+  Completion runs on the BSP, at TPL_APPLICATION, once Procedure has returned.
+  It may use EFI services, for instance to install the protocols of the driver.
+  The DXE dispatcher does not return before every Completion has run.
+
+  The image of the driver must stay loaded until Completion has run, so the
+  entry point of the driver must not fail after calling this service.
+
+  @param[in] This           The EDKII_PARALLEL_DRIVER_INIT_PROTOCOL instance.
+  @param[in] ImageHandle    The image handle of the driver.
+  @param[in] Procedure      The phase of the init that may run on an AP.
+  @param[in] Completion     The phase of the init that runs on the BSP afterwards.
+                            Optional.
+  @param[in] Context        The context passed to Procedure and Completion.
+
+  @retval EFI_SUCCESS           Procedure was started on an AP, or has run on the BSP.
+  @retval EFI_INVALID_PARAMETER ImageHandle or Procedure is NULL.
+  @retval EFI_OUT_OF_RESOURCES  There is not enough memory to track Procedure.
+                                Neither Procedure nor Completion has run.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_PARALLEL_DRIVER_INIT_RUN_PARALLEL)(
+  IN EDKII_PARALLEL_DRIVER_INIT_PROTOCOL   *This,
+  IN EFI_HANDLE                            ImageHandle,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Procedure,
+  IN EDKII_PARALLEL_DRIVER_INIT_PROCEDURE  Completion OPTIONAL,
+  IN VOID                                  *Context
+  );
+
+///
+/// Parallel Driver Init Protocol is related to EDK II-specific implementation of
+/// the DXE Core and intended for use by DXE drivers with a long-running init phase.
+///
+struct _EDKII_PARALLEL_DRIVER_INIT_PROTOCOL {
+  EDKII_PARALLEL_DRIVER_INIT_RUN_PARALLEL    RunParallel;
+};
+
+extern EFI_GUID  gEdkiiParallelDriverInitProtocolGuid;
+
+#endif
@@ -0,0 +1,82 @@
+/** @file
+  Variable Batch Protocol is related to EDK II-specific implementation of variables
+  and intended for use as a means to set several variables with one request to the
+  variable driver, such as one MM communication for the SMM variable driver.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __VARIABLE_BATCH_H__
+#define __VARIABLE_BATCH_H__
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_GUID \
+  { \
+    0x0e8a31ef, 0x8dca, 0x457d, { 0xb1, 0x66, 0x82, 0x3f, 0x53, 0x52, 0xda, 0xee } \
+  }
+
+#define EDKII_VARIABLE_BATCH_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_VARIABLE_BATCH_PROTOCOL EDKII_VARIABLE_BATCH_PROTOCOL;
+
+///
+/// One variable update of a batch. The fields other than Status have the same
+/// meaning as the parameters of the SetVariable() runtime service.
+///
+typedef struct {
+  CHAR16        *VariableName;
+  EFI_GUID      *VendorGuid;
+  UINT32        Attributes;
+  UINTN         DataSize;
+  VOID          *Data;
+  ///
+  /// The status of the update. EFI_NOT_STARTED if the update was not attempted
+  /// because an earlier update of the batch failed.
+  ///
+  EFI_STATUS    Status;
+} EDKII_VARIABLE_BATCH_ENTRY;
+
+/**
+  Sets several variables in one request to the variable driver.
+
+  The entries are applied in order, with the same checks as the SetVariable()
+  runtime service, and processing stops at the first entry that fails. The
+  entries are committed in as few requests as the variable driver can take,
+  and the driver makes room for all entries of a request at once, so that at
+  most one reclaim of the variable store happens per request.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The variable updates. The Status of each entry is updated.
+  @param[out]     CommitCount   Optional pointer to return the number of requests sent
+                                to the variable driver.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER EntryCount is 0, Entries is NULL, or an entry
+                                cannot fit in a single request.
+  @retval EFI_UNSUPPORTED       The service is called after ExitBootServices().
+  @retval Others                The status of the first entry that failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES)(
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN     UINTN                          EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY     *Entries,
+  OUT    UINTN                          *CommitCount OPTIONAL
+  );
+
+///
+/// Variable Batch Protocol is related to EDK II-specific implementation of variables
+/// and intended for use as a means to set several variables with one request to the
+/// variable driver.
+///
+struct _EDKII_VARIABLE_BATCH_PROTOCOL {
+  UINT64                                         Revision;
+  EDKII_VARIABLE_BATCH_PROTOCOL_SET_VARIABLES    SetVariables;
+};
+
+extern EFI_GUID  gEdkiiVariableBatchProtocolGuid;
+
+#endif
@@ -218,3 +218,253 @@ LzmaUefiDecompress (
     return RETURN_INVALID_PARAMETER;
   }
 }
+
+/**
+  Validate the header and block index of a multi-block LZMA buffer.
+
+  @param  Source      The source buffer containing the multi-block data.
+  @param  SourceSize  The size, in bytes, of the source buffer.
+
+  @return The header of the buffer, or NULL if the buffer is malformed.
+**/
+STATIC
+CONST LZMA_MULTI_BLOCK_HEADER *
+LzmaMultiBlockGetHeader (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize
+  )
+{
+  CONST LZMA_MULTI_BLOCK_HEADER  *Header;
+  UINT32                         BlockCount;
+
+  if (SourceSize < sizeof (LZMA_MULTI_BLOCK_HEADER) + sizeof (UINT32)) {
+    return NULL;
+  }
+
+  Header = Source;
+  if ((Header->Signature != LZMA_MULTI_BLOCK_SIGNATURE) || (Header->BlockSize == 0)) {
+    return NULL;
+  }
+
+  BlockCount = Header->DecodedSize / Header->BlockSize;
+  if ((Header->DecodedSize % Header->BlockSize) != 0) {
+    BlockCount++;
+  }
+
+  //
+  // The offset array has BlockCount + 1 entries and must fit in the source.
+  //
+  if ((Header->BlockCount != BlockCount) ||
+      (BlockCount >= (SourceSize - sizeof (LZMA_MULTI_BLOCK_HEADER)) / sizeof (UINT32)))
+  {
+    return NULL;
+  }
+
+  return Header;
+}
+
+/**
+  Given a multi-block Lzma compressed source buffer, this function retrieves
+  the size of the uncompressed buffer and the size of the scratch buffer
+  required to decompress it.
+
+  The scratch buffer is only large enough to decode one block at a time.
+  Callers decoding several blocks concurrently need one scratch buffer of
+  this size per concurrent decode.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+  @param  BlockSize       Optional pointer to the uncompressed size of each block.
+  @param  BlockCount      Optional pointer to the number of blocks.
+
+  @retval RETURN_SUCCESS            The sizes were returned.
+  @retval RETURN_INVALID_PARAMETER  The source buffer is not a valid
+                                    multi-block Lzma buffer.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINTN       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize,
+  OUT UINT32      *BlockSize   OPTIONAL,
+  OUT UINT32      *BlockCount  OPTIONAL
+  )
+{
+  CONST LZMA_MULTI_BLOCK_HEADER  *Header;
+
+  Header = LzmaMultiBlockGetHeader (Source, SourceSize);
+  if (Header == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  *DestinationSize = Header->DecodedSize;
+  *ScratchSize     = SCRATCH_BUFFER_REQUEST_SIZE;
+  if (BlockSize != NULL) {
+    *BlockSize = Header->BlockSize;
+  }
+
+  if (BlockCount != NULL) {
+    *BlockCount = Header->BlockCount;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Decompresses a single block of a multi-block Lzma compressed source buffer.
+
+  Blocks are independent of each other, so this may be called for any subset
+  of the blocks, in any order, and concurrently as long as each caller passes
+  its own Scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  BlockIndex  The zero-based index of the block to decode.
+  @param  Destination The buffer receiving the decoded block. It must hold
+                      BlockSize bytes, or the remainder of the decoded size
+                      for the last block.
+  @param  Scratch     A scratch buffer of the size returned by
+                      LzmaMultiBlockDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            The block was decoded into Destination.
+  @retval  RETURN_INVALID_PARAMETER  BlockIndex is out of range, or the
+                                     source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompressBlock (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      BlockIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  CONST LZMA_MULTI_BLOCK_HEADER  *Header;
+  CONST UINT32                   *Offsets;
+  CONST EFI_GUID_DEFINED_SECTION  *BlockSection;
+  UINTN                          IndexEnd;
+  UINT32                         Start;
+  UINT32                         End;
+  UINT32                         SectionSize;
+  UINT32                         DataOffset;
+  UINT32                         ExpectedSize;
+
+  Header = LzmaMultiBlockGetHeader (Source, SourceSize);
+  if ((Header == NULL) || (BlockIndex >= Header->BlockCount)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Offsets  = (CONST UINT32 *)(Header + 1);
+  IndexEnd = sizeof (LZMA_MULTI_BLOCK_HEADER) + (Header->BlockCount + 1) * sizeof (UINT32);
+  Start    = ReadUnaligned32 (&Offsets[BlockIndex]);
+  End      = ReadUnaligned32 (&Offsets[BlockIndex + 1]);
+  if ((Start < IndexEnd) || (End > SourceSize) || (End < Start) ||
+      (End - Start < sizeof (EFI_GUID_DEFINED_SECTION2)))
+  {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The block is a GUIDed section of the single stream LZMA format.
+  //
+  BlockSection = (CONST EFI_GUID_DEFINED_SECTION *)((UINT8 *)Source + Start);
+  if (BlockSection->CommonHeader.Type != EFI_SECTION_GUID_DEFINED) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IS_SECTION2 (BlockSection)) {
+    SectionSize = SECTION2_SIZE (BlockSection);
+    DataOffset  = ((EFI_GUID_DEFINED_SECTION2 *)BlockSection)->DataOffset;
+    if (!CompareGuid (&((EFI_GUID_DEFINED_SECTION2 *)BlockSection)->SectionDefinitionGuid, &gLzmaCustomDecompressGuid) ||
+        (DataOffset < sizeof (EFI_GUID_DEFINED_SECTION2)))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+  } else {
+    SectionSize = SECTION_SIZE (BlockSection);
+    DataOffset  = BlockSection->DataOffset;
+    if (!CompareGuid (&BlockSection->SectionDefinitionGuid, &gLzmaCustomDecompressGuid) ||
+        (DataOffset < sizeof (EFI_GUID_DEFINED_SECTION)))
+    {
+      return RETURN_INVALID_PARAMETER;
+    }
+  }
+
+  if ((SectionSize > End - Start) || (SectionSize < DataOffset + LZMA_HEADER_SIZE)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  //
+  // The block carries its own decoded size, which LzmaUefiDecompress() uses
+  // as the output limit; make sure it matches what the index promises.
+  //
+  ExpectedSize = Header->DecodedSize - BlockIndex * Header->BlockSize;
+  if (ExpectedSize > Header->BlockSize) {
+    ExpectedSize = Header->BlockSize;
+  }
+
+  if (GetDecodedSizeOfBuf ((UINT8 *)BlockSection + DataOffset) != ExpectedSize) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  return LzmaUefiDecompress (
+           (UINT8 *)BlockSection + DataOffset,
+           SectionSize - DataOffset,
+           Destination,
+           Scratch
+           );
+}
+
+/**
+  Decompresses a multi-block Lzma compressed source buffer.
+
+  The blocks are decoded one after the other into Destination, reusing the
+  same Scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by
+                      LzmaMultiBlockDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  )
+{
+  CONST LZMA_MULTI_BLOCK_HEADER  *Header;
+  UINT32                         BlockIndex;
+  RETURN_STATUS                  Status;
+
+  Header = LzmaMultiBlockGetHeader (Source, SourceSize);
+  if (Header == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  for (BlockIndex = 0; BlockIndex < Header->BlockCount; BlockIndex++) {
+    Status = LzmaMultiBlockDecompressBlock (
+               Source,
+               SourceSize,
+               BlockIndex,
+               (UINT8 *)Destination + BlockIndex * Header->BlockSize,
+               Scratch
+               );
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return RETURN_SUCCESS;
+}
@@ -91,4 +91,90 @@ LzmaUefiDecompress (
   IN OUT VOID    *Scratch
   );
 
+/**
+  Given a multi-block Lzma compressed source buffer, this function retrieves
+  the size of the uncompressed buffer and the size of the scratch buffer
+  required to decompress it.
+
+  The scratch buffer is only large enough to decode one block at a time.
+  Callers decoding several blocks concurrently need one scratch buffer of
+  this size per concurrent decode.
+
+  @param  Source          The source buffer containing the compressed data.
+  @param  SourceSize      The size, in bytes, of the source buffer.
+  @param  DestinationSize A pointer to the size, in bytes, of the uncompressed buffer.
+  @param  ScratchSize     A pointer to the size, in bytes, of the scratch buffer.
+  @param  BlockSize       Optional pointer to the uncompressed size of each block.
+  @param  BlockCount      Optional pointer to the number of blocks.
+
+  @retval RETURN_SUCCESS            The sizes were returned.
+  @retval RETURN_INVALID_PARAMETER  The source buffer is not a valid
+                                    multi-block Lzma buffer.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompressGetInfo (
+  IN  CONST VOID  *Source,
+  IN  UINTN       SourceSize,
+  OUT UINT32      *DestinationSize,
+  OUT UINT32      *ScratchSize,
+  OUT UINT32      *BlockSize   OPTIONAL,
+  OUT UINT32      *BlockCount  OPTIONAL
+  );
+
+/**
+  Decompresses a single block of a multi-block Lzma compressed source buffer.
+
+  Each block is a GUIDed section of the single stream Lzma format, so a block
+  may also be decoded by LzmaGuidedSectionExtraction(). Blocks are independent
+  of each other, so this may be called for any subset of the blocks, in any
+  order, and concurrently as long as each caller passes its own Scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  BlockIndex  The zero-based index of the block to decode.
+  @param  Destination The buffer receiving the decoded block. It must hold
+                      BlockSize bytes, or the remainder of the decoded size
+                      for the last block.
+  @param  Scratch     A scratch buffer of the size returned by
+                      LzmaMultiBlockDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            The block was decoded into Destination.
+  @retval  RETURN_INVALID_PARAMETER  BlockIndex is out of range, or the
+                                     source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompressBlock (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN UINT32      BlockIndex,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
+/**
+  Decompresses a multi-block Lzma compressed source buffer.
+
+  The blocks are decoded one after the other into Destination, reusing the
+  same Scratch buffer.
+
+  @param  Source      The source buffer containing the compressed data.
+  @param  SourceSize  The size of source buffer.
+  @param  Destination The destination buffer to store the decompressed data.
+  @param  Scratch     A scratch buffer of the size returned by
+                      LzmaMultiBlockDecompressGetInfo().
+
+  @retval  RETURN_SUCCESS            Decompression completed successfully.
+  @retval  RETURN_INVALID_PARAMETER  The source buffer is corrupted.
+**/
+RETURN_STATUS
+EFIAPI
+LzmaMultiBlockDecompress (
+  IN CONST VOID  *Source,
+  IN UINTN       SourceSize,
+  IN OUT VOID    *Destination,
+  IN OUT VOID    *Scratch
+  );
+
 #endif
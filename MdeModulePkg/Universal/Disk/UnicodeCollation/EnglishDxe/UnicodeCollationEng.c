@@ -73,28 +73,22 @@ GLOBAL_REMOVE_IF_UNREFERENCED EFI_UNICODE_COLLATION_PROTOCOL  Unicode2Eng = {
 };
 
 /**
-  The user Entry Point for English module.
-
-  This function initializes unicode character mapping and then installs Unicode
-  Collation & Unicode Collation 2 Protocols based on the feature flags.
+  Initializes the unicode character mapping tables.
 
-  @param  ImageHandle    The firmware allocated handle for the EFI image.
-  @param  SystemTable    A pointer to the EFI System Table.
+  This is the phase of the init of the module that may run on an AP, so it only
+  touches the mapping tables.
 
-  @retval EFI_SUCCESS    The entry point is executed successfully.
-  @retval other          Some error occurs when executing this entry point.
+  @param  Context        Not used.
 
 **/
-EFI_STATUS
+VOID
 EFIAPI
-InitializeUnicodeCollationEng (
-  IN EFI_HANDLE        ImageHandle,
-  IN EFI_SYSTEM_TABLE  *SystemTable
+EngInitializeMaps (
+  IN VOID  *Context
   )
 {
-  EFI_STATUS  Status;
-  UINTN       Index;
-  UINTN       Index2;
+  UINTN  Index;
+  UINTN  Index2;
 
   //
   // Initialize mapping tables for the supported languages
@@ -118,7 +112,27 @@ InitializeUnicodeCollationEng (
     Index2               = mOtherChars[Index];
     mEngInfoMap[Index2] |= CHAR_FAT_VALID;
   }
+}
+
+/**
+  Installs Unicode Collation & Unicode Collation 2 Protocols based on the
+  feature flags, once the mapping tables are initialized.
+
+  @retval EFI_SUCCESS    The protocols are installed.
+  @retval other          Some error occurs when installing the protocols.
 
+**/
+EFI_STATUS
+EngInstallProtocols (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // The entry point has checked that at least one of the protocols is
+  // supported.
+  //
   if (FeaturePcdGet (PcdUnicodeCollation2Support)) {
     if (FeaturePcdGet (PcdUnicodeCollationSupport)) {
       Status = gBS->InstallMultipleProtocolInterfaces (
@@ -140,27 +154,87 @@ InitializeUnicodeCollationEng (
       ASSERT_EFI_ERROR (Status);
     }
   } else {
-    if (FeaturePcdGet (PcdUnicodeCollationSupport)) {
-      Status = gBS->InstallMultipleProtocolInterfaces (
-                      &mHandle,
-                      &gEfiUnicodeCollationProtocolGuid,
-                      &UnicodeEng,
-                      NULL
-                      );
-      ASSERT_EFI_ERROR (Status);
-    } else {
-      //
-      // This module must support to produce at least one of Unicode Collation Protocol
-      // and Unicode Collation 2 Protocol.
-      //
-      ASSERT (FALSE);
-      Status = EFI_UNSUPPORTED;
-    }
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &mHandle,
+                    &gEfiUnicodeCollationProtocolGuid,
+                    &UnicodeEng,
+                    NULL
+                    );
+    ASSERT_EFI_ERROR (Status);
   }
 
   return Status;
 }
 
+/**
+  Installs the protocols once EngInitializeMaps() has returned.
+
+  This is the completion of the init of the module, which runs on the BSP.
+
+  @param  Context        Not used.
+
+**/
+VOID
+EFIAPI
+EngCompleteInitialization (
+  IN VOID  *Context
+  )
+{
+  EngInstallProtocols ();
+}
+
+/**
+  The user Entry Point for English module.
+
+  This function initializes unicode character mapping and then installs Unicode
+  Collation & Unicode Collation 2 Protocols based on the feature flags. The
+  mapping is initialized on an AP through EDKII_PARALLEL_DRIVER_INIT_PROTOCOL
+  when the DXE core can, and the protocols are installed once it returns.
+
+  @param  ImageHandle    The firmware allocated handle for the EFI image.
+  @param  SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS    The entry point is executed successfully.
+  @retval other          Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+InitializeUnicodeCollationEng (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                           Status;
+  EDKII_PARALLEL_DRIVER_INIT_PROTOCOL  *ParallelDriverInit;
+
+  if (!FeaturePcdGet (PcdUnicodeCollation2Support) && !FeaturePcdGet (PcdUnicodeCollationSupport)) {
+    //
+    // This module must support to produce at least one of Unicode Collation Protocol
+    // and Unicode Collation 2 Protocol.
+    //
+    ASSERT (FALSE);
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = gBS->LocateProtocol (&gEdkiiParallelDriverInitProtocolGuid, NULL, (VOID **)&ParallelDriverInit);
+  if (!EFI_ERROR (Status)) {
+    Status = ParallelDriverInit->RunParallel (
+                                   ParallelDriverInit,
+                                   ImageHandle,
+                                   EngInitializeMaps,
+                                   EngCompleteInitialization,
+                                   NULL
+                                   );
+    if (!EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+  }
+
+  EngInitializeMaps (NULL);
+  return EngInstallProtocols ();
+}
+
 /**
   Performs a case-insensitive comparison of two Null-terminated strings.
 
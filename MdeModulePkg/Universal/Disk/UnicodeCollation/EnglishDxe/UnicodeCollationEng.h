@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/UnicodeCollation.h>
+#include <Protocol/ParallelDriverInit.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -156,11 +157,55 @@ EngStrToFat (
   OUT CHAR8                          *Fat
   );
 
+/**
+  Initializes the unicode character mapping tables.
+
+  This is the phase of the init of the module that may run on an AP, so it only
+  touches the mapping tables.
+
+  @param  Context        Not used.
+
+**/
+VOID
+EFIAPI
+EngInitializeMaps (
+  IN VOID  *Context
+  );
+
+/**
+  Installs Unicode Collation & Unicode Collation 2 Protocols based on the
+  feature flags, once the mapping tables are initialized.
+
+  @retval EFI_SUCCESS    The protocols are installed.
+  @retval other          Some error occurs when installing the protocols.
+
+**/
+EFI_STATUS
+EngInstallProtocols (
+  VOID
+  );
+
+/**
+  Installs the protocols once EngInitializeMaps() has returned.
+
+  This is the completion of the init of the module, which runs on the BSP.
+
+  @param  Context        Not used.
+
+**/
+VOID
+EFIAPI
+EngCompleteInitialization (
+  IN VOID  *Context
+  );
+
 /**
   The user Entry Point for English module.
 
   This function initializes unicode character mapping and then installs Unicode
-  Collation & Unicode Collation 2 Protocols based on the feature flags.
+  Collation & Unicode Collation 2 Protocols based on the feature flags. The
+  mapping is initialized on an AP through EDKII_PARALLEL_DRIVER_INIT_PROTOCOL
+  when the DXE core can, and the protocols are installed once it returns.
 
   @param  ImageHandle    The firmware allocated handle for the EFI image.
   @param  SystemTable    A pointer to the EFI System Table.
@@ -92,8 +92,16 @@ GetLbaAndOffsetByAddress (
   volume block device. The destination is specified by parameter
   VariableBase. Fault Tolerant Write protocol is used for writing.
 
+  Only the span of flash blocks whose content differs from the buffer is
+  written, so that blocks still holding the same data, such as the leading
+  blocks of live variables left in place by a reclaim or the trailing erased
+  blocks, are neither erased nor rewritten. The span is written as a single
+  fault tolerant write to keep the update atomic.
+
   @param  VariableBase   Base address of variable to write
   @param  VariableBuffer Point to the variable data buffer.
+  @param  WrittenSize    Optional pointer to return the number of bytes
+                         written to the flash.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -102,16 +110,28 @@ GetLbaAndOffsetByAddress (
 **/
 EFI_STATUS
 FtwVariableSpace (
-  IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *WrittenSize OPTIONAL
   )
 {
-  EFI_STATUS                         Status;
-  EFI_HANDLE                         FvbHandle;
-  EFI_LBA                            VarLba;
-  UINTN                              VarOffset;
-  UINTN                              FtwBufferSize;
-  EFI_FAULT_TOLERANT_WRITE_PROTOCOL  *FtwProtocol;
+  EFI_STATUS                          Status;
+  EFI_HANDLE                          FvbHandle;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
+  EFI_LBA                             VarLba;
+  UINTN                               VarOffset;
+  UINTN                               BlockSize;
+  UINTN                               NumberOfBlocks;
+  UINTN                               FtwBufferSize;
+  UINTN                               ChunkStart;
+  UINTN                               ChunkEnd;
+  UINTN                               WriteStart;
+  UINTN                               WriteEnd;
+  EFI_FAULT_TOLERANT_WRITE_PROTOCOL   *FtwProtocol;
+
+  if (WrittenSize != NULL) {
+    *WrittenSize = 0;
+  }
 
   //
   // Locate fault tolerant write protocol.
@@ -124,7 +144,7 @@ FtwVariableSpace (
   //
   // Locate Fvb handle by address.
   //
-  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, NULL);
+  Status = GetFvbInfoByAddress (VariableBase, &FvbHandle, &Fvb);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -137,21 +157,63 @@ FtwVariableSpace (
     return EFI_ABORTED;
   }
 
+  Status = Fvb->GetBlockSize (Fvb, VarLba, &BlockSize, &NumberOfBlocks);
+  if (EFI_ERROR (Status) || (BlockSize == 0)) {
+    return EFI_ABORTED;
+  }
+
   FtwBufferSize = ((VARIABLE_STORE_HEADER *)((UINTN)VariableBase))->Size;
   ASSERT (FtwBufferSize == VariableBuffer->Size);
 
+  //
+  // Find the first and the last flash block whose content differs from the
+  // buffer. The first block starts at VarOffset inside block VarLba.
+  //
+  WriteStart = FtwBufferSize;
+  WriteEnd   = 0;
+  for (ChunkStart = 0; ChunkStart < FtwBufferSize; ChunkStart = ChunkEnd) {
+    ChunkEnd = (ChunkStart == 0) ? BlockSize - VarOffset : ChunkStart + BlockSize;
+    ChunkEnd = MIN (ChunkEnd, FtwBufferSize);
+    if (CompareMem (
+          (VOID *)(UINTN)(VariableBase + ChunkStart),
+          (UINT8 *)VariableBuffer + ChunkStart,
+          ChunkEnd - ChunkStart
+          ) != 0)
+    {
+      WriteStart = MIN (WriteStart, ChunkStart);
+      WriteEnd   = ChunkEnd;
+    }
+  }
+
+  if (WriteStart >= WriteEnd) {
+    //
+    // The flash already holds the buffer content.
+    //
+    return EFI_SUCCESS;
+  }
+
+  if (WriteStart != 0) {
+    Status = GetLbaAndOffsetByAddress (VariableBase + WriteStart, &VarLba, &VarOffset);
+    if (EFI_ERROR (Status)) {
+      return EFI_ABORTED;
+    }
+  }
+
   //
   // FTW write record.
   //
   Status = FtwProtocol->Write (
                           FtwProtocol,
-                          VarLba,                // LBA
-                          VarOffset,             // Offset
-                          FtwBufferSize,         // NumBytes
-                          NULL,                  // PrivateData NULL
-                          FvbHandle,             // Fvb Handle
-                          (VOID *)VariableBuffer // write buffer
+                          VarLba,                                         // LBA
+                          VarOffset,                                      // Offset
+                          WriteEnd - WriteStart,                          // NumBytes
+                          NULL,                                           // PrivateData NULL
+                          FvbHandle,                                      // Fvb Handle
+                          (VOID *)((UINT8 *)VariableBuffer + WriteStart)  // write buffer
                           );
+  if (!EFI_ERROR (Status) && (WrittenSize != NULL)) {
+    *WrittenSize = WriteEnd - WriteStart;
+  }
 
   return Status;
 }
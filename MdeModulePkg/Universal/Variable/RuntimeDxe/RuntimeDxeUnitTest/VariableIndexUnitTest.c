@@ -0,0 +1,924 @@
+/** @file
+  This is a host-based unit test for the variable store hash index.
+
+  The index only covers part of a store in several cases: when its hash table
+  is full, when it meets a variable that is still being written or whose name
+  is malformed, and after a reclaim. These tests check that FindVariableEx ()
+  still returns what a full walk through the store would return in each case.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "../VariableParsing.h"
+#include "../VariableIndex.h"
+
+#define UNIT_TEST_NAME     "Variable Store Index Unit Tests"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define TEST_STORE_SIZE      SIZE_64KB
+#define TEST_VARIABLE_COUNT  64
+#define TEST_NAME_LENGTH     8
+#define BENCHMARK_LOOKUPS    4096
+
+typedef struct {
+  VARIABLE_STORE_HEADER    *Store;
+  UINTN                    LastOffset;
+} TEST_STORE;
+
+BOOLEAN  mAtRuntime    = FALSE;
+BOOLEAN  mRunBenchmark = FALSE;
+
+EFI_GUID  mTestGuid1 = {
+  0x5b8a6a2e, 0x4c3f, 0x4f42, { 0x9a, 0x4e, 0x1d, 0x6f, 0x2c, 0x7b, 0x3a, 0x10 }
+};
+EFI_GUID  mTestGuid2 = {
+  0x0e4c1d0f, 0x7a2b, 0x48d6, { 0xb1, 0x95, 0x62, 0x3e, 0x8f, 0x04, 0xc7, 0x21 }
+};
+
+/**
+  Indicates if the variable driver is running at runtime.
+
+  @retval TRUE   The variable driver is running at runtime.
+  @retval FALSE  The variable driver is not running at runtime.
+
+**/
+BOOLEAN
+AtRuntime (
+  VOID
+  )
+{
+  return mAtRuntime;
+}
+
+/**
+  Builds the name of a test variable.
+
+  @param[out] Name    Buffer of TEST_NAME_LENGTH + 1 characters.
+  @param[in]  Number  Number of the test variable.
+
+**/
+VOID
+BuildVariableName (
+  OUT CHAR16  *Name,
+  IN  UINTN   Number
+  )
+{
+  UINTN  Index;
+
+  Name[0] = L'V';
+  Name[1] = L'a';
+  Name[2] = L'r';
+  for (Index = TEST_NAME_LENGTH - 1; Index >= 3; Index--) {
+    Name[Index] = L"0123456789ABCDEF"[Number & 0xF];
+    Number    >>= 4;
+  }
+
+  Name[TEST_NAME_LENGTH] = L'\0';
+}
+
+/**
+  Creates an empty variable store and registers it as the volatile store.
+
+  @param[out] TestStore  The test store.
+  @param[in]  Size       Size of the variable store.
+
+  @retval TRUE   The store was created and registered.
+  @retval FALSE  The store could not be created or registered.
+
+**/
+BOOLEAN
+CreateStore (
+  OUT TEST_STORE  *TestStore,
+  IN  UINTN       Size
+  )
+{
+  VARIABLE_STORE_HEADER  *Store;
+
+  Store = AllocatePool (Size);
+  if (Store == NULL) {
+    return FALSE;
+  }
+
+  SetMem (Store, Size, 0xFF);
+  CopyGuid (&Store->Signature, &gEfiVariableGuid);
+  Store->Size      = (UINT32)Size;
+  Store->Format    = VARIABLE_STORE_FORMATTED;
+  Store->State     = VARIABLE_STORE_HEALTHY;
+  Store->Reserved  = 0;
+  Store->Reserved1 = 0;
+
+  TestStore->Store      = Store;
+  TestStore->LastOffset = (UINTN)GetStartPointer (Store) - (UINTN)Store;
+  return !EFI_ERROR (VariableStoreIndexRegister (VariableStoreTypeVolatile, Store));
+}
+
+/**
+  Unregisters and frees a test store.
+
+  @param[in] TestStore  The test store.
+
+**/
+VOID
+FreeStore (
+  IN TEST_STORE  *TestStore
+  )
+{
+  VariableStoreIndexUnregister (VariableStoreTypeVolatile);
+  FreePool (TestStore->Store);
+}
+
+/**
+  Appends a variable to a test store.
+
+  @param[in, out] TestStore   The test store.
+  @param[in]      Name        Name of the variable.
+  @param[in]      NameSize    Size of the name in bytes, as written in the header.
+  @param[in]      Guid        Vendor GUID of the variable.
+  @param[in]      Attributes  Attributes of the variable.
+  @param[in]      State       State of the variable.
+
+  @return Offset of the variable header in the store.
+
+**/
+UINTN
+AppendRawVariable (
+  IN OUT TEST_STORE  *TestStore,
+  IN     CHAR16      *Name,
+  IN     UINT32      NameSize,
+  IN     EFI_GUID    *Guid,
+  IN     UINT32      Attributes,
+  IN     UINT8       State
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  UINTN            Offset;
+  UINT32           Data;
+
+  Offset   = TestStore->LastOffset;
+  Variable = (VARIABLE_HEADER *)((UINTN)TestStore->Store + Offset);
+  ZeroMem (Variable, sizeof (VARIABLE_HEADER));
+  Variable->StartId    = VARIABLE_DATA;
+  Variable->State      = State;
+  Variable->Attributes = Attributes;
+  Variable->NameSize   = NameSize;
+  Variable->DataSize   = sizeof (Data);
+  CopyGuid (&Variable->VendorGuid, Guid);
+  CopyMem (GetVariableNamePtr (Variable, FALSE), Name, NameSize);
+  Data = (UINT32)Offset;
+  CopyMem (GetVariableDataPtr (Variable, FALSE), &Data, sizeof (Data));
+
+  TestStore->LastOffset = (UINTN)GetNextVariablePtr (Variable, FALSE) - (UINTN)TestStore->Store;
+  return Offset;
+}
+
+/**
+  Appends a variable with a well formed name to a test store.
+
+  @param[in, out] TestStore   The test store.
+  @param[in]      Name        Name of the variable.
+  @param[in]      Guid        Vendor GUID of the variable.
+  @param[in]      State       State of the variable.
+
+  @return Offset of the variable header in the store.
+
+**/
+UINTN
+AppendVariable (
+  IN OUT TEST_STORE  *TestStore,
+  IN     CHAR16      *Name,
+  IN     EFI_GUID    *Guid,
+  IN     UINT8       State
+  )
+{
+  return AppendRawVariable (TestStore, Name, (UINT32)StrSize (Name), Guid, EFI_VARIABLE_BOOTSERVICE_ACCESS, State);
+}
+
+/**
+  Appends numbered test variables to a test store.
+
+  @param[in, out] TestStore  The test store.
+  @param[in]      First      Number of the first variable.
+  @param[in]      Count      Number of variables.
+  @param[out]     Offsets    Offsets of the variables.
+
+**/
+VOID
+AppendVariables (
+  IN OUT TEST_STORE  *TestStore,
+  IN     UINTN       First,
+  IN     UINTN       Count,
+  OUT    UINTN       *Offsets
+  )
+{
+  CHAR16  Name[TEST_NAME_LENGTH + 1];
+  UINTN   Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    BuildVariableName (Name, First + Index);
+    Offsets[Index] = AppendVariable (TestStore, Name, &mTestGuid1, VAR_ADDED);
+  }
+}
+
+/**
+  Changes the state of a variable in a test store.
+
+  @param[in, out] TestStore  The test store.
+  @param[in]      Offset     Offset of the variable header in the store.
+  @param[in]      State      New state of the variable.
+
+**/
+VOID
+SetVariableState (
+  IN OUT TEST_STORE  *TestStore,
+  IN     UINTN       Offset,
+  IN     UINT8       State
+  )
+{
+  ((VARIABLE_HEADER *)((UINTN)TestStore->Store + Offset))->State = State;
+}
+
+/**
+  Looks a variable up in a test store with FindVariableEx ().
+
+  @param[in]  TestStore      The test store.
+  @param[in]  Name           Name of the variable.
+  @param[in]  Guid           Vendor GUID of the variable.
+  @param[in]  IgnoreRtCheck  Ignore the runtime access attribute at runtime.
+  @param[out] InDeleted      Offset of the variable in deleted transition
+                             returned with it, 0 if none. Optional.
+
+  @return Offset of the variable found, 0 if not found.
+
+**/
+UINTN
+LookUp (
+  IN  TEST_STORE  *TestStore,
+  IN  CHAR16      *Name,
+  IN  EFI_GUID    *Guid,
+  IN  BOOLEAN     IgnoreRtCheck,
+  OUT UINTN       *InDeleted OPTIONAL
+  )
+{
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  UINTN                   Offset;
+
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetStartPointer (TestStore->Store);
+  PtrTrack.EndPtr   = GetEndPointer (TestStore->Store);
+
+  Offset = 0;
+  if (InDeleted != NULL) {
+    *InDeleted = 0;
+  }
+
+  if (!EFI_ERROR (FindVariableEx (Name, Guid, IgnoreRtCheck, &PtrTrack, FALSE))) {
+    Offset = (UINTN)PtrTrack.CurrPtr - (UINTN)TestStore->Store;
+    if ((InDeleted != NULL) && (PtrTrack.InDeletedTransitionPtr != NULL)) {
+      *InDeleted = (UINTN)PtrTrack.InDeletedTransitionPtr - (UINTN)TestStore->Store;
+    }
+  }
+
+  return Offset;
+}
+
+/**
+  Returns the offset up to which the volatile store is indexed.
+
+  @return The IndexedEnd of the volatile store index.
+
+**/
+UINTN
+IndexedEnd (
+  VOID
+  )
+{
+  return mVariableStoreIndex[VariableStoreTypeVolatile].IndexedEnd;
+}
+
+/**
+  When a store holds several added copies of a variable, which happens when an
+  update is interrupted, the first one is returned, as by a walk through the
+  store.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexReturnsFirstAddedCopy (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+  UINTN       First;
+  UINTN       Second;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  BuildVariableName (Name, TEST_VARIABLE_COUNT);
+  First = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT, Offsets);
+  Second = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), First);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid2, FALSE, NULL), 0);
+
+  SetVariableState (&TestStore, First, VAR_ADDED & VAR_DELETED);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Second);
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The variable in deleted transition returned with an added variable is the
+  last one found before it. A variable in deleted transition is returned on
+  its own when there is no added copy.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexReturnsLastInDeletedTransition (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+  UINTN       Deleting1;
+  UINTN       Deleting2;
+  UINTN       Added;
+  UINTN       InDeleted;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  BuildVariableName (Name, TEST_VARIABLE_COUNT);
+  Deleting1 = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_IN_DELETED_TRANSITION & VAR_ADDED);
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT / 2, Offsets);
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, &InDeleted), Deleting1);
+  UT_ASSERT_EQUAL (InDeleted, 0);
+
+  Deleting2 = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_IN_DELETED_TRANSITION & VAR_ADDED);
+  AppendVariables (&TestStore, TEST_VARIABLE_COUNT / 2, TEST_VARIABLE_COUNT / 2, Offsets);
+  Added = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+  AppendVariable (&TestStore, Name, &mTestGuid1, VAR_IN_DELETED_TRANSITION & VAR_ADDED);
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, &InDeleted), Added);
+  UT_ASSERT_EQUAL (InDeleted, Deleting2);
+
+  SetVariableState (&TestStore, Deleting2, VAR_IN_DELETED_TRANSITION & VAR_ADDED & VAR_DELETED);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, &InDeleted), Added);
+  UT_ASSERT_EQUAL (InDeleted, Deleting1);
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Once the hash table is three quarters full, indexing stops and the rest of
+  the store is walked through.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexFullFallsBackToWalk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+  UINTN       Index;
+  UINT32      BucketCount;
+
+  //
+  // The bucket count is derived from the store size when the store is
+  // registered. Register it with a smaller size to fill the table up, after
+  // dropping the larger bucket array left by the previous tests.
+  //
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  FreePool (mVariableStoreIndex[VariableStoreTypeVolatile].Buckets);
+  mVariableStoreIndex[VariableStoreTypeVolatile].Buckets = NULL;
+  TestStore.Store->Size = SIZE_1KB;
+  UT_ASSERT_NOT_EFI_ERROR (VariableStoreIndexRegister (VariableStoreTypeVolatile, TestStore.Store));
+  TestStore.Store->Size = TEST_STORE_SIZE;
+  BucketCount           = mVariableStoreIndex[VariableStoreTypeVolatile].BucketCount;
+  UT_ASSERT_TRUE (BucketCount < TEST_VARIABLE_COUNT);
+
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT, Offsets);
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    BuildVariableName (Name, Index);
+    UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[Index]);
+  }
+
+  UT_ASSERT_EQUAL (mVariableStoreIndex[VariableStoreTypeVolatile].EntryCount, (BucketCount / 4) * 3);
+  UT_ASSERT_EQUAL (IndexedEnd (), Offsets[(BucketCount / 4) * 3]);
+
+  //
+  // Deleted variables are not indexed, so the walk still finds the added
+  // copy that follows them.
+  //
+  BuildVariableName (Name, 0);
+  SetVariableState (&TestStore, Offsets[0], VAR_ADDED & VAR_DELETED);
+  Offsets[0] = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[0]);
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Indexing stops before a variable whose header is written but whose data may
+  not be yet, and resumes once the variable is added.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexStopsAtVariableBeingWritten (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+  UINTN       Pending;
+  UINTN       Index;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT / 2, Offsets);
+  BuildVariableName (Name, TEST_VARIABLE_COUNT);
+  Pending = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_HEADER_VALID_ONLY);
+  AppendVariables (&TestStore, TEST_VARIABLE_COUNT / 2, TEST_VARIABLE_COUNT / 2, &Offsets[TEST_VARIABLE_COUNT / 2]);
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), 0);
+  UT_ASSERT_EQUAL (IndexedEnd (), Pending);
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    BuildVariableName (Name, Index);
+    UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[Index]);
+  }
+
+  SetVariableState (&TestStore, Pending, VAR_ADDED);
+  BuildVariableName (Name, TEST_VARIABLE_COUNT);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Pending);
+  UT_ASSERT_EQUAL (IndexedEnd (), TestStore.LastOffset);
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Indexing stops before a variable whose name is not null terminated. The
+  walk through the rest of the store still finds it the way it always did,
+  by comparing NameSize bytes.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexStopsAtMalformedName (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+  UINTN       Malformed;
+  UINTN       Index;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT / 2, Offsets);
+  BuildVariableName (Name, TEST_VARIABLE_COUNT);
+  Malformed = AppendRawVariable (
+                &TestStore,
+                Name,
+                TEST_NAME_LENGTH * sizeof (CHAR16),
+                &mTestGuid1,
+                EFI_VARIABLE_BOOTSERVICE_ACCESS,
+                VAR_ADDED
+                );
+  AppendVariables (&TestStore, TEST_VARIABLE_COUNT / 2, TEST_VARIABLE_COUNT / 2, &Offsets[TEST_VARIABLE_COUNT / 2]);
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Malformed);
+  UT_ASSERT_EQUAL (IndexedEnd (), Malformed);
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    BuildVariableName (Name, Index);
+    UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[Index]);
+  }
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Variables without runtime access are hidden at runtime unless the runtime
+  check is ignored, and a hidden copy does not shadow a later visible one.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexHonorsRuntimeAccess (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  TestStore;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Hidden;
+  UINTN       Visible;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  BuildVariableName (Name, 0);
+  Hidden  = AppendRawVariable (&TestStore, Name, (UINT32)StrSize (Name), &mTestGuid1, EFI_VARIABLE_BOOTSERVICE_ACCESS, VAR_ADDED);
+  Visible = AppendRawVariable (
+              &TestStore,
+              Name,
+              (UINT32)StrSize (Name),
+              &mTestGuid1,
+              EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS,
+              VAR_ADDED
+              );
+
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Hidden);
+  mAtRuntime = TRUE;
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Visible);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, TRUE, NULL), Hidden);
+  mAtRuntime = FALSE;
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  After a reclaim moves the variables, the index is rebuilt once it is
+  invalidated. A lookup over a range that is not a registered store is not
+  served by the index.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexFollowsReclaim (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE              TestStore;
+  CHAR16                  Name[TEST_NAME_LENGTH + 1];
+  UINTN                   Offsets[TEST_VARIABLE_COUNT];
+  UINTN                   Index;
+  VARIABLE_POINTER_TRACK  PtrTrack;
+  VARIABLE_HEADER         *InDeletedVariable;
+  VARIABLE_HEADER         *ResumePtr;
+
+  UT_ASSERT_TRUE (CreateStore (&TestStore, TEST_STORE_SIZE));
+  AppendVariables (&TestStore, 0, TEST_VARIABLE_COUNT, Offsets);
+  BuildVariableName (Name, 0);
+  UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[0]);
+
+  //
+  // Rewrite the store with the variables in reverse order, as a reclaim that
+  // dropped deleted variables would move them.
+  //
+  SetMem (GetStartPointer (TestStore.Store), TestStore.LastOffset, 0xFF);
+  TestStore.LastOffset = (UINTN)GetStartPointer (TestStore.Store) - (UINTN)TestStore.Store;
+  for (Index = TEST_VARIABLE_COUNT; Index > 0; Index--) {
+    BuildVariableName (Name, Index - 1);
+    Offsets[Index - 1] = AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+  }
+
+  VariableStoreIndexInvalidate (TestStore.Store);
+  for (Index = 0; Index < TEST_VARIABLE_COUNT; Index++) {
+    BuildVariableName (Name, Index);
+    UT_ASSERT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), Offsets[Index]);
+  }
+
+  //
+  // A range that starts past the store header is not the registered store.
+  //
+  ZeroMem (&PtrTrack, sizeof (PtrTrack));
+  PtrTrack.StartPtr = GetNextVariablePtr (GetStartPointer (TestStore.Store), FALSE);
+  PtrTrack.EndPtr   = GetEndPointer (TestStore.Store);
+  UT_ASSERT_STATUS_EQUAL (
+    VariableStoreIndexFind (Name, &mTestGuid1, FALSE, &PtrTrack, FALSE, &InDeletedVariable, &ResumePtr),
+    EFI_NOT_FOUND
+    );
+  UT_ASSERT_TRUE (ResumePtr == PtrTrack.StartPtr);
+  UT_ASSERT_TRUE (InDeletedVariable == NULL);
+
+  FreeStore (&TestStore);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Registering a store of the same type again reuses the bucket array unless
+  it is too small for the new store.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexReusesBuckets (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_STORE  Small;
+  TEST_STORE  Large;
+  UINT32      *Buckets;
+  UINT32      BucketCount;
+  CHAR16      Name[TEST_NAME_LENGTH + 1];
+  UINTN       Offsets[TEST_VARIABLE_COUNT];
+
+  UT_ASSERT_TRUE (CreateStore (&Large, TEST_STORE_SIZE));
+  Buckets     = mVariableStoreIndex[VariableStoreTypeVolatile].Buckets;
+  BucketCount = mVariableStoreIndex[VariableStoreTypeVolatile].BucketCount;
+
+  UT_ASSERT_TRUE (CreateStore (&Small, SIZE_4KB));
+  UT_ASSERT_TRUE (mVariableStoreIndex[VariableStoreTypeVolatile].Buckets == Buckets);
+  UT_ASSERT_EQUAL (mVariableStoreIndex[VariableStoreTypeVolatile].BucketCount, BucketCount);
+
+  //
+  // Stale entries left by another store in the reused array are not used.
+  //
+  AppendVariables (&Large, 0, TEST_VARIABLE_COUNT, Offsets);
+  UT_ASSERT_NOT_EFI_ERROR (VariableStoreIndexRegister (VariableStoreTypeVolatile, Large.Store));
+  BuildVariableName (Name, 1);
+  UT_ASSERT_EQUAL (LookUp (&Large, Name, &mTestGuid1, FALSE, NULL), Offsets[1]);
+  UT_ASSERT_NOT_EFI_ERROR (VariableStoreIndexRegister (VariableStoreTypeVolatile, Small.Store));
+  UT_ASSERT_EQUAL (LookUp (&Small, Name, &mTestGuid1, FALSE, NULL), 0);
+  Offsets[1] = AppendVariable (&Small, Name, &mTestGuid1, VAR_ADDED);
+  UT_ASSERT_EQUAL (LookUp (&Small, Name, &mTestGuid1, FALSE, NULL), Offsets[1]);
+
+  FreePool (Large.Store);
+  FreeStore (&Small);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports the cycles per lookup with and without the index as the variable
+  store grows. Each store is filled to three quarters of its size.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  StoreSizes[] = { SIZE_16KB, SIZE_64KB, SIZE_256KB, SIZE_1MB };
+  TEST_STORE          TestStore;
+  CHAR16              Name[TEST_NAME_LENGTH + 1];
+  UINTN               SizeIndex;
+  UINTN               Count;
+  UINTN               Index;
+  UINTN               Offset;
+  UINT64              Start;
+  UINT64              IndexedCycles;
+  UINT64              LinearCycles;
+
+  for (SizeIndex = 0; SizeIndex < ARRAY_SIZE (StoreSizes); SizeIndex++) {
+    UT_ASSERT_TRUE (CreateStore (&TestStore, StoreSizes[SizeIndex]));
+    for (Count = 0; TestStore.LastOffset < (StoreSizes[SizeIndex] / 4) * 3; Count++) {
+      BuildVariableName (Name, Count);
+      AppendVariable (&TestStore, Name, &mTestGuid1, VAR_ADDED);
+    }
+
+    //
+    // The first lookup builds the index.
+    //
+    BuildVariableName (Name, 0);
+    UT_ASSERT_NOT_EQUAL (LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL), 0);
+
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      BuildVariableName (Name, (Index * 7919) % Count);
+      Offset = LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL);
+      ASSERT (Offset != 0);
+    }
+
+    IndexedCycles = AsmReadTsc () - Start;
+
+    VariableStoreIndexUnregister (VariableStoreTypeVolatile);
+    Start = AsmReadTsc ();
+    for (Index = 0; Index < BENCHMARK_LOOKUPS; Index++) {
+      BuildVariableName (Name, (Index * 7919) % Count);
+      Offset = LookUp (&TestStore, Name, &mTestGuid1, FALSE, NULL);
+      ASSERT (Offset != 0);
+    }
+
+    LinearCycles = AsmReadTsc () - Start;
+
+    UT_LOG_INFO (
+      "%u KB store, %u variables: %Lu cycles per indexed lookup, %Lu per walk\n",
+      (UINT32)(StoreSizes[SizeIndex] / SIZE_1KB),
+      (UINT32)Count,
+      DivU64x32 (IndexedCycles, BENCHMARK_LOOKUPS),
+      DivU64x32 (LinearCycles, BENCHMARK_LOOKUPS)
+      );
+
+    FreeStore (&TestStore);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Main entry point to the unit test.
+
+  @retval EFI_SUCCESS       The unit test ran.
+  @retval Others            The unit test framework could not be set up.
+
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexTests;
+  UNIT_TEST_SUITE_HANDLE      BenchmarkTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&IndexTests, Framework, "Variable Store Index Tests", "VariableIndex", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the variable store index tests.\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (IndexTests, "The first added copy is returned", "FirstAddedCopy", IndexReturnsFirstAddedCopy, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "The last copy in deleted transition is returned", "LastInDeletedTransition", IndexReturnsLastInDeletedTransition, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "A full index falls back to a walk", "IndexFull", IndexFullFallsBackToWalk, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Indexing stops at a variable being written", "VariableBeingWritten", IndexStopsAtVariableBeingWritten, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Indexing stops at a malformed name", "MalformedName", IndexStopsAtMalformedName, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Runtime access is honored", "RuntimeAccess", IndexHonorsRuntimeAccess, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Reclaimed variables are found", "Reclaim", IndexFollowsReclaim, NULL, NULL, NULL);
+  AddTestCase (IndexTests, "Bucket arrays are reused", "ReuseBuckets", IndexReusesBuckets, NULL, NULL, NULL);
+
+  //
+  // The benchmark is only run on request, with --benchmark.
+  //
+  if (mRunBenchmark) {
+    Status = CreateUnitTestSuite (&BenchmarkTests, Framework, "Variable Store Index Benchmark", "VariableIndexBenchmark", NULL, NULL);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the variable store index benchmark.\n"));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto EXIT;
+    }
+
+    AddTestCase (BenchmarkTests, "Cycles per lookup vs. store size", "Benchmark", IndexBenchmark, NULL, NULL, NULL);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define Main  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+Main (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  mRunBenchmark = (BOOLEAN)((Argc > 1) && (AsciiStrCmp (Argv[1], "--benchmark") == 0));
+  return UnitTestingEntry ();
+}
@@ -28,6 +28,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "Variable.h"
 #include "VariableNonVolatile.h"
 #include "VariableParsing.h"
+#include "VariableIndex.h"
 #include "VariableRuntimeCache.h"
 
 VARIABLE_MODULE_GLOBAL  *mVariableModuleGlobal;
@@ -405,15 +406,17 @@ InitializeVarErrorFlag (
 /**
   Is user variable?
 
-  @param[in] Variable   Pointer to variable header.
+  @param[in] VariableName   Name of the variable.
+  @param[in] VendorGuid     Guid of the variable.
 
   @retval TRUE          User variable.
   @retval FALSE         System variable.
 
 **/
 BOOLEAN
-IsUserVariable (
-  IN VARIABLE_HEADER  *Variable
+IsUserVariableName (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
   )
 {
   VAR_CHECK_VARIABLE_PROPERTY  Property;
@@ -424,12 +427,7 @@ IsUserVariable (
   // then no need to check if the variable is user variable or not specially.
   //
   if (mEndOfDxe && (mVariableModuleGlobal->CommonMaxUserVariableSpace != mVariableModuleGlobal->CommonVariableSpace)) {
-    if (VarCheckLibVariablePropertyGet (
-          GetVariableNamePtr (Variable, mVariableModuleGlobal->VariableGlobal.AuthFormat),
-          GetVendorGuidPtr (Variable, mVariableModuleGlobal->VariableGlobal.AuthFormat),
-          &Property
-          ) == EFI_NOT_FOUND)
-    {
+    if (VarCheckLibVariablePropertyGet (VariableName, VendorGuid, &Property) == EFI_NOT_FOUND) {
       return TRUE;
     }
   }
@@ -437,6 +435,26 @@ IsUserVariable (
   return FALSE;
 }
 
+/**
+  Is user variable?
+
+  @param[in] Variable   Pointer to variable header.
+
+  @retval TRUE          User variable.
+  @retval FALSE         System variable.
+
+**/
+BOOLEAN
+IsUserVariable (
+  IN VARIABLE_HEADER  *Variable
+  )
+{
+  return IsUserVariableName (
+           GetVariableNamePtr (Variable, mVariableModuleGlobal->VariableGlobal.AuthFormat),
+           GetVendorGuidPtr (Variable, mVariableModuleGlobal->VariableGlobal.AuthFormat)
+           );
+}
+
 /**
   Calculate common user variable total size.
 
@@ -545,6 +563,20 @@ Reclaim (
   VARIABLE_HEADER        *UpdatingVariable;
   VARIABLE_HEADER        *UpdatingInDeletedTransition;
   BOOLEAN                AuthFormat;
+  UINTN                  WrittenSize;
+  BOOLEAN                MeasureStall;
+  UINT64                 StartTick;
+  UINT64                 Stall;
+
+  //
+  // The stall is only timed on platforms that enable performance measurement,
+  // which need a working TimerLib for it. Others may map the null TimerLib.
+  //
+  MeasureStall = PerformanceMeasurementEnabled ();
+  StartTick    = 0;
+  if (MeasureStall) {
+    StartTick = GetPerformanceCounter ();
+  }
 
   AuthFormat                  = mVariableModuleGlobal->VariableGlobal.AuthFormat;
   UpdatingVariable            = NULL;
@@ -756,17 +788,46 @@ Reclaim (
     Status = EFI_SUCCESS;
   } else {
     //
-    // If non-volatile variable store, perform FTW here.
+    // If non-volatile variable store, perform FTW here. The performance
+    // protocol is gone at OS runtime, so the reclaim is only measured before.
     //
+    if (!AtRuntime ()) {
+      PERF_INMODULE_BEGIN ("VariableReclaim");
+    }
+
     Status = FtwVariableSpace (
                VariableBase,
-               (VARIABLE_STORE_HEADER *)ValidBuffer
+               (VARIABLE_STORE_HEADER *)ValidBuffer,
+               &WrittenSize
                );
+    if (!AtRuntime ()) {
+      PERF_INMODULE_END ("VariableReclaim");
+    }
+
     if (!EFI_ERROR (Status)) {
       *LastVariableOffset                                = (UINTN)CurrPtr - (UINTN)ValidBuffer;
       mVariableModuleGlobal->HwErrVariableTotalSize      = HwErrVariableTotalSize;
       mVariableModuleGlobal->CommonVariableTotalSize     = CommonVariableTotalSize;
       mVariableModuleGlobal->CommonUserVariableTotalSize = CommonUserVariableTotalSize;
+
+      Stall = 0;
+      if (MeasureStall) {
+        Stall = GetTimeInNanoSecond (GetPerformanceCounter () - StartTick);
+      }
+
+      mVariableModuleGlobal->NvReclaimCount        += 1;
+      mVariableModuleGlobal->NvReclaimBytesWritten += WrittenSize;
+      mVariableModuleGlobal->NvReclaimMaxStall      = MAX (mVariableModuleGlobal->NvReclaimMaxStall, Stall);
+      DEBUG ((
+        DEBUG_INFO,
+        "Variable driver: NV reclaim %Lu wrote 0x%x of 0x%x bytes in %Lu us (total 0x%Lx bytes, worst %Lu us)\n",
+        mVariableModuleGlobal->NvReclaimCount,
+        WrittenSize,
+        VariableStoreHeader->Size,
+        DivU64x32 (Stall, 1000),
+        mVariableModuleGlobal->NvReclaimBytesWritten,
+        DivU64x32 (mVariableModuleGlobal->NvReclaimMaxStall, 1000)
+        ));
     } else {
       mVariableModuleGlobal->HwErrVariableTotalSize      = 0;
       mVariableModuleGlobal->CommonVariableTotalSize     = 0;
@@ -793,7 +854,9 @@ Reclaim (
 
 Done:
   DoneStatus = EFI_SUCCESS;
+  mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.PendingReclaim = TRUE;
   if (IsVolatile || mVariableModuleGlobal->VariableGlobal.EmuNvMode) {
+    VariableStoreIndexInvalidate (VariableStoreHeader);
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeVolatileCache,
                    0,
@@ -806,6 +869,7 @@ Done:
     // For NV variable reclaim, we use mNvVariableCache as the buffer, so copy the data back.
     //
     CopyMem (mNvVariableCache, (UINT8 *)(UINTN)VariableBase, VariableStoreHeader->Size);
+    VariableStoreIndexInvalidate (mNvVariableCache);
     DoneStatus = SynchronizeRuntimeVariableCache (
                    &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext.VariableRuntimeNvCache,
                    0,
@@ -3258,6 +3322,54 @@ ReclaimForOS (
   }
 }
 
+/**
+  This function reclaims variable storage once ahead of a batch of variable
+  updates if the free space cannot hold all the non-volatile variables of the
+  batch. Without it, each update that runs out of space would reclaim again.
+
+  Caution: This function may be invoked at SMM mode.
+  Care must be taken to make sure not security issue.
+
+  @param[in] CommonVariableSize     Total size of the common variables to be written.
+  @param[in] CommonUserVariableSize Total size of the common user variables to be written,
+                                    included in CommonVariableSize.
+  @param[in] HwErrVariableSize      Total size of the hardware error record variables to be written.
+
+**/
+VOID
+ReclaimForBatchUpdate (
+  IN UINTN  CommonVariableSize,
+  IN UINTN  CommonUserVariableSize,
+  IN UINTN  HwErrVariableSize
+  )
+{
+  EFI_STATUS  Status;
+
+  //
+  // Reclaim is not allowed at runtime, the updates fail as they would one by one.
+  //
+  if (AtRuntime ()) {
+    return;
+  }
+
+  if ((CommonVariableSize + mVariableModuleGlobal->CommonVariableTotalSize > mVariableModuleGlobal->CommonVariableSpace) ||
+      (CommonUserVariableSize + mVariableModuleGlobal->CommonUserVariableTotalSize > mVariableModuleGlobal->CommonMaxUserVariableSpace) ||
+      (HwErrVariableSize + mVariableModuleGlobal->HwErrVariableTotalSize > PcdGet32 (PcdHwErrStorageSize)))
+  {
+    Status = Reclaim (
+               mVariableModuleGlobal->VariableGlobal.NonVolatileVariableBase,
+               &mVariableModuleGlobal->NonVolatileLastVariableOffset,
+               FALSE,
+               NULL,
+               NULL,
+               0
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: Reclaim - %r\n", __func__, Status));
+    }
+  }
+}
+
 /**
   Get maximum variable size, covering both non-volatile and volatile variables.
 
@@ -3316,6 +3428,7 @@ FlushHobVariableToFlash (
     // Set HobVariableBase to 0, it can avoid SetVariable to call back.
     //
     mVariableModuleGlobal->VariableGlobal.HobVariableBase = 0;
+    VariableStoreIndexUnregister (VariableStoreTypeHob);
     for ( Variable = GetStartPointer (VariableStoreHeader)
           ; IsValidVariableHeader (Variable, GetEndPointer (VariableStoreHeader))
           ; Variable = GetNextVariablePtr (Variable, AuthFormat)
@@ -3399,6 +3512,7 @@ FlushHobVariableToFlash (
       // We still have HOB variable(s) not flushed in flash.
       //
       mVariableModuleGlobal->VariableGlobal.HobVariableBase = (EFI_PHYSICAL_ADDRESS)(UINTN)VariableStoreHeader;
+      VariableStoreIndexRegister (VariableStoreTypeHob, VariableStoreHeader);
     } else {
       //
       // All HOB variables have been flushed in flash.
@@ -3807,6 +3921,16 @@ VariableCommonInitialize (
   VolatileVariableStore->Reserved  = 0;
   VolatileVariableStore->Reserved1 = 0;
 
+  //
+  // Index the variable stores to speed up variable lookup. A store that could
+  // not be indexed is still searched by walking through it.
+  //
+  VariableStoreIndexRegister (VariableStoreTypeVolatile, VolatileVariableStore);
+  VariableStoreIndexRegister (VariableStoreTypeNv, mNvVariableCache);
+  if (mVariableModuleGlobal->VariableGlobal.HobVariableBase != 0) {
+    VariableStoreIndexRegister (VariableStoreTypeHob, (VARIABLE_STORE_HEADER *)(UINTN)mVariableModuleGlobal->VariableGlobal.HobVariableBase);
+  }
+
   return EFI_SUCCESS;
 }
 
@@ -28,6 +28,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/BaseLib.h>
 #include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PerformanceLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/AuthVariableLib.h>
 #include <Library/VarCheckLib.h>
@@ -72,6 +74,11 @@ typedef struct {
   BOOLEAN                   *ReadLock;
   BOOLEAN                   *PendingUpdate;
   BOOLEAN                   *HobFlushComplete;
+  UINT32                    *ReclaimCount;
+  //
+  // TRUE if a variable store was reclaimed since the last flush of the runtime caches.
+  //
+  BOOLEAN                   PendingReclaim;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeHobCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeNvCache;
   VARIABLE_RUNTIME_CACHE    VariableRuntimeVolatileCache;
@@ -122,6 +129,15 @@ typedef struct {
   CHAR8                                 *PlatformLang;
   CHAR8                                 Lang[ISO_639_2_ENTRY_SIZE + 1];
   EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL    *FvbInstance;
+  ///
+  /// Statistics of the non-volatile variable store reclaims: the number of
+  /// reclaims, the total bytes written to the flash, and the longest time
+  /// a reclaim took in nanoseconds. The time is only measured when
+  /// performance measurement is enabled, and stays 0 otherwise.
+  ///
+  UINT64                                NvReclaimCount;
+  UINT64                                NvReclaimBytesWritten;
+  UINT64                                NvReclaimMaxStall;
 } VARIABLE_MODULE_GLOBAL;
 
 /**
@@ -142,10 +158,13 @@ FlushHobVariableToFlash (
 
   This function writes a buffer to variable storage space into a firmware
   volume block device. The destination is specified by the parameter
-  VariableBase. Fault Tolerant Write protocol is used for writing.
+  VariableBase. Fault Tolerant Write protocol is used for writing. Only
+  the span of flash blocks that differ from the buffer is written.
 
   @param  VariableBase   Base address of the variable to write.
   @param  VariableBuffer Point to the variable data buffer.
+  @param  WrittenSize    Optional pointer to return the number of bytes
+                         written to the flash.
 
   @retval EFI_SUCCESS    The function completed successfully.
   @retval EFI_NOT_FOUND  Fail to locate Fault Tolerant Write protocol.
@@ -154,8 +173,9 @@ FlushHobVariableToFlash (
 **/
 EFI_STATUS
 FtwVariableSpace (
-  IN EFI_PHYSICAL_ADDRESS   VariableBase,
-  IN VARIABLE_STORE_HEADER  *VariableBuffer
+  IN  EFI_PHYSICAL_ADDRESS   VariableBase,
+  IN  VARIABLE_STORE_HEADER  *VariableBuffer,
+  OUT UINTN                  *WrittenSize OPTIONAL
   );
 
 /**
@@ -378,6 +398,40 @@ ReclaimForOS (
   VOID
   );
 
+/**
+  Is user variable?
+
+  @param[in] VariableName   Name of the variable.
+  @param[in] VendorGuid     Guid of the variable.
+
+  @retval TRUE          User variable.
+  @retval FALSE         System variable.
+
+**/
+BOOLEAN
+IsUserVariableName (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid
+  );
+
+/**
+  This function reclaims variable storage once ahead of a batch of variable
+  updates if the free space cannot hold all the non-volatile variables of the
+  batch.
+
+  @param[in] CommonVariableSize     Total size of the common variables to be written.
+  @param[in] CommonUserVariableSize Total size of the common user variables to be written,
+                                    included in CommonVariableSize.
+  @param[in] HwErrVariableSize      Total size of the hardware error record variables to be written.
+
+**/
+VOID
+ReclaimForBatchUpdate (
+  IN UINTN  CommonVariableSize,
+  IN UINTN  CommonUserVariableSize,
+  IN UINTN  HwErrVariableSize
+  );
+
 /**
   Get maximum variable size, covering both non-volatile and volatile variables.
 
@@ -0,0 +1,386 @@
+/** @file
+  Hash index over the variable stores.
+
+  Variables are only ever appended to a variable store and their state only
+  ever moves from added to deleted, until the store is reclaimed. The index
+  takes advantage of that: it maps the (name, GUID) hash of every variable up
+  to IndexedEnd to the offset of its header, is extended over the variables
+  appended since the last lookup, and checks the state of the variables it
+  finds. Only a reclaim, which moves variables, needs the index to be rebuilt.
+
+  Caution: This module requires additional review when modified.
+  This driver will have external input - variable data.
+  This external input must be validated carefully to avoid security issue like
+  buffer overflow, integer overflow.
+
+Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "VariableParsing.h"
+#include "VariableIndex.h"
+
+#define VARIABLE_INDEX_FNV_OFFSET_BASIS  0x811C9DC5
+#define VARIABLE_INDEX_FNV_PRIME         0x01000193
+#define VARIABLE_INDEX_MIN_BUCKET_COUNT  16
+
+VARIABLE_STORE_INDEX  mVariableStoreIndex[VariableStoreTypeMax];
+
+/**
+  Computes the FNV-1a hash of a variable name and vendor GUID.
+
+  @param[in] VariableName  Pointer to the variable name.
+  @param[in] NameLength    Length of the variable name in characters, without
+                           the terminating null character.
+  @param[in] VendorGuid    Pointer to the vendor GUID.
+
+  @return The hash value.
+
+**/
+STATIC
+UINT32
+VariableIndexHash (
+  IN CONST CHAR16    *VariableName,
+  IN UINTN           NameLength,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  CONST UINT8  *Bytes;
+  UINTN        Index;
+  UINT32       Hash;
+
+  Hash  = VARIABLE_INDEX_FNV_OFFSET_BASIS;
+  Bytes = (CONST UINT8 *)VariableName;
+  for (Index = 0; Index < NameLength * sizeof (CHAR16); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * VARIABLE_INDEX_FNV_PRIME;
+  }
+
+  Bytes = (CONST UINT8 *)VendorGuid;
+  for (Index = 0; Index < sizeof (EFI_GUID); Index++) {
+    Hash = (Hash ^ Bytes[Index]) * VARIABLE_INDEX_FNV_PRIME;
+  }
+
+  return Hash;
+}
+
+/**
+  Empties an index and makes it cover nothing of its store.
+
+  @param[in, out] StoreIndex  Pointer to the index.
+  @param[in]      AuthFormat  TRUE indicates authenticated variables are used.
+                              FALSE indicates authenticated variables are not used.
+
+**/
+STATIC
+VOID
+VariableIndexReset (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     BOOLEAN               AuthFormat
+  )
+{
+  ZeroMem (StoreIndex->Buckets, StoreIndex->BucketCount * sizeof (UINT32));
+  StoreIndex->EntryCount = 0;
+  StoreIndex->IndexedEnd = (UINT32)((UINTN)GetStartPointer (StoreIndex->Store) - (UINTN)StoreIndex->Store);
+  StoreIndex->AuthFormat = AuthFormat;
+}
+
+/**
+  Extends an index over the variables found after IndexedEnd.
+
+  Indexing stops before a variable whose header or data may still be written,
+  before a variable whose name is not a well formed string, and when the
+  index is three quarters full. Lookups search the rest of the store linearly,
+  so that the result is the same as with a full linear walk.
+
+  @param[in, out] StoreIndex  Pointer to the index.
+  @param[in]      EndPtr      End of the variable store.
+
+**/
+STATIC
+VOID
+VariableIndexExtend (
+  IN OUT VARIABLE_STORE_INDEX  *StoreIndex,
+  IN     VARIABLE_HEADER       *EndPtr
+  )
+{
+  VARIABLE_HEADER  *Variable;
+  CHAR16           *Name;
+  UINTN            NameSize;
+  UINT32           Bucket;
+  UINT32           Mask;
+
+  Mask     = StoreIndex->BucketCount - 1;
+  Variable = (VARIABLE_HEADER *)((UINTN)StoreIndex->Store + StoreIndex->IndexedEnd);
+
+  while (IsValidVariableHeader (Variable, EndPtr)) {
+    //
+    // A deleted variable never comes back and is left out of the index.
+    //
+    if ((Variable->State | VAR_DELETED) != VAR_DELETED) {
+      //
+      // Only index the states FindVariableEx () looks at, as any other state
+      // may still change to VAR_ADDED.
+      //
+      if ((Variable->State != VAR_ADDED) &&
+          (Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)))
+      {
+        break;
+      }
+
+      if (StoreIndex->EntryCount >= (StoreIndex->BucketCount / 4) * 3) {
+        break;
+      }
+
+      NameSize = NameSizeOfVariable (Variable, StoreIndex->AuthFormat);
+      Name     = GetVariableNamePtr (Variable, StoreIndex->AuthFormat);
+      if ((NameSize < sizeof (CHAR16)) ||
+          ((NameSize % sizeof (CHAR16)) != 0) ||
+          (NameSize > (UINTN)EndPtr - (UINTN)Name) ||
+          (StrnLenS (Name, NameSize / sizeof (CHAR16)) != NameSize / sizeof (CHAR16) - 1))
+      {
+        break;
+      }
+
+      Bucket = VariableIndexHash (
+                 Name,
+                 NameSize / sizeof (CHAR16) - 1,
+                 GetVendorGuidPtr (Variable, StoreIndex->AuthFormat)
+                 ) & Mask;
+      while (StoreIndex->Buckets[Bucket] != 0) {
+        Bucket = (Bucket + 1) & Mask;
+      }
+
+      StoreIndex->Buckets[Bucket] = (UINT32)((UINTN)Variable - (UINTN)StoreIndex->Store);
+      StoreIndex->EntryCount++;
+    }
+
+    Variable               = GetNextVariablePtr (Variable, StoreIndex->AuthFormat);
+    StoreIndex->IndexedEnd = (UINT32)((UINTN)Variable - (UINTN)StoreIndex->Store);
+  }
+}
+
+/**
+  Registers a variable store to be indexed.
+
+  The bucket array is sized from the store size so that it is never allocated
+  again once the store is registered. The index content is built on the first
+  lookup in the store.
+
+  @param[in] Type          Type of the variable store.
+  @param[in] Store         Pointer to the variable store header.
+
+  @retval EFI_SUCCESS            The store was registered.
+  @retval EFI_INVALID_PARAMETER  Type or Store is invalid.
+  @retval EFI_OUT_OF_RESOURCES   The bucket array could not be allocated.
+
+**/
+EFI_STATUS
+VariableStoreIndexRegister (
+  IN VARIABLE_STORE_TYPE    Type,
+  IN VARIABLE_STORE_HEADER  *Store
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  UINT32                BucketCount;
+
+  if ((Type >= VariableStoreTypeMax) || (Store == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // No variable is smaller than a variable header, so that many buckets leave
+  // room for every variable of the store with typical variable sizes.
+  //
+  BucketCount = MAX (GetPowerOfTwo32 (Store->Size / sizeof (VARIABLE_HEADER)), VARIABLE_INDEX_MIN_BUCKET_COUNT);
+
+  StoreIndex = &mVariableStoreIndex[Type];
+  if ((StoreIndex->Buckets == NULL) || (StoreIndex->BucketCount < BucketCount)) {
+    if (StoreIndex->Buckets != NULL) {
+      FreePool (StoreIndex->Buckets);
+    }
+
+    StoreIndex->Store   = NULL;
+    StoreIndex->Buckets = AllocateRuntimePool (BucketCount * sizeof (UINT32));
+    if (StoreIndex->Buckets == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    StoreIndex->BucketCount = BucketCount;
+  }
+
+  StoreIndex->Store      = Store;
+  StoreIndex->IndexedEnd = 0;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Stops indexing a variable store. The bucket array is kept so that it can be
+  reused if the store type is registered again.
+
+  @param[in] Type          Type of the variable store.
+
+**/
+VOID
+VariableStoreIndexUnregister (
+  IN VARIABLE_STORE_TYPE  Type
+  )
+{
+  if (Type < VariableStoreTypeMax) {
+    mVariableStoreIndex[Type].Store      = NULL;
+    mVariableStoreIndex[Type].IndexedEnd = 0;
+  }
+}
+
+/**
+  Discards the content of the index over a variable store.
+
+  This must be called whenever variables are moved inside the store, such as
+  after a reclaim. Appending variables and changing variable states does not
+  need it.
+
+  @param[in] Store         Pointer to the variable store header, or NULL to
+                           discard the content of all indexes.
+
+**/
+VOID
+VariableStoreIndexInvalidate (
+  IN VARIABLE_STORE_HEADER  *Store OPTIONAL
+  )
+{
+  VARIABLE_STORE_TYPE  Type;
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    if ((Store == NULL) || (mVariableStoreIndex[Type].Store == Store)) {
+      mVariableStoreIndex[Type].IndexedEnd = 0;
+    }
+  }
+}
+
+/**
+  Looks a variable up in the index over the range of PtrTrack.
+
+  Only the indexed part of the store is searched. On EFI_NOT_FOUND, the caller
+  must continue the search linearly from ResumePtr, carrying InDeletedVariable
+  over, to get the exact result of a full linear walk.
+
+  @param[in]       VariableName       Name of the variable to be found, must not be empty.
+  @param[in]       VendorGuid         Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck      Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                      check at runtime when searching variable.
+  @param[in, out]  PtrTrack           Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat         TRUE indicates authenticated variables are used.
+                                      FALSE indicates authenticated variables are not used.
+  @param[out]      InDeletedVariable  The IN_DELETED_TRANSITION variable found in the indexed part, if any.
+  @param[out]      ResumePtr          Where the linear search must resume.
+
+  @retval EFI_SUCCESS      An added variable was found, PtrTrack is updated.
+  @retval EFI_NOT_FOUND    No added variable is in the indexed part of the store,
+                           or the range of PtrTrack is not indexed.
+
+**/
+EFI_STATUS
+VariableStoreIndexFind (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat,
+  OUT    VARIABLE_HEADER         **InDeletedVariable,
+  OUT    VARIABLE_HEADER         **ResumePtr
+  )
+{
+  VARIABLE_STORE_INDEX  *StoreIndex;
+  VARIABLE_STORE_TYPE   Type;
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *AddedVariable;
+  VARIABLE_HEADER       *DeletingVariable;
+  UINTN                 NameLength;
+  UINT32                Hash;
+  UINT32                Bucket;
+  UINT32                Mask;
+  UINTN                 Pass;
+
+  *InDeletedVariable = NULL;
+  *ResumePtr         = PtrTrack->StartPtr;
+
+  StoreIndex = NULL;
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    if ((mVariableStoreIndex[Type].Store != NULL) &&
+        (GetStartPointer (mVariableStoreIndex[Type].Store) == PtrTrack->StartPtr) &&
+        (GetEndPointer (mVariableStoreIndex[Type].Store) == PtrTrack->EndPtr))
+    {
+      StoreIndex = &mVariableStoreIndex[Type];
+      break;
+    }
+  }
+
+  if (StoreIndex == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((StoreIndex->IndexedEnd == 0) || (StoreIndex->AuthFormat != AuthFormat)) {
+    VariableIndexReset (StoreIndex, AuthFormat);
+  }
+
+  VariableIndexExtend (StoreIndex, PtrTrack->EndPtr);
+
+  NameLength = StrLen (VariableName);
+  Hash       = VariableIndexHash (VariableName, NameLength, VendorGuid);
+  Mask       = StoreIndex->BucketCount - 1;
+
+  //
+  // FindVariableEx () returns the first added variable of the store, along with
+  // the last variable in deleted transition found before it. The first pass
+  // finds the added variable, the second the variable in deleted transition.
+  //
+  AddedVariable    = NULL;
+  DeletingVariable = NULL;
+  for (Pass = 0; Pass < 2; Pass++) {
+    for (Bucket = Hash & Mask; StoreIndex->Buckets[Bucket] != 0; Bucket = (Bucket + 1) & Mask) {
+      Variable = (VARIABLE_HEADER *)((UINTN)StoreIndex->Store + StoreIndex->Buckets[Bucket]);
+      if (Pass == 0) {
+        if ((Variable->State != VAR_ADDED) ||
+            ((AddedVariable != NULL) && (Variable > AddedVariable)))
+        {
+          continue;
+        }
+      } else {
+        if ((Variable->State != (VAR_IN_DELETED_TRANSITION & VAR_ADDED)) ||
+            ((AddedVariable != NULL) && (Variable > AddedVariable)) ||
+            ((DeletingVariable != NULL) && (Variable < DeletingVariable)))
+        {
+          continue;
+        }
+      }
+
+      if (!IgnoreRtCheck && AtRuntime () && ((Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS) == 0)) {
+        continue;
+      }
+
+      if ((NameSizeOfVariable (Variable, AuthFormat) != (NameLength + 1) * sizeof (CHAR16)) ||
+          !CompareGuid (VendorGuid, GetVendorGuidPtr (Variable, AuthFormat)) ||
+          (CompareMem (VariableName, GetVariableNamePtr (Variable, AuthFormat), NameLength * sizeof (CHAR16)) != 0))
+      {
+        continue;
+      }
+
+      if (Pass == 0) {
+        AddedVariable = Variable;
+      } else {
+        DeletingVariable = Variable;
+      }
+    }
+  }
+
+  if (AddedVariable != NULL) {
+    PtrTrack->CurrPtr                = AddedVariable;
+    PtrTrack->InDeletedTransitionPtr = DeletingVariable;
+    return EFI_SUCCESS;
+  }
+
+  *InDeletedVariable = DeletingVariable;
+  *ResumePtr         = (VARIABLE_HEADER *)((UINTN)StoreIndex->Store + StoreIndex->IndexedEnd);
+  return EFI_NOT_FOUND;
+}
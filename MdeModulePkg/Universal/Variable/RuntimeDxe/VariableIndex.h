@@ -0,0 +1,124 @@
+/** @file
+  The hash index kept over a variable store to speed up variable lookup. The
+  index is shared by the DXE_RUNTIME variable module, the SMM variable module
+  and the runtime cache of the SMM variable DXE module.
+
+Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _VARIABLE_INDEX_H_
+#define _VARIABLE_INDEX_H_
+
+#include "Variable.h"
+
+typedef struct {
+  ///
+  /// The variable store covered by this index, NULL if the slot is unused.
+  ///
+  VARIABLE_STORE_HEADER    *Store;
+  ///
+  /// Open addressing hash table. Each non-zero bucket holds the offset of a
+  /// variable header from the start of Store.
+  ///
+  UINT32                   *Buckets;
+  UINT32                   BucketCount;
+  UINT32                   EntryCount;
+  ///
+  /// Offset from the start of Store where indexing stopped. Variables from
+  /// this offset on are not in the index and are searched linearly.
+  ///
+  UINT32                   IndexedEnd;
+  BOOLEAN                  AuthFormat;
+} VARIABLE_STORE_INDEX;
+
+///
+/// One index per variable store type. The pointers in here must be converted
+/// on virtual address change by the modules that register runtime stores.
+///
+extern VARIABLE_STORE_INDEX  mVariableStoreIndex[VariableStoreTypeMax];
+
+/**
+  Registers a variable store to be indexed.
+
+  The bucket array is sized from the store size so that it is never allocated
+  again once the store is registered. The index content is built on the first
+  lookup in the store.
+
+  @param[in] Type          Type of the variable store.
+  @param[in] Store         Pointer to the variable store header.
+
+  @retval EFI_SUCCESS            The store was registered.
+  @retval EFI_INVALID_PARAMETER  Type or Store is invalid.
+  @retval EFI_OUT_OF_RESOURCES   The bucket array could not be allocated.
+
+**/
+EFI_STATUS
+VariableStoreIndexRegister (
+  IN VARIABLE_STORE_TYPE    Type,
+  IN VARIABLE_STORE_HEADER  *Store
+  );
+
+/**
+  Stops indexing a variable store. The bucket array is kept so that it can be
+  reused if the store type is registered again.
+
+  @param[in] Type          Type of the variable store.
+
+**/
+VOID
+VariableStoreIndexUnregister (
+  IN VARIABLE_STORE_TYPE  Type
+  );
+
+/**
+  Discards the content of the index over a variable store.
+
+  This must be called whenever variables are moved inside the store, such as
+  after a reclaim. Appending variables and changing variable states does not
+  need it.
+
+  @param[in] Store         Pointer to the variable store header, or NULL to
+                           discard the content of all indexes.
+
+**/
+VOID
+VariableStoreIndexInvalidate (
+  IN VARIABLE_STORE_HEADER  *Store OPTIONAL
+  );
+
+/**
+  Looks a variable up in the index over the range of PtrTrack.
+
+  Only the indexed part of the store is searched. On EFI_NOT_FOUND, the caller
+  must continue the search linearly from ResumePtr, carrying InDeletedVariable
+  over, to get the exact result of a full linear walk.
+
+  @param[in]       VariableName       Name of the variable to be found, must not be empty.
+  @param[in]       VendorGuid         Vendor GUID to be found.
+  @param[in]       IgnoreRtCheck      Ignore EFI_VARIABLE_RUNTIME_ACCESS attribute
+                                      check at runtime when searching variable.
+  @param[in, out]  PtrTrack           Variable Track Pointer structure that contains Variable Information.
+  @param[in]       AuthFormat         TRUE indicates authenticated variables are used.
+                                      FALSE indicates authenticated variables are not used.
+  @param[out]      InDeletedVariable  The IN_DELETED_TRANSITION variable found in the indexed part, if any.
+  @param[out]      ResumePtr          Where the linear search must resume.
+
+  @retval EFI_SUCCESS      An added variable was found, PtrTrack is updated.
+  @retval EFI_NOT_FOUND    No added variable is in the indexed part of the store,
+                           or the range of PtrTrack is not indexed.
+
+**/
+EFI_STATUS
+VariableStoreIndexFind (
+  IN     CHAR16                  *VariableName,
+  IN     EFI_GUID                *VendorGuid,
+  IN     BOOLEAN                 IgnoreRtCheck,
+  IN OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN     BOOLEAN                 AuthFormat,
+  OUT    VARIABLE_HEADER         **InDeletedVariable,
+  OUT    VARIABLE_HEADER         **ResumePtr
+  );
+
+#endif
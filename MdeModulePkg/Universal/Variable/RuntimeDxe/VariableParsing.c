@@ -8,6 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
 #include "VariableParsing.h"
+#include "VariableIndex.h"
 
 /**
 
@@ -469,16 +470,27 @@ FindVariableEx (
   )
 {
   VARIABLE_HEADER  *InDeletedVariable;
+  VARIABLE_HEADER  *StartPtr;
   VOID             *Point;
 
   PtrTrack->InDeletedTransitionPtr = NULL;
 
   //
-  // Find the variable by walk through HOB, volatile and non-volatile variable store.
+  // Look the variable up in the index of the variable store first, if any.
+  // The part of the store the index does not cover is walked through below.
   //
   InDeletedVariable = NULL;
+  StartPtr          = PtrTrack->StartPtr;
+  if (VariableName[0] != 0) {
+    if (!EFI_ERROR (VariableStoreIndexFind (VariableName, VendorGuid, IgnoreRtCheck, PtrTrack, AuthFormat, &InDeletedVariable, &StartPtr))) {
+      return EFI_SUCCESS;
+    }
+  }
 
-  for ( PtrTrack->CurrPtr = PtrTrack->StartPtr
+  //
+  // Find the variable by walk through HOB, volatile and non-volatile variable store.
+  //
+  for ( PtrTrack->CurrPtr = StartPtr
         ; IsValidVariableHeader (PtrTrack->CurrPtr, PtrTrack->EndPtr)
         ; PtrTrack->CurrPtr = GetNextVariablePtr (PtrTrack->CurrPtr, AuthFormat)
         )
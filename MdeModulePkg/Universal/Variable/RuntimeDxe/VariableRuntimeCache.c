@@ -87,7 +87,17 @@ FlushPendingRuntimeVariableCacheUpdates (
       );
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateLength = 0;
     VariableRuntimeCacheContext->VariableRuntimeVolatileCache.PendingUpdateOffset = 0;
-    *(VariableRuntimeCacheContext->PendingUpdate)                                 = FALSE;
+
+    //
+    // Variables moved inside the runtime caches, tell the runtime cache users
+    // to discard what they know about variable locations.
+    //
+    if (VariableRuntimeCacheContext->PendingReclaim && (VariableRuntimeCacheContext->ReclaimCount != NULL)) {
+      *(VariableRuntimeCacheContext->ReclaimCount) += 1;
+      VariableRuntimeCacheContext->PendingReclaim   = FALSE;
+    }
+
+    *(VariableRuntimeCacheContext->PendingUpdate) = FALSE;
   }
 
   return EFI_SUCCESS;
@@ -424,6 +424,119 @@ SmmVariableGetStatistics (
   return EFI_SUCCESS;
 }
 
+/**
+  Sets the variables of a SetVariable batch.
+
+  Caution: This function may receive untrusted input.
+  The batch is external input, so every entry is validated before any variable
+  of the batch is set.
+
+  @param[in]  Batch           Pointer to the batch, copied out of the communicate buffer.
+  @param[in]  BatchSize       Size of the batch in bytes.
+  @param[out] ProcessedCount  Number of entries set successfully.
+
+  @retval EFI_SUCCESS         All the entries were set.
+  @retval EFI_ACCESS_DENIED   The batch is malformed, no entry was set.
+  @retval Others              The status of the first entry that failed.
+
+**/
+EFI_STATUS
+SmmVariableSetVariableBatch (
+  IN  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *Batch,
+  IN  UINTN                                        BatchSize,
+  OUT UINTN                                        *ProcessedCount
+  )
+{
+  EFI_STATUS                                Status;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE  *Entry;
+  UINTN                                     EntryCount;
+  UINTN                                     Index;
+  UINTN                                     Offset;
+  UINTN                                     VarSize;
+  UINTN                                     CommonVariableSize;
+  UINTN                                     CommonUserVariableSize;
+  UINTN                                     HwErrVariableSize;
+
+  *ProcessedCount        = 0;
+  EntryCount             = Batch->EntryCount;
+  CommonVariableSize     = 0;
+  CommonUserVariableSize = 0;
+  HwErrVariableSize      = 0;
+
+  //
+  // Validate all the entries and sum up the space the non-volatile ones need.
+  //
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < EntryCount; Index++) {
+    if ((Offset > BatchSize) || (BatchSize - Offset < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name))) {
+      DEBUG ((DEBUG_ERROR, "SetVariableBatch: Entry %d exceeds communication buffer size limit!\n", Index));
+      return EFI_ACCESS_DENIED;
+    }
+
+    Entry = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *)((UINT8 *)Batch + Offset);
+    if ((Entry->NameSize > BatchSize - Offset - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) ||
+        (Entry->DataSize > BatchSize - Offset - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) - Entry->NameSize))
+    {
+      DEBUG ((DEBUG_ERROR, "SetVariableBatch: Entry %d exceeds communication buffer size limit!\n", Index));
+      return EFI_ACCESS_DENIED;
+    }
+
+    //
+    // The VariableSpeculationBarrier() call here is to ensure the previous
+    // range checks have been completed before the name is consumed.
+    //
+    VariableSpeculationBarrier ();
+    if ((Entry->NameSize < sizeof (CHAR16)) || (Entry->Name[Entry->NameSize/sizeof (CHAR16) - 1] != L'\0')) {
+      //
+      // Make sure VariableName is A Null-terminated string.
+      //
+      return EFI_ACCESS_DENIED;
+    }
+
+    if ((Entry->DataSize != 0) && ((Entry->Attributes & EFI_VARIABLE_NON_VOLATILE) != 0)) {
+      VarSize = GetVariableHeaderSize (mVariableModuleGlobal->VariableGlobal.AuthFormat) +
+                Entry->NameSize + GET_PAD_SIZE (Entry->NameSize) +
+                Entry->DataSize + GET_PAD_SIZE (Entry->DataSize);
+      if ((Entry->Attributes & EFI_VARIABLE_HARDWARE_ERROR_RECORD) != 0) {
+        HwErrVariableSize += HEADER_ALIGN (VarSize);
+      } else {
+        CommonVariableSize += HEADER_ALIGN (VarSize);
+        if (IsUserVariableName (Entry->Name, &Entry->Guid)) {
+          CommonUserVariableSize += HEADER_ALIGN (VarSize);
+        }
+      }
+    }
+
+    Offset += SMM_VARIABLE_BATCH_ENTRY_SIZE (Entry->NameSize, Entry->DataSize);
+  }
+
+  //
+  // Make room for the whole batch at once, then set the variables in order
+  // and stop at the first failure.
+  //
+  ReclaimForBatchUpdate (CommonVariableSize, CommonUserVariableSize, HwErrVariableSize);
+
+  Offset = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entry  = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *)((UINT8 *)Batch + Offset);
+    Status = VariableServiceSetVariable (
+               Entry->Name,
+               &Entry->Guid,
+               Entry->Attributes,
+               Entry->DataSize,
+               (UINT8 *)Entry->Name + Entry->NameSize
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    *ProcessedCount += 1;
+    Offset          += SMM_VARIABLE_BATCH_ENTRY_SIZE (Entry->NameSize, Entry->DataSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Communication service SMI Handler entry.
 
@@ -433,7 +546,8 @@ SmmVariableGetStatistics (
   This variable data and communicate buffer are external input, so this function will do basic validation.
   Each sub function VariableServiceGetVariable(), VariableServiceGetNextVariableName(),
   VariableServiceSetVariable(), VariableServiceQueryVariableInfo(), ReclaimForOS(),
-  SmmVariableGetStatistics() should also do validation based on its own knowledge.
+  SmmVariableGetStatistics(), SmmVariableSetVariableBatch() should also do validation
+  based on its own knowledge.
 
   @param[in]     DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
   @param[in]     RegisterContext Points to an optional handler context which was specified when the
@@ -469,6 +583,7 @@ SmmVariableHandler (
   SMM_VARIABLE_COMMUNICATE_GET_RUNTIME_CACHE_INFO          *GetRuntimeCacheInfo;
   SMM_VARIABLE_COMMUNICATE_LOCK_VARIABLE                   *VariableToLock;
   SMM_VARIABLE_COMMUNICATE_VAR_CHECK_VARIABLE_PROPERTY     *CommVariableProperty;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH              *SetVariableBatch;
   VARIABLE_INFO_ENTRY                                      *VariableInfo;
   VARIABLE_RUNTIME_CACHE_CONTEXT                           *VariableCacheContext;
   VARIABLE_STORE_HEADER                                    *VariableCache;
@@ -476,6 +591,7 @@ SmmVariableHandler (
   UINTN                                                    NameBufferSize;
   UINTN                                                    CommBufferPayloadSize;
   UINTN                                                    TempCommBufferSize;
+  UINTN                                                    ProcessedCount;
 
   //
   // If input is invalid, stop processing this SMI
@@ -665,6 +781,23 @@ SmmVariableHandler (
                  );
       break;
 
+    case SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH:
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH)) {
+        DEBUG ((DEBUG_ERROR, "SetVariableBatch: SMM communication buffer size invalid!\n"));
+        return EFI_SUCCESS;
+      }
+
+      //
+      // Copy the input communicate buffer payload to pre-allocated SMM variable buffer payload.
+      //
+      CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
+      SetVariableBatch = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *)mVariableBufferPayload;
+      Status           = SmmVariableSetVariableBatch (SetVariableBatch, CommBufferPayloadSize, &ProcessedCount);
+
+      SetVariableBatch                 = (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH *)SmmVariableFunctionHeader->Data;
+      SetVariableBatch->ProcessedCount = ProcessedCount;
+      break;
+
     case SMM_VARIABLE_FUNCTION_QUERY_VARIABLE_INFO:
       if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_QUERY_VARIABLE_INFO)) {
         DEBUG ((DEBUG_ERROR, "QueryVariableInfo: SMM communication buffer size invalid!\n"));
@@ -815,7 +948,7 @@ SmmVariableHandler (
       CopyMem (SmmVariableFunctionHeader->Data, mVariableBufferPayload, CommBufferPayloadSize);
       break;
     case SMM_VARIABLE_FUNCTION_INIT_RUNTIME_VARIABLE_CACHE_CONTEXT:
-      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+      if (CommBufferPayloadSize < OFFSET_OF (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT, ReclaimCount)) {
         DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: SMM communication buffer size invalid!\n"));
         Status = EFI_ACCESS_DENIED;
         goto EXIT;
@@ -833,6 +966,14 @@ SmmVariableHandler (
       CopyMem (mVariableBufferPayload, SmmVariableFunctionHeader->Data, CommBufferPayloadSize);
       RuntimeVariableCacheContext = (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT *)mVariableBufferPayload;
 
+      //
+      // ReclaimCount was appended to the context. Callers built before that send
+      // the shorter context and do not use the reclaim count.
+      //
+      if (CommBufferPayloadSize < sizeof (SMM_VARIABLE_COMMUNICATE_RUNTIME_VARIABLE_CACHE_CONTEXT)) {
+        RuntimeVariableCacheContext->ReclaimCount = NULL;
+      }
+
       //
       // Verify required runtime cache buffers are provided.
       //
@@ -924,6 +1065,17 @@ SmmVariableHandler (
         goto EXIT;
       }
 
+      if ((RuntimeVariableCacheContext->ReclaimCount != NULL) &&
+          !VariableSmmIsNonPrimaryBufferValid (
+             (UINTN)RuntimeVariableCacheContext->ReclaimCount,
+             sizeof (*(RuntimeVariableCacheContext->ReclaimCount))
+             ))
+      {
+        DEBUG ((DEBUG_ERROR, "InitRuntimeVariableCacheContext: Runtime cache reclaim count buffer in SMRAM or overflow!\n"));
+        Status = EFI_ACCESS_DENIED;
+        goto EXIT;
+      }
+
       VariableCacheContext                                     = &mVariableModuleGlobal->VariableGlobal.VariableRuntimeCacheContext;
       VariableCacheContext->VariableRuntimeHobCache.Store      = RuntimeVariableCacheContext->RuntimeHobCache;
       VariableCacheContext->VariableRuntimeVolatileCache.Store = RuntimeVariableCacheContext->RuntimeVolatileCache;
@@ -931,6 +1083,10 @@ SmmVariableHandler (
       VariableCacheContext->PendingUpdate                      = RuntimeVariableCacheContext->PendingUpdate;
       VariableCacheContext->ReadLock                           = RuntimeVariableCacheContext->ReadLock;
       VariableCacheContext->HobFlushComplete                   = RuntimeVariableCacheContext->HobFlushComplete;
+      VariableCacheContext->ReclaimCount                       = RuntimeVariableCacheContext->ReclaimCount;
+      if (VariableCacheContext->ReclaimCount != NULL) {
+        *(VariableCacheContext->ReclaimCount) = 0;
+      }
 
       // Set up the intial pending request since the RT cache needs to be in sync with SMM cache
       VariableCacheContext->VariableRuntimeHobCache.PendingUpdateOffset = 0;
@@ -26,6 +26,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/SmmVariable.h>
 #include <Protocol/VariableLock.h>
 #include <Protocol/VarCheck.h>
+#include <Protocol/VariableBatch.h>
 
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -44,6 +45,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "PrivilegePolymorphic.h"
 #include "VariableParsing.h"
+#include "VariableIndex.h"
 
 EFI_HANDLE                      mHandle                    = NULL;
 EFI_SMM_VARIABLE_PROTOCOL       *mSmmVariable              = NULL;
@@ -59,8 +61,10 @@ BOOLEAN                         mVariableAuthFormat;
 EFI_LOCK                        mVariableServicesLock;
 EDKII_VARIABLE_LOCK_PROTOCOL    mVariableLock;
 EDKII_VAR_CHECK_PROTOCOL        mVarCheck;
+EDKII_VARIABLE_BATCH_PROTOCOL   mVariableBatch;
 VARIABLE_RUNTIME_CACHE_INFO     mVariableRtCacheInfo;
 BOOLEAN                         mIsRuntimeCacheEnabled = FALSE;
+UINT32                          mVariableRtCacheReclaimCount;
 
 /**
   The logic to initialize the VariablePolicy engine is in its own file.
@@ -559,6 +563,16 @@ CheckForRuntimeCacheSync (
   //
   if ((CacheInfoFlag->HobFlushComplete) && (mVariableRtCacheInfo.RuntimeHobCacheBuffer != 0)) {
     mVariableRtCacheInfo.RuntimeHobCacheBuffer = 0;
+    VariableStoreIndexUnregister (VariableStoreTypeHob);
+  }
+
+  //
+  // The variables moved inside the runtime caches if a variable store was reclaimed
+  // since the last check, so the indexes over the runtime caches are out of date.
+  //
+  if (CacheInfoFlag->ReclaimCount != mVariableRtCacheReclaimCount) {
+    mVariableRtCacheReclaimCount = CacheInfoFlag->ReclaimCount;
+    VariableStoreIndexInvalidate (NULL);
   }
 }
 
@@ -1253,6 +1267,161 @@ Done:
   return Status;
 }
 
+/**
+  Sets several variables with as few MM communications as possible.
+
+  The entries are packed into the communicate buffer in order, and each full
+  buffer is sent to SMM as one SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH
+  request. Processing stops at the first entry that fails.
+
+  Caution: This function may receive untrusted input.
+  The data size and data are external input, so this function will validate it carefully to avoid buffer overflow.
+
+  @param[in]      This          The EDKII_VARIABLE_BATCH_PROTOCOL instance.
+  @param[in]      EntryCount    The number of entries in Entries.
+  @param[in, out] Entries       The variable updates. The Status of each entry is updated.
+  @param[out]     CommitCount   Optional pointer to return the number of MM communications.
+
+  @retval EFI_SUCCESS           All the variables were set.
+  @retval EFI_INVALID_PARAMETER EntryCount is 0, Entries is NULL, or an entry is invalid
+                                or cannot fit in the communicate buffer.
+  @retval EFI_UNSUPPORTED       The service is called after ExitBootServices().
+  @retval Others                The status of the first entry that failed.
+
+**/
+EFI_STATUS
+EFIAPI
+VariableBatchSetVariables (
+  IN     EDKII_VARIABLE_BATCH_PROTOCOL  *This,
+  IN     UINTN                          EntryCount,
+  IN OUT EDKII_VARIABLE_BATCH_ENTRY     *Entries,
+  OUT    UINTN                          *CommitCount OPTIONAL
+  )
+{
+  EFI_STATUS                                   Status;
+  SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH  *Batch;
+  SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE     *SmmVariableHeader;
+  UINTN                                        MaxEntrySize;
+  UINTN                                        VariableNameSize;
+  UINTN                                        PayloadSize;
+  UINTN                                        EntrySize;
+  UINTN                                        Index;
+  UINTN                                        First;
+  UINTN                                        Last;
+  UINTN                                        ProcessedCount;
+
+  if (EfiAtRuntime ()) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (CommitCount != NULL) {
+    *CommitCount = 0;
+  }
+
+  if ((EntryCount == 0) || (Entries == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Check all the entries before anything is sent, each one must fit in a
+  // batch on its own.
+  //
+  MaxEntrySize = mVariableBufferPayloadSize - sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+  for (Index = 0; Index < EntryCount; Index++) {
+    Entries[Index].Status = EFI_NOT_STARTED;
+    if ((Entries[Index].VariableName == NULL) || (Entries[Index].VariableName[0] == 0) || (Entries[Index].VendorGuid == NULL)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if ((Entries[Index].DataSize != 0) && (Entries[Index].Data == NULL)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    VariableNameSize = StrSize (Entries[Index].VariableName);
+    if ((VariableNameSize > MaxEntrySize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name)) ||
+        (Entries[Index].DataSize > MaxEntrySize - OFFSET_OF (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE, Name) - VariableNameSize) ||
+        (SMM_VARIABLE_BATCH_ENTRY_SIZE (VariableNameSize, Entries[Index].DataSize) > MaxEntrySize))
+    {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  AcquireLockOnlyAtBootTime (&mVariableServicesLock);
+
+  Status = EFI_SUCCESS;
+  First  = 0;
+  while (First < EntryCount) {
+    //
+    // Take as many of the remaining entries as the communicate buffer holds.
+    //
+    PayloadSize = sizeof (SMM_VARIABLE_COMMUNICATE_SET_VARIABLE_BATCH);
+    for (Last = First; Last < EntryCount; Last++) {
+      EntrySize = SMM_VARIABLE_BATCH_ENTRY_SIZE (StrSize (Entries[Last].VariableName), Entries[Last].DataSize);
+      if (EntrySize > mVariableBufferPayloadSize - PayloadSize) {
+        break;
+      }
+
+      PayloadSize += EntrySize;
+    }
+
+    //
+    // Init the communicate buffer. The buffer data size is:
+    // SMM_COMMUNICATE_HEADER_SIZE + SMM_VARIABLE_COMMUNICATE_HEADER_SIZE + PayloadSize.
+    //
+    Status = InitCommunicateBuffer ((VOID **)&Batch, PayloadSize, SMM_VARIABLE_FUNCTION_SET_VARIABLE_BATCH);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Batch->EntryCount = Last - First;
+    SmmVariableHeader = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *)(Batch + 1);
+    for (Index = First; Index < Last; Index++) {
+      CopyGuid (&SmmVariableHeader->Guid, Entries[Index].VendorGuid);
+      SmmVariableHeader->DataSize   = Entries[Index].DataSize;
+      SmmVariableHeader->NameSize   = StrSize (Entries[Index].VariableName);
+      SmmVariableHeader->Attributes = Entries[Index].Attributes;
+      CopyMem (SmmVariableHeader->Name, Entries[Index].VariableName, SmmVariableHeader->NameSize);
+      CopyMem ((UINT8 *)SmmVariableHeader->Name + SmmVariableHeader->NameSize, Entries[Index].Data, Entries[Index].DataSize);
+      SmmVariableHeader = (SMM_VARIABLE_COMMUNICATE_ACCESS_VARIABLE *)((UINT8 *)SmmVariableHeader +
+                                                                       SMM_VARIABLE_BATCH_ENTRY_SIZE (SmmVariableHeader->NameSize, SmmVariableHeader->DataSize));
+    }
+
+    //
+    // Send data to SMM.
+    //
+    Status = SendCommunicateBuffer (PayloadSize);
+    if (CommitCount != NULL) {
+      *CommitCount += 1;
+    }
+
+    ProcessedCount = Last - First;
+    if (EFI_ERROR (Status)) {
+      ProcessedCount = MIN (Batch->ProcessedCount, Last - First - 1);
+    }
+
+    for (Index = First; Index < First + ProcessedCount; Index++) {
+      Entries[Index].Status = EFI_SUCCESS;
+    }
+
+    if (EFI_ERROR (Status)) {
+      Entries[First + ProcessedCount].Status = Status;
+      break;
+    }
+
+    First = Last;
+  }
+
+  ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Entries[Index].Status == EFI_SUCCESS) {
+      SecureBootHook (Entries[Index].VariableName, Entries[Index].VendorGuid);
+    }
+  }
+
+  return Status;
+}
+
 /**
   This code returns information about the EFI variables.
 
@@ -1409,6 +1578,8 @@ VariableAddressChangeEvent (
   IN VOID       *Context
   )
 {
+  VARIABLE_STORE_TYPE  Type;
+
   EfiConvertPointer (0x0, (VOID **)&mVariableBuffer);
   if (mMmCommunication3 != NULL) {
     EfiConvertPointer (0x0, (VOID **)&mMmCommunication3);
@@ -1420,6 +1591,11 @@ VariableAddressChangeEvent (
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeHobCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeNvCacheBuffer);
   EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableRtCacheInfo.RuntimeVolatileCacheBuffer);
+
+  for (Type = (VARIABLE_STORE_TYPE)0; Type < VariableStoreTypeMax; Type++) {
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Type].Store);
+    EfiConvertPointer (EFI_OPTIONAL_PTR, (VOID **)&mVariableStoreIndex[Type].Buckets);
+  }
 }
 
 /**
@@ -1700,6 +1876,17 @@ InitVariableCache (
     InitVariableStoreHeader ((VOID *)(UINTN)mVariableRtCacheInfo.RuntimeHobCacheBuffer, AllocatedHobCacheSize);
     InitVariableStoreHeader ((VOID *)(UINTN)mVariableRtCacheInfo.RuntimeNvCacheBuffer, AllocatedNvCacheSize);
     InitVariableStoreHeader ((VOID *)(UINTN)mVariableRtCacheInfo.RuntimeVolatileCacheBuffer, AllocatedVolatileCacheSize);
+
+    //
+    // Index the runtime caches to speed up variable lookup. A runtime cache that
+    // could not be indexed is still searched by walking through it.
+    //
+    if (mVariableRtCacheInfo.RuntimeHobCacheBuffer != 0) {
+      VariableStoreIndexRegister (VariableStoreTypeHob, (VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeHobCacheBuffer);
+    }
+
+    VariableStoreIndexRegister (VariableStoreTypeNv, (VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeNvCacheBuffer);
+    VariableStoreIndexRegister (VariableStoreTypeVolatile, (VARIABLE_STORE_HEADER *)(UINTN)mVariableRtCacheInfo.RuntimeVolatileCacheBuffer);
   }
 
   return Status;
@@ -1724,6 +1911,7 @@ SendRuntimeVariableCacheContextToSmm (
   EFI_MM_COMMUNICATE_HEADER                                *SmmCommunicateHeader;
   EFI_MM_COMMUNICATE_HEADER_V3                             *SmmCommunicateHeaderV3;
   SMM_VARIABLE_COMMUNICATE_HEADER                          *SmmVariableFunctionHeader;
+  CACHE_INFO_FLAG                                          *CacheInfoFlag;
   UINTN                                                    CommSize;
   UINT8                                                    *CommBuffer;
 
@@ -1760,6 +1948,8 @@ SendRuntimeVariableCacheContextToSmm (
     SmmRuntimeVarCacheContext->PendingUpdate        = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->PendingUpdate;
     SmmRuntimeVarCacheContext->ReadLock             = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReadLock;
     SmmRuntimeVarCacheContext->HobFlushComplete     = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->HobFlushComplete;
+    SmmRuntimeVarCacheContext->ReclaimCount         = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReclaimCount;
+    *(SmmRuntimeVarCacheContext->ReclaimCount)      = MAX_UINT32;
 
     //
     // Send data to SMM.
@@ -1788,6 +1978,8 @@ SendRuntimeVariableCacheContextToSmm (
     SmmRuntimeVarCacheContext->PendingUpdate        = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->PendingUpdate;
     SmmRuntimeVarCacheContext->ReadLock             = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReadLock;
     SmmRuntimeVarCacheContext->HobFlushComplete     = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->HobFlushComplete;
+    SmmRuntimeVarCacheContext->ReclaimCount         = &((CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer)->ReclaimCount;
+    *(SmmRuntimeVarCacheContext->ReclaimCount)      = MAX_UINT32;
 
     //
     // Send data to SMM.
@@ -1806,6 +1998,20 @@ SendRuntimeVariableCacheContextToSmm (
     goto Done;
   }
 
+  //
+  // An MM variable driver that does not report reclaims leaves ReclaimCount
+  // untouched. The indexes over the runtime caches could not be invalidated
+  // when a reclaim moves the variables, so do not use them.
+  //
+  CacheInfoFlag = (CACHE_INFO_FLAG *)(UINTN)mVariableRtCacheInfo.CacheInfoFlagBuffer;
+  if (CacheInfoFlag->ReclaimCount == MAX_UINT32) {
+    VariableStoreIndexUnregister (VariableStoreTypeHob);
+    VariableStoreIndexUnregister (VariableStoreTypeNv);
+    VariableStoreIndexUnregister (VariableStoreTypeVolatile);
+  }
+
+  mVariableRtCacheReclaimCount = CacheInfoFlag->ReclaimCount;
+
 Done:
   ReleaseLockOnlyAtBootTime (&mVariableServicesLock);
   return Status;
@@ -1871,6 +2077,9 @@ SmmVariableReady (
 
     if (EFI_ERROR (Status)) {
       ZeroMem (&mVariableRtCacheInfo, sizeof (VARIABLE_RUNTIME_CACHE_INFO));
+      VariableStoreIndexUnregister (VariableStoreTypeHob);
+      VariableStoreIndexUnregister (VariableStoreTypeNv);
+      VariableStoreIndexUnregister (VariableStoreTypeVolatile);
     }
 
     ASSERT_EFI_ERROR (Status);
@@ -1966,6 +2175,16 @@ SmmVariableWriteReady (
                   );
   ASSERT_EFI_ERROR (Status);
 
+  mVariableBatch.Revision     = EDKII_VARIABLE_BATCH_PROTOCOL_REVISION;
+  mVariableBatch.SetVariables = VariableBatchSetVariables;
+  Status                      = gBS->InstallMultipleProtocolInterfaces (
+                                       &mHandle,
+                                       &gEdkiiVariableBatchProtocolGuid,
+                                       &mVariableBatch,
+                                       NULL
+                                       );
+  ASSERT_EFI_ERROR (Status);
+
   gBS->CloseEvent (Event);
 }
 
@@ -597,21 +597,22 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HTTP child for the file download.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HTTP_IO wrapping the HTTP child.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
@@ -636,15 +637,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -1804,3 +1826,607 @@ ERROR_1:
 
   return Status;
 }
+
+/**
+  Build the HTTP request header to download a byte range of the boot file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       RangeStart      The offset of the range in the boot file.
+  @param[in]       RangeLength     The length of the range, not 0.
+  @param[out]      HttpIoHeader    The request header. The caller must free it
+                                   with HttpIoFreeHeader().
+
+  @retval EFI_SUCCESS              The request header was built.
+  @retval EFI_OUT_OF_RESOURCES     Could not allocate needed resources
+  @retval EFI_UNSUPPORTED          The authentication scheme is not supported.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootBuildRangeHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     UINTN                   RangeStart,
+  IN     UINTN                   RangeLength,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  UINTN           HeadersCount;
+  CHAR8           *HostName;
+  CHAR8           BaseAuthValue[80];
+  CHAR8           RangeValue[64];
+
+  //
+  // Host, Accept, User-Agent, Range, [Authorization], [If-Match]|[If-Unmodified-Since]
+  //
+  HeadersCount = 4;
+  if (Private->AuthData != NULL) {
+    if ((Private->AuthScheme != NULL) && (CompareMem (Private->AuthScheme, "Basic", 5) != 0)) {
+      return EFI_UNSUPPORTED;
+    }
+
+    HeadersCount++;
+  }
+
+  if (Private->LastModifiedOrEtag != NULL) {
+    HeadersCount++;
+  }
+
+  Header = HttpIoCreateHeader (HeadersCount);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  AsciiSPrint (
+    RangeValue,
+    sizeof (RangeValue),
+    "bytes=%lu-%lu",
+    (UINT64)RangeStart,
+    (UINT64)(RangeStart + RangeLength - 1)
+    );
+  Status = HttpIoSetHeader (Header, "Range", RangeValue);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Private->AuthData != NULL) {
+    AsciiSPrint (
+      BaseAuthValue,
+      sizeof (BaseAuthValue),
+      "%a %a",
+      "Basic",
+      Private->AuthData
+      );
+    Status = HttpIoSetHeader (Header, HTTP_HEADER_AUTHORIZATION, BaseAuthValue);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  //
+  // All the ranges must come from the same version of the boot file.
+  //
+  if (Private->LastModifiedOrEtag != NULL) {
+    if (Private->LastModifiedOrEtag[0] == '"') {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_MATCH, Private->LastModifiedOrEtag);
+    } else {
+      Status = HttpIoSetHeader (Header, HTTP_HEADER_IF_UNMODIFIED_SINCE, Private->LastModifiedOrEtag);
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Queue a response token on a range connection, either for the response header
+  or for the next part of the message-body.
+
+  @param[in, out]  Connection      The range connection.
+  @param[in]       Buffer          The buffer of the whole boot file.
+
+  @retval EFI_SUCCESS              The response token was queued.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootQueueRangeResponse (
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+
+  HttpIo                  = &Connection->HttpIo;
+  HttpIo->RspToken.Status = EFI_NOT_READY;
+  if (Connection->State == HttpBootRangeHeader) {
+    HttpIo->RspToken.Message->Data.Response = &Connection->Response;
+    HttpIo->RspToken.Message->BodyLength    = 0;
+    HttpIo->RspToken.Message->Body          = NULL;
+  } else {
+    HttpIo->RspToken.Message->Data.Response = NULL;
+    HttpIo->RspToken.Message->BodyLength    = Connection->RangeLength - Connection->ReceivedSize;
+    HttpIo->RspToken.Message->Body          = Buffer + Connection->RangeStart + Connection->ReceivedSize;
+  }
+
+  HttpIo->RspToken.Message->HeaderCount = 0;
+  HttpIo->RspToken.Message->Headers     = NULL;
+  HttpIo->IsRxDone                      = FALSE;
+
+  Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  }
+
+  return Status;
+}
+
+/**
+  Check that the response of a range connection carries the requested range of
+  the boot file.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Connection      The range connection.
+  @param[in]       HeaderCount     Number of HTTP header structures in Headers.
+  @param[in]       Headers         Array containing list of HTTP headers.
+
+  @retval EFI_SUCCESS              The response carries the requested range.
+  @retval EFI_UNSUPPORTED          The server didn't honor the range request.
+
+**/
+EFI_STATUS
+HttpBootCheckRangeResponse (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN     HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINTN                       HeaderCount,
+  IN     EFI_HTTP_HEADER             *Headers
+  )
+{
+  EFI_HTTP_HEADER  *HttpHeader;
+  CHAR8            *Value;
+
+  if (Connection->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Content-Range: bytes <range-start>-<range-end>/<size>
+  //
+  HttpHeader = HttpFindHeader (HeaderCount, Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((HttpHeader == NULL) || (AsciiStrnCmp (HttpHeader->FieldValue, "bytes ", 6) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = HttpHeader->FieldValue + 6;
+  if (AsciiStrDecimalToUintn (Value) != Connection->RangeStart) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = AsciiStrStr (Value, "-");
+  if ((Value == NULL) ||
+      (AsciiStrDecimalToUintn (Value + 1) != Connection->RangeStart + Connection->RangeLength - 1))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Value = AsciiStrStr (Value, "/");
+  if ((Value == NULL) || (AsciiStrDecimalToUintn (Value + 1) != Private->BootFileSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Advance a range connection if its pending request or response token completed.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  Connection      The range connection.
+  @param[in]       Buffer          The buffer of the whole boot file.
+
+  @retval EFI_SUCCESS              The connection is still downloading, waits for the
+                                   other connections, or it is done.
+  @retval EFI_TIMEOUT              The request could not be sent or no response was
+                                   received in time.
+  @retval EFI_UNSUPPORTED          The server didn't honor the range request.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootPollRangeConnection (
+  IN     HTTP_BOOT_PRIVATE_DATA      *Private,
+  IN OUT HTTP_BOOT_RANGE_CONNECTION  *Connection,
+  IN     UINT8                       *Buffer
+  )
+{
+  EFI_STATUS                       Status;
+  HTTP_IO                          *HttpIo;
+  EFI_HTTP_BOOT_CALLBACK_PROTOCOL  *HttpBootCallback;
+  UINTN                            Length;
+
+  HttpIo = &Connection->HttpIo;
+
+  if (Connection->State == HttpBootRangeReady) {
+    return EFI_SUCCESS;
+  }
+
+  if (Connection->State == HttpBootRangeRequest) {
+    if (!HttpIo->IsTxDone) {
+      if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+        HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->ReqToken);
+        return EFI_TIMEOUT;
+      }
+
+      return EFI_SUCCESS;
+    }
+
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    if (EFI_ERROR (HttpIo->ReqToken.Status)) {
+      return HttpIo->ReqToken.Status;
+    }
+
+    Connection->State = HttpBootRangeHeader;
+    return HttpBootQueueRangeResponse (Connection, Buffer);
+  }
+
+  if (!HttpIo->IsRxDone) {
+    if (!EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+      HttpIo->Http->Cancel (HttpIo->Http, &HttpIo->RspToken);
+      return EFI_TIMEOUT;
+    }
+
+    return EFI_SUCCESS;
+  }
+
+  gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+  HttpIo->IsRxDone = FALSE;
+
+  if (Connection->State == HttpBootRangeHeader) {
+    if ((HttpIo->RspToken.Status != EFI_SUCCESS) && (HttpIo->RspToken.Status != EFI_HTTP_ERROR)) {
+      return HttpIo->RspToken.Status;
+    }
+
+    Status = HttpBootCheckRangeResponse (
+               Private,
+               Connection,
+               HttpIo->RspToken.Message->HeaderCount,
+               HttpIo->RspToken.Message->Headers
+               );
+    if (HttpIo->RspToken.Message->Headers != NULL) {
+      HttpFreeHeaderFields (HttpIo->RspToken.Message->Headers, HttpIo->RspToken.Message->HeaderCount);
+      HttpIo->RspToken.Message->Headers = NULL;
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_INFO,
+        "HttpBootPollRangeConnection: Range %lu-%lu refused, status code %d.\n",
+        (UINT64)Connection->RangeStart,
+        (UINT64)(Connection->RangeStart + Connection->RangeLength - 1),
+        Connection->Response.StatusCode
+        ));
+      return Status;
+    }
+
+    //
+    // The message-body is only received once every connection got its range,
+    // so that no progress is reported when the server refuses a range.
+    //
+    Connection->State = HttpBootRangeReady;
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (HttpIo->RspToken.Status)) {
+    return HttpIo->RspToken.Status;
+  }
+
+  Length = HttpIo->RspToken.Message->BodyLength;
+  if (Length > Connection->RangeLength - Connection->ReceivedSize) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  HttpBootCallback = Private->HttpBootCallback;
+  if ((HttpBootCallback != NULL) && (Length != 0)) {
+    Status = HttpBootCallback->Callback (
+                                 HttpBootCallback,
+                                 HttpBootHttpEntityBody,
+                                 TRUE,
+                                 (UINT32)Length,
+                                 Buffer + Connection->RangeStart + Connection->ReceivedSize
+                                 );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Connection->ReceivedSize += Length;
+  if (Connection->ReceivedSize < Connection->RangeLength) {
+    return HttpBootQueueRangeResponse (Connection, Buffer);
+  }
+
+  Connection->State = HttpBootRangeDone;
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file in several byte ranges at the same time, each over its own
+  HTTP connection, directly into the caller's buffer.
+
+  The size of the boot file must already be known. The parallel download is only used
+  when enabled by PcdHttpBootParallelConnections and the boot file is not smaller than
+  PcdHttpBootParallelMinimumSize.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer. On output with a return code of EFI_BUFFER_TOO_SMALL,
+                                   the size of Buffer required to retrieve the requested file.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_INVALID_PARAMETER    BufferSize, Buffer or ImageType is NULL.
+  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to hold the boot file.
+                                   BufferSize has been updated with the size needed.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled or not suitable for
+                                   this boot file, or the server doesn't support ranges.
+                                   Nothing was reported to the HTTP boot callback, the caller
+                                   may download the boot file over a single connection.
+  @retval EFI_TIMEOUT              A connection timed out.
+  @retval Others                   Unexpected error happened, or the HTTP boot callback
+                                   aborted the download.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileParallel (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  )
+{
+  EFI_STATUS                  Status;
+  HTTP_BOOT_RANGE_CONNECTION  *Connections;
+  HTTP_BOOT_RANGE_CONNECTION  *Connection;
+  HTTP_IO                     *HttpIo;
+  UINTN                       Count;
+  UINTN                       Index;
+  UINTN                       Pending;
+  UINTN                       Ready;
+  UINTN                       UrlSize;
+  CHAR16                      *Url;
+
+  ASSERT (Private != NULL);
+  ASSERT (Private->HttpCreated);
+
+  if ((BufferSize == NULL) || (Buffer == NULL) || (ImageType == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Only large boot files are worth it, and the ranges can't go through the tunnel
+  // of a proxy or resume a partial download.
+  //
+  Count = MIN (PcdGet8 (PcdHttpBootParallelConnections), HTTP_BOOT_PARALLEL_MAX_CONNECTIONS);
+  if ((Count < 2) ||
+      (Private->BootFileSize == 0) ||
+      (Private->BootFileSize < PcdGet32 (PcdHttpBootParallelMinimumSize)) ||
+      (Private->ProxyUri != NULL) ||
+      (Private->PartialTransferredSize != 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (*BufferSize < Private->BootFileSize) {
+    *BufferSize = Private->BootFileSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  UrlSize = AsciiStrSize (Private->BootFileUri);
+  Url     = AllocatePool (UrlSize * sizeof (CHAR16));
+  if (Url == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+
+  //
+  // A file already downloaded without a buffer is in the cache.
+  //
+  Status = HttpBootGetFileFromCache (Private, Url, BufferSize, Buffer, ImageType);
+  if (Status != EFI_NOT_FOUND) {
+    FreePool (Url);
+    return Status;
+  }
+
+  Connections = AllocateZeroPool (Count * sizeof (HTTP_BOOT_RANGE_CONNECTION));
+  if (Connections == NULL) {
+    FreePool (Url);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Send one range request per connection. The TCP connections are established
+  // one by one, then all the ranges are received at the same time. Each connection
+  // is also measured on its own, from its creation until its range is received.
+  //
+  PERF_INMODULE_BEGIN ("HttpBootParallel");
+  for (Index = 0; Index < Count; Index++) {
+    Connection              = &Connections[Index];
+    Connection->RangeStart  = (UINTN)DivU64x32 (MultU64x32 (Private->BootFileSize, (UINT32)Index), (UINT32)Count);
+    Connection->RangeLength = (UINTN)DivU64x32 (MultU64x32 (Private->BootFileSize, (UINT32)Index + 1), (UINT32)Count) -
+                              Connection->RangeStart;
+    Connection->State = HttpBootRangeRequest;
+
+    Status = HttpBootCreateHttpIoInstance (Private, &Connection->HttpIo);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Connection->HttpCreated = TRUE;
+    AsciiSPrint (Connection->PerfToken, sizeof (Connection->PerfToken), "HttpBootRange%Lu", (UINT64)Index);
+    PERF_INMODULE_BEGIN (Connection->PerfToken);
+
+    Status = HttpBootBuildRangeHeader (
+               Private,
+               Connection->RangeStart,
+               Connection->RangeLength,
+               &Connection->HttpIoHeader
+               );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Connection->RequestData.Method = HttpMethodGet;
+    Connection->RequestData.Url    = Url;
+
+    HttpIo                                 = &Connection->HttpIo;
+    HttpIo->ReqToken.Status                = EFI_NOT_READY;
+    HttpIo->ReqToken.Message->Data.Request = &Connection->RequestData;
+    HttpIo->ReqToken.Message->HeaderCount  = Connection->HttpIoHeader->HeaderCount;
+    HttpIo->ReqToken.Message->Headers      = Connection->HttpIoHeader->Headers;
+    HttpIo->ReqToken.Message->BodyLength   = 0;
+    HttpIo->ReqToken.Message->Body         = NULL;
+    HttpIo->IsTxDone                       = FALSE;
+
+    Status = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+    if (EFI_ERROR (Status)) {
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+      goto ON_EXIT;
+    }
+  }
+
+  //
+  // Poll all the connections until every range is received, writing the data
+  // directly to its place in Buffer.
+  //
+  Pending = Count;
+  Ready   = 0;
+  while (Pending > 0) {
+    for (Index = 0; Index < Count; Index++) {
+      Connection = &Connections[Index];
+      if ((Connection->State == HttpBootRangeDone) || (Connection->State == HttpBootRangeReady)) {
+        continue;
+      }
+
+      Connection->HttpIo.Http->Poll (Connection->HttpIo.Http);
+      Status = HttpBootPollRangeConnection (Private, Connection, Buffer);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      if (Connection->State == HttpBootRangeReady) {
+        Ready++;
+      } else if (Connection->State == HttpBootRangeDone) {
+        Pending--;
+        PERF_INMODULE_END (Connection->PerfToken);
+        DEBUG ((
+          DEBUG_INFO,
+          "HttpBootGetBootFileParallel: Connection %Lu received %Lu bytes.\n",
+          (UINT64)Index,
+          (UINT64)Connection->RangeLength
+          ));
+      }
+    }
+
+    //
+    // Once the server accepted every range, receive all the message-bodies.
+    //
+    if (Ready == Count) {
+      Ready = 0;
+      for (Index = 0; Index < Count; Index++) {
+        Connections[Index].State = HttpBootRangeBody;
+        Status                   = HttpBootQueueRangeResponse (&Connections[Index], Buffer);
+        if (EFI_ERROR (Status)) {
+          goto ON_EXIT;
+        }
+      }
+    }
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "HttpBootGetBootFileParallel: Received %Lu bytes over %Lu connections.\n",
+    (UINT64)Private->BootFileSize,
+    (UINT64)Count
+    ));
+
+  *BufferSize = Private->BootFileSize;
+  *ImageType  = Private->ImageType;
+  Status      = EFI_SUCCESS;
+
+ON_EXIT:
+  PERF_INMODULE_END ("HttpBootParallel");
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN | DEBUG_INFO, "HttpBootGetBootFileParallel: Parallel download failed - %r.\n", Status));
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Connection = &Connections[Index];
+    if (Connection->HttpCreated) {
+      //
+      // Close the measurement of a connection that failed or was cut short.
+      //
+      if (Connection->State != HttpBootRangeDone) {
+        PERF_INMODULE_END (Connection->PerfToken);
+      }
+
+      HttpIoDestroyIo (&Connection->HttpIo);
+    }
+
+    if (Connection->HttpIoHeader != NULL) {
+      HttpIoFreeHeader (Connection->HttpIoHeader);
+    }
+  }
+
+  FreePool (Connections);
+  FreePool (Url);
+  return Status;
+}
@@ -13,6 +13,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define HTTP_BOOT_BLOCK_SIZE                   1500
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT          "UefiHttpBoot/1.0"
 #define HTTP_BOOT_AUTHENTICATION_INFO_MAX_LEN  255
+#define HTTP_BOOT_PARALLEL_MAX_CONNECTIONS     8
+#define HTTP_BOOT_RANGE_PERF_TOKEN_SIZE        16
 
 //
 // Record the data length and start address of a data block.
@@ -58,6 +60,33 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// State of a connection which downloads one byte range of the boot file.
+//
+typedef enum {
+  HttpBootRangeRequest,                       // Sending the request.
+  HttpBootRangeHeader,                        // Receiving the response header.
+  HttpBootRangeReady,                         // Response header checked, waiting for the other connections.
+  HttpBootRangeBody,                          // Receiving the message-body.
+  HttpBootRangeDone
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// A connection which downloads one byte range of the boot file.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   HttpCreated;
+  HTTP_IO_HEADER            *HttpIoHeader;
+  EFI_HTTP_REQUEST_DATA     RequestData;
+  EFI_HTTP_RESPONSE_DATA    Response;
+  HTTP_BOOT_RANGE_STATE     State;
+  UINTN                     RangeStart;       // Offset of the range in the boot file.
+  UINTN                     RangeLength;
+  UINTN                     ReceivedSize;
+  CHAR8                     PerfToken[HTTP_BOOT_RANGE_PERF_TOKEN_SIZE]; // "HttpBootRange<index>"
+} HTTP_BOOT_RANGE_CONNECTION;
+
 /**
   Discover all the boot information for boot file.
 
@@ -136,6 +165,43 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  Download the boot file in several byte ranges at the same time, each over its own
+  HTTP connection, directly into the caller's buffer.
+
+  The size of the boot file must already be known. The parallel download is only used
+  when enabled by PcdHttpBootParallelConnections and the boot file is not smaller than
+  PcdHttpBootParallelMinimumSize.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in, out]  BufferSize      On input the size of Buffer in bytes. On output with a return
+                                   code of EFI_SUCCESS, the amount of data transferred to
+                                   Buffer. On output with a return code of EFI_BUFFER_TOO_SMALL,
+                                   the size of Buffer required to retrieve the requested file.
+  @param[out]      Buffer          The memory buffer to transfer the file to.
+  @param[out]      ImageType       The image type of the downloaded file.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_INVALID_PARAMETER    BufferSize, Buffer or ImageType is NULL.
+  @retval EFI_BUFFER_TOO_SMALL     The BufferSize is too small to hold the boot file.
+                                   BufferSize has been updated with the size needed.
+  @retval EFI_UNSUPPORTED          The parallel download is disabled or not suitable for
+                                   this boot file, or the server doesn't support ranges.
+                                   Nothing was reported to the HTTP boot callback, the caller
+                                   may download the boot file over a single connection.
+  @retval EFI_TIMEOUT              A connection timed out.
+  @retval Others                   Unexpected error happened, or the HTTP boot callback
+                                   aborted the download.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileParallel (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN OUT UINTN                   *BufferSize,
+  OUT UINT8                      *Buffer,
+  OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
+  );
+
 /**
   Clean up all cached data.
 
@@ -394,6 +394,23 @@ HttpBootGetBootFileCaller (
           return Status;
         }
 
+        //
+        // Download a large boot file over several connections at the same time
+        // if enabled. Fall back to a single connection only if the parallel
+        // download is not used or the server doesn't support ranges. Any other
+        // failure, such as a timeout or an abort from the HTTP boot callback,
+        // is returned as it is.
+        //
+        Status = HttpBootGetBootFileParallel (
+                   Private,
+                   BufferSize,
+                   Buffer,
+                   ImageType
+                   );
+        if (Status != EFI_UNSUPPORTED) {
+          return Status;
+        }
+
         //
         // Load the boot file into Buffer
         //
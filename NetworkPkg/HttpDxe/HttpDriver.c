@@ -67,6 +67,7 @@ HttpCreateService (
   HttpService->ControllerHandle            = Controller;
   HttpService->ChildrenNumber              = 0;
   InitializeListHead (&HttpService->ChildrenList);
+  InitializeListHead (&HttpService->IdleConnections);
 
   *ServiceData = HttpService;
   return EFI_SUCCESS;
@@ -90,6 +91,8 @@ HttpCleanService (
     return;
   }
 
+  HttpPoolFlush (HttpService, UsingIpv6);
+
   if (!UsingIpv6) {
     if (HttpService->Tcp4ChildHandle != NULL) {
       gBS->CloseProtocol (
@@ -562,6 +565,14 @@ HttpDxeStop (
       HttpCleanService (HttpService, UsingIpv6);
 
       if ((HttpService->Tcp4ChildHandle == NULL) && (HttpService->Tcp6ChildHandle == NULL)) {
+        DEBUG ((
+          DEBUG_NET,
+          "HttpDxe: %Lu requests over %Lu new connections, %Lu idle connections reused\n",
+          (UINT64)HttpService->RequestCount,
+          (UINT64)HttpService->ConnectCount,
+          (UINT64)HttpService->PoolHitCount
+          ));
+
         gBS->UninstallProtocolInterface (
                NicHandle,
                &gEfiHttpServiceBindingProtocolGuid,
@@ -29,6 +29,7 @@
 #include <Library/DpcLib.h>
 #include <Library/PrintLib.h>
 #include <Library/PcdLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // UEFI Driver Model Protocols
@@ -244,6 +244,7 @@ EfiHttpRequest (
   BOOLEAN                        Configure;
   BOOLEAN                        ReConfigure;
   BOOLEAN                        TlsConfigure;
+  BOOLEAN                        Pooled;
   CHAR8                          *RequestMsg;
   CHAR8                          *Url;
   UINTN                          UrlLen;
@@ -272,6 +273,7 @@ EfiHttpRequest (
   Wrap               = NULL;
   FileUrl            = NULL;
   TlsConfigure       = FALSE;
+  Pooled             = FALSE;
   EndPointUrlMsg     = NULL;
   EndPointRemotePort = 0;
   ConnRequest        = NULL;
@@ -524,6 +526,7 @@ EfiHttpRequest (
 
           Wrap->HttpToken    = Token;
           Wrap->HttpInstance = HttpInstance;
+          PERF_START (HttpInstance->Handle, HTTP_PERF_REQUEST_TOKEN, NULL, 0);
 
           Status = HttpCreateTcpTxEvent (Wrap);
           if (EFI_ERROR (Status)) {
@@ -536,6 +539,7 @@ EfiHttpRequest (
           }
 
           Wrap->TcpWrap.Method = Request->Method;
+          HttpInstance->Service->RequestCount++;
 
           FreePool (HostName);
 
@@ -565,6 +569,21 @@ EfiHttpRequest (
     }
   }
 
+  if (Configure && !ReConfigure && !HttpInstance->UseHttps && (HttpInstance->Method != HttpMethodConnect)) {
+    //
+    // The first request of a plain HTTP instance can take over an idle
+    // connection to the same host that another HTTP child left in the pool.
+    //
+    Status = HttpPoolTakeConnection (HttpInstance, HostName, RemotePort);
+    if (!EFI_ERROR (Status)) {
+      HttpInstance->RemotePort = RemotePort;
+      HttpInstance->RemoteHost = HostName;
+      HostName                 = NULL;
+      Configure                = FALSE;
+      Pooled                   = TRUE;
+    }
+  }
+
   if (Configure) {
     //
     // Parse Url for IPv4 or IPv6 address, if failed, perform DNS resolution.
@@ -642,6 +661,7 @@ EfiHttpRequest (
 
   Wrap->HttpToken    = Token;
   Wrap->HttpInstance = HttpInstance;
+  PERF_START (HttpInstance->Handle, HTTP_PERF_REQUEST_TOKEN, NULL, 0);
   if (Request != NULL) {
     Wrap->TcpWrap.Method = Request->Method;
   }
@@ -758,6 +778,25 @@ EfiHttpRequest (
 
   HttpInstance->ConnectionClose = FALSE;
 
+  //
+  // The server may close an idle pooled connection just as the request is
+  // sent over it. Keep a copy of a request without body to send it again
+  // over a new connection if no response arrives on the pooled one.
+  //
+  if (HttpInstance->ReplayMsg != NULL) {
+    FreePool (HttpInstance->ReplayMsg);
+    HttpInstance->ReplayMsg = NULL;
+  }
+
+  if (Pooled && (Request != NULL) && (HttpMsg->BodyLength == 0) &&
+      ((Request->Method == HttpMethodGet) || (Request->Method == HttpMethodHead)))
+  {
+    HttpInstance->ReplayMsg = AllocateCopyPool (RequestMsgSize, RequestMsg);
+    if (HttpInstance->ReplayMsg != NULL) {
+      HttpInstance->ReplayMsgSize = RequestMsgSize;
+    }
+  }
+
   //
   // Transmit the request message.
   //
@@ -777,6 +816,10 @@ EfiHttpRequest (
     HttpInstance->ProxyConnected = TRUE;
   }
 
+  if (Request != NULL) {
+    HttpInstance->Service->RequestCount++;
+  }
+
   if (HostName != NULL) {
     FreePool (HostName);
   }
@@ -1195,8 +1238,24 @@ HttpResponseWorker (
 
     Status = HttpTcpReceiveHeader (HttpInstance, &SizeofHeaders, &BufferSize, HttpInstance->TimeoutEvent);
 
+    if (EFI_ERROR (Status) && (Status != EFI_TIMEOUT) && (SizeofHeaders == 0) && (HttpInstance->ReplayMsg != NULL)) {
+      //
+      // The server closed the pooled connection before it answered, retry once
+      // over a new connection.
+      //
+      Status = HttpPoolReplayRequest (HttpInstance, HttpInstance->TimeoutEvent);
+      if (!EFI_ERROR (Status)) {
+        Status = HttpTcpReceiveHeader (HttpInstance, &SizeofHeaders, &BufferSize, HttpInstance->TimeoutEvent);
+      }
+    }
+
     gBS->SetTimer (HttpInstance->TimeoutEvent, TimerCancel, 0);
 
+    if (HttpInstance->ReplayMsg != NULL) {
+      FreePool (HttpInstance->ReplayMsg);
+      HttpInstance->ReplayMsg = NULL;
+    }
+
     if (EFI_ERROR (Status)) {
       goto Error;
     }
@@ -1284,6 +1343,8 @@ HttpResponseWorker (
       if (!ValueInItem->TcpWrap.IsTxDone) {
         goto Error2;
       }
+
+      PERF_END (HttpInstance->Handle, HTTP_PERF_REQUEST_TOKEN, NULL, 0);
     }
 
     if (SizeofHeaders != 0) {
@@ -822,6 +822,11 @@ HttpCleanProtocol (
   IN  HTTP_PROTOCOL  *HttpInstance
   )
 {
+  //
+  // Leave an idle keep-alive connection to the other HTTP children.
+  //
+  HttpPoolPutConnection (HttpInstance);
+
   HttpCloseConnection (HttpInstance);
 
   HttpCloseTcpConnCloseEvent (HttpInstance);
@@ -837,6 +842,11 @@ HttpCleanProtocol (
     HttpInstance->NextMsg   = NULL;
   }
 
+  if (HttpInstance->ReplayMsg != NULL) {
+    FreePool (HttpInstance->ReplayMsg);
+    HttpInstance->ReplayMsg = NULL;
+  }
+
   if (HttpInstance->RemoteHost != NULL) {
     FreePool (HttpInstance->RemoteHost);
     HttpInstance->RemoteHost = NULL;
@@ -997,6 +1007,7 @@ HttpCreateConnection (
 
   if (!EFI_ERROR (Status)) {
     HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+    HttpInstance->Service->ConnectCount++;
   }
 
   return Status;
@@ -1048,6 +1059,574 @@ HttpCloseConnection (
   return EFI_SUCCESS;
 }
 
+/**
+  Close an idle connection of the pool and destroy its TCP child.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  Connection         The idle connection, removed from the pool.
+
+**/
+VOID
+HttpPoolDestroyConnection (
+  IN  HTTP_SERVICE          *HttpService,
+  IN  HTTP_IDLE_CONNECTION  *Connection
+  )
+{
+  if (!Connection->IsIPv6) {
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  } else {
+    gBS->CloseProtocol (
+           Connection->TcpChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      Connection->TcpChildHandle
+      );
+  }
+
+  FreePool (Connection->RemoteHost);
+  FreePool (Connection);
+}
+
+/**
+  Check whether the TCP connection of a TCP child is still established.
+
+  @param[in]  IsIPv6             TRUE if Tcp6 is used, FALSE if Tcp4 is used.
+  @param[in]  Tcp4               The TCP4 protocol of the child.
+  @param[in]  Tcp6               The TCP6 protocol of the child.
+
+  @retval TRUE                   The connection is established.
+  @retval FALSE                  The connection is closing or closed.
+
+**/
+BOOLEAN
+HttpPoolIsEstablished (
+  IN  BOOLEAN            IsIPv6,
+  IN  EFI_TCP4_PROTOCOL  *Tcp4,
+  IN  EFI_TCP6_PROTOCOL  *Tcp6
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_TCP4_CONNECTION_STATE  Tcp4State;
+  EFI_TCP6_CONNECTION_STATE  Tcp6State;
+
+  if (!IsIPv6) {
+    Status = Tcp4->GetModeData (Tcp4, &Tcp4State, NULL, NULL, NULL, NULL);
+    return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp4State == Tcp4StateEstablished));
+  }
+
+  Status = Tcp6->GetModeData (Tcp6, &Tcp6State, NULL, NULL, NULL, NULL);
+  return (BOOLEAN)(!EFI_ERROR (Status) && (Tcp6State == Tcp6StateEstablished));
+}
+
+/**
+  Move the TCP connection of an HTTP child to the idle connection pool of the
+  HTTP service, so that another HTTP child sending requests to the same host
+  can take it over without a new TCP handshake.
+
+  Only plain HTTP connections that the server keeps alive and that have no
+  pending request or response data are kept. HTTPS connections are not kept:
+  the TLS session belongs to the TLS child of the HTTP child, which is
+  destroyed with it. When the pool is full, the oldest idle connection is
+  closed.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The TCP child is moved to the pool.
+  @retval EFI_UNSUPPORTED        The connection cannot be reused.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the pool entry.
+
+**/
+EFI_STATUS
+HttpPoolPutConnection (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTP_SERVICE          *HttpService;
+  HTTP_IDLE_CONNECTION  *Connection;
+  HTTP_IDLE_CONNECTION  *Oldest;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+  Oldest      = NULL;
+
+  if ((PcdGet8 (PcdHttpConnectionPoolSize) == 0) ||
+      (HttpInstance->State != HTTP_STATE_TCP_CONNECTED) ||
+      (HttpInstance->RemoteHost == NULL) ||
+      HttpInstance->ConnectionClose ||
+      HttpInstance->UseHttps ||
+      HttpInstance->ProxyConnected ||
+      (HttpInstance->ProxyUrl != NULL) ||
+      (HttpInstance->MsgParser != NULL) ||
+      (HttpInstance->CacheBody != NULL) ||
+      !NetMapIsEmpty (&HttpInstance->TxTokens) ||
+      !NetMapIsEmpty (&HttpInstance->RxTokens))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (!HttpPoolIsEstablished (HttpInstance->LocalAddressIsIPv6, HttpInstance->Tcp4, HttpInstance->Tcp6)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Connection = AllocateZeroPool (sizeof (HTTP_IDLE_CONNECTION));
+  if (Connection == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Connection->IsIPv6     = HttpInstance->LocalAddressIsIPv6;
+  Connection->RemoteHost = HttpInstance->RemoteHost;
+  Connection->RemotePort = HttpInstance->RemotePort;
+
+  if (!Connection->IsIPv6) {
+    Connection->TcpChildHandle = HttpInstance->Tcp4ChildHandle;
+    Connection->Tcp4           = HttpInstance->Tcp4;
+    IP4_COPY_ADDRESS (&Connection->RemoteAddr, &HttpInstance->RemoteAddr);
+    CopyMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (Connection->IPv4Node));
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp4ChildHandle = NULL;
+    HttpInstance->Tcp4            = NULL;
+  } else {
+    Connection->TcpChildHandle = HttpInstance->Tcp6ChildHandle;
+    Connection->Tcp6           = HttpInstance->Tcp6;
+    IP6_COPY_ADDRESS (&Connection->RemoteIpv6Addr, &HttpInstance->RemoteIpv6Addr);
+    CopyMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Connection->Ipv6Node));
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    HttpInstance->Tcp6ChildHandle = NULL;
+    HttpInstance->Tcp6            = NULL;
+  }
+
+  HttpInstance->RemoteHost = NULL;
+  HttpInstance->RemotePort = 0;
+  HttpInstance->State      = HTTP_STATE_TCP_UNCONFIGED;
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (HttpService->IdleConnectionCount >= PcdGet8 (PcdHttpConnectionPoolSize)) {
+    Oldest = NET_LIST_HEAD (&HttpService->IdleConnections, HTTP_IDLE_CONNECTION, Link);
+    RemoveEntryList (&Oldest->Link);
+    HttpService->IdleConnectionCount--;
+  }
+
+  InsertTailList (&HttpService->IdleConnections, &Connection->Link);
+  HttpService->IdleConnectionCount++;
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Oldest != NULL) {
+    HttpPoolDestroyConnection (HttpService, Oldest);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Replace the unused TCP child of an HTTP child by the TCP child of an idle
+  connection.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  Connection         The idle connection, removed from the pool.
+
+  @retval EFI_SUCCESS            The HTTP child uses the TCP child of Connection.
+  @retval Others                 Connection is not usable, nothing is changed.
+
+**/
+EFI_STATUS
+HttpPoolAttachConnection (
+  IN  HTTP_PROTOCOL         *HttpInstance,
+  IN  HTTP_IDLE_CONNECTION  *Connection
+  )
+{
+  EFI_STATUS    Status;
+  HTTP_SERVICE  *HttpService;
+
+  HttpService = HttpInstance->Service;
+
+  if (!HttpPoolIsEstablished (Connection->IsIPv6, Connection->Tcp4, Connection->Tcp6)) {
+    return EFI_NOT_READY;
+  }
+
+  Status = HttpCreateTcpConnCloseEvent (HttpInstance);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (!Connection->IsIPv6) {
+    Status = gBS->OpenProtocol (
+                    Connection->TcpChildHandle,
+                    &gEfiTcp4ProtocolGuid,
+                    (VOID **)&Connection->Tcp4,
+                    HttpService->Ip4DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+    if (EFI_ERROR (Status)) {
+      HttpCloseTcpConnCloseEvent (HttpInstance);
+      return Status;
+    }
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp4ChildHandle,
+           &gEfiTcp4ProtocolGuid,
+           HttpService->Ip4DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip4DriverBindingHandle,
+      &gEfiTcp4ServiceBindingProtocolGuid,
+      HttpInstance->Tcp4ChildHandle
+      );
+
+    HttpInstance->Tcp4ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp4            = Connection->Tcp4;
+    IP4_COPY_ADDRESS (&HttpInstance->RemoteAddr, &Connection->RemoteAddr);
+  } else {
+    Status = gBS->OpenProtocol (
+                    Connection->TcpChildHandle,
+                    &gEfiTcp6ProtocolGuid,
+                    (VOID **)&Connection->Tcp6,
+                    HttpService->Ip6DriverBindingHandle,
+                    HttpInstance->Handle,
+                    EFI_OPEN_PROTOCOL_BY_CHILD_CONTROLLER
+                    );
+    if (EFI_ERROR (Status)) {
+      HttpCloseTcpConnCloseEvent (HttpInstance);
+      return Status;
+    }
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpService->ControllerHandle
+           );
+
+    gBS->CloseProtocol (
+           HttpInstance->Tcp6ChildHandle,
+           &gEfiTcp6ProtocolGuid,
+           HttpService->Ip6DriverBindingHandle,
+           HttpInstance->Handle
+           );
+
+    NetLibDestroyServiceChild (
+      HttpService->ControllerHandle,
+      HttpService->Ip6DriverBindingHandle,
+      &gEfiTcp6ServiceBindingProtocolGuid,
+      HttpInstance->Tcp6ChildHandle
+      );
+
+    HttpInstance->Tcp6ChildHandle = Connection->TcpChildHandle;
+    HttpInstance->Tcp6            = Connection->Tcp6;
+    IP6_COPY_ADDRESS (&HttpInstance->RemoteIpv6Addr, &Connection->RemoteIpv6Addr);
+  }
+
+  HttpInstance->State = HTTP_STATE_TCP_CONNECTED;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Take over an idle connection to the remote host from the pool of the HTTP
+  service, in place of the TCP child of the HTTP child. This is only done for
+  the first request of an HTTP child, before its TCP child is configured.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  HostName           The host name of the request URL.
+  @param[in]  RemotePort         The port of the request URL.
+
+  @retval EFI_SUCCESS            The HTTP child uses the pooled connection.
+  @retval EFI_NOT_FOUND          No idle connection to the host is usable.
+
+**/
+EFI_STATUS
+HttpPoolTakeConnection (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *HostName,
+  IN  UINT16         RemotePort
+  )
+{
+  EFI_STATUS            Status;
+  HTTP_SERVICE          *HttpService;
+  HTTP_IDLE_CONNECTION  *Connection;
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *Next;
+  EFI_TPL               OldTpl;
+
+  HttpService = HttpInstance->Service;
+
+  if (HttpInstance->State != HTTP_STATE_HTTP_CONFIGED) {
+    return EFI_NOT_FOUND;
+  }
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->IdleConnections) {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+
+    if ((Connection->IsIPv6 != HttpInstance->LocalAddressIsIPv6) ||
+        (Connection->RemotePort != RemotePort) ||
+        (AsciiStrCmp (Connection->RemoteHost, HostName) != 0))
+    {
+      continue;
+    }
+
+    if (!Connection->IsIPv6) {
+      if (CompareMem (&Connection->IPv4Node, &HttpInstance->IPv4Node, sizeof (Connection->IPv4Node)) != 0) {
+        continue;
+      }
+    } else {
+      if (CompareMem (&Connection->Ipv6Node, &HttpInstance->Ipv6Node, sizeof (Connection->Ipv6Node)) != 0) {
+        continue;
+      }
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+    RemoveEntryList (&Connection->Link);
+    HttpService->IdleConnectionCount--;
+    gBS->RestoreTPL (OldTpl);
+
+    Status = HttpPoolAttachConnection (HttpInstance, Connection);
+    if (EFI_ERROR (Status)) {
+      //
+      // The server may have closed the idle connection meanwhile.
+      //
+      HttpPoolDestroyConnection (HttpService, Connection);
+      continue;
+    }
+
+    HttpService->PoolHitCount++;
+
+    FreePool (Connection->RemoteHost);
+    FreePool (Connection);
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Close all the idle connections of the HTTP service over TCP4 or TCP6.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  UsingIpv6          TRUE to close the TCP6 connections,
+                                 FALSE to close the TCP4 connections.
+
+**/
+VOID
+HttpPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  )
+{
+  HTTP_IDLE_CONNECTION  *Connection;
+  LIST_ENTRY            *Entry;
+  LIST_ENTRY            *Next;
+
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &HttpService->IdleConnections) {
+    Connection = NET_LIST_USER_STRUCT (Entry, HTTP_IDLE_CONNECTION, Link);
+    if (Connection->IsIPv6 == UsingIpv6) {
+      RemoveEntryList (&Connection->Link);
+      HttpService->IdleConnectionCount--;
+      HttpPoolDestroyConnection (HttpService, Connection);
+    }
+  }
+}
+
+/**
+  Send the request kept in ReplayMsg again over a new TCP connection, after
+  the connection taken from the pool failed before the response header.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  Timeout            The event signaled when the request times out.
+
+  @retval EFI_SUCCESS            The request is sent over a new connection.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the transmit resources.
+  @retval EFI_TIMEOUT            The request was not sent in time.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpPoolReplayRequest (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  EFI_EVENT      Timeout
+  )
+{
+  EFI_STATUS         Status;
+  EFI_HTTP_TOKEN     Token;
+  HTTP_TOKEN_WRAP    *Wrap;
+  UINT8              *RequestMsg;
+  EFI_TCP4_IO_TOKEN  *Rx4Token;
+  EFI_TCP6_IO_TOKEN  *Rx6Token;
+
+  ASSERT (HttpInstance->ReplayMsg != NULL);
+
+  DEBUG ((DEBUG_NET, "HttpPoolReplayRequest: pooled connection to %a failed\n", HttpInstance->RemoteHost));
+
+  //
+  // Release the receive token of the failed response header.
+  //
+  if (HttpInstance->LocalAddressIsIPv6) {
+    Rx6Token = &HttpInstance->Rx6Token;
+    if (Rx6Token->CompletionToken.Event != NULL) {
+      gBS->CloseEvent (Rx6Token->CompletionToken.Event);
+      Rx6Token->CompletionToken.Event = NULL;
+    }
+
+    if (Rx6Token->Packet.RxData->FragmentTable[0].FragmentBuffer != NULL) {
+      FreePool (Rx6Token->Packet.RxData->FragmentTable[0].FragmentBuffer);
+      Rx6Token->Packet.RxData->FragmentTable[0].FragmentBuffer = NULL;
+    }
+  } else {
+    Rx4Token = &HttpInstance->Rx4Token;
+    if (Rx4Token->CompletionToken.Event != NULL) {
+      gBS->CloseEvent (Rx4Token->CompletionToken.Event);
+      Rx4Token->CompletionToken.Event = NULL;
+    }
+
+    if (Rx4Token->Packet.RxData->FragmentTable[0].FragmentBuffer != NULL) {
+      FreePool (Rx4Token->Packet.RxData->FragmentTable[0].FragmentBuffer);
+      Rx4Token->Packet.RxData->FragmentTable[0].FragmentBuffer = NULL;
+    }
+  }
+
+  HttpCloseConnection (HttpInstance);
+
+  if (HttpInstance->LocalAddressIsIPv6) {
+    Status = HttpConnectTcp6 (HttpInstance, FALSE);
+  } else {
+    Status = HttpConnectTcp4 (HttpInstance, FALSE);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The user's token belongs to the original transmit, send the copy with a
+  // token of our own and wait for it.
+  //
+  ZeroMem (&Token, sizeof (Token));
+  Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &Token.Event);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  RequestMsg = NULL;
+  Wrap       = AllocateZeroPool (sizeof (HTTP_TOKEN_WRAP));
+  if (Wrap == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  Wrap->HttpToken    = &Token;
+  Wrap->HttpInstance = HttpInstance;
+
+  Status = HttpCreateTcpTxEvent (Wrap);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  RequestMsg = AllocateCopyPool (HttpInstance->ReplayMsgSize, HttpInstance->ReplayMsg);
+  if (RequestMsg == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  //
+  // The transmit DPC frees RequestMsg and closes the transmit event.
+  //
+  Status = HttpTransmitTcp (HttpInstance, Wrap, RequestMsg, HttpInstance->ReplayMsgSize);
+  if (EFI_ERROR (Status)) {
+    goto ON_EXIT;
+  }
+
+  RequestMsg = NULL;
+
+  while (!Wrap->TcpWrap.IsTxDone && EFI_ERROR (gBS->CheckEvent (Timeout))) {
+    if (HttpInstance->LocalAddressIsIPv6) {
+      HttpInstance->Tcp6->Poll (HttpInstance->Tcp6);
+    } else {
+      HttpInstance->Tcp4->Poll (HttpInstance->Tcp4);
+    }
+  }
+
+  if (!Wrap->TcpWrap.IsTxDone) {
+    //
+    // Aborting the connection completes the pending transmit token.
+    //
+    HttpCloseConnection (HttpInstance);
+    DispatchDpc ();
+    ASSERT (Wrap->TcpWrap.IsTxDone);
+    Status = EFI_TIMEOUT;
+  } else {
+    Status = Token.Status;
+  }
+
+  FreePool (Wrap);
+  Wrap = NULL;
+
+ON_EXIT:
+  if (RequestMsg != NULL) {
+    FreePool (RequestMsg);
+  }
+
+  if (Wrap != NULL) {
+    if (HttpInstance->LocalAddressIsIPv6) {
+      if (Wrap->TcpWrap.Tx6Token.CompletionToken.Event != NULL) {
+        gBS->CloseEvent (Wrap->TcpWrap.Tx6Token.CompletionToken.Event);
+      }
+    } else {
+      if (Wrap->TcpWrap.Tx4Token.CompletionToken.Event != NULL) {
+        gBS->CloseEvent (Wrap->TcpWrap.Tx4Token.CompletionToken.Event);
+      }
+    }
+
+    FreePool (Wrap);
+  }
+
+  gBS->CloseEvent (Token.Event);
+  return Status;
+}
+
 /**
   Configure TCP4 protocol child.
 
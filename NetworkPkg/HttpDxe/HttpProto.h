@@ -49,6 +49,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_URL_BUFFER_LEN  4096
 
+//
+// The performance record of an HTTP request, from Request() to the reception
+// of the response header, logged against the handle of the HTTP child.
+//
+#define HTTP_PERF_REQUEST_TOKEN  "HttpRequest"
+
 typedef struct _HTTP_SERVICE {
   UINT32                          Signature;
   EFI_SERVICE_BINDING_PROTOCOL    ServiceBinding;
@@ -60,8 +66,39 @@ typedef struct _HTTP_SERVICE {
   LIST_ENTRY                      ChildrenList;
   UINTN                           ChildrenNumber;
   INTN                            State;
+
+  //
+  // Idle keep-alive connections left by the HTTP children.
+  //
+  LIST_ENTRY                      IdleConnections;
+  UINTN                           IdleConnectionCount;
+
+  //
+  // Statistics of the connection reuse.
+  //
+  UINTN                           RequestCount;
+  UINTN                           ConnectCount;
+  UINTN                           PoolHitCount;
 } HTTP_SERVICE;
 
+//
+// An idle TCP connection in the pool of the HTTP service. The TCP child stays
+// opened BY_DRIVER on the controller, but by no HTTP child.
+//
+typedef struct {
+  LIST_ENTRY                 Link;
+  BOOLEAN                    IsIPv6;
+  EFI_HANDLE                 TcpChildHandle;
+  EFI_TCP4_PROTOCOL          *Tcp4;
+  EFI_TCP6_PROTOCOL          *Tcp6;
+  CHAR8                      *RemoteHost;
+  UINT16                     RemotePort;
+  EFI_IPv4_ADDRESS           RemoteAddr;
+  EFI_IPv6_ADDRESS           RemoteIpv6Addr;
+  EFI_HTTPv4_ACCESS_POINT    IPv4Node;
+  EFI_HTTPv6_ACCESS_POINT    Ipv6Node;
+} HTTP_IDLE_CONNECTION;
+
 typedef struct {
   EFI_TCP4_IO_TOKEN         Tx4Token;
   EFI_TCP4_TRANSMIT_DATA    Tx4Data;
@@ -206,6 +243,13 @@ typedef struct _HTTP_PROTOCOL {
   BOOLEAN                           TlsIsRxDone;
 
   BOOLEAN                           ConnectionClose;
+
+  //
+  // Copy of the request sent over a connection taken from the pool, sent
+  // again over a new connection if the server closed the pooled one.
+  //
+  CHAR8                             *ReplayMsg;
+  UINTN                             ReplayMsgSize;
 } HTTP_PROTOCOL;
 
 typedef struct {
@@ -371,6 +415,75 @@ HttpCloseConnection (
   IN  HTTP_PROTOCOL  *HttpInstance
   );
 
+/**
+  Move the TCP connection of an HTTP child to the idle connection pool of the
+  HTTP service, so that another HTTP child sending requests to the same host
+  can take it over without a new TCP handshake.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The TCP child is moved to the pool.
+  @retval EFI_UNSUPPORTED        The connection cannot be reused.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the pool entry.
+
+**/
+EFI_STATUS
+HttpPoolPutConnection (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Take over an idle connection to the remote host from the pool of the HTTP
+  service, in place of the TCP child of the HTTP child.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  HostName           The host name of the request URL.
+  @param[in]  RemotePort         The port of the request URL.
+
+  @retval EFI_SUCCESS            The HTTP child uses the pooled connection.
+  @retval EFI_NOT_FOUND          No idle connection to the host is usable.
+
+**/
+EFI_STATUS
+HttpPoolTakeConnection (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  CHAR8          *HostName,
+  IN  UINT16         RemotePort
+  );
+
+/**
+  Close all the idle connections of the HTTP service over TCP4 or TCP6.
+
+  @param[in]  HttpService        The HTTP service private data.
+  @param[in]  UsingIpv6          TRUE to close the TCP6 connections,
+                                 FALSE to close the TCP4 connections.
+
+**/
+VOID
+HttpPoolFlush (
+  IN  HTTP_SERVICE  *HttpService,
+  IN  BOOLEAN       UsingIpv6
+  );
+
+/**
+  Send the request kept in ReplayMsg again over a new TCP connection, after
+  the connection taken from the pool failed before the response header.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+  @param[in]  Timeout            The event signaled when the request times out.
+
+  @retval EFI_SUCCESS            The request is sent over a new connection.
+  @retval EFI_OUT_OF_RESOURCES   Failed to allocate the transmit resources.
+  @retval EFI_TIMEOUT            The request was not sent in time.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+HttpPoolReplayRequest (
+  IN  HTTP_PROTOCOL  *HttpInstance,
+  IN  EFI_EVENT      Timeout
+  );
+
 /**
   Configure TCP4 protocol child.
 
@@ -411,6 +411,14 @@ Ip4CleanService (
 
   IpSb->State = IP4_SERVICE_DESTROY;
 
+  DEBUG (
+    (DEBUG_NET,
+     "Ip4CleanService: %ld packets loaned, %ld copied (%ld bytes).\n",
+     IpSb->RxLoanCount,
+     IpSb->RxCopyCount,
+     IpSb->RxCopyBytes)
+    );
+
   if (IpSb->Timer != NULL) {
     gBS->SetTimer (IpSb->Timer, TimerCancel, 0);
     gBS->CloseEvent (IpSb->Timer);
@@ -216,6 +216,14 @@ struct _IP4_SERVICE {
 
   UINT32                             MaxPacketSize;
   UINT32                             OldMaxPacketSize; ///< The MTU before IPsec enable.
+
+  //
+  // Receive statistics. The packets wrap the frames loaned by MNP, and are
+  // only copied for an instance when several instances share them.
+  //
+  UINT64                             RxLoanCount;
+  UINT64                             RxCopyCount;
+  UINT64                             RxCopyBytes;
 };
 
 #define IP4_INSTANCE_FROM_PROTOCOL(Ip4) \
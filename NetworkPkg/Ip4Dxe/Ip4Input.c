@@ -1283,6 +1283,8 @@ Ip4InstanceDeliverPacket (
       }
 
       RemoveEntryList (&Packet->List);
+
+      IpInstance->Service->RxLoanCount++;
     } else {
       //
       // Create a duplicated packet if this packet is shared
@@ -1325,6 +1327,9 @@ Ip4InstanceDeliverPacket (
       NetbufFree (Packet);
 
       Packet = Dup;
+
+      IpInstance->Service->RxCopyCount++;
+      IpInstance->Service->RxCopyBytes += Dup->TotalSize;
     }
 
     //
@@ -1608,6 +1608,11 @@ NetbufQueFlush (
 /**
   Compute the checksum for a bulk of data.
 
+  The one's complement sum doesn't depend on the width of the words added,
+  as long as the carries are folded back at the end. The data is added 32 bits
+  at a time into a 64-bit accumulator, which can't overflow for any Len, then
+  folded to 16 bits.
+
   @param[in]   Bulk                  Pointer to the data.
   @param[in]   Len                   Length of the data, in bytes.
 
@@ -1621,7 +1626,8 @@ NetblockChecksum (
   IN UINT32  Len
   )
 {
-  register UINT32  Sum;
+  UINT64  Sum;
+  UINT32  *Word;
 
   Sum = 0;
 
@@ -1632,6 +1638,34 @@ NetblockChecksum (
     Sum += *(Bulk + Len - 1);
   }
 
+  //
+  // Align the data to 32 bits. Data at an odd address is added 16 bits at a
+  // time below.
+  //
+  if ((((UINTN)Bulk & 0x3) == 2) && (Len > 1)) {
+    Sum  += *(UINT16 *)Bulk;
+    Bulk += 2;
+    Len  -= 2;
+  }
+
+  if (((UINTN)Bulk & 0x3) == 0) {
+    Word = (UINT32 *)Bulk;
+
+    while (Len >= 16) {
+      Sum  += (UINT64)Word[0] + Word[1] + Word[2] + Word[3];
+      Word += 4;
+      Len  -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Word;
+      Word++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *)Word;
+  }
+
   while (Len > 1) {
     Sum  += *(UINT16 *)Bulk;
     Bulk += 2;
@@ -1639,10 +1673,10 @@ NetblockChecksum (
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 16 bits
   //
-  while ((Sum >> 16) != 0) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  while (RShiftU64 (Sum, 16) != 0) {
+    Sum = (Sum & 0xffff) + RShiftU64 (Sum, 16);
   }
 
   return (UINT16)Sum;
@@ -622,6 +622,16 @@ MnpDestroyDeviceData (
 
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  DEBUG (
+    (DEBUG_NET,
+     "MnpDestroyDeviceData: %ld frames (%ld bytes) received, %ld loaned, %ld copied (%ld bytes).\n",
+     MnpDeviceData->RxFrameCount,
+     MnpDeviceData->RxFrameBytes,
+     MnpDeviceData->RxLoanCount,
+     MnpDeviceData->RxCopyCount,
+     MnpDeviceData->RxCopyBytes)
+    );
+
   //
   // Free Vlan Config variable name string
   //
@@ -1273,6 +1283,8 @@ MnpStart (
     }
 
     MnpDeviceData->EnableSystemPoll = EnableSystemPoll;
+    MnpDeviceData->PollInterval     = MNP_SYS_POLL_INTERVAL;
+    MnpDeviceData->PollIdleCount    = 0;
   }
 
   //
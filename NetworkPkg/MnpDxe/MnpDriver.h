@@ -24,6 +24,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiLib.h>
 #include <Library/NetLib.h>
 #include <Library/DpcLib.h>
+#include <Library/PcdLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
@@ -69,6 +70,12 @@ typedef struct {
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The current period of the PollTimer, and the number of periods without
+  // any packet received, used by the adaptive receive polling.
+  //
+  UINT64                         PollInterval;
+  UINTN                          PollIdleCount;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -85,6 +92,17 @@ typedef struct {
   UINT32                         BufferLength;
   UINT32                         PaddingSize;
   NET_BUF                        *RxNbufCache;
+
+  //
+  // Receive statistics. Snp->Receive() copies each frame into a NET_BUF of
+  // the pool, which is then loaned to the MNP children. It is only copied
+  // again for a child when several children share the frame.
+  //
+  UINT64                         RxFrameCount;
+  UINT64                         RxFrameBytes;
+  UINT64                         RxLoanCount;
+  UINT64                         RxCopyCount;
+  UINT64                         RxCopyBytes;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
@@ -345,6 +345,15 @@ MnpInstanceDeliverPacket (
     NetbufDuplicate (RxDataWrap->Nbuf, DupNbuf, 0);
     MnpFreeNbuf (MnpDeviceData, RxDataWrap->Nbuf);
     RxDataWrap->Nbuf = DupNbuf;
+
+    MnpDeviceData->RxCopyCount++;
+    MnpDeviceData->RxCopyBytes += DupNbuf->TotalSize;
+  } else {
+    //
+    // The Nbuf filled by Snp->Receive() is loaned to the instance as is,
+    // and returns to the pool when the instance recycles the RxData.
+    //
+    MnpDeviceData->RxLoanCount++;
   }
 
   //
@@ -903,6 +912,9 @@ MnpReceivePacket (
     return EFI_DEVICE_ERROR;
   }
 
+  MnpDeviceData->RxFrameCount++;
+  MnpDeviceData->RxFrameBytes += BufLen;
+
   Trimmed = 0;
   if (Nbuf->TotalSize != BufLen) {
     //
@@ -1083,6 +1095,66 @@ MnpCheckMediaStatus (
   }
 }
 
+/**
+  Receive the pending packets from Snp in the system poll, and adapt the period
+  of the poll timer to the receive activity.
+
+  If the Snp provides the WaitForPacket event, it is checked first so that an
+  idle interface costs one status query per period. Otherwise, or when a packet
+  is pending, up to MNP_SYS_POLL_RX_BUDGET packets are received at once. The
+  timer period is switched to MNP_SYS_POLL_FAST_INTERVAL as soon as packets are
+  received, and back to MNP_SYS_POLL_INTERVAL after MNP_SYS_POLL_IDLE_COUNT
+  periods without any packet.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+
+**/
+VOID
+MnpAdaptivePoll (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData
+  )
+{
+  EFI_SIMPLE_NETWORK_PROTOCOL  *Snp;
+  EFI_STATUS                   Status;
+  UINTN                        Count;
+  UINT64                       Interval;
+
+  Snp   = MnpDeviceData->Snp;
+  Count = 0;
+
+  //
+  // CheckEvent() runs the notify function of the WaitForPacket event, which
+  // signals the event if the UNDI reports a received frame.
+  //
+  if ((Snp->WaitForPacket == NULL) || !EFI_ERROR (gBS->CheckEvent (Snp->WaitForPacket))) {
+    while (Count < MNP_SYS_POLL_RX_BUDGET) {
+      Status = MnpReceivePacket (MnpDeviceData);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      Count++;
+    }
+  }
+
+  if (Count != 0) {
+    MnpDeviceData->PollIdleCount = 0;
+    Interval                     = MNP_SYS_POLL_FAST_INTERVAL;
+  } else if (MnpDeviceData->PollIdleCount < MNP_SYS_POLL_IDLE_COUNT) {
+    MnpDeviceData->PollIdleCount++;
+    return;
+  } else {
+    Interval = MNP_SYS_POLL_INTERVAL;
+  }
+
+  if ((Interval != MnpDeviceData->PollInterval) && MnpDeviceData->EnableSystemPoll) {
+    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, Interval);
+    if (!EFI_ERROR (Status)) {
+      MnpDeviceData->PollInterval = Interval;
+    }
+  }
+}
+
 /**
   Poll to receive the packets from Snp. This function is either called by upperlayer
   protocols/applications or the system poll timer notify mechanism.
@@ -1106,7 +1178,11 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  if (PcdGetBool (PcdMnpAdaptiveReceive)) {
+    MnpAdaptivePoll (MnpDeviceData);
+  } else {
+    MnpReceivePacket (MnpDeviceData);
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
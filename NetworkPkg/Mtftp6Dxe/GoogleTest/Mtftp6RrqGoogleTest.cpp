@@ -0,0 +1,439 @@
+/** @file
+  Tests for Mtftp6Rrq.c.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/UefiBootServicesTableLib.h>
+  #include "../Mtftp6Impl.h"
+  #include "Mtftp6RrqGoogleTest.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////
+
+#define MTFTP6_TEST_BLKSIZE      512
+#define MTFTP6_TEST_DATA_PORT    1069
+#define MTFTP6_TEST_MAX_ACKS     64
+#define MTFTP6_TEST_FILE_BLOCKS  16
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These functions are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+
+//
+// The block numbers of the ACKs sent by the instance, in order.
+//
+UINT16  mAckBlock[MTFTP6_TEST_MAX_ACKS];
+UINTN   mAckCount;
+
+EFI_STATUS
+EFIAPI
+UdpIoSendDatagram (
+  IN  UDP_IO           *UdpIo,
+  IN  NET_BUF          *Packet,
+  IN  UDP_END_POINT    *EndPoint OPTIONAL,
+  IN  EFI_IP_ADDRESS   *Gateway  OPTIONAL,
+  IN  UDP_IO_CALLBACK  CallBack,
+  IN  VOID             *Context
+  )
+{
+  EFI_MTFTP6_PACKET  *Ack;
+
+  Ack = (EFI_MTFTP6_PACKET *)NetbufGetByte (Packet, 0, NULL);
+  if ((Ack != NULL) && (NTOHS (Ack->OpCode) == EFI_MTFTP6_OPCODE_ACK) && (mAckCount < MTFTP6_TEST_MAX_ACKS)) {
+    mAckBlock[mAckCount++] = NTOHS (Ack->Ack.Block[0]);
+  }
+
+  CallBack (Packet, NULL, EFI_SUCCESS, Context);
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+UdpIoRecvDatagram (
+  IN  UDP_IO           *UdpIo,
+  IN  UDP_IO_CALLBACK  CallBack,
+  IN  VOID             *Context,
+  IN  UINT32           HeadLen
+  )
+{
+  return EFI_SUCCESS;
+}
+
+UDP_IO *
+EFIAPI
+UdpIoCreateIo (
+  IN  EFI_HANDLE     Controller,
+  IN  EFI_HANDLE     ImageHandle,
+  IN  UDP_IO_CONFIG  Configure,
+  IN  UINT8          UdpVersion,
+  IN  VOID           *Context
+  )
+{
+  return NULL;
+}
+
+EFI_STATUS
+EFIAPI
+UdpIoFreeIo (
+  IN  UDP_IO  *UdpIo
+  )
+{
+  return EFI_SUCCESS;
+}
+
+VOID
+EFIAPI
+UdpIoCleanIo (
+  IN  UDP_IO  *UdpIo
+  )
+{
+}
+
+EFI_STATUS
+EFIAPI
+Mtftp6TestUdpGetModeData (
+  IN  EFI_UDP6_PROTOCOL                *This,
+  OUT EFI_UDP6_CONFIG_DATA             *Udp6ConfigData OPTIONAL,
+  OUT EFI_IP6_MODE_DATA                *Ip6ModeData    OPTIONAL,
+  OUT EFI_MANAGED_NETWORK_CONFIG_DATA  *MnpConfigData  OPTIONAL,
+  OUT EFI_SIMPLE_NETWORK_MODE          *SnpModeData    OPTIONAL
+  )
+{
+  if (Udp6ConfigData != NULL) {
+    ZeroMem (Udp6ConfigData, sizeof (EFI_UDP6_CONFIG_DATA));
+    Udp6ConfigData->RemotePort = MTFTP6_TEST_DATA_PORT;
+  }
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+Mtftp6TestUdpPoll (
+  IN EFI_UDP6_PROTOCOL  *This
+  )
+{
+  return EFI_SUCCESS;
+}
+
+//
+// The net buffers are freed through the boot services.
+//
+EFI_STATUS
+EFIAPI
+Mtftp6TestFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+EFI_TPL
+EFIAPI
+Mtftp6TestRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+VOID
+EFIAPI
+Mtftp6TestRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+////////////////////////////////////////////////////////////////////////
+// Mtftp6RrqOackValid Tests
+////////////////////////////////////////////////////////////////////////
+
+class Mtftp6RrqOackValidTest : public ::testing::Test {
+protected:
+  MTFTP6_INSTANCE Instance;
+  MTFTP6_EXT_OPTION_INFO RequestInfo;
+  MTFTP6_EXT_OPTION_INFO ReplyInfo;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Instance, sizeof (Instance));
+    ZeroMem (&RequestInfo, sizeof (RequestInfo));
+    ZeroMem (&ReplyInfo, sizeof (ReplyInfo));
+
+    RequestInfo.BitMap     = MTFTP6_OPT_BLKSIZE_BIT | MTFTP6_OPT_WINDOWSIZE_BIT;
+    RequestInfo.BlkSize    = 1428;
+    RequestInfo.WindowSize = 8;
+  }
+};
+
+// Test Description:
+// The server may answer with the requested window size or a smaller one.
+TEST_F (Mtftp6RrqOackValidTest, WindowSizeAccepted) {
+  ReplyInfo.BitMap     = MTFTP6_OPT_BLKSIZE_BIT | MTFTP6_OPT_WINDOWSIZE_BIT;
+  ReplyInfo.BlkSize    = 1428;
+  ReplyInfo.WindowSize = 8;
+  EXPECT_TRUE (Mtftp6RrqOackValid (&Instance, &ReplyInfo, &RequestInfo));
+
+  ReplyInfo.WindowSize = 4;
+  EXPECT_TRUE (Mtftp6RrqOackValid (&Instance, &ReplyInfo, &RequestInfo));
+
+  //
+  // The server may also leave the windowsize option out, which means a
+  // window of one block.
+  //
+  ReplyInfo.BitMap = MTFTP6_OPT_BLKSIZE_BIT;
+  EXPECT_TRUE (Mtftp6RrqOackValid (&Instance, &ReplyInfo, &RequestInfo));
+}
+
+// Test Description:
+// A window larger than requested is refused, even with a valid block size.
+TEST_F (Mtftp6RrqOackValidTest, LargerWindowSizeRejected) {
+  ReplyInfo.BitMap     = MTFTP6_OPT_BLKSIZE_BIT | MTFTP6_OPT_WINDOWSIZE_BIT;
+  ReplyInfo.BlkSize    = 512;
+  ReplyInfo.WindowSize = 16;
+  EXPECT_FALSE (Mtftp6RrqOackValid (&Instance, &ReplyInfo, &RequestInfo));
+}
+
+// Test Description:
+// A windowsize option that wasn't requested is refused.
+TEST_F (Mtftp6RrqOackValidTest, UnrequestedWindowSizeRejected) {
+  RequestInfo.BitMap = MTFTP6_OPT_BLKSIZE_BIT;
+
+  ReplyInfo.BitMap     = MTFTP6_OPT_BLKSIZE_BIT | MTFTP6_OPT_WINDOWSIZE_BIT;
+  ReplyInfo.BlkSize    = 1428;
+  ReplyInfo.WindowSize = 1;
+  EXPECT_FALSE (Mtftp6RrqOackValid (&Instance, &ReplyInfo, &RequestInfo));
+}
+
+////////////////////////////////////////////////////////////////////////
+// Mtftp6RrqHandleData Tests
+////////////////////////////////////////////////////////////////////////
+
+class Mtftp6RrqHandleDataTest : public ::testing::Test {
+protected:
+  MTFTP6_INSTANCE Instance;
+  EFI_MTFTP6_TOKEN Token;
+  EFI_MTFTP6_CONFIG_DATA Config;
+  UDP_IO UdpIo;
+  EFI_UDP6_PROTOCOL Udp6;
+  EFI_BOOT_SERVICES BootServices;
+  UINT8 Buffer[MTFTP6_TEST_FILE_BLOCKS * MTFTP6_TEST_BLKSIZE];
+  UINT8 Packet[MTFTP6_DATA_HEAD_LEN + MTFTP6_TEST_BLKSIZE];
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Instance, sizeof (Instance));
+    ZeroMem (&Token, sizeof (Token));
+    ZeroMem (&Config, sizeof (Config));
+    ZeroMem (&UdpIo, sizeof (UdpIo));
+    ZeroMem (&Udp6, sizeof (Udp6));
+    ZeroMem (&BootServices, sizeof (BootServices));
+    ZeroMem (Buffer, sizeof (Buffer));
+
+    BootServices.FreePool   = Mtftp6TestFreePool;
+    BootServices.RaiseTPL   = Mtftp6TestRaiseTpl;
+    BootServices.RestoreTPL = Mtftp6TestRestoreTpl;
+    gBS                     = &BootServices;
+
+    Udp6.GetModeData    = Mtftp6TestUdpGetModeData;
+    Udp6.Poll           = Mtftp6TestUdpPoll;
+    UdpIo.Protocol.Udp6 = &Udp6;
+
+    Token.Buffer     = Buffer;
+    Token.BufferSize = sizeof (Buffer);
+
+    Instance.Signature      = MTFTP6_INSTANCE_SIGNATURE;
+    Instance.Token          = &Token;
+    Instance.Config         = &Config;
+    Instance.UdpIo          = &UdpIo;
+    Instance.BlkSize        = MTFTP6_TEST_BLKSIZE;
+    Instance.WindowSize     = 4;
+    Instance.IsMaster       = TRUE;
+    Instance.ServerDataPort = MTFTP6_TEST_DATA_PORT;
+    InitializeListHead (&Instance.BlkList);
+    ASSERT_EQ (Mtftp6InitBlockRange (&Instance.BlkList, 1, 0xffff), EFI_SUCCESS);
+
+    mAckCount = 0;
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    LIST_ENTRY  *Entry;
+    LIST_ENTRY  *Next;
+
+    NET_LIST_FOR_EACH_SAFE (Entry, Next, &Instance.BlkList) {
+      RemoveEntryList (Entry);
+      FreePool (NET_LIST_USER_STRUCT (Entry, MTFTP6_BLOCK_RANGE, Link));
+    }
+
+    if (Instance.LastPacket != NULL) {
+      NetbufFree (Instance.LastPacket);
+    }
+  }
+
+  //
+  // Deliver block Block to the instance. The data of every block is filled
+  // with its block number. The last block of the file is a short one.
+  //
+  EFI_STATUS
+  ReceiveBlock (
+    UINT16   Block,
+    BOOLEAN  *IsCompleted
+    )
+  {
+    EFI_MTFTP6_PACKET  *Data;
+    NET_BUF            *UdpPacket;
+    UINT32             DataLen;
+    EFI_STATUS         Status;
+
+    DataLen = (Block == MTFTP6_TEST_FILE_BLOCKS) ? 1 : MTFTP6_TEST_BLKSIZE;
+    Data    = (EFI_MTFTP6_PACKET *)Packet;
+
+    Data->Data.OpCode = HTONS (EFI_MTFTP6_OPCODE_DATA);
+    Data->Data.Block  = HTONS (Block);
+    SetMem (Data->Data.Data, DataLen, (UINT8)Block);
+
+    //
+    // The instance keeps the last ACK for retransmission, the driver frees
+    // it when it sends the next one.
+    //
+    if (Instance.LastPacket != NULL) {
+      NetbufFree (Instance.LastPacket);
+      Instance.LastPacket = NULL;
+    }
+
+    UdpPacket = NetbufAlloc (MTFTP6_DATA_HEAD_LEN + DataLen);
+    if (UdpPacket == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Status = Mtftp6RrqHandleData (&Instance, Data, MTFTP6_DATA_HEAD_LEN + DataLen, &UdpPacket, IsCompleted);
+    if (UdpPacket != NULL) {
+      NetbufFree (UdpPacket);
+    }
+
+    return Status;
+  }
+};
+
+// Test Description:
+// Blocks received in order are ACKed once per window, and the last block
+// of the file is ACKed at once.
+TEST_F (Mtftp6RrqHandleDataTest, InOrderAckedPerWindow) {
+  BOOLEAN  IsCompleted;
+  UINT16   Block;
+
+  for (Block = 1; Block <= MTFTP6_TEST_FILE_BLOCKS; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+    EXPECT_EQ (IsCompleted, Block == MTFTP6_TEST_FILE_BLOCKS);
+  }
+
+  ASSERT_EQ (mAckCount, (UINTN)4);
+  EXPECT_EQ (mAckBlock[0], 4);
+  EXPECT_EQ (mAckBlock[1], 8);
+  EXPECT_EQ (mAckBlock[2], 12);
+  EXPECT_EQ (mAckBlock[3], 16);
+  EXPECT_EQ (Token.BufferSize, (UINT64)((MTFTP6_TEST_FILE_BLOCKS - 1) * MTFTP6_TEST_BLKSIZE + 1));
+}
+
+// Test Description:
+// After a lost block, the blocks that follow it in the window arrive out
+// of order. They are ACKed once per window, not once each, so that the
+// server doesn't restart the window for each of them. The retransmitted
+// window is then received in order and ACKed at its end.
+TEST_F (Mtftp6RrqHandleDataTest, GapAckedOncePerWindow) {
+  BOOLEAN  IsCompleted;
+  UINT16   Block;
+
+  ASSERT_EQ (ReceiveBlock (1, &IsCompleted), EFI_SUCCESS);
+
+  //
+  // Block 2 is lost, 3 to 8 arrive out of order.
+  //
+  for (Block = 3; Block <= 8; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+  }
+
+  ASSERT_EQ (mAckCount, (UINTN)2);
+  EXPECT_EQ (mAckBlock[0], 1);
+  EXPECT_EQ (mAckBlock[1], 1);
+
+  //
+  // The server restarts the window from block 2.
+  //
+  for (Block = 2; Block <= 5; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+  }
+
+  ASSERT_EQ (mAckCount, (UINTN)3);
+  EXPECT_EQ (mAckBlock[2], 5);
+  EXPECT_EQ (Buffer[1 * MTFTP6_TEST_BLKSIZE], 2);
+  EXPECT_EQ (Buffer[4 * MTFTP6_TEST_BLKSIZE], 5);
+}
+
+// Test Description:
+// When the ACK of a window is lost, the server retransmits the window. The
+// duplicate blocks are ACKed once, and the transfer carries on from the
+// next window.
+TEST_F (Mtftp6RrqHandleDataTest, RetransmittedWindowAckedOnce) {
+  BOOLEAN  IsCompleted;
+  UINT16   Block;
+
+  for (Block = 1; Block <= 4; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+  }
+
+  for (Block = 1; Block <= 4; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+  }
+
+  ASSERT_EQ (mAckCount, (UINTN)2);
+  EXPECT_EQ (mAckBlock[0], 4);
+  EXPECT_EQ (mAckBlock[1], 4);
+
+  for (Block = 5; Block <= 8; Block++) {
+    ASSERT_EQ (ReceiveBlock (Block, &IsCompleted), EFI_SUCCESS);
+  }
+
+  ASSERT_EQ (mAckCount, (UINTN)3);
+  EXPECT_EQ (mAckBlock[2], 8);
+}
+
+// Test Description:
+// Without the windowsize option, every block, in order or not, is ACKed.
+TEST_F (Mtftp6RrqHandleDataTest, LockStepAcksEveryBlock) {
+  BOOLEAN  IsCompleted;
+
+  Instance.WindowSize = 1;
+
+  ASSERT_EQ (ReceiveBlock (1, &IsCompleted), EFI_SUCCESS);
+  ASSERT_EQ (ReceiveBlock (3, &IsCompleted), EFI_SUCCESS);
+  ASSERT_EQ (ReceiveBlock (3, &IsCompleted), EFI_SUCCESS);
+  ASSERT_EQ (ReceiveBlock (2, &IsCompleted), EFI_SUCCESS);
+
+  ASSERT_EQ (mAckCount, (UINTN)4);
+  EXPECT_EQ (mAckBlock[0], 1);
+  EXPECT_EQ (mAckBlock[1], 1);
+  EXPECT_EQ (mAckBlock[2], 1);
+  EXPECT_EQ (mAckBlock[3], 2);
+}
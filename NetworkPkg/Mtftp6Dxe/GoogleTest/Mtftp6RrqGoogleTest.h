@@ -0,0 +1,57 @@
+/** @file
+  Exposes the functions needed to test the Mtftp6Rrq module.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef MTFTP6_RRQ_GOOGLE_TEST_H_
+#define MTFTP6_RRQ_GOOGLE_TEST_H_
+
+#include <Uefi.h>
+#include "../Mtftp6Impl.h"
+
+/**
+  Process the received data packets. It will save the block
+  then send back an ACK if it is active.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  Packet                The pointer to the received packet.
+  @param[in]  Len                   The length of the packet.
+  @param[out] UdpPacket             The net buf of received packet.
+  @param[out] IsCompleted           If TRUE, the download has been completed.
+                                    Otherwise, the download has not been completed.
+
+  @retval EFI_SUCCESS           The data packet was successfully processed.
+  @retval EFI_ABORTED           The download was aborted by the user.
+  @retval EFI_BUFFER_TOO_SMALL  The user-provided buffer is too small.
+
+**/
+EFI_STATUS
+Mtftp6RrqHandleData (
+  IN  MTFTP6_INSTANCE    *Instance,
+  IN  EFI_MTFTP6_PACKET  *Packet,
+  IN  UINT32             Len,
+  OUT NET_BUF            **UdpPacket,
+  OUT BOOLEAN            *IsCompleted
+  );
+
+/**
+  Validate whether the options received in the server's OACK packet is valid.
+
+  @param[in]  Instance              The pointer to the Mtftp6 instance.
+  @param[in]  ReplyInfo             The pointer to options information in reply packet.
+  @param[in]  RequestInfo           The pointer to requested options info.
+
+  @retval     TRUE                  If the option in the OACK is valid.
+  @retval     FALSE                 If the option is invalid.
+
+**/
+BOOLEAN
+Mtftp6RrqOackValid (
+  IN MTFTP6_INSTANCE         *Instance,
+  IN MTFTP6_EXT_OPTION_INFO  *ReplyInfo,
+  IN MTFTP6_EXT_OPTION_INFO  *RequestInfo
+  );
+
+#endif // MTFTP6_RRQ_GOOGLE_TEST_H_
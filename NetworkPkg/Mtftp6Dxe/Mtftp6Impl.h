@@ -86,6 +86,12 @@ struct _MTFTP6_INSTANCE {
   //
   UINT64                    AckedBlock;
 
+  //
+  // Record the number of blocks received out of order since the last block
+  // received in order.
+  //
+  UINT16                    OutOfOrder;
+
   EFI_IPv6_ADDRESS          ServerIp;
   UINT16                    ServerCmdPort;
   UINT16                    ServerDataPort;
@@ -241,6 +241,17 @@ Mtftp6RrqHandleData (
     NetbufFree (*UdpPacket);
     *UdpPacket = NULL;
 
+    //
+    // With a window of several blocks, all the blocks of the window that
+    // follow a lost one arrive out of order. Each ACK restarts the window
+    // on the server, so ACK once per window worth of such blocks, as in
+    // RFC7440. The retransmit timer covers a lost ACK.
+    //
+    Instance->OutOfOrder++;
+    if ((Instance->WindowSize > 1) && (((Instance->OutOfOrder - 1) % Instance->WindowSize) != 0)) {
+      return EFI_SUCCESS;
+    }
+
     //
     // If Expected is 0, (UINT16) (Expected - 1) is also the expected Ack number (65535).
     //
@@ -253,6 +264,8 @@ Mtftp6RrqHandleData (
     return Status;
   }
 
+  Instance->OutOfOrder = 0;
+
   //
   // Record the total received and saved block number.
   //
@@ -337,7 +350,7 @@ Mtftp6RrqOackValid (
   // return the timeout matches that requested.
   //
   if ((((ReplyInfo->BitMap & MTFTP6_OPT_BLKSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
-      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->BlkSize > RequestInfo->BlkSize)) ||
+      (((ReplyInfo->BitMap & MTFTP6_OPT_WINDOWSIZE_BIT) != 0) && (ReplyInfo->WindowSize > RequestInfo->WindowSize)) ||
       (((ReplyInfo->BitMap & MTFTP6_OPT_TIMEOUT_BIT) != 0) && (ReplyInfo->Timeout != RequestInfo->Timeout))
       )
   {
@@ -958,6 +958,7 @@ Mtftp6OperationClean (
   Instance->WindowSize     = 1;
   Instance->TotalBlock     = 0;
   Instance->AckedBlock     = 0;
+  Instance->OutOfOrder     = 0;
   Instance->LastBlk        = 0;
   Instance->PacketToLive   = 0;
   Instance->MaxRetry       = 0;
@@ -0,0 +1,240 @@
+/** @file
+  Tests for TcpCongestion.c.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../TcpMain.h"
+  #include "TcpCongestionGoogleTest.h"
+}
+
+/////////////////////////////////////////////////////////////////////////
+// Defines
+///////////////////////////////////////////////////////////////////////
+
+#define TCP_TEST_MSS  1460
+
+//
+// The path of the throughput test: one tick of round trip time, a
+// bandwidth delay product of 4096 segments and a loss rate of one
+// segment in 100000.
+//
+#define TCP_TEST_PATH_BDP     4096
+#define TCP_TEST_PATH_LOSS    100000
+#define TCP_TEST_PATH_ROUNDS  3000
+
+////////////////////////////////////////////////////////////////////////
+// TcpCubicRoot Tests
+////////////////////////////////////////////////////////////////////////
+
+// Test Description:
+// The cube root is the largest integer whose cube is not greater than the value.
+TEST (TcpCubicRootTest, ComputesIntegerCubeRoot) {
+  EXPECT_EQ (TcpCubicRoot (0), 0u);
+  EXPECT_EQ (TcpCubicRoot (1), 1u);
+  EXPECT_EQ (TcpCubicRoot (7), 1u);
+  EXPECT_EQ (TcpCubicRoot (8), 2u);
+  EXPECT_EQ (TcpCubicRoot (26), 2u);
+  EXPECT_EQ (TcpCubicRoot (27), 3u);
+  EXPECT_EQ (TcpCubicRoot (1000000000000000000ULL), 1000000u);
+  EXPECT_EQ (TcpCubicRoot (MAX_UINT64), 2642245u);
+}
+
+////////////////////////////////////////////////////////////////////////
+// TcpCongestion Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpCongestionTest : public ::testing::Test {
+protected:
+  TCP_CB Tcb;
+  UINT32 Random;
+
+  virtual void
+  SetUp (
+    )
+  {
+    ZeroMem (&Tcb, sizeof (Tcb));
+    Tcb.SndMss   = TCP_TEST_MSS;
+    Tcb.CWnd     = 100 * TCP_TEST_MSS;
+    Tcb.Ssthresh = 0xffffffff;
+    Tcb.SRtt     = 1 << TCP_RTT_SHIFT;
+    mTcpTick     = 1000;
+    Random       = 1;
+  }
+
+  // A deterministic pseudo random number, so that both algorithms
+  // see the same losses.
+  UINT32
+  NextRandom (
+    )
+  {
+    Random = Random * 1103515245 + 12345;
+    return Random >> 1;
+  }
+
+  // React to a loss like TcpFastRecover, then finish the recovery.
+  void
+  Loss (
+    )
+  {
+    Tcb.Ssthresh     = TcpCongestionOnLoss (&Tcb, Tcb.CWnd);
+    Tcb.CWnd         = Tcb.Ssthresh;
+    Tcb.CongestState = TCP_CONGEST_OPEN;
+  }
+
+  // Send over the lossy path for a number of round trips and return
+  // the number of segments delivered.
+  UINT64
+  Transfer (
+    UINT8  CongestControl
+    )
+  {
+    UINT64  Delivered;
+    UINT32  Round;
+    UINT32  Segments;
+    UINT32  Index;
+    BOOLEAN Lost;
+
+    Tcb.CongestControl = CongestControl;
+    Delivered          = 0;
+
+    for (Round = 0; Round < TCP_TEST_PATH_ROUNDS; Round++) {
+      Segments = Tcb.CWnd / TCP_TEST_MSS;
+      Lost     = FALSE;
+
+      for (Index = 0; Index < Segments; Index++) {
+        if ((NextRandom () % TCP_TEST_PATH_LOSS) == 0) {
+          Lost = TRUE;
+        }
+      }
+
+      //
+      // The bottleneck drops what exceeds the bandwidth delay product.
+      //
+      if (Segments > TCP_TEST_PATH_BDP) {
+        Segments = TCP_TEST_PATH_BDP;
+        Lost     = TRUE;
+      }
+
+      Delivered += Segments;
+      mTcpTick++;
+
+      if (Lost) {
+        Loss ();
+        continue;
+      }
+
+      for (Index = 0; Index < Segments; Index++) {
+        if (Tcb.CWnd < Tcb.Ssthresh) {
+          Tcb.CWnd += Tcb.SndMss;
+        } else {
+          TcpCongestionAvoid (&Tcb);
+        }
+      }
+    }
+
+    return Delivered;
+  }
+};
+
+// Test Description:
+// On a loss NewReno halves the window and CUBIC reduces it to 70%.
+TEST_F (TcpCongestionTest, WindowReductionOnLoss) {
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_NEWRENO;
+  EXPECT_EQ (TcpCongestionOnLoss (&Tcb, Tcb.CWnd), 50u * TCP_TEST_MSS);
+  EXPECT_EQ (TcpCongestionOnLoss (&Tcb, TCP_TEST_MSS), 2u * TCP_TEST_MSS);
+
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_CUBIC;
+  EXPECT_EQ (TcpCongestionOnLoss (&Tcb, Tcb.CWnd), 70u * TCP_TEST_MSS);
+  EXPECT_EQ (Tcb.CubicWMax, 100u * TCP_TEST_MSS);
+  EXPECT_FALSE (Tcb.CubicEpochOn);
+
+  //
+  // Fast convergence: a window that stopped short of the last
+  // maximum lowers the maximum further.
+  //
+  Tcb.CWnd = 80 * TCP_TEST_MSS;
+  EXPECT_EQ (TcpCongestionOnLoss (&Tcb, Tcb.CWnd), 56u * TCP_TEST_MSS);
+  EXPECT_EQ (Tcb.CubicWMax, 68u * TCP_TEST_MSS);
+
+  //
+  // Repeated timeouts don't change the maximum.
+  //
+  Tcb.CongestState = TCP_CONGEST_LOSS;
+  Tcb.CWnd         = TCP_TEST_MSS;
+  TcpCongestionOnLoss (&Tcb, Tcb.CWnd);
+  EXPECT_EQ (Tcb.CubicWMax, 68u * TCP_TEST_MSS);
+}
+
+// Test Description:
+// After a reduction, CUBIC grows the window back close to the last
+// maximum in about K seconds, then slowly probes beyond it.
+TEST_F (TcpCongestionTest, CubicRecoversToLastMaximum) {
+  UINT32  Index;
+  UINT32  Round;
+
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_CUBIC;
+  Tcb.CWnd           = 1000 * TCP_TEST_MSS;
+  Loss ();
+  EXPECT_EQ (Tcb.CWnd, 700u * TCP_TEST_MSS);
+
+  //
+  // K = cbrt (1000 * 0.3 / 0.4) = 9.08 seconds, or about 45 ticks.
+  //
+  for (Round = 0; Round < 45; Round++) {
+    mTcpTick++;
+    for (Index = 0; Index < Tcb.CWnd / TCP_TEST_MSS; Index++) {
+      TcpCongestionAvoid (&Tcb);
+    }
+  }
+
+  EXPECT_GE (Tcb.CubicK, 9000u);
+  EXPECT_LE (Tcb.CubicK, 9100u);
+  EXPECT_GE (Tcb.CWnd, 980u * TCP_TEST_MSS);
+  EXPECT_LE (Tcb.CWnd, 1020u * TCP_TEST_MSS);
+
+  for (Round = 0; Round < 45; Round++) {
+    mTcpTick++;
+    for (Index = 0; Index < Tcb.CWnd / TCP_TEST_MSS; Index++) {
+      TcpCongestionAvoid (&Tcb);
+    }
+  }
+
+  EXPECT_GT (Tcb.CWnd, 1200u * TCP_TEST_MSS);
+}
+
+// Test Description:
+// NewReno grows the window by one segment per round trip.
+TEST_F (TcpCongestionTest, NewRenoAddsOneSegmentPerRtt) {
+  UINT32  Index;
+
+  Tcb.CongestControl = TCP_CONGEST_CONTROL_NEWRENO;
+  for (Index = 0; Index < 100; Index++) {
+    TcpCongestionAvoid (&Tcb);
+  }
+
+  EXPECT_GE (Tcb.CWnd, 100u * TCP_TEST_MSS + TCP_TEST_MSS - 100);
+  EXPECT_LE (Tcb.CWnd, 101u * TCP_TEST_MSS);
+}
+
+// Test Description:
+// On a path with a large bandwidth delay product and random losses,
+// CUBIC delivers more data than NewReno.
+TEST_F (TcpCongestionTest, CubicOutperformsNewRenoOnLossyPath) {
+  UINT64  NewReno;
+  UINT64  Cubic;
+
+  NewReno = Transfer (TCP_CONGEST_CONTROL_NEWRENO);
+
+  SetUp ();
+  Cubic = Transfer (TCP_CONGEST_CONTROL_CUBIC);
+
+  EXPECT_GT (Cubic, NewReno + NewReno / 2);
+}
@@ -0,0 +1,253 @@
+/** @file
+  Tests for the SACK options of TcpOption.c.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include <Library/MemoryAllocationLib.h>
+  #include <Library/UefiBootServicesTableLib.h>
+  #include "../TcpMain.h"
+}
+
+////////////////////////////////////////////////////////////////////////
+// Symbol Definitions
+// These are not directly under test - but required to compile
+////////////////////////////////////////////////////////////////////////
+UINT32  mTcpTick = 1000;
+
+//
+// The net buffers are freed through the boot services.
+//
+EFI_STATUS
+EFIAPI
+TcpTestFreePool (
+  IN VOID  *Buffer
+  )
+{
+  FreePool (Buffer);
+  return EFI_SUCCESS;
+}
+
+EFI_BOOT_SERVICES  mTcpTestBootServices;
+
+////////////////////////////////////////////////////////////////////////
+// TcpSackOption Tests
+////////////////////////////////////////////////////////////////////////
+
+class TcpSackOptionTest : public ::testing::Test {
+protected:
+  SOCKET Sock;
+  TCP_CB Tcb;
+
+  virtual void
+  SetUp (
+    )
+  {
+    mTcpTestBootServices.FreePool = TcpTestFreePool;
+    gBS                           = &mTcpTestBootServices;
+
+    ZeroMem (&Sock, sizeof (Sock));
+    ZeroMem (&Tcb, sizeof (Tcb));
+
+    Sock.RcvBuffer.HighWater = 0x10000;
+    Tcb.Sk                   = &Sock;
+    Tcb.RcvMss               = 1460;
+    Tcb.TsRecent             = 1;
+    InitializeListHead (&Tcb.RcvQue);
+  }
+
+  virtual void
+  TearDown (
+    )
+  {
+    LIST_ENTRY  *Entry;
+    LIST_ENTRY  *Next;
+
+    NET_LIST_FOR_EACH_SAFE (Entry, Next, &Tcb.RcvQue) {
+      RemoveEntryList (Entry);
+      NetbufFree (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+    }
+  }
+
+  // Queue a segment received out of order.
+  void
+  QueueSegment (
+    TCP_SEQNO  Seq,
+    TCP_SEQNO  End
+    )
+  {
+    NET_BUF  *Nbuf;
+
+    Nbuf = NetbufAlloc (0);
+    ASSERT_NE (Nbuf, nullptr);
+
+    TCPSEG_NETBUF (Nbuf)->Seq = Seq;
+    TCPSEG_NETBUF (Nbuf)->End = End;
+    InsertTailList (&Tcb.RcvQue, &Nbuf->List);
+  }
+
+  // Build the options of a segment with the given flags, then parse them back.
+  INTN
+  BuildAndParse (
+    UINT8       Flag,
+    UINT32      DataLen,
+    BOOLEAN     Syn,
+    TCP_OPTION  *Option
+    )
+  {
+    NET_BUF   *Nbuf;
+    TCP_HEAD  *Head;
+    UINT16    Len;
+    INTN      Result;
+
+    Nbuf = NetbufAlloc (TCP_MAX_HEAD + DataLen);
+    EXPECT_NE (Nbuf, nullptr);
+    NetbufReserve (Nbuf, TCP_MAX_HEAD);
+    if (DataLen != 0) {
+      NetbufAllocSpace (Nbuf, DataLen, NET_BUF_TAIL);
+    }
+
+    TCPSEG_NETBUF (Nbuf)->Flag = Flag;
+
+    if (Syn) {
+      Len = TcpSynBuildOption (&Tcb, Nbuf);
+    } else {
+      Len = TcpBuildOption (&Tcb, Nbuf);
+    }
+
+    EXPECT_LE (Len, TCP_OPTION_MAX_LEN);
+    EXPECT_EQ (Len % 4, 0);
+
+    Head = (TCP_HEAD *)NetbufAllocSpace (Nbuf, sizeof (TCP_HEAD), NET_BUF_HEAD);
+    ZeroMem (Head, sizeof (TCP_HEAD));
+    Head->HeadLen = (UINT8)((sizeof (TCP_HEAD) + Len) >> 2);
+
+    ZeroMem (Option, sizeof (TCP_OPTION));
+    Result = TcpParseOption (Head, Option);
+
+    NetbufFree (Nbuf);
+    return Result;
+  }
+};
+
+// Test Description:
+// An active open advertises SACK, a passive open only when the peer did.
+TEST_F (TcpSackOptionTest, SynAdvertisesSackPermitted) {
+  TCP_OPTION  Option;
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_SYN, 0, TRUE, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+  EXPECT_EQ (Option.Mss, 1460);
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_SYN | TCP_FLG_ACK, 0, TRUE, &Option), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+  EXPECT_EQ (BuildAndParse (TCP_FLG_SYN | TCP_FLG_ACK, 0, TRUE, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_NO_SACK);
+  EXPECT_EQ (BuildAndParse (TCP_FLG_SYN, 0, TRUE, &Option), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK_PERM));
+}
+
+// Test Description:
+// An ACK reports the out of order data, the block of the most recent
+// segment first, as many blocks as fit with the timestamp option.
+TEST_F (TcpSackOptionTest, AckReportsSackBlocks) {
+  TCP_OPTION  Option;
+
+  QueueSegment (1000, 2000);
+  QueueSegment (2000, 3000);
+  QueueSegment (5000, 6000);
+  QueueSegment (8000, 9000);
+  QueueSegment (11000, 12000);
+  Tcb.SackRcvSeq = 8000;
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK, 0, FALSE, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS));
+  ASSERT_EQ (Option.SackCount, 4);
+  EXPECT_EQ (Option.SackBlock[0].Left, 8000u);
+  EXPECT_EQ (Option.SackBlock[0].Right, 9000u);
+  EXPECT_EQ (Option.SackBlock[1].Left, 1000u);
+  EXPECT_EQ (Option.SackBlock[1].Right, 3000u);
+  EXPECT_EQ (Option.SackBlock[2].Left, 5000u);
+  EXPECT_EQ (Option.SackBlock[2].Right, 6000u);
+  EXPECT_EQ (Option.SackBlock[3].Left, 11000u);
+  EXPECT_EQ (Option.SackBlock[3].Right, 12000u);
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_SND_TS);
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK, 0, FALSE, &Option), 0);
+  EXPECT_TRUE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_TS));
+  ASSERT_EQ (Option.SackCount, 3);
+  EXPECT_EQ (Option.SackBlock[0].Left, 8000u);
+  EXPECT_EQ (Option.SackBlock[1].Left, 1000u);
+  EXPECT_EQ (Option.SackBlock[2].Left, 5000u);
+}
+
+// Test Description:
+// SACK blocks are not sent if the peer didn't permit them, nor on
+// segments carrying data.
+TEST_F (TcpSackOptionTest, NoSackBlocksWhenNotAllowed) {
+  TCP_OPTION  Option;
+
+  QueueSegment (5000, 6000);
+  Tcb.SackRcvSeq = 5000;
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK, 0, FALSE, &Option), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+
+  TCP_SET_FLG (Tcb.CtrlFlag, TCP_CTRL_RCVD_SACK);
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK, 100, FALSE, &Option), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK | TCP_FLG_RST, 0, FALSE, &Option), 0);
+  EXPECT_FALSE (TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK));
+
+  EXPECT_EQ (BuildAndParse (TCP_FLG_ACK, 0, FALSE, &Option), 0);
+  ASSERT_EQ (Option.SackCount, 1);
+  EXPECT_EQ (Option.SackBlock[0].Left, 5000u);
+  EXPECT_EQ (Option.SackBlock[0].Right, 6000u);
+}
+
+// Test Description:
+// A SACK option with a length that isn't a whole number of blocks is
+// rejected.
+TEST_F (TcpSackOptionTest, MalformedSackIsRejected) {
+  UINT8       Buffer[sizeof (TCP_HEAD) + 12];
+  TCP_HEAD    *Head;
+  TCP_OPTION  Option;
+  UINT8       *Data;
+
+  ZeroMem (Buffer, sizeof (Buffer));
+  Head          = (TCP_HEAD *)Buffer;
+  Head->HeadLen = sizeof (Buffer) >> 2;
+  Data          = (UINT8 *)(Head + 1);
+
+  Data[0] = TCP_OPTION_NOP;
+  Data[1] = TCP_OPTION_NOP;
+  Data[2] = TCP_OPTION_SACK;
+  Data[3] = 2 + TCP_OPTION_SACK_BLOCK_LEN + 1;
+
+  ZeroMem (&Option, sizeof (Option));
+  EXPECT_EQ (TcpParseOption (Head, &Option), -1);
+
+  Data[3] = 2 + TCP_OPTION_SACK_BLOCK_LEN;
+  Data[6]  = 0x10;
+  Data[10] = 0x20;
+
+  ZeroMem (&Option, sizeof (Option));
+  EXPECT_EQ (TcpParseOption (Head, &Option), 0);
+  ASSERT_EQ (Option.SackCount, 1);
+  EXPECT_EQ (Option.SackBlock[0].Left, 0x1000u);
+  EXPECT_EQ (Option.SackBlock[0].Right, 0x2000u);
+}
@@ -218,6 +218,8 @@ SockSetTcpRxData (
     RcvdBytes               -= CopyBytes;
     OffSet                  += CopyBytes;
   }
+
+  Sock->RcvCopiedBytes += OffSet;
 }
 
 /**
@@ -812,6 +814,13 @@ SockDestroy (
 {
   ASSERT (SockStream == Sock->Type);
 
+  DEBUG (
+    (DEBUG_NET,
+     "SockDestroy: %ld bytes queued by reference, %ld bytes copied to the application.\n",
+     Sock->RcvQueuedBytes,
+     Sock->RcvCopiedBytes)
+    );
+
   //
   // Flush the completion token buffered
   // by sock and rcv, snd buffer
@@ -1139,6 +1148,8 @@ SockDataRcvd (
 
   NetbufQueAppend (Sock->RcvBuffer.DataQueue, NetBuffer);
 
+  Sock->RcvQueuedBytes += NetBuffer->TotalSize;
+
   SockWakeRcvToken (Sock);
 }
 
@@ -473,6 +473,13 @@ struct _TCP_SOCKET {
   EFI_STATUS                  SockError;    ///< The error returned by low layer protocol
   BOOLEAN                     InDestroy;
 
+  //
+  // Receive statistics. The received segments are queued in the receive
+  // buffer by reference, and copied once into the application's buffers.
+  //
+  UINT64                      RcvQueuedBytes;
+  UINT64                      RcvCopiedBytes;
+
   //
   // Fields used to manage the connection request
   //
@@ -0,0 +1,243 @@
+/** @file
+  TCP congestion avoidance routines, with the standard algorithm of RFC5681
+  and the CUBIC algorithm of RFC8312.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC parameters of RFC8312, as fractions: C = 0.4, beta_cubic = 0.7.
+//
+#define TCP_CUBIC_C_NUM     4
+#define TCP_CUBIC_C_DEN     10
+#define TCP_CUBIC_BETA_NUM  7
+#define TCP_CUBIC_BETA_DEN  10
+
+//
+// The time since the start of the epoch is capped, in milliseconds,
+// to keep the cubic function in the range of 64-bit integers.
+//
+#define TCP_CUBIC_MAX_TIME  1000000
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value   The value to compute the cube root of.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Bit;
+  INTN    Shift;
+
+  Root = 0;
+
+  for (Shift = 63; Shift >= 0; Shift -= 3) {
+    Root = LShiftU64 (Root, 1);
+    Bit  = MultU64x32 (MultU64x32 (Root, (UINT32)Root + 1), 3) + 1;
+
+    if (RShiftU64 (Value, Shift) >= Bit) {
+      Value -= LShiftU64 (Bit, Shift);
+      Root++;
+    }
+  }
+
+  return (UINT32)Root;
+}
+
+/**
+  Compute the window of the cubic function W_cubic(t) of RFC8312.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]  Time    The time since the start of the epoch, in milliseconds.
+
+  @return The window of the cubic function, in bytes.
+
+**/
+UINT32
+TcpCubicWindow (
+  IN TCP_CB  *Tcb,
+  IN UINT32  Time
+  )
+{
+  UINT32  Delta;
+  UINT64  Offset;
+
+  Time = MIN (Time, TCP_CUBIC_MAX_TIME);
+
+  if (Time >= Tcb->CubicK) {
+    Delta = Time - Tcb->CubicK;
+  } else {
+    Delta = Tcb->CubicK - Time;
+  }
+
+  //
+  // C * (t - K)^3 segments, with t and K in milliseconds, is
+  // 4 * Delta^3 * SndMss / 10^10 bytes. Divide in two steps to
+  // stay in the range of 64-bit integers.
+  //
+  Offset = MultU64x32 (MultU64x32 (Delta, Delta), Delta);
+  Offset = DivU64x32 (Offset, 100000);
+  Offset = DivU64x32 (
+             MultU64x32 (Offset, TCP_CUBIC_C_NUM * Tcb->SndMss),
+             TCP_CUBIC_C_DEN * 10000
+             );
+
+  if (Time >= Tcb->CubicK) {
+    return (UINT32)MIN (Tcb->CubicOrigin + Offset, MAX_UINT32);
+  }
+
+  if (Offset >= Tcb->CubicOrigin) {
+    return Tcb->SndMss;
+  }
+
+  return (UINT32)(Tcb->CubicOrigin - Offset);
+}
+
+/**
+  Increase the congestion window in congestion avoidance with CUBIC.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicAvoid (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  Ticks;
+  UINT32  Time;
+  UINT32  Target;
+  UINT32  Increase;
+
+  //
+  // Start a new epoch on the first ACK in congestion avoidance after
+  // the window was reduced. K is the time the cubic function takes
+  // to grow from the current window to W_max.
+  //
+  if (!Tcb->CubicEpochOn) {
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+    Tcb->CubicWEst    = Tcb->CWnd;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicK = TcpCubicRoot (
+                      DivU64x32 (
+                        MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, 1000000000U / TCP_CUBIC_C_NUM * TCP_CUBIC_C_DEN),
+                        Tcb->SndMss
+                        )
+                      );
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    }
+  }
+
+  //
+  // The target is the window of the cubic function one RTT later.
+  //
+  Ticks = MIN (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch), TCP_CUBIC_MAX_TIME / TCP_TICK);
+  Time  = Ticks * TCP_TICK + (Tcb->SRtt >> TCP_RTT_SHIFT) * TCP_TICK;
+
+  Target = TcpCubicWindow (Tcb, Time);
+
+  //
+  // Stay in the Reno-friendly region: the window is never smaller
+  // than the one standard TCP would reach with the same beta,
+  // which grows alpha = 3 * (1 - beta) / (1 + beta) = 9 / 17 as
+  // fast. As in RFC9438, W_est grows by alpha * SMSS * SMSS / cwnd
+  // per ACK, so it follows the same ACK clock as the real window.
+  //
+  Tcb->CubicWEst += MAX (((UINT32)Tcb->SndMss * 9 / 17) * Tcb->SndMss / Tcb->CWnd, 1);
+  Target          = MAX (Target, Tcb->CubicWEst);
+
+  //
+  // Grow by (target - cwnd) / cwnd segments per ACK. The target is
+  // limited to 1.5 cwnd, and close to the plateau the window grows
+  // very slowly.
+  //
+  Target = MIN (Target, Tcb->CWnd + (Tcb->CWnd >> 1));
+
+  if (Target > Tcb->CWnd) {
+    Increase = (UINT32)DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Tcb->SndMss), Tcb->CWnd);
+  } else {
+    Increase = (UINT32)Tcb->SndMss * Tcb->SndMss / Tcb->CWnd / 100;
+  }
+
+  Tcb->CWnd += MAX (Increase, 1);
+}
+
+/**
+  Increase the congestion window for an ACK of new data in congestion
+  avoidance, with the congestion control algorithm selected for the TCB.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestionAvoid (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  if (Tcb->CongestControl == TCP_CONGEST_CONTROL_CUBIC) {
+    TcpCubicAvoid (Tcb);
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Compute the slow start threshold after a loss is detected, either by
+  duplicate ACKs or by a retransmission timeout.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data sent but not yet ACKed.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestionOnLoss (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  )
+{
+  if (Tcb->CongestControl != TCP_CONGEST_CONTROL_CUBIC) {
+    return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+  }
+
+  //
+  // Remember the window before the reduction. With fast convergence,
+  // a window that stopped short of the previous W_max releases some
+  // bandwidth to the new flows. Repeated timeouts don't count.
+  //
+  if (Tcb->CongestState != TCP_CONGEST_LOSS) {
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Tcb->CubicWMax = (UINT32)DivU64x32 (
+                                 MultU64x32 (Tcb->CWnd, TCP_CUBIC_BETA_DEN + TCP_CUBIC_BETA_NUM),
+                                 2 * TCP_CUBIC_BETA_DEN
+                                 );
+    } else {
+      Tcb->CubicWMax = Tcb->CWnd;
+    }
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (
+           (UINT32)DivU64x32 (MultU64x32 (FlightSize, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN),
+           (UINT32)(2 * Tcb->SndMss)
+           );
+}
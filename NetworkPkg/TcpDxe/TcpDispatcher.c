@@ -551,6 +551,10 @@ TcpConfigurePcb (
     );
 
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_KEEPALIVE);
+  if (!PcdGetBool (PcdTcpSackSupport)) {
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+  }
+
   Tcb->State = TCP_CLOSED;
 
   Tcb->SndMss = 536;
@@ -562,7 +566,8 @@ TcpConfigurePcb (
   Tcb->CWnd     = Tcb->SndMss;
   Tcb->Ssthresh = 0xffffffff;
 
-  Tcb->CongestState = TCP_CONGEST_OPEN;
+  Tcb->CongestState   = TCP_CONGEST_OPEN;
+  Tcb->CongestControl = PcdGet8 (PcdTcpCongestionControl);
 
   Tcb->KeepAliveIdle   = TCP_KEEPALIVE_IDLE_MIN;
   Tcb->KeepAlivePeriod = TCP_KEEPALIVE_PERIOD;
@@ -354,6 +354,54 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the first hole in the data SACKed by the peer, as the NextSeg ()
+  of RFC6675.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to search the hole from.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole to retransmit.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  );
+
+/**
+  Estimate the data still in the network during loss recovery, as the pipe
+  of RFC6675.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The estimated data in the network, in bytes.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB  *Tcb
+  );
+
+/**
+  Retransmit the holes in the data SACKed by the peer as long as the pipe
+  leaves room for one more segment in the congestion window.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to search the holes from.
+
+  @return The number of holes retransmitted.
+
+**/
+UINT32
+TcpSackRecover (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -445,6 +493,38 @@ TcpVerifySegment (
   IN NET_BUF  *Nbuf
   );
 
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Increase the congestion window for an ACK of new data in congestion
+  avoidance, with the congestion control algorithm selected for the TCB.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCongestionAvoid (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Compute the slow start threshold after a loss is detected, either by
+  duplicate ACKs or by a retransmission timeout.
+
+  @param[in, out]  Tcb         Pointer to the TCP_CB of this TCP instance.
+  @param[in]       FlightSize  The amount of data sent but not yet ACKed.
+
+  @return The new slow start threshold.
+
+**/
+UINT32
+TcpCongestionOnLoss (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  FlightSize
+  );
+
 //
 // Functions from TcpInput.c
 //
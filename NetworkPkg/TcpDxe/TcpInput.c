@@ -54,7 +54,7 @@ TcpFastRecover (
     //
     FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
 
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = TcpCongestionOnLoss (Tcb, FlightSize);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -63,9 +63,23 @@ TcpFastRecover (
     //
     // Step 2: Entering fast retransmission
     //
-    TcpRetransmit (Tcb, Tcb->SndUna);
+    Tcb->SackRexmitNxt = Tcb->SndUna;
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+      TcpSackRetransmit (Tcb, Tcb->SndUna);
+    } else {
+      TcpRetransmit (Tcb, Tcb->SndUna);
+    }
+
     Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
 
+    //
+    // With SACK, more holes may be retransmitted at once
+    // if the pipe of RFC6675 leaves room for them.
+    //
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+      TcpSackRecover (Tcb, Tcb->SndUna);
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: enter fast retransmission for TCB %p, recover point is %d\n",
@@ -82,12 +96,21 @@ TcpFastRecover (
     //
     // Step 3: Fast Recovery,
     // If this is a duplicated ACK, increse Cwnd by SMSS.
+    // With SACK, the segment that left the network is
+    // replaced by the retransmission of the next holes
+    // reported by the peer instead, as long as the pipe
+    // of RFC6675 stays below CWnd.
     //
 
     // Step 4 is skipped here only to be executed later
     // by TcpToSendData
     //
-    Tcb->CWnd += Tcb->SndMss;
+    if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) ||
+        (TcpSackRecover (Tcb, Tcb->SndUna) == 0))
+    {
+      Tcb->CWnd += Tcb->SndMss;
+    }
+
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +142,16 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, retransmit
+      // the holes not retransmitted yet that fit in the
+      // pipe of RFC6675.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+        TcpSackRecover (Tcb, Seg->Ack);
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -179,9 +209,19 @@ TcpFastLossRecover (
     } else {
       //
       // Partial ACK:
-      // fast retransmit the first unacknowledge field.
+      // fast retransmit the first unacknowledge field,
+      // skipping the data SACKed by the peer. With SACK,
+      // further holes are retransmitted while the pipe of
+      // RFC6675 leaves room for them in CWnd.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+        if (TcpSackRetransmit (Tcb, Seg->Ack) == 1) {
+          TcpSackRecover (Tcb, Seg->Ack);
+        }
+      } else {
+        TcpRetransmit (Tcb, Seg->Ack);
+      }
+
       DEBUG (
         (DEBUG_NET,
          "TcpFastLossRecover: received a partial ACK(%d) for TCB %p\n",
@@ -569,6 +609,7 @@ TcpQueueData (
   //
   if (IsListEmpty (Head)) {
     InsertTailList (Head, &Nbuf->List);
+    Tcb->SackRcvSeq = Seg->Seq;
     return 1;
   }
 
@@ -606,6 +647,7 @@ TcpQueueData (
 
   InsertHeadList (Prev, &Nbuf->List);
 
+  Tcb->SackRcvSeq = Seg->Seq;
   TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_ACK_NOW);
 
   //
@@ -691,6 +733,151 @@ TcpAdjustSndQue (
   return 1;
 }
 
+/**
+  Add a block of SACKed data to the SACK scoreboard, merging it with
+  the blocks it overlaps or adjoins.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number of the block.
+  @param[in]       Right    The sequence number following the block.
+
+**/
+VOID
+TcpSackAddBlock (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  UINT8  Index;
+  UINT8  Last;
+
+  //
+  // Find the first block that is not completely below the new one.
+  //
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_GEQ (Tcb->SackBlock[Index].Right, Left)) {
+      break;
+    }
+  }
+
+  //
+  // Absorb all the blocks that overlap or adjoin the new one.
+  //
+  for (Last = Index; Last < Tcb->SackCount; Last++) {
+    if (TCP_SEQ_GT (Tcb->SackBlock[Last].Left, Right)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Tcb->SackBlock[Last].Left, Left)) {
+      Left = Tcb->SackBlock[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Tcb->SackBlock[Last].Right, Right)) {
+      Right = Tcb->SackBlock[Last].Right;
+    }
+  }
+
+  if (Last == Index) {
+    //
+    // Nothing to merge, insert a new block. If the scoreboard is full,
+    // forget the highest block, the holes below it matter more.
+    //
+    if (Tcb->SackCount == TCP_SACK_SCOREBOARD_SIZE) {
+      if (Index == TCP_SACK_SCOREBOARD_SIZE) {
+        return;
+      }
+
+      Tcb->SackCount--;
+    }
+
+    CopyMem (
+      &Tcb->SackBlock[Index + 1],
+      &Tcb->SackBlock[Index],
+      (Tcb->SackCount - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackCount++;
+  } else if (Last > Index + 1) {
+    CopyMem (
+      &Tcb->SackBlock[Index + 1],
+      &Tcb->SackBlock[Last],
+      (Tcb->SackCount - Last) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackCount = (UINT8)(Tcb->SackCount - (Last - Index - 1));
+  }
+
+  Tcb->SackBlock[Index].Left  = Left;
+  Tcb->SackBlock[Index].Right = Right;
+}
+
+/**
+  Update the SACK scoreboard with the acknowledgment and the SACK
+  option of the received segment.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledge sequence number of the received segment.
+  @param[in]       Option   Pointer to the options of the received segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEQNO       Left;
+  TCP_SEQNO       Right;
+  UINT8           Index;
+  UINT8           Count;
+
+  //
+  // Remove the data cumulatively acknowledged from the scoreboard.
+  //
+  Count = 0;
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    Block = &Tcb->SackBlock[Index];
+
+    if (TCP_SEQ_LEQ (Block->Right, Ack)) {
+      continue;
+    }
+
+    Tcb->SackBlock[Count].Left  = TCP_SEQ_LT (Block->Left, Ack) ? Ack : Block->Left;
+    Tcb->SackBlock[Count].Right = Block->Right;
+    Count++;
+  }
+
+  Tcb->SackCount = Count;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackCount; Index++) {
+    Left  = Option->SackBlock[Index].Left;
+    Right = Option->SackBlock[Index].Right;
+
+    //
+    // Ignore the malformed blocks, the blocks for data not sent
+    // and the duplicate SACK blocks of RFC2883 below SEG.ACK.
+    //
+    if (TCP_SEQ_LEQ (Right, Left) ||
+        TCP_SEQ_LEQ (Right, Ack) ||
+        TCP_SEQ_GT (Right, Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Ack)) {
+      Left = Ack;
+    }
+
+    TcpSackAddBlock (Tcb, Left, Right);
+  }
+}
+
 /**
   Process the received TCP segments.
 
@@ -1213,6 +1400,10 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1236,7 +1427,7 @@ TcpInput (
       if (Tcb->CWnd < Tcb->Ssthresh) {
         Tcb->CWnd += Tcb->SndMss;
       } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+        TcpCongestionAvoid (Tcb);
       }
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
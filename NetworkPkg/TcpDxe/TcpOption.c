@@ -160,6 +160,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when SACK is not
+  // disabled, and either we are doing active open or we
+  // have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +194,89 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Collect the blocks of out-of-order data queued in the reassemble queue,
+  to be reported to the peer in a SACK option.
+
+  As required by RFC2018, the block that contains the most recently received
+  segment is reported first. The other blocks follow in sequence order.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the blocks.
+  @param[in]   MaxCount  The maximum number of blocks to collect, at least 1.
+
+  @return                The number of blocks collected.
+
+**/
+UINT8
+TcpSackCollectBlocks (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxCount
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEG     *Seg;
+  TCP_SEG     *Next;
+  TCP_SEQNO   Left;
+  TCP_SEQNO   Right;
+  BOOLEAN     Open;
+  BOOLEAN     Recent;
+  UINT8       Count;
+
+  ASSERT (MaxCount >= 1);
+
+  //
+  // The first slot is reserved for the block of the recent segment.
+  //
+  Count  = 1;
+  Open   = FALSE;
+  Recent = FALSE;
+  Left   = 0;
+  Right  = 0;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->RcvQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (!Open) {
+      Left  = Seg->Seq;
+      Right = Seg->End;
+      Open  = TRUE;
+    } else if (TCP_SEQ_GT (Seg->End, Right)) {
+      Right = Seg->End;
+    }
+
+    //
+    // Merge the segments that are contiguous in sequence space.
+    //
+    if (Entry->ForwardLink != &Tcb->RcvQue) {
+      Next = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry->ForwardLink, NET_BUF, List));
+      if (TCP_SEQ_LEQ (Next->Seq, Right)) {
+        continue;
+      }
+    }
+
+    Open = FALSE;
+
+    if (!Recent && TCP_SEQ_LEQ (Left, Tcb->SackRcvSeq) && TCP_SEQ_LT (Tcb->SackRcvSeq, Right)) {
+      Block[0].Left  = Left;
+      Block[0].Right = Right;
+      Recent         = TRUE;
+    } else if (Count < MaxCount) {
+      Block[Count].Left  = Left;
+      Block[Count].Right = Right;
+      Count++;
+    }
+  }
+
+  if (!Recent) {
+    Count--;
+    CopyMem (&Block[0], &Block[1], Count * sizeof (TCP_SACK_BLOCK));
+  }
+
+  return Count;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -187,11 +292,16 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCK];
+  UINT8           Count;
+  UINT8           Index;
+  BOOLEAN         HasData;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  HasData = (BOOLEAN)(Nbuf->TotalSize != 0);
 
   //
   // Build the Timestamp option.
@@ -214,6 +324,45 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option if some data is received out of
+  // order. The blocks are only added to segments without
+  // data, which can't exceed the MSS of the peer.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      !HasData &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    Count = TcpSackCollectBlocks (
+              Tcb,
+              Block,
+              (UINT8)MIN (
+                       TCP_OPTION_MAX_SACK_BLOCK,
+                       (TCP_OPTION_MAX_LEN - Len - 4) / TCP_OPTION_SACK_BLOCK_LEN
+                       )
+              );
+
+    if (Count != 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               4 + Count * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len = (UINT16)(Len + 4 + Count * TCP_OPTION_SACK_BLOCK_LEN);
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + Count * TCP_OPTION_SACK_BLOCK_LEN));
+
+      for (Index = 0; Index < Count; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,6 +388,7 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
@@ -297,6 +447,40 @@ TcpParseOption (
         Cur += TCP_OPTION_WS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+            ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN > TCP_OPTION_MAX_SACK_BLOCK) ||
+            (TotalLen - Cur < Len))
+        {
+          return -1;
+        }
+
+        Option->SackCount = (UINT8)((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN);
+        for (Index = 0; Index < Option->SackCount; Index++) {
+          Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_TS:
         Len = Head[Cur + 1];
 
@@ -24,6 +24,15 @@
 #define TCP_OPTION_WS_ALIGNED_LEN  4  ///< Length of window scale option, aligned
 #define TCP_OPTION_TS_ALIGNED_LEN  12 ///< Length of timestamp option, aligned
 
+//
+// Selective acknowledgment options of RFC2018 and their length.
+//
+#define TCP_OPTION_SACK_PERM              4  ///< SACK permitted
+#define TCP_OPTION_SACK                   5  ///< Selective acknowledgment
+#define TCP_OPTION_SACK_PERM_LEN          2  ///< Length of SACK permitted option
+#define TCP_OPTION_SACK_BLOCK_LEN         8  ///< Length of each block in SACK option
+#define TCP_OPTION_SACK_PERM_ALIGNED_LEN  4  ///< Length of SACK permitted option, aligned
+
 //
 // recommend format of timestamp window scale
 // option for fast process.
@@ -39,6 +48,15 @@
 
 #define TCP_OPTION_MSS_FAST  ((TCP_OPTION_MSS << 24) | (TCP_OPTION_MSS_LEN << 16))
 
+#define TCP_OPTION_SACK_PERM_FAST  ((TCP_OPTION_NOP << 24)       | \
+                                    (TCP_OPTION_NOP << 16)       | \
+                                    (TCP_OPTION_SACK_PERM << 8)  | \
+                                    (TCP_OPTION_SACK_PERM_LEN))
+
+#define TCP_OPTION_SACK_FAST  ((TCP_OPTION_NOP << 24) | \
+                               (TCP_OPTION_NOP << 16) | \
+                               (TCP_OPTION_SACK << 8))
+
 //
 // Other misc definitions
 //
@@ -48,16 +66,23 @@
 #define TCP_OPTION_MAX_WS    14            ///< Maximum window scale value
 #define TCP_OPTION_MAX_WIN   0xffff        ///< Max window size in TCP header
 
+#define TCP_OPTION_RCVD_SACK_PERM  0x08
+#define TCP_OPTION_RCVD_SACK       0x10
+#define TCP_OPTION_MAX_LEN         40      ///< Max length of the option field
+#define TCP_OPTION_MAX_SACK_BLOCK  4       ///< Max SACK blocks in the option space
+
 ///
 /// The structure to store the parse option value.
 /// ParseOption only parses the options, doesn't process them.
 ///
 typedef struct _TCP_OPTION {
-  UINT8     Flag;     ///< Flag such as TCP_OPTION_RCVD_MSS
-  UINT8     WndScale; ///< The WndScale received
-  UINT16    Mss;      ///< The Mss received
-  UINT32    TSVal;    ///< The TSVal field in a timestamp option
-  UINT32    TSEcr;    ///< The TSEcr field in a timestamp option
+  UINT8             Flag;                                 ///< Flag such as TCP_OPTION_RCVD_MSS
+  UINT8             WndScale;                             ///< The WndScale received
+  UINT16            Mss;                                  ///< The Mss received
+  UINT32            TSVal;                                ///< The TSVal field in a timestamp option
+  UINT32            TSEcr;                                ///< The TSEcr field in a timestamp option
+  UINT8             SackCount;                            ///< The number of blocks in a SACK option
+  TCP_SACK_BLOCK    SackBlock[TCP_OPTION_MAX_SACK_BLOCK]; ///< The blocks in a SACK option
 } TCP_OPTION;
 
 /**
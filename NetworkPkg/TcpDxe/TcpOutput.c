@@ -636,6 +636,7 @@ TcpRetransmit (
 {
   NET_BUF  *Nbuf;
   UINT32   Len;
+  UINT8    Index;
 
   //
   // Compute the maximum length of retransmission. It is
@@ -675,6 +676,16 @@ TcpRetransmit (
 
   Len = MIN (Len, Tcb->SndMss);
 
+  //
+  // Don't retransmit the data already SACKed by the peer.
+  //
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      Len = MIN (Len, TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Seq));
+      break;
+    }
+  }
+
   Nbuf = TcpGetSegmentSndQue (Tcb, Seq, Len);
   if (Nbuf == NULL) {
     return -1;
@@ -712,6 +723,169 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the first hole in the data SACKed by the peer, as the NextSeg ()
+  of RFC6675.
+
+  The hole is searched from sequence Seq, skipping the data SACKed by the
+  peer and the data already retransmitted in this recovery. Data above the
+  highest SACKed sequence is not known to be lost, only Seq itself is
+  retransmitted there, which is the same as NewReno.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to search the hole from.
+
+  @retval 1       A hole was retransmitted.
+  @retval 0       No hole to retransmit.
+  @retval -1      Error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  )
+{
+  TCP_SEQNO  Start;
+  TCP_SEQNO  End;
+  UINT8      Index;
+
+  Start = Seq;
+  if (TCP_SEQ_LT (Start, Tcb->SackRexmitNxt)) {
+    Start = Tcb->SackRexmitNxt;
+  }
+
+  End = Tcb->SndNxt;
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Start)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Left, Start)) {
+      Start = Tcb->SackBlock[Index].Right;
+      continue;
+    }
+
+    End = Tcb->SackBlock[Index].Left;
+    break;
+  }
+
+  if (((Index == Tcb->SackCount) && (Start != Seq)) || TCP_SEQ_GEQ (Start, Tcb->SndNxt)) {
+    return 0;
+  }
+
+  DEBUG (
+    (DEBUG_NET,
+     "TcpSackRetransmit: retransmit the hole at %d for TCB %p\n",
+     Start,
+     Tcb)
+    );
+
+  if (TcpRetransmit (Tcb, Start) != 0) {
+    return -1;
+  }
+
+  Tcb->SackRexmitNxt = Start + MIN (TCP_SUB_SEQ (End, Start), Tcb->SndMss);
+  return 1;
+}
+
+/**
+  Estimate the data still in the network during loss recovery, as the pipe
+  of RFC6675.
+
+  The holes below the highest sequence SACKed by the peer are taken as lost,
+  and after a retransmission timeout everything up to the recover point is.
+  The pipe is the data above the lost range, plus the data of the holes that
+  was retransmitted in this recovery and is not SACKed yet.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @return The estimated data in the network, in bytes.
+
+**/
+UINT32
+TcpSackPipe (
+  IN TCP_CB  *Tcb
+  )
+{
+  TCP_SEQNO  HighLost;
+  TCP_SEQNO  RexmitEnd;
+  UINT32     Pipe;
+  UINT8      Index;
+
+  HighLost = Tcb->SndUna;
+  if (Tcb->SackCount != 0) {
+    HighLost = Tcb->SackBlock[Tcb->SackCount - 1].Right;
+  }
+
+  if ((Tcb->CongestState == TCP_CONGEST_LOSS) && TCP_SEQ_GT (Tcb->LossRecover, HighLost)) {
+    HighLost = Tcb->LossRecover;
+  }
+
+  if (TCP_SEQ_GT (HighLost, Tcb->SndNxt)) {
+    HighLost = Tcb->SndNxt;
+  }
+
+  Pipe = TCP_SUB_SEQ (Tcb->SndNxt, HighLost);
+
+  RexmitEnd = Tcb->SackRexmitNxt;
+  if (TCP_SEQ_GT (RexmitEnd, HighLost)) {
+    RexmitEnd = HighLost;
+  }
+
+  if (TCP_SEQ_LEQ (RexmitEnd, Tcb->SndUna)) {
+    return Pipe;
+  }
+
+  Pipe += TCP_SUB_SEQ (RexmitEnd, Tcb->SndUna);
+
+  for (Index = 0; Index < Tcb->SackCount; Index++) {
+    if (TCP_SEQ_GEQ (Tcb->SackBlock[Index].Left, RexmitEnd)) {
+      break;
+    }
+
+    Pipe -= TCP_SUB_SEQ (
+              TCP_SEQ_LT (Tcb->SackBlock[Index].Right, RexmitEnd) ? Tcb->SackBlock[Index].Right : RexmitEnd,
+              TCP_SEQ_GT (Tcb->SackBlock[Index].Left, Tcb->SndUna) ? Tcb->SackBlock[Index].Left : Tcb->SndUna
+              );
+  }
+
+  return Pipe;
+}
+
+/**
+  Retransmit the holes in the data SACKed by the peer as long as the pipe
+  leaves room for one more segment in the congestion window, as in step (C)
+  of the loss recovery of RFC6675.
+
+  @param[in, out]  Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Seq     The sequence number to search the holes from.
+
+  @return The number of holes retransmitted.
+
+**/
+UINT32
+TcpSackRecover (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Seq
+  )
+{
+  UINT32  Count;
+
+  Count = 0;
+
+  while (TcpSackPipe (Tcb) + Tcb->SndMss <= Tcb->CWnd) {
+    if (TcpSackRetransmit (Tcb, Seq) != 1) {
+      break;
+    }
+
+    Count++;
+  }
+
+  return Count;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
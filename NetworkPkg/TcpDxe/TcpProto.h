@@ -52,6 +52,12 @@
 #define TCP_CONGEST_LOSS     2      ///< Retxmit because of retxmit time out.
 #define TCP_CONGEST_OPEN     3      ///< TCP is opening its congestion window.
 
+//
+// Congestion control algorithms used in congestion avoidance.
+//
+#define TCP_CONGEST_CONTROL_NEWRENO  0  ///< RFC5681 congestion avoidance.
+#define TCP_CONGEST_CONTROL_CUBIC    1  ///< RFC8312 CUBIC.
+
 //
 // TCP control flags
 //
@@ -70,6 +76,8 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable SACK option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK permitted option in syn.
 
 //
 // Timer related values
@@ -204,6 +212,19 @@
 
 #define TCP_MAX_WIN  0xFFFFU
 
+//
+// The number of SACK blocks kept by the sender, see RFC2018.
+//
+#define TCP_SACK_SCOREBOARD_SIZE  8
+
+///
+/// A block of contiguous data selectively acknowledged.
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number following the last byte of the block.
+} TCP_SACK_BLOCK;
+
 ///
 /// TCP segmentation data.
 ///
@@ -298,13 +319,32 @@ struct _TCP_CONTROL_BLOCK {
   // RFC2581, and 3782 variables.
   // Congestion control + NewReno fast recovery.
   //
-  UINT32              CWnd;         ///< Sender's congestion window.
-  UINT32              Ssthresh;     ///< Slow start threshold.
-  TCP_SEQNO           Recover;      ///< Recover point for NewReno.
-  UINT16              DupAck;       ///< Number of duplicate ACKs.
-  UINT8               CongestState; ///< The current congestion state(RFC3782).
-  UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
-  TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
+  UINT32              CWnd;           ///< Sender's congestion window.
+  UINT32              Ssthresh;       ///< Slow start threshold.
+  TCP_SEQNO           Recover;        ///< Recover point for NewReno.
+  UINT16              DupAck;         ///< Number of duplicate ACKs.
+  UINT8               CongestState;   ///< The current congestion state(RFC3782).
+  UINT8               LossTimes;      ///< Number of retxmit timeouts in a row.
+  TCP_SEQNO           LossRecover;    ///< Recover point for retxmit.
+  UINT8               CongestControl; ///< Congestion avoidance algorithm, such as CUBIC.
+
+  //
+  // RFC8312 defined variables. CUBIC congestion control.
+  //
+  UINT32              CubicWMax;    ///< Window just before the last reduction.
+  UINT32              CubicOrigin;  ///< Window at the plateau of the cubic function.
+  UINT32              CubicK;       ///< Time to reach CubicOrigin, in milliseconds.
+  UINT32              CubicEpoch;   ///< The tick when the current epoch started.
+  UINT32              CubicWEst;    ///< Window estimated for standard TCP.
+  BOOLEAN             CubicEpochOn; ///< If TRUE, the congestion avoidance epoch started.
+
+  //
+  // RFC2018 defined variables. Selective acknowledgment.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_SIZE]; ///< Data SACKed by the peer, sorted.
+  UINT8               SackCount;                           ///< Number of valid blocks in SackBlock.
+  TCP_SEQNO           SackRexmitNxt;                       ///< Next hole sequence to retxmit.
+  TCP_SEQNO           SackRcvSeq;                          ///< Last out-of-order data received.
 
   //
   // RFC7323
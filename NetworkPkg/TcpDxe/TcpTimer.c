@@ -194,11 +194,18 @@ TcpRexmitTimeout (
   // yet ACKed.
   //
   FlightSize    = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh = MAX ((UINT32)(2 * Tcb->SndMss), FlightSize / 2);
+  Tcb->Ssthresh = TcpCongestionOnLoss (Tcb, FlightSize);
 
   Tcb->CWnd        = Tcb->SndMss;
   Tcb->LossRecover = Tcb->SndNxt;
 
+  //
+  // RFC2018: the SACK information must be ignored after a
+  // retransmission timeout, the peer may have reneged.
+  //
+  Tcb->SackCount     = 0;
+  Tcb->SackRexmitNxt = Tcb->SndUna;
+
   Tcb->LossTimes++;
   if ((Tcb->LossTimes > Tcb->MaxRexmit) && !TCP_TIMER_ON (Tcb->EnabledTimer, TCP_TIMER_CONNECT)) {
     DEBUG (
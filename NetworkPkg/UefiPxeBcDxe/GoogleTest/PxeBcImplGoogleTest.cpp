@@ -0,0 +1,375 @@
+/** @file
+  Host based unit test for PxeBcImpl.c.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+#include <Library/GoogleTestLib.h>
+
+extern "C" {
+  #include <Uefi.h>
+  #include <Library/BaseLib.h>
+  #include <Library/BaseMemoryLib.h>
+  #include <Library/DebugLib.h>
+  #include "../PxeBcImpl.h"
+  #include "PxeBcImplGoogleTest.h"
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Definitions
+///////////////////////////////////////////////////////////////////////////////
+
+#define PXEBC_TEST_FILE_SIZE     (64 * 1024)
+#define PXEBC_TEST_MAX_ATTEMPTS  16
+
+EFI_IPv6_ADDRESS  mServerIp6 = {
+  { 0x20, 0x01, 0x0D, 0xB8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// Symbol Definitions
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// The TFTP server model: it refuses a request whose block size or window
+// size is larger than it supports, with error code mServerErrorCode. A
+// window size of 0 stands for no windowsize option.
+//
+UINTN   mServerMaxBlockSize;
+UINTN   mServerMaxWindowSize;
+UINT16  mServerErrorCode;
+
+//
+// The options of each request sent to the server, in order.
+//
+UINTN  mAttemptBlockSize[PXEBC_TEST_MAX_ATTEMPTS];
+UINTN  mAttemptWindowSize[PXEBC_TEST_MAX_ATTEMPTS];
+UINTN  mAttemptCount;
+
+EFI_STATUS
+PxeBcTestServerAnswer (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
+  IN OUT UINT64              *BufferSize
+  )
+{
+  if (mAttemptCount < PXEBC_TEST_MAX_ATTEMPTS) {
+    mAttemptBlockSize[mAttemptCount]  = (BlockSize != NULL) ? *BlockSize : 0;
+    mAttemptWindowSize[mAttemptCount] = (WindowSize != NULL) ? *WindowSize : 0;
+    mAttemptCount++;
+  }
+
+  if (((BlockSize != NULL) && (*BlockSize > mServerMaxBlockSize)) ||
+      ((WindowSize != NULL) && (*WindowSize > mServerMaxWindowSize)))
+  {
+    Private->Mode.TftpErrorReceived   = TRUE;
+    Private->Mode.TftpError.ErrorCode = (UINT8)mServerErrorCode;
+    return EFI_TFTP_ERROR;
+  }
+
+  *BufferSize = PXEBC_TEST_FILE_SIZE;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+PxeBcTftpGetFileSize (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     VOID                *Config,
+  IN     UINT8               *Filename,
+  IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
+  IN OUT UINT64              *BufferSize
+  )
+{
+  return PxeBcTestServerAnswer (Private, BlockSize, WindowSize, BufferSize);
+}
+
+EFI_STATUS
+PxeBcTftpReadFile (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     VOID                *Config,
+  IN     UINT8               *Filename,
+  IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
+  IN     UINT8               *BufferPtr,
+  IN OUT UINT64              *BufferSize,
+  IN     BOOLEAN             DontUseBuffer
+  )
+{
+  return PxeBcTestServerAnswer (Private, BlockSize, WindowSize, BufferSize);
+}
+
+EFI_STATUS
+PxeBcTftpWriteFile (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     VOID                *Config,
+  IN     UINT8               *Filename,
+  IN     BOOLEAN             Overwrite,
+  IN     UINTN               *BlockSize,
+  IN     UINT8               *BufferPtr,
+  IN OUT UINT64              *BufferSize
+  )
+{
+  return PxeBcTestServerAnswer (Private, BlockSize, NULL, BufferSize);
+}
+
+EFI_STATUS
+PxeBcTftpReadDirectory (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     VOID                *Config,
+  IN     UINT8               *Filename,
+  IN     UINTN               *BlockSize,
+  IN     UINTN               *WindowSize,
+  IN     UINT8               *BufferPtr,
+  IN OUT UINT64              *BufferSize,
+  IN     BOOLEAN             DontUseBuffer
+  )
+{
+  return PxeBcTestServerAnswer (Private, BlockSize, WindowSize, BufferSize);
+}
+
+// Needed by PxeBcImpl
+EFI_STATUS
+PxeBcDhcp4Dora (
+  IN PXEBC_PRIVATE_DATA  *Private,
+  IN EFI_DHCP4_PROTOCOL  *Dhcp4
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+PxeBcDiscoverBootServer (
+  IN  PXEBC_PRIVATE_DATA         *Private,
+  IN  UINT16                     Type,
+  IN  UINT16                     *Layer,
+  IN  BOOLEAN                    UseBis,
+  IN  EFI_IP_ADDRESS             *DestIp,
+  IN  UINT16                     IpCount,
+  IN  EFI_PXE_BASE_CODE_SRVLIST  *SrvList
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+PxeBcExtractDiscoverInfo (
+  IN     PXEBC_PRIVATE_DATA               *Private,
+  IN     UINT16                           Type,
+  IN OUT EFI_PXE_BASE_CODE_DISCOVER_INFO  **DiscoverInfo,
+  OUT PXEBC_BOOT_SVR_ENTRY                **BootEntry,
+  OUT EFI_PXE_BASE_CODE_SRVLIST           **SrvList
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+PxeBcLoadBootFile (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN OUT UINTN               *BufferSize,
+  IN     VOID                *Buffer         OPTIONAL
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+PxeBcParseDhcp4Packet (
+  IN PXEBC_DHCP4_PACKET_CACHE  *Cache4
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+VOID
+PxeBcSeedDhcp4Packet (
+  OUT EFI_DHCP4_PACKET   *Seed,
+  IN  EFI_UDP4_PROTOCOL  *Udp4
+  )
+{
+}
+
+EFI_STATUS
+PxeBcSetIp4Policy (
+  IN PXEBC_PRIVATE_DATA  *Private
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+EFI_STATUS
+EFIAPI
+PxeBcTestSetIpFilter (
+  IN EFI_PXE_BASE_CODE_PROTOCOL   *This,
+  IN EFI_PXE_BASE_CODE_IP_FILTER  *NewFilter
+  )
+{
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+PxeBcTestUdp6Configure (
+  IN EFI_UDP6_PROTOCOL     *This,
+  IN EFI_UDP6_CONFIG_DATA  *UdpConfigData OPTIONAL
+  )
+{
+  return EFI_SUCCESS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// EfiPxeBcMtftp Tests
+///////////////////////////////////////////////////////////////////////////////
+
+class EfiPxeBcMtftpTest : public ::testing::Test {
+public:
+  PXEBC_PRIVATE_DATA Private = { 0 };
+  EFI_UDP6_PROTOCOL Udp6Read = { 0 };
+  EFI_IP_ADDRESS ServerIp = { 0 };
+  UINT8 Buffer[PXEBC_TEST_FILE_SIZE];
+  UINT64 BufferSize;
+
+protected:
+  virtual void
+  SetUp (
+    )
+  {
+    Private.Signature         = PXEBC_PRIVATE_DATA_SIGNATURE;
+    Private.PxeBc.Mode        = &Private.Mode;
+    Private.PxeBc.SetIpFilter = PxeBcTestSetIpFilter;
+    Private.Mode.UsingIpv6    = TRUE;
+    Private.TftpWindowSize    = 16;
+
+    Udp6Read.Configure = PxeBcTestUdp6Configure;
+    Private.Udp6Read   = &Udp6Read;
+
+    CopyMem (&ServerIp.v6, &mServerIp6, sizeof (EFI_IPv6_ADDRESS));
+    BufferSize = sizeof (Buffer);
+
+    mServerMaxBlockSize  = 8192;
+    mServerMaxWindowSize = 16;
+    mServerErrorCode     = EFI_MTFTP6_ERRORCODE_REQUEST_DENIED;
+    mAttemptCount        = 0;
+  }
+
+  EFI_STATUS
+  Mtftp (
+    EFI_PXE_BASE_CODE_TFTP_OPCODE  Operation,
+    UINTN                          *BlockSize
+    )
+  {
+    BufferSize = sizeof (Buffer);
+    return EfiPxeBcMtftp (
+             &Private.PxeBc,
+             Operation,
+             Buffer,
+             FALSE,
+             &BufferSize,
+             BlockSize,
+             &ServerIp,
+             (UINT8 *)"bootx64.efi",
+             NULL,
+             FALSE
+             );
+  }
+};
+
+// Test Description:
+// A server that refuses the requested window size gets the request again
+// with the window halved, and the accepted window is kept for the next
+// transfers.
+TEST_F (EfiPxeBcMtftpTest, WindowSizeReducedUntilAccepted) {
+  UINTN  BlockSize;
+
+  mServerMaxWindowSize = 4;
+  BlockSize            = 8192;
+
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_READ_FILE, &BlockSize), EFI_SUCCESS);
+  ASSERT_EQ (mAttemptCount, (UINTN)3);
+  EXPECT_EQ (mAttemptWindowSize[0], (UINTN)16);
+  EXPECT_EQ (mAttemptWindowSize[1], (UINTN)8);
+  EXPECT_EQ (mAttemptWindowSize[2], (UINTN)4);
+  EXPECT_EQ (mAttemptBlockSize[2], (UINTN)8192);
+  EXPECT_EQ (Private.TftpWindowSize, (UINTN)4);
+  EXPECT_EQ (BlockSize, (UINTN)8192);
+  EXPECT_EQ (BufferSize, (UINT64)PXEBC_TEST_FILE_SIZE);
+
+  //
+  // The next transfer starts from the accepted window size.
+  //
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_GET_FILE_SIZE, &BlockSize), EFI_SUCCESS);
+  ASSERT_EQ (mAttemptCount, (UINTN)4);
+  EXPECT_EQ (mAttemptWindowSize[3], (UINTN)4);
+}
+
+// Test Description:
+// Once the windowsize option is dropped, the block size is halved down to
+// the one the server accepts. The caller's block size is kept.
+TEST_F (EfiPxeBcMtftpTest, BlockSizeReducedAfterWindowSize) {
+  UINTN  BlockSize;
+
+  mServerMaxBlockSize  = 1024;
+  mServerMaxWindowSize = 0;
+  BlockSize            = 8192;
+
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_READ_FILE, &BlockSize), EFI_SUCCESS);
+  ASSERT_EQ (mAttemptCount, (UINTN)8);
+  EXPECT_EQ (mAttemptWindowSize[3], (UINTN)2);
+  EXPECT_EQ (mAttemptBlockSize[3], (UINTN)8192);
+  EXPECT_EQ (mAttemptWindowSize[4], (UINTN)0);
+  EXPECT_EQ (mAttemptBlockSize[4], (UINTN)8192);
+  EXPECT_EQ (mAttemptBlockSize[5], (UINTN)4096);
+  EXPECT_EQ (mAttemptBlockSize[6], (UINTN)2048);
+  EXPECT_EQ (mAttemptWindowSize[7], (UINTN)0);
+  EXPECT_EQ (mAttemptBlockSize[7], (UINTN)1024);
+  EXPECT_EQ (Private.TftpWindowSize, (UINTN)1);
+  EXPECT_EQ (BlockSize, (UINTN)8192);
+}
+
+// Test Description:
+// The retries stop at the default block size without the windowsize option,
+// and a failed transfer doesn't change the kept window size.
+TEST_F (EfiPxeBcMtftpTest, RetriesStopAtDefaults) {
+  UINTN  BlockSize;
+
+  mServerMaxBlockSize  = 256;
+  mServerMaxWindowSize = 0;
+  BlockSize            = 2048;
+
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_READ_FILE, &BlockSize), EFI_TFTP_ERROR);
+  ASSERT_EQ (mAttemptCount, (UINTN)7);
+  EXPECT_EQ (mAttemptWindowSize[6], (UINTN)0);
+  EXPECT_EQ (mAttemptBlockSize[6], (UINTN)PXE_MTFTP_DEFAULT_BLOCK_SIZE);
+  EXPECT_EQ (Private.TftpWindowSize, (UINTN)16);
+}
+
+// Test Description:
+// An error other than a refused option isn't retried.
+TEST_F (EfiPxeBcMtftpTest, OtherErrorNotRetried) {
+  UINTN  BlockSize;
+
+  mServerMaxWindowSize = 0;
+  mServerErrorCode     = EFI_MTFTP6_ERRORCODE_FILE_NOT_FOUND;
+  BlockSize            = 8192;
+
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_READ_FILE, &BlockSize), EFI_TFTP_ERROR);
+  ASSERT_EQ (mAttemptCount, (UINTN)1);
+  EXPECT_EQ (Private.TftpWindowSize, (UINTN)16);
+}
+
+// Test Description:
+// A write doesn't use the windowsize option, only its block size is reduced.
+TEST_F (EfiPxeBcMtftpTest, WriteFileReducesBlockSize) {
+  UINTN  BlockSize;
+
+  mServerMaxBlockSize = 1024;
+  BlockSize           = 2048;
+
+  ASSERT_EQ (Mtftp (EFI_PXE_BASE_CODE_TFTP_WRITE_FILE, &BlockSize), EFI_SUCCESS);
+  ASSERT_EQ (mAttemptCount, (UINTN)2);
+  EXPECT_EQ (mAttemptBlockSize[0], (UINTN)2048);
+  EXPECT_EQ (mAttemptBlockSize[1], (UINTN)1024);
+  EXPECT_EQ (Private.TftpWindowSize, (UINTN)16);
+}
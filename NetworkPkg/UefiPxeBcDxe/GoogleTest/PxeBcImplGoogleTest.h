@@ -0,0 +1,56 @@
+/** @file
+  This file exposes the internal interfaces which may be unit tested
+  for the PxeBcImpl of the UefiPxeBcDxe driver.
+
+  Copyright (c) 2026, NVIDIA CORPORATION. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef PXE_BC_IMPL_GOOGLE_TEST_H_
+#define PXE_BC_IMPL_GOOGLE_TEST_H_
+
+//
+// Minimal includes needed to compile
+//
+#include <Uefi.h>
+#include "../PxeBcImpl.h"
+
+/**
+  Used to perform TFTP and MTFTP services.
+
+  @param[in]      This          Pointer to the EFI_PXE_BASE_CODE_PROTOCOL instance.
+  @param[in]      Operation     The type of operation to perform.
+  @param[in, out] BufferPtr     A pointer to the data buffer.
+  @param[in]      Overwrite     Only used on write file operations. TRUE if a file on a remote
+                                server can be overwritten.
+  @param[in, out] BufferSize    For get-file-size operations, *BufferSize returns the size of the
+                                requested file.
+  @param[in]      BlockSize     The requested block size to be used during a TFTP transfer.
+  @param[in]      ServerIp      The TFTP / MTFTP server IP address.
+  @param[in]      Filename      A Null-terminated ASCII string that specifies a directory name
+                                or a file name.
+  @param[in]      Info          Pointer to the MTFTP information.
+  @param[in]      DontUseBuffer Set to FALSE for normal TFTP and MTFTP read file operation.
+
+  @retval EFI_SUCCESS           The TFTP/MTFTP operation was completed.
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid.
+  @retval EFI_TFTP_ERROR        A TFTP error packet was received during the MTFTP session.
+  @retval Others                The TFTP/MTFTP operation failed.
+
+**/
+EFI_STATUS
+EFIAPI
+EfiPxeBcMtftp (
+  IN     EFI_PXE_BASE_CODE_PROTOCOL     *This,
+  IN     EFI_PXE_BASE_CODE_TFTP_OPCODE  Operation,
+  IN OUT VOID                           *BufferPtr    OPTIONAL,
+  IN     BOOLEAN                        Overwrite,
+  IN OUT UINT64                         *BufferSize,
+  IN     UINTN                          *BlockSize    OPTIONAL,
+  IN     EFI_IP_ADDRESS                 *ServerIp,
+  IN     UINT8                          *Filename,
+  IN     EFI_PXE_BASE_CODE_MTFTP_INFO   *Info         OPTIONAL,
+  IN     BOOLEAN                        DontUseBuffer
+  );
+
+#endif // PXE_BC_IMPL_GOOGLE_TEST_H_
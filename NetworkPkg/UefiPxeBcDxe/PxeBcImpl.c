@@ -225,6 +225,11 @@ EfiPxeBcStart (
     Private->BlockSize = (UINTN)PcdGet64 (PcdTftpBlockSize);
   }
 
+  //
+  // Start with PcdPxeTftpWindowSize, Mtftp() reduces it if the server refuses it.
+  //
+  Private->TftpWindowSize = (UINTN)PcdGet64 (PcdPxeTftpWindowSize);
+
   //
   // Create event for UdpRead/UdpWrite timeout since they are both blocking API.
   //
@@ -766,6 +771,61 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Reduce the requested TFTP options after the server refused them, to probe for
+  the largest window size and block size the server accepts.
+
+  The window size is halved first, down to one block, which requests no windowsize
+  option at all. Then the block size is halved, down to the default block size.
+
+  @param[in]       Private       Pointer to PxeBc private data.
+  @param[in]       Status        The status of the last TFTP operation.
+  @param[in, out]  BlockSize     Pointer to the requested block size, or NULL if
+                                 no blksize option is requested.
+  @param[in, out]  WindowSize    Pointer to the requested window size, or NULL if
+                                 the operation doesn't use the windowsize option.
+
+  @retval TRUE                   The options were reduced, the operation can be retried.
+  @retval FALSE                  The operation didn't fail on the options, or they
+                                 can't be reduced any further.
+
+**/
+BOOLEAN
+PxeBcTftpReduceOptions (
+  IN     PXEBC_PRIVATE_DATA  *Private,
+  IN     EFI_STATUS          Status,
+  IN OUT UINTN               *BlockSize  OPTIONAL,
+  IN OUT UINTN               *WindowSize OPTIONAL
+  )
+{
+  //
+  // The server answers an option it doesn't accept with error 8 (RFC2347).
+  //
+  if ((Status != EFI_TFTP_ERROR) ||
+      !Private->Mode.TftpErrorReceived ||
+      (Private->Mode.TftpError.ErrorCode != EFI_MTFTP4_ERRORCODE_REQUEST_DENIED))
+  {
+    return FALSE;
+  }
+
+  if ((WindowSize != NULL) && (*WindowSize > 1)) {
+    *WindowSize = *WindowSize / 2;
+  } else if ((BlockSize != NULL) && (*BlockSize > PXE_MTFTP_DEFAULT_BLOCK_SIZE)) {
+    *BlockSize = MAX (*BlockSize / 2, PXE_MTFTP_DEFAULT_BLOCK_SIZE);
+  } else {
+    return FALSE;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "PXE: TFTP options refused, retry with window size %d and block size %d.\n",
+    (WindowSize != NULL) ? (UINT32)*WindowSize : 0,
+    (BlockSize != NULL) ? (UINT32)*BlockSize : 0
+    ));
+
+  return TRUE;
+}
+
 /**
   Used to perform TFTP and MTFTP services.
 
@@ -852,6 +912,8 @@ EfiPxeBcMtftp (
   EFI_STATUS                   Status;
   EFI_PXE_BASE_CODE_IP_FILTER  IpFilter;
   UINTN                        WindowSize;
+  UINTN                        TftpBlockSize;
+  UINTN                        *TftpBlockSizePtr;
 
   if ((This == NULL) ||
       (Filename == NULL) ||
@@ -878,9 +940,15 @@ EfiPxeBcMtftp (
   Mode    = Private->PxeBc.Mode;
 
   //
-  // Get PcdPxeTftpWindowSize.
+  // Get the window size the server accepted so far, PcdPxeTftpWindowSize at first.
+  // The block size is reduced on a copy, so that the caller's value is kept.
   //
-  WindowSize = (UINTN)PcdGet64 (PcdPxeTftpWindowSize);
+  WindowSize       = Private->TftpWindowSize;
+  TftpBlockSizePtr = NULL;
+  if (BlockSize != NULL) {
+    TftpBlockSize    = *BlockSize;
+    TftpBlockSizePtr = &TftpBlockSize;
+  }
 
   if (Mode->UsingIpv6) {
     if (!NetIp6IsValidUnicast (&ServerIp->v6)) {
@@ -925,86 +993,103 @@ EfiPxeBcMtftp (
     Private->Udp4Read->Configure (Private->Udp4Read, NULL);
   }
 
-  Mode->TftpErrorReceived = FALSE;
-  Mode->IcmpErrorReceived = FALSE;
+  //
+  // Retry with smaller options while the server refuses the requested ones.
+  //
+  do {
+    Mode->TftpErrorReceived = FALSE;
+    Mode->IcmpErrorReceived = FALSE;
 
-  switch (Operation) {
-    case EFI_PXE_BASE_CODE_TFTP_GET_FILE_SIZE:
-      //
-      // Send TFTP request to get file size.
-      //
-      Status = PxeBcTftpGetFileSize (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferSize
-                 );
+    switch (Operation) {
+      case EFI_PXE_BASE_CODE_TFTP_GET_FILE_SIZE:
+        //
+        // Send TFTP request to get file size.
+        //
+        Status = PxeBcTftpGetFileSize (
+                   Private,
+                   Config,
+                   Filename,
+                   TftpBlockSizePtr,
+                   (WindowSize > 1) ? &WindowSize : NULL,
+                   BufferSize
+                   );
 
-      break;
+        break;
 
-    case EFI_PXE_BASE_CODE_TFTP_READ_FILE:
-      //
-      // Send TFTP request to read file.
-      //
-      Status = PxeBcTftpReadFile (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferPtr,
-                 BufferSize,
-                 DontUseBuffer
-                 );
+      case EFI_PXE_BASE_CODE_TFTP_READ_FILE:
+        //
+        // Send TFTP request to read file.
+        //
+        Status = PxeBcTftpReadFile (
+                   Private,
+                   Config,
+                   Filename,
+                   TftpBlockSizePtr,
+                   (WindowSize > 1) ? &WindowSize : NULL,
+                   BufferPtr,
+                   BufferSize,
+                   DontUseBuffer
+                   );
 
-      break;
+        break;
 
-    case EFI_PXE_BASE_CODE_TFTP_WRITE_FILE:
-      //
-      // Send TFTP request to write file.
-      //
-      Status = PxeBcTftpWriteFile (
-                 Private,
-                 Config,
-                 Filename,
-                 Overwrite,
-                 BlockSize,
-                 BufferPtr,
-                 BufferSize
-                 );
+      case EFI_PXE_BASE_CODE_TFTP_WRITE_FILE:
+        //
+        // Send TFTP request to write file.
+        //
+        Status = PxeBcTftpWriteFile (
+                   Private,
+                   Config,
+                   Filename,
+                   Overwrite,
+                   TftpBlockSizePtr,
+                   BufferPtr,
+                   BufferSize
+                   );
 
-      break;
+        break;
 
-    case EFI_PXE_BASE_CODE_TFTP_READ_DIRECTORY:
-      //
-      // Send TFTP request to read directory.
-      //
-      Status = PxeBcTftpReadDirectory (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferPtr,
-                 BufferSize,
-                 DontUseBuffer
-                 );
+      case EFI_PXE_BASE_CODE_TFTP_READ_DIRECTORY:
+        //
+        // Send TFTP request to read directory.
+        //
+        Status = PxeBcTftpReadDirectory (
+                   Private,
+                   Config,
+                   Filename,
+                   TftpBlockSizePtr,
+                   (WindowSize > 1) ? &WindowSize : NULL,
+                   BufferPtr,
+                   BufferSize,
+                   DontUseBuffer
+                   );
 
-      break;
+        break;
 
-    case EFI_PXE_BASE_CODE_MTFTP_GET_FILE_SIZE:
-    case EFI_PXE_BASE_CODE_MTFTP_READ_FILE:
-    case EFI_PXE_BASE_CODE_MTFTP_READ_DIRECTORY:
-      Status = EFI_UNSUPPORTED;
+      case EFI_PXE_BASE_CODE_MTFTP_GET_FILE_SIZE:
+      case EFI_PXE_BASE_CODE_MTFTP_READ_FILE:
+      case EFI_PXE_BASE_CODE_MTFTP_READ_DIRECTORY:
+        Status = EFI_UNSUPPORTED;
 
-      break;
+        break;
 
-    default:
-      Status = EFI_INVALID_PARAMETER;
+      default:
+        Status = EFI_INVALID_PARAMETER;
 
-      break;
+        break;
+    }
+  } while (PxeBcTftpReduceOptions (
+             Private,
+             Status,
+             TftpBlockSizePtr,
+             (Operation == EFI_PXE_BASE_CODE_TFTP_WRITE_FILE) ? NULL : &WindowSize
+             ));
+
+  //
+  // Keep the window size the server accepted for the next transfers.
+  //
+  if (!EFI_ERROR (Status) && (Operation != EFI_PXE_BASE_CODE_TFTP_WRITE_FILE)) {
+    Private->TftpWindowSize = WindowSize;
   }
 
   if (Status == EFI_ICMP_ERROR) {
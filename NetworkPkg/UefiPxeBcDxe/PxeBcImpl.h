@@ -180,6 +180,7 @@ struct _PXEBC_PRIVATE_DATA {
   UINT8                                        *BootFileName;
   UINTN                                        BootFileSize;
   UINTN                                        BlockSize;
+  UINTN                                        TftpWindowSize;
 
   PXEBC_DHCP_PACKET_CACHE                      ProxyOffer;
   PXEBC_DHCP_PACKET_CACHE                      DhcpAck;
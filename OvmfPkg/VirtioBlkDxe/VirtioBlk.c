@@ -6,9 +6,13 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - EFI_BLOCK_IO_PROTOCOL requests, and EFI_BLOCK_IO2_PROTOCOL requests without
+    an event, are synchronous and own the virtio ring exclusively while they
+    are processed.
+
+  - Non-blocking EFI_BLOCK_IO2_PROTOCOL reads and writes are submitted to
+    fixed three-descriptor slots of the ring, so several of them can be in
+    flight at once. Completions are reaped by a periodic timer.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -175,6 +179,341 @@ VerifyReadWriteRequest (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Complete an asynchronous request: release its data buffer mapping, report
+  the outcome through its token, and free it.
+
+  @param[in] Dev     The virtio-blk device the request was targeted at.
+
+  @param[in] Req     The request to complete. It must have been unlinked from
+                     Dev->PendingQueue and Dev->InFlight by the caller.
+
+  @param[in] Status  The transaction status to report.
+
+**/
+STATIC
+VOID
+VirtioBlkCompleteAsyncRequest (
+  IN VBLK_DEV        *Dev,
+  IN VBLK_ASYNC_REQ  *Req,
+  IN EFI_STATUS      Status
+  )
+{
+  EFI_STATUS  UnmapStatus;
+
+  UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Req->BufferMapping);
+  if (EFI_ERROR (UnmapStatus) && !Req->RequestIsWrite && !EFI_ERROR (Status)) {
+    //
+    // Data from the bus master may not reach the caller; fail the request.
+    //
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  Req->Token->TransactionStatus = Status;
+  gBS->SignalEvent (Req->Token->Event);
+  FreePool (Req);
+}
+
+/**
+
+  Move requests from Dev->PendingQueue to free slots of the virtio ring, and
+  notify the host once about the whole batch.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device whose pending requests to submit.
+
+**/
+STATIC
+VOID
+VirtioBlkSubmitAsyncRequests (
+  IN VBLK_DEV  *Dev
+  )
+{
+  LIST_ENTRY      *Link;
+  VBLK_ASYNC_REQ  *Req;
+  VBLK_ASYNC_HDR  *Hdr;
+  DESC_INDICES    Indices;
+  UINT16          Slot;
+  UINT16          NextAvailIdx;
+  UINT16          Submitted;
+  EFI_STATUS      Status;
+
+  //
+  // A synchronous request owns the ring; VirtioBlkReleaseRing() submits the
+  // pending requests once it is done.
+  //
+  if (Dev->RingOwned) {
+    return;
+  }
+
+  NextAvailIdx = *Dev->Ring.Avail.Idx;
+  Submitted    = 0;
+  Slot         = 0;
+
+  while (!IsListEmpty (&Dev->PendingQueue) &&
+         (Dev->InFlightCount < Dev->AsyncSlots))
+  {
+    Link = GetFirstNode (&Dev->PendingQueue);
+    Req  = VBLK_ASYNC_REQ_FROM_LINK (Link);
+
+    while (Dev->InFlight[Slot] != NULL) {
+      Slot++;
+    }
+
+    ASSERT (Slot < Dev->AsyncSlots);
+
+    Hdr                 = &Dev->AsyncHdr[Slot];
+    Hdr->Request.Type   = Req->RequestIsWrite ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+    Hdr->Request.IoPrio = 0;
+    Hdr->Request.Sector = MultU64x32 (Req->Lba, Dev->BlockIoMedia.BlockSize / 512);
+    Hdr->HostStatus     = VIRTIO_BLK_S_IOERR;
+    Indices.HeadDescIdx = (UINT16)(Slot * VBLK_DESC_PER_SLOT);
+    Indices.NextDescIdx = Indices.HeadDescIdx;
+
+    //
+    // Same chain layout as in SynchronousRequest(), only the header and the
+    // host status come from the slot's part of the common buffer.
+    //
+    VirtioAppendDesc (
+      &Dev->Ring,
+      Dev->AsyncHdrDevAddr + Slot * sizeof (VBLK_ASYNC_HDR),
+      sizeof (Hdr->Request),
+      VRING_DESC_F_NEXT,
+      &Indices
+      );
+    VirtioAppendDesc (
+      &Dev->Ring,
+      Req->BufferDeviceAddress,
+      Req->BufferSize,
+      VRING_DESC_F_NEXT | (Req->RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
+      &Indices
+      );
+    VirtioAppendDesc (
+      &Dev->Ring,
+      Dev->AsyncHdrDevAddr + Slot * sizeof (VBLK_ASYNC_HDR) +
+      OFFSET_OF (VBLK_ASYNC_HDR, HostStatus),
+      sizeof (Hdr->HostStatus),
+      VRING_DESC_F_WRITE,
+      &Indices
+      );
+
+    Dev->Ring.Avail.Ring[NextAvailIdx++ % Dev->Ring.QueueSize] =
+      Indices.HeadDescIdx;
+
+    RemoveEntryList (&Req->Link);
+    Dev->InFlight[Slot] = Req;
+    Dev->InFlightCount++;
+    Submitted++;
+  }
+
+  if (Submitted == 0) {
+    return;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field: the descriptor chains and
+  // the available ring entries must be visible before the index update, and
+  // the index update before the notification.
+  //
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = NextAvailIdx;
+  MemoryFence ();
+
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+  if (EFI_ERROR (Status)) {
+    //
+    // The chains are published already; the device may still pick them up.
+    //
+    DEBUG ((DEBUG_ERROR, "%a: SetQueueNotify: %r\n", __func__, Status));
+  }
+
+  if (!Dev->AsyncTimerArmed) {
+    gBS->SetTimer (Dev->AsyncTimer, TimerPeriodic, VBLK_ASYNC_POLL_PERIOD);
+    Dev->AsyncTimerArmed = TRUE;
+  }
+}
+
+/**
+
+  Reap the requests that the host has finished since the last call, signal
+  their tokens, and submit pending requests into the freed slots.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device whose used ring to process.
+
+**/
+STATIC
+VOID
+VirtioBlkProcessUsedRing (
+  IN VBLK_DEV  *Dev
+  )
+{
+  volatile VRING_USED_ELEM  *UsedElem;
+  VBLK_ASYNC_REQ            *Req;
+  UINT16                    Slot;
+  EFI_STATUS                Status;
+
+  //
+  // The used ring entry of a synchronous request is consumed by VirtioFlush().
+  //
+  if (Dev->RingOwned) {
+    return;
+  }
+
+  MemoryFence ();
+  while (Dev->LastUsedIdx != *Dev->Ring.Used.Idx) {
+    MemoryFence ();
+    UsedElem = &Dev->Ring.Used.UsedElem[Dev->LastUsedIdx % Dev->Ring.QueueSize];
+    Slot     = (UINT16)(UsedElem->Id / VBLK_DESC_PER_SLOT);
+    Dev->LastUsedIdx++;
+
+    if ((Slot >= Dev->AsyncSlots) || (Dev->InFlight[Slot] == NULL)) {
+      DEBUG ((DEBUG_ERROR, "%a: stray used element Id=%u\n", __func__, UsedElem->Id));
+      continue;
+    }
+
+    Req                 = Dev->InFlight[Slot];
+    Dev->InFlight[Slot] = NULL;
+    Dev->InFlightCount--;
+
+    Status = (Dev->AsyncHdr[Slot].HostStatus == VIRTIO_BLK_S_OK) ?
+             EFI_SUCCESS :
+             EFI_DEVICE_ERROR;
+    VirtioBlkCompleteAsyncRequest (Dev, Req, Status);
+  }
+
+  VirtioBlkSubmitAsyncRequests (Dev);
+
+  if ((Dev->InFlightCount == 0) && Dev->AsyncTimerArmed) {
+    gBS->SetTimer (Dev->AsyncTimer, TimerCancel, 0);
+    Dev->AsyncTimerArmed = FALSE;
+  }
+}
+
+/**
+
+  Timer notification function polling the used ring while asynchronous
+  requests are in flight.
+
+  @param[in] Event    Event whose notification function is being invoked.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkAsyncTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  VirtioBlkProcessUsedRing (Context);
+}
+
+/**
+
+  Wait until all asynchronous requests have completed, and take exclusive
+  ownership of the virtio ring for a synchronous request.
+
+  The ring is owned at the caller's TPL, but at least at TPL_CALLBACK, so the
+  asynchronous poll timer and other TPL_NOTIFY events keep running while the
+  synchronous request is polled for, and no other BlockIo or BlockIo2 call,
+  which may only be made at TPL_CALLBACK or below, can preempt it.
+
+  @param[in] Dev  The virtio-blk device whose ring to acquire.
+
+  @return  The TPL to pass to VirtioBlkReleaseRing() once the synchronous
+           request has completed. The ring is owned until then.
+
+**/
+STATIC
+EFI_TPL
+VirtioBlkAcquireRing (
+  IN VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL  OldTpl;
+
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ASSERT (!Dev->RingOwned);
+    VirtioBlkProcessUsedRing (Dev);
+    //
+    // Pending requests are submitted as soon as a slot frees up, hence no
+    // request is in flight only if none is pending either.
+    //
+    if (Dev->InFlightCount == 0) {
+      Dev->RingOwned = TRUE;
+      gBS->RestoreTPL (MAX (OldTpl, TPL_CALLBACK));
+      return OldTpl;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+    gBS->Stall (1);
+  }
+}
+
+/**
+
+  Give up the ownership of the virtio ring taken by VirtioBlkAcquireRing(),
+  and submit the asynchronous requests queued in the meantime.
+
+  @param[in] Dev     The virtio-blk device whose ring to release.
+
+  @param[in] OldTpl  The TPL returned by VirtioBlkAcquireRing().
+
+**/
+STATIC
+VOID
+VirtioBlkReleaseRing (
+  IN VBLK_DEV  *Dev,
+  IN EFI_TPL   OldTpl
+  )
+{
+  gBS->RaiseTPL (TPL_NOTIFY);
+  ASSERT (Dev->RingOwned);
+  Dev->LastUsedIdx = *Dev->Ring.Used.Idx;
+  Dev->RingOwned   = FALSE;
+  VirtioBlkSubmitAsyncRequests (Dev);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+
+  Fail all pending asynchronous requests with EFI_ABORTED, and wait for the
+  ones already submitted to the host to complete.
+
+  @param[in] Dev  The virtio-blk device whose asynchronous requests to cancel.
+
+**/
+STATIC
+VOID
+VirtioBlkCancelAsyncRequests (
+  IN VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL         OldTpl;
+  LIST_ENTRY      *Link;
+  VBLK_ASYNC_REQ  *Req;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  while (!IsListEmpty (&Dev->PendingQueue)) {
+    Link = GetFirstNode (&Dev->PendingQueue);
+    Req  = VBLK_ASYNC_REQ_FROM_LINK (Link);
+    RemoveEntryList (&Req->Link);
+    VirtioBlkCompleteAsyncRequest (Dev, Req, EFI_ABORTED);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  OldTpl = VirtioBlkAcquireRing (Dev);
+  VirtioBlkReleaseRing (Dev, OldTpl);
+}
+
 /**
 
   Format a read / write / flush request as three consecutive virtio
@@ -253,6 +592,7 @@ SynchronousRequest (
   EFI_PHYSICAL_ADDRESS     RequestDeviceAddress;
   EFI_STATUS               Status;
   EFI_STATUS               UnmapStatus;
+  EFI_TPL                  OldTpl;
 
   BlockSize = Dev->BlockIoMedia.BlockSize;
 
@@ -365,6 +705,12 @@ SynchronousRequest (
     goto UnmapDataBuffer;
   }
 
+  //
+  // Wait for asynchronous requests to drain; from here on until VirtioFlush()
+  // returns, the ring is ours.
+  //
+  OldTpl = VirtioBlkAcquireRing (Dev);
+
   VirtioPrepare (&Dev->Ring, &Indices);
 
   //
@@ -424,15 +770,16 @@ SynchronousRequest (
   //
   // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
   //
-  if ((VirtioFlush (
-         Dev->VirtIo,
-         0,
-         &Dev->Ring,
-         &Indices,
-         NULL
-         ) == EFI_SUCCESS) &&
-      (*HostStatus == VIRTIO_BLK_S_OK))
-  {
+  Status = VirtioFlush (
+             Dev->VirtIo,
+             0,
+             &Dev->Ring,
+             &Indices,
+             NULL
+             );
+  VirtioBlkReleaseRing (Dev, OldTpl);
+
+  if ((Status == EFI_SUCCESS) && (*HostStatus == VIRTIO_BLK_S_OK)) {
     Status = EFI_SUCCESS;
   } else {
     Status = EFI_DEVICE_ERROR;
@@ -611,6 +958,225 @@ VirtioBlkFlushBlocks (
          EFI_SUCCESS;
 }
 
+/**
+
+  Queue a verified, non-empty read or write request for asynchronous
+  processing.
+
+  @param[in] Dev             The virtio-blk device the request is targeted at.
+
+  @param[in] Lba             Logical Block Address of the transfer.
+
+  @param[in] BufferSize      Size of the transfer in bytes, positive.
+
+  @param[in] Buffer          The guest side area to transfer to or from.
+
+  @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to device.
+
+  @param[in] Token           The caller's token, with a non-NULL Event.
+
+  @retval EFI_SUCCESS           The request has been queued.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @retval EFI_DEVICE_ERROR      Failed to map Buffer for a bus master operation.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkQueueAsyncRequest (
+  IN VBLK_DEV             *Dev,
+  IN EFI_LBA              Lba,
+  IN UINTN                BufferSize,
+  IN VOID                 *Buffer,
+  IN BOOLEAN              RequestIsWrite,
+  IN EFI_BLOCK_IO2_TOKEN  *Token
+  )
+{
+  VBLK_ASYNC_REQ  *Req;
+  EFI_TPL         OldTpl;
+  EFI_STATUS      Status;
+
+  Req = AllocateZeroPool (sizeof *Req);
+  if (Req == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Req->Signature      = VBLK_ASYNC_REQ_SIG;
+  Req->Token          = Token;
+  Req->Lba            = Lba;
+  Req->BufferSize     = (UINT32)BufferSize;
+  Req->RequestIsWrite = RequestIsWrite;
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             (RequestIsWrite ?
+              VirtioOperationBusMasterRead :
+              VirtioOperationBusMasterWrite),
+             Buffer,
+             BufferSize,
+             &Req->BufferDeviceAddress,
+             &Req->BufferMapping
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (Req);
+    return EFI_DEVICE_ERROR;
+  }
+
+  Token->TransactionStatus = EFI_NOT_READY;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Dev->PendingQueue, &Req->Link);
+  VirtioBlkSubmitAsyncRequests (Dev);
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  ResetEx() operation for virtio-blk.
+
+  Pending non-blocking requests are failed with EFI_ABORTED; those already
+  handed to the host are waited for.
+
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
+  VirtioBlkCancelAsyncRequests (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return VirtioBlkReadBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             FALSE               // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return VirtioBlkQueueAsyncRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           FALSE,      // RequestIsWrite
+           Token
+           );
+}
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return VirtioBlkWriteBlocks (&Dev->BlockIo, MediaId, Lba, BufferSize, Buffer);
+  }
+
+  if (BufferSize == 0) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+    return EFI_SUCCESS;
+  }
+
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             TRUE                // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return VirtioBlkQueueAsyncRequest (
+           Dev,
+           Lba,
+           BufferSize,
+           Buffer,
+           TRUE,       // RequestIsWrite
+           Token
+           );
+}
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+
+  //
+  // Let all non-blocking writes reach the device first, even if there is no
+  // write cache to flush afterwards.
+  //
+  OldTpl = VirtioBlkAcquireRing (Dev);
+  VirtioBlkReleaseRing (Dev, OldTpl);
+
+  Status = VirtioBlkFlushBlocks (&Dev->BlockIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 
   Device probe function for this driver.
@@ -694,6 +1260,99 @@ VirtioBlkDriverBindingSupported (
   return Status;
 }
 
+/**
+
+  Set up the request slots for non-blocking requests: carve the virtio ring
+  into three-descriptor slots, and allocate and map the common buffer holding
+  the request headers and host statuses of all slots.
+
+  @param[in out] Dev  The virtio-blk device whose ring has been mapped with
+                      VirtioRingMap().
+
+  @retval EFI_SUCCESS  Setup complete.
+
+  @return              Error codes from the VirtIo protocol.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkAsyncInit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       HdrSize;
+
+  Dev->AsyncSlots = (UINT16)MIN (
+                              Dev->Ring.QueueSize / VBLK_DESC_PER_SLOT,
+                              VBLK_MAX_ASYNC_SLOTS
+                              );
+  ASSERT (Dev->AsyncSlots > 0);
+
+  HdrSize = Dev->AsyncSlots * sizeof (VBLK_ASYNC_HDR);
+  Status  = Dev->VirtIo->AllocateSharedPages (
+                           Dev->VirtIo,
+                           EFI_SIZE_TO_PAGES (HdrSize),
+                           (VOID **)&Dev->AsyncHdr
+                           );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (Dev->AsyncHdr, HdrSize);
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             Dev->AsyncHdr,
+             HdrSize,
+             &Dev->AsyncHdrDevAddr,
+             &Dev->AsyncHdrMap
+             );
+  if (EFI_ERROR (Status)) {
+    Dev->VirtIo->FreeSharedPages (
+                   Dev->VirtIo,
+                   EFI_SIZE_TO_PAGES (HdrSize),
+                   Dev->AsyncHdr
+                   );
+    return Status;
+  }
+
+  Dev->LastUsedIdx   = 0;
+  Dev->InFlightCount = 0;
+  Dev->RingOwned     = FALSE;
+  ZeroMem (Dev->InFlight, sizeof Dev->InFlight);
+
+  DEBUG ((DEBUG_INFO, "%a: AsyncSlots=%u\n", __func__, Dev->AsyncSlots));
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Release the resources set up by VirtioBlkAsyncInit(). No request may be
+  in flight.
+
+  @param[in out] Dev  The virtio-blk device to clean up.
+
+**/
+STATIC
+VOID
+VirtioBlkAsyncUninit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  ASSERT (Dev->InFlightCount == 0);
+
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->AsyncHdrMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Dev->AsyncSlots * sizeof (VBLK_ASYNC_HDR)),
+                 Dev->AsyncHdr
+                 );
+  Dev->AsyncHdr   = NULL;
+  Dev->AsyncSlots = 0;
+}
+
 /**
 
   Set up all BlockIo and virtio-blk aspects of this driver for the specified
@@ -881,18 +1540,27 @@ VirtioBlkInit (
     goto ReleaseQueue;
   }
 
+  //
+  // Request slots for EFI_BLOCK_IO2_PROTOCOL. If anything fails after this,
+  // we must release them too.
+  //
+  Status = VirtioBlkAsyncInit (Dev);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
   //
   // Additional steps for MMIO: align the queue appropriately, and set the
   // size. If anything fails from here on, we must unmap the ring resources.
   //
   Status = Dev->VirtIo->SetQueueNum (Dev->VirtIo, QueueSize);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitAsync;
   }
 
   Status = Dev->VirtIo->SetQueueAlign (Dev->VirtIo, EFI_PAGE_SIZE);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitAsync;
   }
 
   //
@@ -904,7 +1572,7 @@ VirtioBlkInit (
                           RingBaseShift
                           );
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitAsync;
   }
 
   //
@@ -914,7 +1582,7 @@ VirtioBlkInit (
     Features &= ~(UINT64)(VIRTIO_F_VERSION_1 | VIRTIO_F_IOMMU_PLATFORM);
     Status    = Dev->VirtIo->SetGuestFeatures (Dev->VirtIo, Features);
     if (EFI_ERROR (Status)) {
-      goto UnmapQueue;
+      goto UninitAsync;
     }
   }
 
@@ -924,7 +1592,7 @@ VirtioBlkInit (
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitAsync;
   }
 
   //
@@ -937,6 +1605,11 @@ VirtioBlkInit (
   Dev->BlockIo.ReadBlocks            = &VirtioBlkReadBlocks;
   Dev->BlockIo.WriteBlocks           = &VirtioBlkWriteBlocks;
   Dev->BlockIo.FlushBlocks           = &VirtioBlkFlushBlocks;
+  Dev->BlockIo2.Media                = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset                = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx         = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx        = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx        = &VirtioBlkFlushBlocksEx;
   Dev->BlockIoMedia.MediaId          = 0;
   Dev->BlockIoMedia.RemovableMedia   = FALSE;
   Dev->BlockIoMedia.MediaPresent     = TRUE;
@@ -982,6 +1655,9 @@ VirtioBlkInit (
 
   return EFI_SUCCESS;
 
+UninitAsync:
+  VirtioBlkAsyncUninit (Dev);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1021,10 +1697,12 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  VirtioBlkAsyncUninit (Dev);
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
+  SetMem (&Dev->BlockIo2, sizeof Dev->BlockIo2, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1118,6 +1796,7 @@ VirtioBlkDriverBindingStart (
   //
   // VirtIo access granted, configure virtio-blk device.
   //
+  InitializeListHead (&Dev->PendingQueue);
   Status = VirtioBlkInit (Dev);
   if (EFI_ERROR (Status)) {
     goto CloseVirtIo;
@@ -1134,22 +1813,39 @@ VirtioBlkDriverBindingStart (
     goto UninitDev;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  &VirtioBlkAsyncTimer,
+                  Dev,
+                  &Dev->AsyncTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto CloseExitBoot;
+  }
+
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
-    goto CloseExitBoot;
+    goto CloseAsyncTimer;
   }
 
   return EFI_SUCCESS;
 
+CloseAsyncTimer:
+  gBS->CloseEvent (Dev->AsyncTimer);
+
 CloseExitBoot:
   gBS->CloseEvent (Dev->ExitBoot);
 
@@ -1172,7 +1868,8 @@ FreeVirtioBlk:
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo and BlockIo2
+  interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -1222,15 +1919,20 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  VirtioBlkCancelAsyncRequests (Dev);
+  gBS->CloseEvent (Dev->AsyncTimer);
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
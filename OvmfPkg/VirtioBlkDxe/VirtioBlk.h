@@ -13,13 +13,57 @@
 #define _VIRTIO_BLK_DXE_H_
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Each asynchronous request occupies a fixed slot of three consecutive
+// descriptors (request header, data buffer, host status), so at most
+// QueueSize / 3 requests, capped at VBLK_MAX_ASYNC_SLOTS, are in flight.
+//
+#define VBLK_MAX_ASYNC_SLOTS  64
+#define VBLK_DESC_PER_SLOT    3
+
+//
+// Period of the timer that reaps the used ring while requests are in flight.
+//
+#define VBLK_ASYNC_POLL_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+//
+// Request header and host status of one asynchronous slot. An array of these
+// lives in a single common buffer shared with the device.
+//
+typedef struct {
+  VIRTIO_BLK_REQ    Request;
+  UINT8             HostStatus;
+  UINT8             Reserved[7];
+} VBLK_ASYNC_HDR;
+
+#define VBLK_ASYNC_REQ_SIG  SIGNATURE_32 ('V', 'B', 'A', 'R')
+
+//
+// A non-blocking read or write submitted through EFI_BLOCK_IO2_PROTOCOL.
+//
+typedef struct {
+  UINT32                  Signature;
+  LIST_ENTRY              Link;
+  EFI_BLOCK_IO2_TOKEN     *Token;
+  EFI_LBA                 Lba;
+  UINT32                  BufferSize;
+  BOOLEAN                 RequestIsWrite;
+  EFI_PHYSICAL_ADDRESS    BufferDeviceAddress;
+  VOID                    *BufferMapping;
+} VBLK_ASYNC_REQ;
+
+#define VBLK_ASYNC_REQ_FROM_LINK(LinkPointer) \
+        CR (LinkPointer, VBLK_ASYNC_REQ, Link, VBLK_ASYNC_REQ_SIG)
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -31,15 +75,31 @@ typedef struct {
   UINT32                    Signature;         // DriverBindingStart  0
   VIRTIO_DEVICE_PROTOCOL    *VirtIo;           // DriverBindingStart  0
   EFI_EVENT                 ExitBoot;          // DriverBindingStart  0
+  EFI_EVENT                 AsyncTimer;        // DriverBindingStart  0
+  LIST_ENTRY                PendingQueue;      // DriverBindingStart  0
   VRING                     Ring;              // VirtioRingInit      2
   EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;          // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
   VOID                      *RingMap;          // VirtioRingMap       2
+  VBLK_ASYNC_HDR            *AsyncHdr;         // VirtioBlkAsyncInit  2
+  VOID                      *AsyncHdrMap;      // VirtioBlkAsyncInit  2
+  EFI_PHYSICAL_ADDRESS      AsyncHdrDevAddr;   // VirtioBlkAsyncInit  2
+  UINT16                    AsyncSlots;        // VirtioBlkAsyncInit  2
+  UINT16                    LastUsedIdx;       // VirtioBlkAsyncInit  2
+  UINT16                    InFlightCount;     // VirtioBlkAsyncInit  2
+  BOOLEAN                   AsyncTimerArmed;   // VirtioBlkAsyncInit  2
+  BOOLEAN                   RingOwned;         // VirtioBlkAsyncInit  2
+  VBLK_ASYNC_REQ            *InFlight[VBLK_MAX_ASYNC_SLOTS];
+                                               // VirtioBlkAsyncInit  2
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -244,6 +304,92 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.4, 12.10 EFI Block I/O 2 Protocol
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+/**
+
+  ReadBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.4, 12.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
+    ReadBlocksEx() Implementation.
+
+  If Token is NULL or Token->Event is NULL, the request is carried out
+  synchronously by VirtioBlkReadBlocks(). Otherwise it is queued to the
+  virtio ring and Token->Event is signaled from the ring polling timer.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+/**
+
+  WriteBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.4, 12.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
+    WriteBlockEx() Implementation.
+
+  If Token is NULL or Token->Event is NULL, the request is carried out
+  synchronously by VirtioBlkWriteBlocks(). Otherwise it is queued to the
+  virtio ring and Token->Event is signaled from the ring polling timer.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+/**
+
+  FlushBlocksEx() operation for virtio-blk.
+
+  See
+  - UEFI Spec 2.4, 12.10 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
+    FlushBlocksEx() Implementation.
+
+  The flush is only issued once all in-flight writes have completed, and it is
+  carried out synchronously. Token->Event, if any, is signaled before return.
+
+**/
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name